@@ -0,0 +1,69 @@
+// File: fw_boot.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Boot information handed over between the boot loader and the firmware of the
+// ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU. Shared by the boot
+// loader and the firmware.
+//
+
+
+
+#ifndef __FW_BOOT_H__
+#define __FW_BOOT_H__
+
+
+
+// ******************************************************************
+// Boot information.
+// ******************************************************************
+
+// The boot information is located in the top 64 bytes of the SRAM, which are
+// initialized neither by the boot loader nor by the startup code of the
+// firmware. It survives a reset, but not a power cycle.
+#define FW_BOOT_INFO_ADDR           0x2003ffc0
+#define FW_BOOT_INFO                ((volatile tFwBootInfo *) FW_BOOT_INFO_ADDR)
+
+// Magic number of valid boot information ("BOOT").
+#define FW_BOOT_MAGIC               0x544f4f42
+
+// Requests of the firmware to the boot loader for the next reset. The boot
+// loader clears the request, so it applies to one reset only.
+#define FW_BOOT_REQ_NONE            0x00000000
+// Start the slot started last time without checking it again and without
+// waiting for the boot loader menu. Only confirmed slots are started this way.
+#define FW_BOOT_REQ_FAST            0x54534146  // "FAST"
+// The firmware downloaded a new image into the other slot. Check the slots and
+// start the newest one without waiting for the boot loader menu.
+#define FW_BOOT_REQ_UPDATE          0x54445055  // "UPDT"
+
+// Flags set by the boot loader.
+#define FW_BOOT_FLAG_FAST           0x01        // The fast path was taken.
+#define FW_BOOT_FLAG_CLOCK          0x02        // The system clock is set up.
+#define FW_BOOT_FLAG_TIME           0x04        // The boot time is valid.
+
+// Frequency of the precision internal oscillator, which clocks the MCU until
+// the PLL is set up.
+#define FW_BOOT_PIOSC_FREQ          16000000
+
+
+
+// Boot information.
+typedef struct {
+    uint32_t ui32Magic;             // FW_BOOT_MAGIC
+    uint32_t ui32Request;           // Request of the firmware for the next reset.
+    uint32_t ui32Flags;             // Set by the boot loader before starting the firmware.
+    uint32_t ui32SysClock;          // System clock frequency in Hz set by the boot loader.
+    uint32_t ui32SlotStart;         // Slot which passed the full check, 0 if none.
+    uint32_t ui32SlotCrc;           // CRC32 of the image in this slot.
+    uint32_t ui32ClockCycles;       // Cycle counter when the system clock was set up.
+    uint32_t ui32StartCycles;       // Cycle counter when the firmware was started.
+    uint32_t ui32BootUs;            // Time in the boot loader in us.
+    uint32_t pui32Reserved[7];
+} tFwBootInfo;
+
+
+
+#endif  // __FW_BOOT_H__
@@ -0,0 +1,69 @@
+// File: fw_slot.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Layout of the application slots in the flash of the ATLAS MDT Trigger
+// Processor (TP) Command Module (CM) MCU. Shared by the boot loader and the
+// firmware.
+//
+
+
+
+#ifndef __FW_SLOT_H__
+#define __FW_SLOT_H__
+
+
+
+// ******************************************************************
+// Application slots.
+// ******************************************************************
+
+// The flash between the boot loader and the persistent log at the top of the
+// flash holds two application slots. Each slot starts with the image header,
+// which is followed by the vector table of the firmware. The firmware is
+// linked for one of the slots (Makefile variable SLOT), so it runs in place.
+#define FW_SLOT_NUM                 2
+#define FW_SLOT_A_START             0x00004000
+#define FW_SLOT_B_START             0x00078000
+#define FW_SLOT_SIZE                0x00074000
+// The vector table must be aligned to 1 kB, so the header occupies 1 kB.
+#define FW_SLOT_HEADER_SIZE         0x00000400
+#define FW_SLOT_START(n)            ((n) ? FW_SLOT_B_START : FW_SLOT_A_START)
+#define FW_SLOT_HEADER(n)           ((const tFwSlotHeader *) FW_SLOT_START(n))
+#define FW_SLOT_NAME(n)             ((n) ? 'B' : 'A')
+
+// Magic number of the image header ("CMFW").
+#define FW_SLOT_MAGIC               0x57464d43
+// Value of an erased flash word.
+#define FW_SLOT_ERASED              0xffffffff
+// Value of the confirmed word after the firmware confirmed the slot.
+#define FW_SLOT_CONFIRMED           0x00000000
+// Number of boot attempts of an unconfirmed slot. If the firmware did not
+// confirm the slot after this many boots, the slot counts as failed and the
+// boot loader falls back to the other slot.
+#define FW_SLOT_BOOT_MAX            3
+// Watchdog timeout in system clock cycles while an unconfirmed slot boots. The
+// watchdog resets the MCU at the second timeout, i.e. after about 60 s at
+// 120 MHz. Confirming the slot disables the watchdog reset.
+#define FW_SLOT_WATCHDOG_LOAD       0xe0000000
+
+
+
+// Image header at the start of a slot. The version, length and CRC are filled
+// in after linking (fw_slot.py). The confirmed and boot words are left erased
+// in the image and are programmed later, each of them only once.
+typedef struct {
+    uint32_t ui32Magic;                     // FW_SLOT_MAGIC
+    uint32_t ui32Version;                   // Image version, the higher the newer.
+    uint32_t ui32Length;                    // Length of the image after the header in bytes.
+    uint32_t ui32Crc;                       // CRC32 of the image after the header.
+    uint32_t pui32Reserved[4];
+    uint32_t ui32Confirmed;                 // Programmed by the firmware after a successful boot.
+    uint32_t pui32Boot[FW_SLOT_BOOT_MAX];   // Programmed by the boot loader on each boot attempt.
+} tFwSlotHeader;
+
+
+
+#endif  // __FW_SLOT_H__
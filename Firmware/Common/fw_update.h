@@ -0,0 +1,69 @@
+// File: fw_update.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Commands of the serial firmware update of the ATLAS MDT Trigger Processor
+// (TP) Command Module (CM) MCU in addition to the commands of the TivaWare
+// boot loader (boot_loader/bl_commands.h). Shared by the boot loader and the
+// firmware, which both accept firmware updates over the UART.
+//
+
+
+
+#ifndef __FW_UPDATE_H__
+#define __FW_UPDATE_H__
+
+
+
+// ******************************************************************
+// Additional boot loader commands.
+// ******************************************************************
+
+// Switch the UART to a new baud rate. The 32 bit baud rate follows the command
+// byte in big endian order, like the addresses of the standard commands.
+#define COMMAND_SET_BAUD            0x26
+// Lowest and highest baud rate accepted by COMMAND_SET_BAUD.
+#define BL_BAUD_MIN                 9600
+#define BL_BAUD_MAX                 3000000
+// Time in ms to wait for each of the two ping packets with which the host
+// confirms the new baud rate. The second ping tells that the host received the
+// acknowledge of the first one. Without confirmation the old baud rate is
+// restored.
+#define BL_BAUD_CONFIRM_TIMEOUT     500
+// Send data with a sequence number in the pipelined (windowed) transfer mode.
+// The sequence number follows the command byte, then the data follows. Each
+// packet in sequence is answered with a cumulative acknowledge, which is not
+// acknowledged by the host: size (4), checksum, status, next sequence number.
+// A packet ahead of the expected sequence number is answered once with the
+// unchanged next sequence number, so the host goes back and resends from
+// there. Of old duplicates, only the last programmed packet is acknowledged
+// again, in case the host missed the acknowledge. Others are dropped silently.
+#define COMMAND_SEND_DATA_WIN       0x27
+// Declare the data of the current download as compressed. It must follow
+// COMMAND_DOWNLOAD, which holds the uncompressed size. The compression type
+// (see bl_lz.h) and the CRC32 of the uncompressed image in big endian order
+// follow the command byte. The compressed data must be sent with
+// COMMAND_SEND_DATA_WIN. When the image is complete, its CRC32 is checked.
+#define COMMAND_DOWNLOAD_COMP       0x28
+// Return the CRC32 of flash erase blocks. The start address in big endian
+// order and the number of blocks (up to BL_PAGE_CRC_MAX) follow the command
+// byte. After the acknowledge the boot loader sends a packet with the status,
+// the erase block size and the CRC32 of each block, all in big endian order.
+// With 0 blocks only the erase block size is returned.
+#define COMMAND_GET_PAGE_CRC        0x29
+#define BL_PAGE_CRC_MAX             60
+// Start a download like COMMAND_DOWNLOAD, but at any erase block in the
+// application area. Only the erase blocks holding the data are erased. This
+// allows to update only the erase blocks that changed.
+#define COMMAND_DOWNLOAD_PAGES      0x2a
+// Skip data of the current download, which is left erased. The number of
+// bytes in big endian order follows the command byte. It must be a multiple of
+// 4, unless it covers the rest of the download. Not supported for compressed
+// data.
+#define COMMAND_SKIP_DATA           0x2b
+
+
+
+#endif  // __FW_UPDATE_H__
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 29 May 2020
+// Rev.: 18 Oct 2026
 //
 // GPIO functions for TI Tiva TM4C1290 MCU on the ATLAS MDT Trigger Processor
 // (TP) Command Module (CM).
@@ -119,3 +119,75 @@ bool GpioOutputGetBool(tGPIO *psGpio)
     }
 }
 
+
+
+
+// Initialize all GPIO pins of a group.
+void GpioGroupInit(const tGpioGroup *psGroup)
+{
+    for (uint32_t i = 0; i < psGroup->ui32GpioNum; i++) {
+        GpioInit(&psGroup->psGpio[i]);
+    }
+}
+
+
+
+// Set the outputs of a GPIO group. All output pins of a port are written at
+// once, so they change at the same time. Bits of input pins are ignored.
+void GpioGroupSet(const tGpioGroup *psGroup, uint32_t ui32Val)
+{
+    const tGpioGroupPort *psPort;
+    uint8_t ui8Val;
+
+    for (uint32_t i = 0; i < psGroup->ui32PortNum; i++) {
+        psPort = &psGroup->psPort[i];
+        ui8Val = 0;
+        for (int iPin = 0; iPin < 8; iPin++) {
+            if ((psPort->ui8PinsOut & (1 << iPin)) && (ui32Val & (1 << psPort->pi8Bit[iPin]))) {
+                ui8Val |= 1 << iPin;
+            }
+        }
+        GPIOPinWrite(psPort->ui32Port, psPort->ui8PinsOut, ui8Val);
+    }
+}
+
+
+
+// Read a GPIO group. All pins of a port are read at once. Outputs are read
+// back.
+uint32_t GpioGroupGet(const tGpioGroup *psGroup)
+{
+    const tGpioGroupPort *psPort;
+    uint8_t ui8Val;
+    uint32_t ui32Val = 0;
+
+    for (uint32_t i = 0; i < psGroup->ui32PortNum; i++) {
+        psPort = &psGroup->psPort[i];
+        ui8Val = GPIOPinRead(psPort->ui32Port, psPort->ui8Pins);
+        for (int iPin = 0; iPin < 8; iPin++) {
+            if (ui8Val & psPort->ui8Pins & (1 << iPin)) {
+                ui32Val |= 1 << psPort->pi8Bit[iPin];
+            }
+        }
+    }
+
+    return ui32Val;
+}
+
+
+
+// Get the bits of the output pins of a GPIO group.
+uint32_t GpioGroupMaskOut(const tGpioGroup *psGroup)
+{
+    const tGpioGroupPort *psPort;
+    uint32_t ui32Mask = 0;
+
+    for (uint32_t i = 0; i < psGroup->ui32PortNum; i++) {
+        psPort = &psGroup->psPort[i];
+        for (int iPin = 0; iPin < 8; iPin++) {
+            if (psPort->ui8PinsOut & (1 << iPin)) ui32Mask |= 1 << psPort->pi8Bit[iPin];
+        }
+    }
+
+    return ui32Mask;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 24 Apr 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the GPIO functions for the TI Tiva TM4C1290 MCU on the ATLAS
 // MDT Trigger Processor (TP) Command Module (CM).
@@ -26,6 +26,30 @@ typedef struct {
     uint32_t ui32IntType;
 } tGPIO;
 
+// Pins of a GPIO group on one port. The pins are accessed with a single masked
+// register access.
+typedef struct {
+    uint32_t ui32Port;
+    uint8_t  ui8PinsOut;        // Output pins of the group on this port.
+    uint8_t  ui8Pins;           // All pins of the group on this port.
+    int8_t   pi8Bit[8];         // Bit of the group value for each port pin. -1 = not in the group.
+} tGpioGroupPort;
+
+// Pin of a single signal.
+typedef struct {
+    char     *pcName;           // Signal name.
+    uint32_t ui32Port;
+    uint8_t  ui8Pin;
+} tGpioPin;
+
+// GPIO group, e.g. all power control signals.
+typedef struct {
+    tGPIO *psGpio;              // Pins with the same port, direction and type.
+    uint32_t ui32GpioNum;
+    const tGpioGroupPort *psPort;
+    uint32_t ui32PortNum;
+} tGpioGroup;
+
 
 
 // Function prototypes.
@@ -37,6 +61,10 @@ void GpioOutputSet(tGPIO *psGpio, uint8_t ui8Val);
 void GpioOutputSetBool(tGPIO *psGpio, bool bVal);
 int32_t GpioOutputGet(tGPIO *psGpio);
 bool GpioOutputGetBool(tGPIO *psGpio);
+void GpioGroupInit(const tGpioGroup *psGroup);
+void GpioGroupSet(const tGpioGroup *psGroup, uint32_t ui32Val);
+uint32_t GpioGroupGet(const tGpioGroup *psGroup);
+uint32_t GpioGroupMaskOut(const tGpioGroup *psGroup);
 
 
 
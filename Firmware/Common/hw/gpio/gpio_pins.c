@@ -2,11 +2,13 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 24 Apr 2020
-// Rev.: 21 Jan 2021
+// Rev.: 18 Oct 2026
 //
 // GPIO pin definitions and functions for the TI Tiva TM4C1290 MCU on the ATLAS
 // MDT Trigger Processor (TP) Command Module (CM).
 //
+// Generated by gpio_pins_gen.py from gpio_pins.txt. Do not edit!
+//
 
 
 
@@ -60,33 +62,39 @@ void GpioInit_All(void)
 // Service Module power enable.
 // ******************************************************************
 
-// SM_PWR_ENA: PN3, 110
-tGPIO g_sGpio_SmPowerEna = {
-    SYSCTL_PERIPH_GPION,
-    GPIO_PORTN_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    // Note: The Servie Module CM_PWR_EN signal is active high, so implement a
-    //       weak pull-down on the MCU input pin.
-    GPIO_PIN_TYPE_STD_WPD,  // ui32PinType
-    true,                   // bInput: false = output, true = input
-    GPIO_BOTH_EDGES         // ui32IntType
+// Bit 0: SM_PWR_ENA: PN3, 110
+tGPIO g_psGpio_SmPowerEna[] = {
+    {
+        SYSCTL_PERIPH_GPION,
+        GPIO_PORTN_BASE,
+        GPIO_PIN_3,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD_WPD,  // ui32PinType
+        true,                   // bInput: false = output, true = input
+        GPIO_BOTH_EDGES         // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_SmPowerEna[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTN_BASE, 0x00, 0x08, {-1, -1, -1,  0, -1, -1, -1, -1}}
 };
 
-// Initialize the Service Module power enable GPIO.
+const tGpioGroup g_sGpioGroup_SmPowerEna = {
+    g_psGpio_SmPowerEna, 1,
+    g_psGpioGroupPort_SmPowerEna, 1
+};
+
+// Initialize the GPIOs of the group "Service Module power enable".
 void GpioInit_SmPowerEna(void)
 {
-    GpioInit(&g_sGpio_SmPowerEna);
+    GpioGroupInit(&g_sGpioGroup_SmPowerEna);
 }
 
-// Read the Service Module power enable GPIO.
+// Read the GPIOs of the group "Service Module power enable".
 uint32_t GpioGet_SmPowerEna(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioInputGetBool(&g_sGpio_SmPowerEna) & 0x1) << 0;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_SmPowerEna);
 }
 
 
@@ -95,34 +103,45 @@ uint32_t GpioGet_SmPowerEna(void)
 // Command Module ready.
 // ******************************************************************
 
-// CM_READY: PN2, 109
-tGPIO g_sGpio_CmReady = {
-    SYSCTL_PERIPH_GPION,
-    GPIO_PORTN_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
+// Bit 0: CM_READY: PN2, 109
+tGPIO g_psGpio_CmReady[] = {
+    {
+        SYSCTL_PERIPH_GPION,
+        GPIO_PORTN_BASE,
+        GPIO_PIN_2,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
 };
 
+const tGpioGroupPort g_psGpioGroupPort_CmReady[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTN_BASE, 0x04, 0x04, {-1, -1,  0, -1, -1, -1, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_CmReady = {
+    g_psGpio_CmReady, 1,
+    g_psGpioGroupPort_CmReady, 1
+};
+
+// Initialize the GPIOs of the group "Command Module ready".
 void GpioInit_CmReady(void)
 {
-    GpioInit(&g_sGpio_CmReady);
+    GpioGroupInit(&g_sGpioGroup_CmReady);
 }
 
+// Set the outputs of the group "Command Module ready".
 void GpioSet_CmReady(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_CmReady, (bool) (ui32Val & 0x01));
+    GpioGroupSet(&g_sGpioGroup_CmReady, ui32Val);
 }
 
+// Read the GPIOs of the group "Command Module ready".
 uint32_t GpioGet_CmReady(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_CmReady) & 0x1) << 0;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_CmReady);
 }
 
 
@@ -131,73 +150,58 @@ uint32_t GpioGet_CmReady(void)
 // Command Module status LEDs.
 // ******************************************************************
 
-// CLK_DOMAIN_PG: PQ0, 5
-tGPIO g_sGpio_LedCmStatus0 = {
-    SYSCTL_PERIPH_GPIOQ,
-    GPIO_PORTQ_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// KUP_DOMAIN_PG: PN4, 111
-tGPIO g_sGpio_LedCmStatus1 = {
-    SYSCTL_PERIPH_GPION,
-    GPIO_PORTN_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_DOMAIN_PG: PN5, 112
-tGPIO g_sGpio_LedCmStatus2 = {
-    SYSCTL_PERIPH_GPION,
-    GPIO_PORTN_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// TEMP_ERROR: PQ1, 6
-tGPIO g_sGpio_LedCmStatus3 = {
-    SYSCTL_PERIPH_GPIOQ,
-    GPIO_PORTQ_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: CLK_DOMAIN_PG: PQ0, 5
+// Bit 1: KUP_DOMAIN_PG: PN4, 111
+// Bit 2: ZUP_DOMAIN_PG: PN5, 112
+// Bit 3: TEMP_ERROR: PQ1, 6
+tGPIO g_psGpio_LedCmStatus[] = {
+    {
+        SYSCTL_PERIPH_GPIOQ,
+        GPIO_PORTQ_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPION,
+        GPIO_PORTN_BASE,
+        GPIO_PIN_4 | GPIO_PIN_5, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_LedCmStatus[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTQ_BASE, 0x03, 0x03, { 0,  3, -1, -1, -1, -1, -1, -1}},
+    {GPIO_PORTN_BASE, 0x30, 0x30, {-1, -1, -1, -1,  1,  2, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_LedCmStatus = {
+    g_psGpio_LedCmStatus, 2,
+    g_psGpioGroupPort_LedCmStatus, 2
+};
+
+// Initialize the GPIOs of the group "Command Module status LEDs".
 void GpioInit_LedCmStatus(void)
 {
-    GpioInit(&g_sGpio_LedCmStatus0);
-    GpioInit(&g_sGpio_LedCmStatus1);
-    GpioInit(&g_sGpio_LedCmStatus2);
-    GpioInit(&g_sGpio_LedCmStatus3);
+    GpioGroupInit(&g_sGpioGroup_LedCmStatus);
 }
 
+// Set the outputs of the group "Command Module status LEDs".
 void GpioSet_LedCmStatus(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_LedCmStatus0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_LedCmStatus1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_LedCmStatus2, (bool) (ui32Val & 0x04));
-    GpioOutputSetBool(&g_sGpio_LedCmStatus3, (bool) (ui32Val & 0x08));
+    GpioGroupSet(&g_sGpioGroup_LedCmStatus, ui32Val);
 }
 
+// Read the GPIOs of the group "Command Module status LEDs".
 uint32_t GpioGet_LedCmStatus(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedCmStatus0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedCmStatus1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedCmStatus2) & 0x1) << 2;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedCmStatus3) & 0x1) << 3;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_LedCmStatus);
 }
 
 
@@ -206,128 +210,52 @@ uint32_t GpioGet_LedCmStatus(void)
 // MCU user LEDs.
 // ******************************************************************
 
-// MCU_USER_LED0: PM0, 78
-tGPIO g_sGpio_LedMcuUser0 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED1: PM1, 77
-tGPIO g_sGpio_LedMcuUser1 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED2: PM2, 76
-tGPIO g_sGpio_LedMcuUser2 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED3: PM3, 75
-tGPIO g_sGpio_LedMcuUser3 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED4: PM4, 74
-tGPIO g_sGpio_LedMcuUser4 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED5: PM5,73
-tGPIO g_sGpio_LedMcuUser5 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED6: PM6, 72
-tGPIO g_sGpio_LedMcuUser6 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_6,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_USER_LED7: PM7, 71
-tGPIO g_sGpio_LedMcuUser7 = {
-    SYSCTL_PERIPH_GPIOM,
-    GPIO_PORTM_BASE,
-    GPIO_PIN_7,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
-// Initialize the MCU user LEDs.
+// Bit 0: MCU_USER_LED0: PM0, 78
+// Bit 1: MCU_USER_LED1: PM1, 77
+// Bit 2: MCU_USER_LED2: PM2, 76
+// Bit 3: MCU_USER_LED3: PM3, 75
+// Bit 4: MCU_USER_LED4: PM4, 74
+// Bit 5: MCU_USER_LED5: PM5, 73
+// Bit 6: MCU_USER_LED6: PM6, 72
+// Bit 7: MCU_USER_LED7: PM7, 71
+tGPIO g_psGpio_LedMcuUser[] = {
+    {
+        SYSCTL_PERIPH_GPIOM,
+        GPIO_PORTM_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_LedMcuUser[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTM_BASE, 0xff, 0xff, { 0,  1,  2,  3,  4,  5,  6,  7}}
+};
+
+const tGpioGroup g_sGpioGroup_LedMcuUser = {
+    g_psGpio_LedMcuUser, 1,
+    g_psGpioGroupPort_LedMcuUser, 1
+};
+
+// Initialize the GPIOs of the group "MCU user LEDs".
 void GpioInit_LedMcuUser(void)
 {
-    GpioInit(&g_sGpio_LedMcuUser0);
-    GpioInit(&g_sGpio_LedMcuUser1);
-    GpioInit(&g_sGpio_LedMcuUser2);
-    GpioInit(&g_sGpio_LedMcuUser3);
-    GpioInit(&g_sGpio_LedMcuUser4);
-    GpioInit(&g_sGpio_LedMcuUser5);
-    GpioInit(&g_sGpio_LedMcuUser6);
-    GpioInit(&g_sGpio_LedMcuUser7);
+    GpioGroupInit(&g_sGpioGroup_LedMcuUser);
 }
 
-// Set the MCU user LEDs.
+// Set the outputs of the group "MCU user LEDs".
 void GpioSet_LedMcuUser(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_LedMcuUser0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser2, (bool) (ui32Val & 0x04));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser3, (bool) (ui32Val & 0x08));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser4, (bool) (ui32Val & 0x10));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser5, (bool) (ui32Val & 0x20));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser6, (bool) (ui32Val & 0x40));
-    GpioOutputSetBool(&g_sGpio_LedMcuUser7, (bool) (ui32Val & 0x80));
+    GpioGroupSet(&g_sGpioGroup_LedMcuUser, ui32Val);
 }
 
-// Read back the MCU user LEDs.
+// Read the GPIOs of the group "MCU user LEDs".
 uint32_t GpioGet_LedMcuUser(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser2) & 0x1) << 2;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser3) & 0x1) << 3;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser4) & 0x1) << 4;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser5) & 0x1) << 5;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser6) & 0x1) << 6;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_LedMcuUser7) & 0x1) << 7;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_LedMcuUser);
 }
 
 
@@ -336,60 +264,57 @@ uint32_t GpioGet_LedMcuUser(void)
 // High speed signal multiplexer selection.
 // ******************************************************************
 
-// B2B_MUX1_SEL: PA2, 35
-tGPIO g_sGpio_MuxSel0 = {
-    SYSCTL_PERIPH_GPIOA,
-    GPIO_PORTA_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// B2B_MUX2_SEL: PA4, 37
-tGPIO g_sGpio_MuxSel1 = {
-    SYSCTL_PERIPH_GPIOA,
-    GPIO_PORTA_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// LTTC_MUX1_SEL: PC4, 25
-tGPIO g_sGpio_MuxSel2 = {
-    SYSCTL_PERIPH_GPIOC,
-    GPIO_PORTC_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: B2B_MUX1_SEL: PA2, 35
+// Bit 1: B2B_MUX2_SEL: PA4, 37
+// Bit 2: LTTC_MUX1_SEL: PC4, 25
+tGPIO g_psGpio_MuxSel[] = {
+    {
+        SYSCTL_PERIPH_GPIOA,
+        GPIO_PORTA_BASE,
+        GPIO_PIN_2 | GPIO_PIN_4, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPIOC,
+        GPIO_PORTC_BASE,
+        GPIO_PIN_4,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_MuxSel[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTA_BASE, 0x14, 0x14, {-1, -1,  0, -1,  1, -1, -1, -1}},
+    {GPIO_PORTC_BASE, 0x10, 0x10, {-1, -1, -1, -1,  2, -1, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_MuxSel = {
+    g_psGpio_MuxSel, 2,
+    g_psGpioGroupPort_MuxSel, 2
+};
+
+// Initialize the GPIOs of the group "High speed signal multiplexer selection".
 void GpioInit_MuxSel(void)
 {
-    GpioInit(&g_sGpio_MuxSel0);
-    GpioInit(&g_sGpio_MuxSel1);
-    GpioInit(&g_sGpio_MuxSel2);
+    GpioGroupInit(&g_sGpioGroup_MuxSel);
 }
 
+// Set the outputs of the group "High speed signal multiplexer selection".
 void GpioSet_MuxSel(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_MuxSel0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_MuxSel1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_MuxSel2, (bool) (ui32Val & 0x04));
+    GpioGroupSet(&g_sGpioGroup_MuxSel, ui32Val);
 }
 
+// Read the GPIOs of the group "High speed signal multiplexer selection".
 uint32_t GpioGet_MuxSel(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_MuxSel0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_MuxSel1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_MuxSel2) & 0x1) << 2;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_MuxSel);
 }
 
 
@@ -398,149 +323,118 @@ uint32_t GpioGet_MuxSel(void)
 // High speed signal multiplexer power down.
 // ******************************************************************
 
-// B2B_MUX1_PD: PA3, 36
-tGPIO g_sGpio_MuxPD0 = {
-    SYSCTL_PERIPH_GPIOA,
-    GPIO_PORTA_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// B2B_MUX2_PD: PA5, 38
-tGPIO g_sGpio_MuxPD1 = {
-    SYSCTL_PERIPH_GPIOA,
-    GPIO_PORTA_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// LTTC_MUX1_PD: PC5, 24
-tGPIO g_sGpio_MuxPD2 = {
-    SYSCTL_PERIPH_GPIOC,
-    GPIO_PORTC_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: B2B_MUX1_PD: PA3, 36
+// Bit 1: B2B_MUX2_PD: PA5, 38
+// Bit 2: LTTC_MUX1_PD: PC5, 24
+tGPIO g_psGpio_MuxPD[] = {
+    {
+        SYSCTL_PERIPH_GPIOA,
+        GPIO_PORTA_BASE,
+        GPIO_PIN_3 | GPIO_PIN_5, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_OD,       // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPIOC,
+        GPIO_PORTC_BASE,
+        GPIO_PIN_5,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_OD,       // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_MuxPD[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTA_BASE, 0x28, 0x28, {-1, -1, -1,  0, -1,  1, -1, -1}},
+    {GPIO_PORTC_BASE, 0x20, 0x20, {-1, -1, -1, -1, -1,  2, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_MuxPD = {
+    g_psGpio_MuxPD, 2,
+    g_psGpioGroupPort_MuxPD, 2
+};
+
+// Initialize the GPIOs of the group "High speed signal multiplexer power down".
 void GpioInit_MuxPD(void)
 {
-    GpioInit(&g_sGpio_MuxPD0);
-    GpioInit(&g_sGpio_MuxPD1);
-    GpioInit(&g_sGpio_MuxPD2);
+    GpioGroupInit(&g_sGpioGroup_MuxPD);
 }
 
+// Set the outputs of the group "High speed signal multiplexer power down".
 void GpioSet_MuxPD(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_MuxPD0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_MuxPD1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_MuxPD2, (bool) (ui32Val & 0x04));
+    GpioGroupSet(&g_sGpioGroup_MuxPD, ui32Val);
 }
 
+// Read the GPIOs of the group "High speed signal multiplexer power down".
 uint32_t GpioGet_MuxPD(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_MuxPD0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_MuxPD1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_MuxPD2) & 0x1) << 2;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_MuxPD);
 }
 
 
 
-
 // ******************************************************************
 // Clock multiplexer selection.
 // ******************************************************************
 
-// AD_CLK2_KUP_SEL: PE0, 15
-tGPIO g_sGpio_ClockSel0 = {
-    SYSCTL_PERIPH_GPIOE,
-    GPIO_PORTE_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// AD_CLK3_KUP_SEL: PE1, 14
-tGPIO g_sGpio_ClockSel1 = {
-    SYSCTL_PERIPH_GPIOE,
-    GPIO_PORTE_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// AD_CLK4_KUP_SEL: PE2, 13
-tGPIO g_sGpio_ClockSel2 = {
-    SYSCTL_PERIPH_GPIOE,
-    GPIO_PORTE_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// AD_CLK5_ZUP_SEL: PN0, 107
-tGPIO g_sGpio_ClockSel3 = {
-    SYSCTL_PERIPH_GPION,
-    GPIO_PORTN_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// CLK_LHC_FPGA_SEL: PN1, 108
-tGPIO g_sGpio_ClockSel4 = {
-    SYSCTL_PERIPH_GPION,
-    GPIO_PORTN_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: AD_CLK2_KUP_SEL: PE0, 15
+// Bit 1: AD_CLK3_KUP_SEL: PE1, 14
+// Bit 2: AD_CLK4_KUP_SEL: PE2, 13
+// Bit 3: AD_CLK5_ZUP_SEL: PN0, 107
+// Bit 4: CLK_LHC_FPGA_SEL: PN1, 108
+tGPIO g_psGpio_ClockSel[] = {
+    {
+        SYSCTL_PERIPH_GPIOE,
+        GPIO_PORTE_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPION,
+        GPIO_PORTN_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_ClockSel[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTE_BASE, 0x07, 0x07, { 0,  1,  2, -1, -1, -1, -1, -1}},
+    {GPIO_PORTN_BASE, 0x03, 0x03, { 3,  4, -1, -1, -1, -1, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_ClockSel = {
+    g_psGpio_ClockSel, 2,
+    g_psGpioGroupPort_ClockSel, 2
+};
+
+// Initialize the GPIOs of the group "Clock multiplexer selection".
 void GpioInit_ClockSel(void)
 {
-    GpioInit(&g_sGpio_ClockSel0);
-    GpioInit(&g_sGpio_ClockSel1);
-    GpioInit(&g_sGpio_ClockSel2);
-    GpioInit(&g_sGpio_ClockSel3);
-    GpioInit(&g_sGpio_ClockSel4);
+    GpioGroupInit(&g_sGpioGroup_ClockSel);
 }
 
+// Set the outputs of the group "Clock multiplexer selection".
 void GpioSet_ClockSel(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_ClockSel0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_ClockSel1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_ClockSel2, (bool) (ui32Val & 0x04));
-    GpioOutputSetBool(&g_sGpio_ClockSel3, (bool) (ui32Val & 0x08));
-    GpioOutputSetBool(&g_sGpio_ClockSel4, (bool) (ui32Val & 0x10));
+    GpioGroupSet(&g_sGpioGroup_ClockSel, ui32Val);
 }
 
+// Read the GPIOs of the group "Clock multiplexer selection".
 uint32_t GpioGet_ClockSel(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ClockSel0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ClockSel1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ClockSel2) & 0x1) << 2;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ClockSel3) & 0x1) << 3;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ClockSel4) & 0x1) << 4;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_ClockSel);
 }
 
 
@@ -549,125 +443,72 @@ uint32_t GpioGet_ClockSel(void)
 // Power control.
 // ******************************************************************
 
-// KUP_CORE_RUN: PF3, 45
-tGPIO g_sGpio_PowerCtrl0 = {
-    SYSCTL_PERIPH_GPIOF,
-    GPIO_PORTF_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// KUP_P3V3_IO_RUN: PH0, 29
-tGPIO g_sGpio_PowerCtrl1 = {
-    SYSCTL_PERIPH_GPIOH,
-    GPIO_PORTH_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// KUP_DDR4_TERM_EN: PF4, 46
-tGPIO g_sGpio_PowerCtrl2 = {
-    SYSCTL_PERIPH_GPIOF,
-    GPIO_PORTF_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_CORE_RUN: PD6, 127
-tGPIO g_sGpio_PowerCtrl3 = {
-    SYSCTL_PERIPH_GPIOD,
-    GPIO_PORTD_BASE,
-    GPIO_PIN_6,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PS_DDR4_TERM_EN: PD7, 128
-tGPIO g_sGpio_PowerCtrl4 = {
-    SYSCTL_PERIPH_GPIOD,
-    GPIO_PORTD_BASE,
-    GPIO_PIN_7,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PL_DDR4_TERM_EN: PF0, 42
-tGPIO g_sGpio_PowerCtrl5 = {
-    SYSCTL_PERIPH_GPIOF,
-    GPIO_PORTF_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// FIREFY_P1V8_RUN: PF1, 43
-tGPIO g_sGpio_PowerCtrl6 = {
-    SYSCTL_PERIPH_GPIOF,
-    GPIO_PORTF_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// FIREFY_P3V3_RUN: PF2, 44
-tGPIO g_sGpio_PowerCtrl7 = {
-    SYSCTL_PERIPH_GPIOF,
-    GPIO_PORTF_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: KUP_CORE_RUN: PF3, 45
+// Bit 1: KUP_P3V3_IO_RUN: PH0, 29
+// Bit 2: KUP_DDR4_TERM_EN: PF4, 46
+// Bit 3: ZUP_CORE_RUN: PD6, 127
+// Bit 4: ZUP_PS_DDR4_TERM_EN: PD7, 128
+// Bit 5: ZUP_PL_DDR4_TERM_EN: PF0, 42
+// Bit 6: FIREFY_P1V8_RUN: PF1, 43
+// Bit 7: FIREFY_P3V3_RUN: PF2, 44
+tGPIO g_psGpio_PowerCtrl[] = {
+    {
+        SYSCTL_PERIPH_GPIOF,
+        GPIO_PORTF_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPIOH,
+        GPIO_PORTH_BASE,
+        GPIO_PIN_0,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPIOD,
+        GPIO_PORTD_BASE,
+        GPIO_PIN_6 | GPIO_PIN_7, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_PowerCtrl[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTF_BASE, 0x1f, 0x1f, { 5,  6,  7,  0,  2, -1, -1, -1}},
+    {GPIO_PORTH_BASE, 0x01, 0x01, { 1, -1, -1, -1, -1, -1, -1, -1}},
+    {GPIO_PORTD_BASE, 0xc0, 0xc0, {-1, -1, -1, -1, -1, -1,  3,  4}}
+};
+
+const tGpioGroup g_sGpioGroup_PowerCtrl = {
+    g_psGpio_PowerCtrl, 3,
+    g_psGpioGroupPort_PowerCtrl, 3
+};
+
+// Initialize the GPIOs of the group "Power control".
 void GpioInit_PowerCtrl(void)
 {
-    GpioInit(&g_sGpio_PowerCtrl0);
-    GpioInit(&g_sGpio_PowerCtrl1);
-    GpioInit(&g_sGpio_PowerCtrl2);
-    GpioInit(&g_sGpio_PowerCtrl3);
-    GpioInit(&g_sGpio_PowerCtrl4);
-    GpioInit(&g_sGpio_PowerCtrl5);
-    GpioInit(&g_sGpio_PowerCtrl6);
-    GpioInit(&g_sGpio_PowerCtrl7);
+    GpioGroupInit(&g_sGpioGroup_PowerCtrl);
 }
 
+// Set the outputs of the group "Power control".
 void GpioSet_PowerCtrl(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_PowerCtrl0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl2, (bool) (ui32Val & 0x04));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl3, (bool) (ui32Val & 0x08));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl4, (bool) (ui32Val & 0x10));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl5, (bool) (ui32Val & 0x20));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl6, (bool) (ui32Val & 0x40));
-    GpioOutputSetBool(&g_sGpio_PowerCtrl7, (bool) (ui32Val & 0x80));
+    GpioGroupSet(&g_sGpioGroup_PowerCtrl, ui32Val);
 }
 
+// Read the GPIOs of the group "Power control".
 uint32_t GpioGet_PowerCtrl(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl2) & 0x1) << 2;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl3) & 0x1) << 3;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl4) & 0x1) << 4;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl5) & 0x1) << 5;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl6) & 0x1) << 6;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_PowerCtrl7) & 0x1) << 7;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_PowerCtrl);
 }
 
 
@@ -676,59 +517,56 @@ uint32_t GpioGet_PowerCtrl(void)
 // Control/status of the KU15P.
 // ******************************************************************
 
-// KUP_PROG_B_3V3: PK6, 60
-tGPIO g_sGpio_KupCtrlStat0 = {
-    SYSCTL_PERIPH_GPIOK,
-    GPIO_PORTK_BASE,
-    GPIO_PIN_6,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// KUP_INIT_B_3V3: PK5, 61
-tGPIO g_sGpio_KupCtrlStat1 = {
-    SYSCTL_PERIPH_GPIOK,
-    GPIO_PORTK_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// KUP_DONE_3V3: PK7, 59
-tGPIO g_sGpio_KupCtrlStat2 = {
-    SYSCTL_PERIPH_GPIOK,
-    GPIO_PORTK_BASE,
-    GPIO_PIN_7,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    true,                   // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: KUP_PROG_B_3V3: PK6, 60
+// Bit 1: KUP_INIT_B_3V3: PK5, 61
+// Bit 2: KUP_DONE_3V3: PK7, 59
+tGPIO g_psGpio_KupCtrlStat[] = {
+    {
+        SYSCTL_PERIPH_GPIOK,
+        GPIO_PORTK_BASE,
+        GPIO_PIN_5 | GPIO_PIN_6, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_OD,       // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPIOK,
+        GPIO_PORTK_BASE,
+        GPIO_PIN_7,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        true,                   // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_KupCtrlStat[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTK_BASE, 0x60, 0xe0, {-1, -1, -1, -1, -1,  1,  0,  2}}
+};
+
+const tGpioGroup g_sGpioGroup_KupCtrlStat = {
+    g_psGpio_KupCtrlStat, 2,
+    g_psGpioGroupPort_KupCtrlStat, 1
+};
+
+// Initialize the GPIOs of the group "Control/status of the KU15P".
 void GpioInit_KupCtrlStat(void)
 {
-    GpioInit(&g_sGpio_KupCtrlStat0);
-    GpioInit(&g_sGpio_KupCtrlStat1);
-    GpioInit(&g_sGpio_KupCtrlStat2);
+    GpioGroupInit(&g_sGpioGroup_KupCtrlStat);
 }
 
+// Set the outputs of the group "Control/status of the KU15P".
 void GpioSet_KupCtrlStat(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_KupCtrlStat0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_KupCtrlStat1, (bool) (ui32Val & 0x02));
+    GpioGroupSet(&g_sGpioGroup_KupCtrlStat, ui32Val);
 }
 
+// Read the GPIOs of the group "Control/status of the KU15P".
 uint32_t GpioGet_KupCtrlStat(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_KupCtrlStat0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_KupCtrlStat1) & 0x1) << 1;
-    ui32Val |= (GpioInputGetBool(&g_sGpio_KupCtrlStat2) & 0x1) << 2;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_KupCtrlStat);
 }
 
 
@@ -737,96 +575,59 @@ uint32_t GpioGet_KupCtrlStat(void)
 // Control/status of the ZU11EG.
 // ******************************************************************
 
-// ZUP_PS_PROG_B: PP1, 119
-tGPIO g_sGpio_ZupCtrlStat0 = {
-    SYSCTL_PERIPH_GPIOP,
-    GPIO_PORTP_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PS_INIT_B: PP0, 118
-tGPIO g_sGpio_ZupCtrlStat1 = {
-    SYSCTL_PERIPH_GPIOP,
-    GPIO_PORTP_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PS_DONE: PP2, 103
-tGPIO g_sGpio_ZupCtrlStat2 = {
-    SYSCTL_PERIPH_GPIOP,
-    GPIO_PORTP_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    true,                   // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PS_nPOR: PP3, 104
-tGPIO g_sGpio_ZupCtrlStat3 = {
-    SYSCTL_PERIPH_GPIOP,
-    GPIO_PORTP_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_OD,       // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PS_ERR_STATUS: PP4, 105
-tGPIO g_sGpio_ZupCtrlStat4 = {
-    SYSCTL_PERIPH_GPIOP,
-    GPIO_PORTP_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    true,                   // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// ZUP_PS_ERR_OUT: PP5, 106
-tGPIO g_sGpio_ZupCtrlStat5 = {
-    SYSCTL_PERIPH_GPIOP,
-    GPIO_PORTP_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    true,                   // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: ZUP_PS_PROG_B: PP1, 119
+// Bit 1: ZUP_PS_INIT_B: PP0, 118
+// Bit 2: ZUP_PS_DONE: PP2, 103
+// Bit 3: ZUP_PS_nPOR: PP3, 104
+// Bit 4: ZUP_PS_ERR_STATUS: PP4, 105
+// Bit 5: ZUP_PS_ERR_OUT: PP5, 106
+tGPIO g_psGpio_ZupCtrlStat[] = {
+    {
+        SYSCTL_PERIPH_GPIOP,
+        GPIO_PORTP_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_3, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_OD,       // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    },
+    {
+        SYSCTL_PERIPH_GPIOP,
+        GPIO_PORTP_BASE,
+        GPIO_PIN_2 | GPIO_PIN_4 | GPIO_PIN_5, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        true,                   // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_ZupCtrlStat[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTP_BASE, 0x0b, 0x3f, { 1,  0,  2,  3,  4,  5, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_ZupCtrlStat = {
+    g_psGpio_ZupCtrlStat, 2,
+    g_psGpioGroupPort_ZupCtrlStat, 1
+};
+
+// Initialize the GPIOs of the group "Control/status of the ZU11EG".
 void GpioInit_ZupCtrlStat(void)
 {
-    GpioInit(&g_sGpio_ZupCtrlStat0);
-    GpioInit(&g_sGpio_ZupCtrlStat1);
-    GpioInit(&g_sGpio_ZupCtrlStat2);
-    GpioInit(&g_sGpio_ZupCtrlStat3);
-    GpioInit(&g_sGpio_ZupCtrlStat4);
-    GpioInit(&g_sGpio_ZupCtrlStat5);
+    GpioGroupInit(&g_sGpioGroup_ZupCtrlStat);
 }
 
+// Set the outputs of the group "Control/status of the ZU11EG".
 void GpioSet_ZupCtrlStat(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_ZupCtrlStat0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_ZupCtrlStat1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_ZupCtrlStat3, (bool) (ui32Val & 0x08));
+    GpioGroupSet(&g_sGpioGroup_ZupCtrlStat, ui32Val);
 }
 
+// Read the GPIOs of the group "Control/status of the ZU11EG".
 uint32_t GpioGet_ZupCtrlStat(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ZupCtrlStat0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ZupCtrlStat1) & 0x1) << 1;
-    ui32Val |= (GpioInputGetBool(&g_sGpio_ZupCtrlStat2) & 0x1) << 2;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_ZupCtrlStat3) & 0x1) << 3;
-    ui32Val |= (GpioInputGetBool(&g_sGpio_ZupCtrlStat4) & 0x1) << 4;
-    ui32Val |= (GpioInputGetBool(&g_sGpio_ZupCtrlStat5) & 0x1) << 5;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_ZupCtrlStat);
 }
 
 
@@ -835,47 +636,46 @@ uint32_t GpioGet_ZupCtrlStat(void)
 // Reset for multiplexers and I2C port expanders.
 // ******************************************************************
 
-// I2C_MUX_nRST: PQ6, 58
-tGPIO g_sGpio_Reset0 = {
-    SYSCTL_PERIPH_GPIOQ,
-    GPIO_PORTQ_BASE,
-    GPIO_PIN_6,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
+// Bit 0: I2C_MUX_nRST: PQ6, 58
+// Bit 1: MCU_PEx_nRST: PQ3, 27
+tGPIO g_psGpio_Reset[] = {
+    {
+        SYSCTL_PERIPH_GPIOQ,
+        GPIO_PORTQ_BASE,
+        GPIO_PIN_3 | GPIO_PIN_6, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_Reset[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTQ_BASE, 0x48, 0x48, {-1, -1, -1,  1, -1, -1,  0, -1}}
 };
-// MCU_PEx_nRST: PQ3, 27
-tGPIO g_sGpio_Reset1 = {
-    SYSCTL_PERIPH_GPIOQ,
-    GPIO_PORTQ_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
+
+const tGpioGroup g_sGpioGroup_Reset = {
+    g_psGpio_Reset, 1,
+    g_psGpioGroupPort_Reset, 1
 };
 
+// Initialize the GPIOs of the group "Reset for multiplexers and I2C port expanders".
 void GpioInit_Reset(void)
 {
-    GpioInit(&g_sGpio_Reset0);
-    GpioInit(&g_sGpio_Reset1);
+    GpioGroupInit(&g_sGpioGroup_Reset);
 }
 
+// Set the outputs of the group "Reset for multiplexers and I2C port expanders".
 void GpioSet_Reset(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_Reset0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_Reset1, (bool) (ui32Val & 0x02));
+    GpioGroupSet(&g_sGpioGroup_Reset, ui32Val);
 }
 
+// Read the GPIOs of the group "Reset for multiplexers and I2C port expanders".
 uint32_t GpioGet_Reset(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_Reset0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_Reset1) & 0x1) << 1;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_Reset);
 }
 
 
@@ -884,29 +684,39 @@ uint32_t GpioGet_Reset(void)
 // Interrupt of I2C port expanders.
 // ******************************************************************
 
-// MCU_PEx_nINT: PQ2, 11
-tGPIO g_sGpio_PEInt = {
-    SYSCTL_PERIPH_GPIOQ,
-    GPIO_PORTQ_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    true,                   // bInput: false = output, true = input
-    0                       // ui32IntType
+// Bit 0: MCU_PEx_nINT: PQ2, 11
+tGPIO g_psGpio_PEInt[] = {
+    {
+        SYSCTL_PERIPH_GPIOQ,
+        GPIO_PORTQ_BASE,
+        GPIO_PIN_2,             // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        true,                   // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_PEInt[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTQ_BASE, 0x00, 0x04, {-1, -1,  0, -1, -1, -1, -1, -1}}
+};
+
+const tGpioGroup g_sGpioGroup_PEInt = {
+    g_psGpio_PEInt, 1,
+    g_psGpioGroupPort_PEInt, 1
 };
 
+// Initialize the GPIOs of the group "Interrupt of I2C port expanders".
 void GpioInit_PEInt(void)
 {
-    GpioInit(&g_sGpio_PEInt);
+    GpioGroupInit(&g_sGpioGroup_PEInt);
 }
 
+// Read the GPIOs of the group "Interrupt of I2C port expanders".
 uint32_t GpioGet_PEInt(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioInputGetBool(&g_sGpio_PEInt) & 0x1) << 0;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_PEInt);
 }
 
 
@@ -915,188 +725,165 @@ uint32_t GpioGet_PEInt(void)
 // Spare signals routed to KU15P / ZU11EG.
 // ******************************************************************
 
-// MCU_2_KUP_SE0: PL4, 85
-tGPIO g_sGpio_SpareKup0 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_4,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_KUP_SE1: PL5, 86
-tGPIO g_sGpio_SpareKup1 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_5,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_KUP_SE2: PL6, 94
-tGPIO g_sGpio_SpareKup2 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_6,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_KUP_SE3: PL7, 93
-tGPIO g_sGpio_SpareKup3 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_7,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_ZUP_SE0: PL0, 81
-tGPIO g_sGpio_SpareZup0 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_ZUP_SE1: PL1, 82
-tGPIO g_sGpio_SpareZup1 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_ZUP_SE2: PL2, 83
-tGPIO g_sGpio_SpareZup2 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-// MCU_2_ZUP_SE3: PL3, 84
-tGPIO g_sGpio_SpareZup3 = {
-    SYSCTL_PERIPH_GPIOL,
-    GPIO_PORTL_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
-};
-
+// Bit 0: MCU_2_KUP_SE0: PL4, 85
+// Bit 1: MCU_2_KUP_SE1: PL5, 86
+// Bit 2: MCU_2_KUP_SE2: PL6, 94
+// Bit 3: MCU_2_KUP_SE3: PL7, 93
+// Bit 4: MCU_2_ZUP_SE0: PL0, 81
+// Bit 5: MCU_2_ZUP_SE1: PL1, 82
+// Bit 6: MCU_2_ZUP_SE2: PL2, 83
+// Bit 7: MCU_2_ZUP_SE3: PL3, 84
+tGPIO g_psGpio_SpareKupZup[] = {
+    {
+        SYSCTL_PERIPH_GPIOL,
+        GPIO_PORTL_BASE,
+        GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
+};
+
+const tGpioGroupPort g_psGpioGroupPort_SpareKupZup[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTL_BASE, 0xff, 0xff, { 4,  5,  6,  7,  0,  1,  2,  3}}
+};
+
+const tGpioGroup g_sGpioGroup_SpareKupZup = {
+    g_psGpio_SpareKupZup, 1,
+    g_psGpioGroupPort_SpareKupZup, 1
+};
+
+// Initialize the GPIOs of the group "Spare signals routed to KU15P / ZU11EG".
 void GpioInit_SpareKupZup(void)
 {
-    GpioInit(&g_sGpio_SpareKup0);
-    GpioInit(&g_sGpio_SpareKup1);
-    GpioInit(&g_sGpio_SpareKup2);
-    GpioInit(&g_sGpio_SpareKup3);
-    GpioInit(&g_sGpio_SpareZup0);
-    GpioInit(&g_sGpio_SpareZup1);
-    GpioInit(&g_sGpio_SpareZup2);
-    GpioInit(&g_sGpio_SpareZup3);
+    GpioGroupInit(&g_sGpioGroup_SpareKupZup);
 }
 
+// Set the outputs of the group "Spare signals routed to KU15P / ZU11EG".
 void GpioSet_SpareKupZup(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_SpareKup0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_SpareKup1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_SpareKup2, (bool) (ui32Val & 0x04));
-    GpioOutputSetBool(&g_sGpio_SpareKup3, (bool) (ui32Val & 0x08));
-    GpioOutputSetBool(&g_sGpio_SpareZup0, (bool) (ui32Val & 0x10));
-    GpioOutputSetBool(&g_sGpio_SpareZup1, (bool) (ui32Val & 0x20));
-    GpioOutputSetBool(&g_sGpio_SpareZup2, (bool) (ui32Val & 0x40));
-    GpioOutputSetBool(&g_sGpio_SpareZup3, (bool) (ui32Val & 0x80));
+    GpioGroupSet(&g_sGpioGroup_SpareKupZup, ui32Val);
 }
 
+// Read the GPIOs of the group "Spare signals routed to KU15P / ZU11EG".
 uint32_t GpioGet_SpareKupZup(void)
 {
-    uint32_t ui32Val = 0;
-
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareKup0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareKup1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareKup2) & 0x1) << 2;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareKup3) & 0x1) << 3;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareZup0) & 0x1) << 4;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareZup1) & 0x1) << 5;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareZup2) & 0x1) << 6;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_SpareZup3) & 0x1) << 7;
-
-    return ui32Val;
+    return GpioGroupGet(&g_sGpioGroup_SpareKupZup);
 }
 
 
 
 // ******************************************************************
-// Reserved Signals
+// Reserved signals.
 // ******************************************************************
 
-// Reserved 0: PH1, 30
-tGPIO g_sGpio_Reserved0 = {
-    SYSCTL_PERIPH_GPIOH,
-    GPIO_PORTH_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
+// Bit 0: RESERVED0: PH1, 30
+// Bit 1: RESERVED1: PH2, 31
+// Bit 2: RESERVED2: PH3, 32
+tGPIO g_psGpio_Reserved[] = {
+    {
+        SYSCTL_PERIPH_GPIOH,
+        GPIO_PORTH_BASE,
+        GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3, // ui8Pins
+        GPIO_STRENGTH_2MA,      // ui32Strength
+        GPIO_PIN_TYPE_STD,      // ui32PinType
+        false,                  // bInput: false = output, true = input
+        0                       // ui32IntType
+    }
 };
 
-// Reserved 1: PH2, 31
-tGPIO g_sGpio_Reserved1 = {
-    SYSCTL_PERIPH_GPIOH,
-    GPIO_PORTH_BASE,
-    GPIO_PIN_2,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
+const tGpioGroupPort g_psGpioGroupPort_Reserved[] = {
+    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]
+    {GPIO_PORTH_BASE, 0x0e, 0x0e, {-1,  0,  1,  2, -1, -1, -1, -1}}
 };
 
-// Reserved 2: PH3, 32
-tGPIO g_sGpio_Reserved2 = {
-    SYSCTL_PERIPH_GPIOH,
-    GPIO_PORTH_BASE,
-    GPIO_PIN_3,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD,      // ui32PinType
-    false,                  // bInput: false = output, true = input
-    0                       // ui32IntType
+const tGpioGroup g_sGpioGroup_Reserved = {
+    g_psGpio_Reserved, 1,
+    g_psGpioGroupPort_Reserved, 1
 };
 
+// Initialize the GPIOs of the group "Reserved signals".
 void GpioInit_Reserved(void)
 {
-    GpioInit(&g_sGpio_Reserved0);
-    GpioInit(&g_sGpio_Reserved1);
-    GpioInit(&g_sGpio_Reserved2);
+    GpioGroupInit(&g_sGpioGroup_Reserved);
 }
 
+// Set the outputs of the group "Reserved signals".
 void GpioSet_Reserved(uint32_t ui32Val)
 {
-    GpioOutputSetBool(&g_sGpio_Reserved0, (bool) (ui32Val & 0x01));
-    GpioOutputSetBool(&g_sGpio_Reserved1, (bool) (ui32Val & 0x02));
-    GpioOutputSetBool(&g_sGpio_Reserved2, (bool) (ui32Val & 0x04));
+    GpioGroupSet(&g_sGpioGroup_Reserved, ui32Val);
 }
 
+// Read the GPIOs of the group "Reserved signals".
 uint32_t GpioGet_Reserved(void)
 {
-    uint32_t ui32Val = 0;
+    return GpioGroupGet(&g_sGpioGroup_Reserved);
+}
 
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_Reserved0) & 0x1) << 0;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_Reserved1) & 0x1) << 1;
-    ui32Val |= (GpioOutputGetBool(&g_sGpio_Reserved2) & 0x1) << 2;
 
-    return ui32Val;
-}
+
+// ******************************************************************
+// Pins of all signals. Index with GPIO_SIG_<SIGNAL>.
+// ******************************************************************
+
+const tGpioPin g_psGpioPin[GPIO_SIG_NUM] = {
+    {"SM_PWR_ENA",              GPIO_PORTN_BASE, GPIO_PIN_3},
+    {"CM_READY",                GPIO_PORTN_BASE, GPIO_PIN_2},
+    {"CLK_DOMAIN_PG",           GPIO_PORTQ_BASE, GPIO_PIN_0},
+    {"KUP_DOMAIN_PG",           GPIO_PORTN_BASE, GPIO_PIN_4},
+    {"ZUP_DOMAIN_PG",           GPIO_PORTN_BASE, GPIO_PIN_5},
+    {"TEMP_ERROR",              GPIO_PORTQ_BASE, GPIO_PIN_1},
+    {"MCU_USER_LED0",           GPIO_PORTM_BASE, GPIO_PIN_0},
+    {"MCU_USER_LED1",           GPIO_PORTM_BASE, GPIO_PIN_1},
+    {"MCU_USER_LED2",           GPIO_PORTM_BASE, GPIO_PIN_2},
+    {"MCU_USER_LED3",           GPIO_PORTM_BASE, GPIO_PIN_3},
+    {"MCU_USER_LED4",           GPIO_PORTM_BASE, GPIO_PIN_4},
+    {"MCU_USER_LED5",           GPIO_PORTM_BASE, GPIO_PIN_5},
+    {"MCU_USER_LED6",           GPIO_PORTM_BASE, GPIO_PIN_6},
+    {"MCU_USER_LED7",           GPIO_PORTM_BASE, GPIO_PIN_7},
+    {"B2B_MUX1_SEL",            GPIO_PORTA_BASE, GPIO_PIN_2},
+    {"B2B_MUX2_SEL",            GPIO_PORTA_BASE, GPIO_PIN_4},
+    {"LTTC_MUX1_SEL",           GPIO_PORTC_BASE, GPIO_PIN_4},
+    {"B2B_MUX1_PD",             GPIO_PORTA_BASE, GPIO_PIN_3},
+    {"B2B_MUX2_PD",             GPIO_PORTA_BASE, GPIO_PIN_5},
+    {"LTTC_MUX1_PD",            GPIO_PORTC_BASE, GPIO_PIN_5},
+    {"AD_CLK2_KUP_SEL",         GPIO_PORTE_BASE, GPIO_PIN_0},
+    {"AD_CLK3_KUP_SEL",         GPIO_PORTE_BASE, GPIO_PIN_1},
+    {"AD_CLK4_KUP_SEL",         GPIO_PORTE_BASE, GPIO_PIN_2},
+    {"AD_CLK5_ZUP_SEL",         GPIO_PORTN_BASE, GPIO_PIN_0},
+    {"CLK_LHC_FPGA_SEL",        GPIO_PORTN_BASE, GPIO_PIN_1},
+    {"KUP_CORE_RUN",            GPIO_PORTF_BASE, GPIO_PIN_3},
+    {"KUP_P3V3_IO_RUN",         GPIO_PORTH_BASE, GPIO_PIN_0},
+    {"KUP_DDR4_TERM_EN",        GPIO_PORTF_BASE, GPIO_PIN_4},
+    {"ZUP_CORE_RUN",            GPIO_PORTD_BASE, GPIO_PIN_6},
+    {"ZUP_PS_DDR4_TERM_EN",     GPIO_PORTD_BASE, GPIO_PIN_7},
+    {"ZUP_PL_DDR4_TERM_EN",     GPIO_PORTF_BASE, GPIO_PIN_0},
+    {"FIREFY_P1V8_RUN",         GPIO_PORTF_BASE, GPIO_PIN_1},
+    {"FIREFY_P3V3_RUN",         GPIO_PORTF_BASE, GPIO_PIN_2},
+    {"KUP_PROG_B_3V3",          GPIO_PORTK_BASE, GPIO_PIN_6},
+    {"KUP_INIT_B_3V3",          GPIO_PORTK_BASE, GPIO_PIN_5},
+    {"KUP_DONE_3V3",            GPIO_PORTK_BASE, GPIO_PIN_7},
+    {"ZUP_PS_PROG_B",           GPIO_PORTP_BASE, GPIO_PIN_1},
+    {"ZUP_PS_INIT_B",           GPIO_PORTP_BASE, GPIO_PIN_0},
+    {"ZUP_PS_DONE",             GPIO_PORTP_BASE, GPIO_PIN_2},
+    {"ZUP_PS_nPOR",             GPIO_PORTP_BASE, GPIO_PIN_3},
+    {"ZUP_PS_ERR_STATUS",       GPIO_PORTP_BASE, GPIO_PIN_4},
+    {"ZUP_PS_ERR_OUT",          GPIO_PORTP_BASE, GPIO_PIN_5},
+    {"I2C_MUX_nRST",            GPIO_PORTQ_BASE, GPIO_PIN_6},
+    {"MCU_PEx_nRST",            GPIO_PORTQ_BASE, GPIO_PIN_3},
+    {"MCU_PEx_nINT",            GPIO_PORTQ_BASE, GPIO_PIN_2},
+    {"MCU_2_KUP_SE0",           GPIO_PORTL_BASE, GPIO_PIN_4},
+    {"MCU_2_KUP_SE1",           GPIO_PORTL_BASE, GPIO_PIN_5},
+    {"MCU_2_KUP_SE2",           GPIO_PORTL_BASE, GPIO_PIN_6},
+    {"MCU_2_KUP_SE3",           GPIO_PORTL_BASE, GPIO_PIN_7},
+    {"MCU_2_ZUP_SE0",           GPIO_PORTL_BASE, GPIO_PIN_0},
+    {"MCU_2_ZUP_SE1",           GPIO_PORTL_BASE, GPIO_PIN_1},
+    {"MCU_2_ZUP_SE2",           GPIO_PORTL_BASE, GPIO_PIN_2},
+    {"MCU_2_ZUP_SE3",           GPIO_PORTL_BASE, GPIO_PIN_3},
+    {"RESERVED0",               GPIO_PORTH_BASE, GPIO_PIN_1},
+    {"RESERVED1",               GPIO_PORTH_BASE, GPIO_PIN_2},
+    {"RESERVED2",               GPIO_PORTH_BASE, GPIO_PIN_3}
+};
 
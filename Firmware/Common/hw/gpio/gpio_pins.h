@@ -2,11 +2,13 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 24 Apr 2020
-// Rev.: 19 Nov 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the GPIO pin definitions and functions for the TI Tiva
 // TM4C1290 MCU on the ATLAS MDT Trigger Processor (TP) Command Module (CM).
 //
+// Generated by gpio_pins_gen.py from gpio_pins.txt. Do not edit!
+//
 
 
 
@@ -15,8 +17,12 @@
 
 
 
+#include "gpio.h"
+
+
+
 // Default values.
-#define GPIO_DEFAULT_CM_READY       0x0
+#define GPIO_DEFAULT_CM_READY       0x0     // 0: CM_READY
 #define GPIO_DEFAULT_LED_CM_STATUS  0x0     // 0..3: LED_CM_STATUS_CLOCK, LED_CM_STATUS_KU15P, LED_CM_STATUS_ZU11EG, LED_CM_STATUS_TEMP_ALERT
 #define GPIO_DEFAULT_LED_CM_USER    0x00    // 0..7: LED_USER_BLUE_0, LED_USER_BLUE_1 LED_USER_ORANGE_0, LED_USER_ORANGE_1, LED_USER_GREEN_0, LED_USER_GREEN_1, LED_USER_RED_0, LED_USER_RED_1
 #define GPIO_DEFAULT_MUX_SEL        0x1     // 0..2: B2B_MUX1_SEL, B2B_MUX2_SEL, LTTC_MUX1_SEL
@@ -32,6 +38,100 @@
 
 
 
+// Signals. Index of the pin of a signal in g_psGpioPin.
+#define GPIO_SIG_SM_PWR_ENA             0
+#define GPIO_SIG_CM_READY               1
+#define GPIO_SIG_CLK_DOMAIN_PG          2
+#define GPIO_SIG_KUP_DOMAIN_PG          3
+#define GPIO_SIG_ZUP_DOMAIN_PG          4
+#define GPIO_SIG_TEMP_ERROR             5
+#define GPIO_SIG_MCU_USER_LED0          6
+#define GPIO_SIG_MCU_USER_LED1          7
+#define GPIO_SIG_MCU_USER_LED2          8
+#define GPIO_SIG_MCU_USER_LED3          9
+#define GPIO_SIG_MCU_USER_LED4          10
+#define GPIO_SIG_MCU_USER_LED5          11
+#define GPIO_SIG_MCU_USER_LED6          12
+#define GPIO_SIG_MCU_USER_LED7          13
+#define GPIO_SIG_B2B_MUX1_SEL           14
+#define GPIO_SIG_B2B_MUX2_SEL           15
+#define GPIO_SIG_LTTC_MUX1_SEL          16
+#define GPIO_SIG_B2B_MUX1_PD            17
+#define GPIO_SIG_B2B_MUX2_PD            18
+#define GPIO_SIG_LTTC_MUX1_PD           19
+#define GPIO_SIG_AD_CLK2_KUP_SEL        20
+#define GPIO_SIG_AD_CLK3_KUP_SEL        21
+#define GPIO_SIG_AD_CLK4_KUP_SEL        22
+#define GPIO_SIG_AD_CLK5_ZUP_SEL        23
+#define GPIO_SIG_CLK_LHC_FPGA_SEL       24
+#define GPIO_SIG_KUP_CORE_RUN           25
+#define GPIO_SIG_KUP_P3V3_IO_RUN        26
+#define GPIO_SIG_KUP_DDR4_TERM_EN       27
+#define GPIO_SIG_ZUP_CORE_RUN           28
+#define GPIO_SIG_ZUP_PS_DDR4_TERM_EN    29
+#define GPIO_SIG_ZUP_PL_DDR4_TERM_EN    30
+#define GPIO_SIG_FIREFY_P1V8_RUN        31
+#define GPIO_SIG_FIREFY_P3V3_RUN        32
+#define GPIO_SIG_KUP_PROG_B_3V3         33
+#define GPIO_SIG_KUP_INIT_B_3V3         34
+#define GPIO_SIG_KUP_DONE_3V3           35
+#define GPIO_SIG_ZUP_PS_PROG_B          36
+#define GPIO_SIG_ZUP_PS_INIT_B          37
+#define GPIO_SIG_ZUP_PS_DONE            38
+#define GPIO_SIG_ZUP_PS_nPOR            39
+#define GPIO_SIG_ZUP_PS_ERR_STATUS      40
+#define GPIO_SIG_ZUP_PS_ERR_OUT         41
+#define GPIO_SIG_I2C_MUX_nRST           42
+#define GPIO_SIG_MCU_PEx_nRST           43
+#define GPIO_SIG_MCU_PEx_nINT           44
+#define GPIO_SIG_MCU_2_KUP_SE0          45
+#define GPIO_SIG_MCU_2_KUP_SE1          46
+#define GPIO_SIG_MCU_2_KUP_SE2          47
+#define GPIO_SIG_MCU_2_KUP_SE3          48
+#define GPIO_SIG_MCU_2_ZUP_SE0          49
+#define GPIO_SIG_MCU_2_ZUP_SE1          50
+#define GPIO_SIG_MCU_2_ZUP_SE2          51
+#define GPIO_SIG_MCU_2_ZUP_SE3          52
+#define GPIO_SIG_RESERVED0              53
+#define GPIO_SIG_RESERVED1              54
+#define GPIO_SIG_RESERVED2              55
+#define GPIO_SIG_NUM                    56
+
+
+
+// Global variables.
+extern tGPIO g_psGpio_SmPowerEna[];
+extern const tGpioGroup g_sGpioGroup_SmPowerEna;
+extern tGPIO g_psGpio_CmReady[];
+extern const tGpioGroup g_sGpioGroup_CmReady;
+extern tGPIO g_psGpio_LedCmStatus[];
+extern const tGpioGroup g_sGpioGroup_LedCmStatus;
+extern tGPIO g_psGpio_LedMcuUser[];
+extern const tGpioGroup g_sGpioGroup_LedMcuUser;
+extern tGPIO g_psGpio_MuxSel[];
+extern const tGpioGroup g_sGpioGroup_MuxSel;
+extern tGPIO g_psGpio_MuxPD[];
+extern const tGpioGroup g_sGpioGroup_MuxPD;
+extern tGPIO g_psGpio_ClockSel[];
+extern const tGpioGroup g_sGpioGroup_ClockSel;
+extern tGPIO g_psGpio_PowerCtrl[];
+extern const tGpioGroup g_sGpioGroup_PowerCtrl;
+extern tGPIO g_psGpio_KupCtrlStat[];
+extern const tGpioGroup g_sGpioGroup_KupCtrlStat;
+extern tGPIO g_psGpio_ZupCtrlStat[];
+extern const tGpioGroup g_sGpioGroup_ZupCtrlStat;
+extern tGPIO g_psGpio_Reset[];
+extern const tGpioGroup g_sGpioGroup_Reset;
+extern tGPIO g_psGpio_PEInt[];
+extern const tGpioGroup g_sGpioGroup_PEInt;
+extern tGPIO g_psGpio_SpareKupZup[];
+extern const tGpioGroup g_sGpioGroup_SpareKupZup;
+extern tGPIO g_psGpio_Reserved[];
+extern const tGpioGroup g_sGpioGroup_Reserved;
+extern const tGpioPin g_psGpioPin[GPIO_SIG_NUM];
+
+
+
 // Function prototypes.
 void GpioInit_All(void);
 void GpioInit_SmPowerEna(void);
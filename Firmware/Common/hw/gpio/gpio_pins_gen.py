@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+#
+# File: gpio_pins_gen.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 18 Oct 2026
+# Rev.: 18 Oct 2026
+#
+# Generate the GPIO pin definitions and functions for the TI Tiva TM4C1290 MCU
+# on the ATLAS MDT Trigger Processor (TP) Command Module (CM) from the pin
+# table gpio_pins.txt.
+#
+# Usage: ./gpio_pins_gen.py [PIN_TABLE [OUTPUT_DIR]]
+#
+
+
+
+import os
+import re
+import shlex
+import sys
+
+
+
+# Message prefixes and separators.
+prefixError             = "ERROR: {0:s}: ".format(__file__)
+
+# Default files.
+fileTable               = os.path.join(os.path.dirname(os.path.abspath(__file__)), "gpio_pins.txt")
+fileC                   = "gpio_pins.c"
+fileH                   = "gpio_pins.h"
+
+# Pin types.
+pinTypes = {
+    "STD":  "GPIO_PIN_TYPE_STD",
+    "OD":   "GPIO_PIN_TYPE_OD",
+    "WPU":  "GPIO_PIN_TYPE_STD_WPU",
+    "WPD":  "GPIO_PIN_TYPE_STD_WPD",
+}
+
+# Interrupt types.
+intTypes = ["FALLING_EDGE", "RISING_EDGE", "BOTH_EDGES", "LOW_LEVEL", "HIGH_LEVEL", "DISCRETE_INT"]
+
+# Header of the generated files.
+fileHeader = """\
+// File: {0:s}
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 24 Apr 2020
+// Rev.: {1:s}
+//
+// {2:s}
+//
+// Generated by gpio_pins_gen.py from gpio_pins.txt. Do not edit!
+//
+"""
+
+
+
+# Group of GPIO pins.
+class GpioGroup:
+    def __init__(self, name, macro, default, title):
+        self.name = name
+        self.macro = macro
+        self.default = default
+        self.title = title
+        self.note = None
+        self.hint = None
+        self.pins = []
+
+    def has_outputs(self):
+        return any(pin["dir"] == "out" for pin in self.pins)
+
+    # Pins with the same port, direction, type and interrupt type are
+    # initialized together.
+    def gpio_entries(self):
+        entries = []
+        for pin in self.pins:
+            key = (pin["port"], pin["dir"], pin["type"], pin["int"])
+            for entry in entries:
+                if entry["key"] == key:
+                    entry["pins"].append(pin["pin"])
+                    break
+            else:
+                entries.append({"key": key, "pins": [pin["pin"]]})
+        return entries
+
+    # Ports of the group in the order of their first appearance.
+    def ports(self):
+        ports = []
+        for pin in self.pins:
+            if pin["port"] not in ports:
+                ports.append(pin["port"])
+        return ports
+
+
+
+# Parse the pin table.
+def parse_table(fileName):
+    groups = []
+    group = None
+    with open(fileName, "r") as f:
+        for lineNum, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            where = "{0:s}:{1:d}: ".format(fileName, lineNum)
+            fields = shlex.split(line)
+            if fields[0] == "group":
+                if len(fields) != 5:
+                    raise ValueError(where + "Syntax: group NAME MACRO DEFAULT \"Title.\"")
+                group = GpioGroup(fields[1], fields[2], fields[3], fields[4])
+                if (group.macro == "-") != (group.default == "-"):
+                    raise ValueError(where + "Both MACRO and DEFAULT must be set or \"-\".")
+                groups.append(group)
+                continue
+            if not group:
+                raise ValueError(where + "Pin definition outside of a group.")
+            if fields[0] in ["note", "hint"]:
+                if len(fields) != 2:
+                    raise ValueError(where + "Syntax: {0:s} \"Text.\"".format(fields[0]))
+                setattr(group, fields[0], fields[1])
+                continue
+            if len(fields) not in [6, 7]:
+                raise ValueError(where + "Syntax: BIT SIGNAL PIN PACKAGE_PIN DIR TYPE [INT_TYPE]")
+            match = re.match(r"^P([A-HJ-NP-T])([0-7])$", fields[2])
+            if not match:
+                raise ValueError(where + "Invalid pin `{0:s}'.".format(fields[2]))
+            pin = {
+                "bit":      int(fields[0], 0),
+                "signal":   fields[1],
+                "name":     fields[2],
+                "port":     match.group(1),
+                "pin":      int(match.group(2)),
+                "package":  int(fields[3], 0),
+                "dir":      fields[4],
+                "type":     fields[5],
+                "int":      fields[6] if len(fields) == 7 else None,
+            }
+            if pin["dir"] not in ["in", "out"]:
+                raise ValueError(where + "Invalid direction `{0:s}'.".format(pin["dir"]))
+            if pin["type"] not in pinTypes:
+                raise ValueError(where + "Invalid pin type `{0:s}'.".format(pin["type"]))
+            # Open-drain pins must be outputs. Reading them back returns the
+            # level on the pin.
+            if pin["dir"] == "in" and pin["type"] == "OD":
+                raise ValueError(where + "Open-drain inputs are not supported.")
+            if pin["int"] and (pin["int"] not in intTypes or pin["dir"] != "in"):
+                raise ValueError(where + "Invalid interrupt type `{0:s}'.".format(pin["int"]))
+            if pin["bit"] != len(group.pins):
+                raise ValueError(where + "Bits must be consecutive, starting at 0.")
+            if not re.match(r"^[A-Za-z_][A-Za-z0-9_]*$", pin["signal"]):
+                raise ValueError(where + "Invalid signal name `{0:s}'.".format(pin["signal"]))
+            for other in groups:
+                for otherPin in other.pins:
+                    if otherPin["name"] == pin["name"]:
+                        raise ValueError(where + "Pin {0:s} already used by {1:s}.".format(pin["name"], otherPin["signal"]))
+                    if otherPin["signal"] == pin["signal"]:
+                        raise ValueError(where + "Signal {0:s} already defined.".format(pin["signal"]))
+            group.pins.append(pin)
+    for group in groups:
+        if not group.pins:
+            raise ValueError("{0:s}: Group `{1:s}' has no pins.".format(fileName, group.name))
+    return groups
+
+
+
+# All pins in the order of the pin table.
+def all_pins(groups):
+    return [pin for group in groups for pin in group.pins]
+
+
+
+# Group title for function comments, e.g. "Power control".
+def title_quoted(group):
+    return "\"{0:s}\"".format(group.title.rstrip("."))
+
+
+
+# Generate the C source file.
+def gen_c(groups, rev):
+    out = [fileHeader.format(fileC, rev, "GPIO pin definitions and functions for the TI Tiva TM4C1290 MCU on the ATLAS\n// MDT Trigger Processor (TP) Command Module (CM).")]
+    out.append("""
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "driverlib/sysctl.h"
+#include "gpio.h"
+#include "gpio_pins.h"
+
+
+
+// ******************************************************************
+// Initialize all GPIO pins.
+// ******************************************************************
+
+void GpioInit_All(void)
+{
+""")
+    for group in groups:
+        out.append("    GpioInit_{0:s}();\n".format(group.name))
+        if group.macro != "-":
+            out.append("    GpioSet_{0:s}(GPIO_DEFAULT_{1:s});\n".format(group.name, group.macro))
+    out.append("}\n")
+
+    for group in groups:
+        name = group.name
+        out.append("""
+
+
+// ******************************************************************
+// {0:s}
+// ******************************************************************
+
+""".format(group.title))
+        for pin in group.pins:
+            out.append("// Bit {0:d}: {1:s}: {2:s}, {3:d}\n".format(pin["bit"], pin["signal"], pin["name"], pin["package"]))
+        # Pin initialization.
+        entries = group.gpio_entries()
+        out.append("tGPIO g_psGpio_{0:s}[] = {{\n".format(name))
+        for i, entry in enumerate(entries):
+            port, direction, pinType, intType = entry["key"]
+            pins = " | ".join("GPIO_PIN_{0:d}".format(p) for p in sorted(entry["pins"])) + ", "
+            out.append("    {\n")
+            out.append("        SYSCTL_PERIPH_GPIO{0:s},\n".format(port))
+            out.append("        GPIO_PORT{0:s}_BASE,\n".format(port))
+            out.append("        {0:<24s}// ui8Pins\n".format(pins))
+            out.append("        GPIO_STRENGTH_2MA,      // ui32Strength\n")
+            out.append("        {0:<24s}// ui32PinType\n".format(pinTypes[pinType] + ","))
+            out.append("        {0:<24s}// bInput: false = output, true = input\n".format("true," if direction == "in" else "false,"))
+            out.append("        {0:<24s}// ui32IntType\n".format("GPIO_" + intType if intType else "0"))
+            out.append("    }}{0:s}\n".format("," if i < len(entries) - 1 else ""))
+        out.append("};\n\n")
+        # Group access.
+        ports = group.ports()
+        out.append("const tGpioGroupPort g_psGpioGroupPort_{0:s}[] = {{\n".format(name))
+        out.append("    // ui32Port, ui8PinsOut, ui8Pins, pi8Bit[8]\n")
+        for i, port in enumerate(ports):
+            pinsOut = 0
+            pinsAll = 0
+            bits = [-1] * 8
+            for pin in group.pins:
+                if pin["port"] != port:
+                    continue
+                pinsAll |= 1 << pin["pin"]
+                if pin["dir"] == "out":
+                    pinsOut |= 1 << pin["pin"]
+                bits[pin["pin"]] = pin["bit"]
+            out.append("    {{GPIO_PORT{0:s}_BASE, 0x{1:02x}, 0x{2:02x}, {{{3:s}}}}}{4:s}\n".format(
+                port, pinsOut, pinsAll, ", ".join("{0:2d}".format(b) for b in bits), "," if i < len(ports) - 1 else ""))
+        out.append("};\n\n")
+        out.append("const tGpioGroup g_sGpioGroup_{0:s} = {{\n".format(name))
+        out.append("    g_psGpio_{0:s}, {1:d},\n".format(name, len(entries)))
+        out.append("    g_psGpioGroupPort_{0:s}, {1:d}\n".format(name, len(ports)))
+        out.append("};\n\n")
+        out.append("// Initialize the GPIOs of the group {0:s}.\n".format(title_quoted(group)))
+        out.append("void GpioInit_{0:s}(void)\n{{\n    GpioGroupInit(&g_sGpioGroup_{0:s});\n}}\n".format(name))
+        if group.has_outputs():
+            out.append("\n// Set the outputs of the group {0:s}.\n".format(title_quoted(group)))
+            out.append("void GpioSet_{0:s}(uint32_t ui32Val)\n{{\n    GpioGroupSet(&g_sGpioGroup_{0:s}, ui32Val);\n}}\n".format(name))
+        out.append("\n// Read the GPIOs of the group {0:s}.\n".format(title_quoted(group)))
+        out.append("uint32_t GpioGet_{0:s}(void)\n{{\n    return GpioGroupGet(&g_sGpioGroup_{0:s});\n}}\n".format(name))
+    # Pins of all signals.
+    out.append("""
+
+
+// ******************************************************************
+// Pins of all signals. Index with GPIO_SIG_<SIGNAL>.
+// ******************************************************************
+
+const tGpioPin g_psGpioPin[GPIO_SIG_NUM] = {
+""")
+    pins = all_pins(groups)
+    for i, pin in enumerate(pins):
+        entry = "{{\"{0:s}\",".format(pin["signal"])
+        out.append("    {0:<28s}GPIO_PORT{1:s}_BASE, GPIO_PIN_{2:d}}}{3:s}\n".format(
+            entry, pin["port"], pin["pin"], "," if i < len(pins) - 1 else ""))
+    out.append("};\n")
+    out.append("\n")
+    return "".join(out)
+
+
+
+# Generate the header file.
+def gen_h(groups, rev):
+    out = [fileHeader.format(fileH, rev, "Header file for the GPIO pin definitions and functions for the TI Tiva\n// TM4C1290 MCU on the ATLAS MDT Trigger Processor (TP) Command Module (CM).")]
+    out.append("""
+
+
+#ifndef __GPIO_PINS_H__
+#define __GPIO_PINS_H__
+
+
+
+#include "gpio.h"
+
+
+
+// Default values.
+""")
+    for group in groups:
+        if group.macro == "-":
+            continue
+        if group.hint:
+            out.append("// {0:s}\n".format(group.hint))
+        note = group.note
+        if not note:
+            note = "0..{0:d}: {1:s}".format(len(group.pins) - 1, ", ".join(pin["signal"] for pin in group.pins))
+            if len(group.pins) == 1:
+                note = "0: {0:s}".format(group.pins[0]["signal"])
+        out.append("{0:<36s}{1:<8s}// {2:s}\n".format("#define GPIO_DEFAULT_" + group.macro, group.default, note))
+    out.append("""
+
+
+// Signals. Index of the pin of a signal in g_psGpioPin.
+""")
+    pins = all_pins(groups)
+    for i, pin in enumerate(pins):
+        out.append("{0:<39s} {1:d}\n".format("#define GPIO_SIG_" + pin["signal"], i))
+    out.append("{0:<39s} {1:d}\n".format("#define GPIO_SIG_NUM", len(pins)))
+    out.append("""
+
+
+// Global variables.
+""")
+    for group in groups:
+        out.append("extern tGPIO g_psGpio_{0:s}[];\n".format(group.name))
+        out.append("extern const tGpioGroup g_sGpioGroup_{0:s};\n".format(group.name))
+    out.append("extern const tGpioPin g_psGpioPin[GPIO_SIG_NUM];\n")
+    out.append("""
+
+
+// Function prototypes.
+void GpioInit_All(void);
+""")
+    for group in groups:
+        out.append("void GpioInit_{0:s}(void);\n".format(group.name))
+        if group.has_outputs():
+            out.append("void GpioSet_{0:s}(uint32_t ui32Val);\n".format(group.name))
+        out.append("uint32_t GpioGet_{0:s}(void);\n".format(group.name))
+    out.append("""
+
+
+#endif  // __GPIO_PINS_H__
+
+""")
+    return "".join(out)
+
+
+
+# Take the revision date from the pin table.
+def table_rev(fileName):
+    with open(fileName, "r") as f:
+        for line in f:
+            match = re.match(r"^# Rev\.: (.*)$", line)
+            if match:
+                return match.group(1).strip()
+    return "unknown"
+
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 1:
+        fileTable = sys.argv[1]
+    outputDir = sys.argv[2] if len(sys.argv) > 2 else os.path.dirname(os.path.abspath(fileTable))
+    try:
+        groups = parse_table(fileTable)
+    except (OSError, ValueError) as e:
+        print(prefixError + str(e))
+        sys.exit(1)
+    rev = table_rev(fileTable)
+    with open(os.path.join(outputDir, fileC), "w") as f:
+        f.write(gen_c(groups, rev))
+    with open(os.path.join(outputDir, fileH), "w") as f:
+        f.write(gen_h(groups, rev))
@@ -2,16 +2,20 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 11 Feb 2020
-// Rev.: 17 Apr 2020
+// Rev.: 18 Oct 2026
 //
 // I2C functions on the ATLAS MDT Trigger Processor (TP) Command Module (CM)
 // MCU.
 //
+// The duration and the errors of each I2C transfer are recorded per I2C master
+// with the DWT cycle counter, see perf.h.
+//
 
 
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "inc/hw_types.h"
 #include "driverlib/gpio.h"
 #include "driverlib/i2c.h"
 #include "driverlib/sysctl.h"
@@ -53,8 +57,8 @@ uint32_t I2CMasterWrite(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, ui
 
 
 
-// Write data to an I2C master (advanced).
-uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
+// Write data to an I2C master (advanced, not instrumented).
+uint32_t I2CMasterWriteAdvRaw(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
 {
     uint32_t ui32I2CMasterInt, ui32I2CMasterErr;
     uint32_t ui32Timeout = psI2C->ui32Timeout + 10;     // Guarantee some minimum timeout value.
@@ -119,6 +123,20 @@ uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data,
 
 
 
+// Write data to an I2C master (advanced).
+// Record the duration and the errors of the transfer.
+uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
+{
+    uint32_t ui32Cycles = PERF_CYCLES_GET();
+    uint32_t ui32Ret = I2CMasterWriteAdvRaw(psI2C, ui8SlaveAddr, pui8Data, ui8Length, bRepeatedStart, bStop);
+
+    PerfStatAdd(&psI2C->sPerfStat, PERF_CYCLES_GET() - ui32Cycles, ui32Ret != 0);
+
+    return ui32Ret;
+}
+
+
+
 // Read data from an I2C master.
 uint32_t I2CMasterRead(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length)
 {
@@ -127,8 +145,8 @@ uint32_t I2CMasterRead(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uin
 
 
 
-// Read data from an I2C master (advanced).
-uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
+// Read data from an I2C master (advanced, not instrumented).
+uint32_t I2CMasterReadAdvRaw(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
 {
     uint32_t ui32I2CMasterInt, ui32I2CMasterErr;
     uint32_t ui32Timeout = psI2C->ui32Timeout + 10;     // Guarantee some minimum timeout value.
@@ -194,6 +212,20 @@ uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data,
 
 
 
+// Read data from an I2C master (advanced).
+// Record the duration and the errors of the transfer.
+uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
+{
+    uint32_t ui32Cycles = PERF_CYCLES_GET();
+    uint32_t ui32Ret = I2CMasterReadAdvRaw(psI2C, ui8SlaveAddr, pui8Data, ui8Length, bRepeatedStart, bStop);
+
+    PerfStatAdd(&psI2C->sPerfStat, PERF_CYCLES_GET() - ui32Cycles, ui32Ret != 0);
+
+    return ui32Ret;
+}
+
+
+
 // Send a quick command.
 uint32_t I2CMasterQuickCmd(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive)
 {
@@ -202,8 +234,8 @@ uint32_t I2CMasterQuickCmd(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive)
 
 
 
-// Send a quick command (advanced).
-uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive, bool bRepeatedStart)
+// Send a quick command (advanced, not instrumented).
+uint32_t I2CMasterQuickCmdAdvRaw(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive, bool bRepeatedStart)
 {
     uint32_t ui32I2CMasterInt, ui32I2CMasterErr;
     uint32_t ui32Timeout = psI2C->ui32Timeout + 10;     // Guarantee some minimum timeout value.
@@ -253,3 +285,17 @@ uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive,
     return ui32I2CMasterInt;
 }
 
+
+
+// Send a quick command (advanced).
+// Record the duration and the errors of the transfer.
+uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive, bool bRepeatedStart)
+{
+    uint32_t ui32Cycles = PERF_CYCLES_GET();
+    uint32_t ui32Ret = I2CMasterQuickCmdAdvRaw(psI2C, ui8SlaveAddr, bReceive, bRepeatedStart);
+
+    PerfStatAdd(&psI2C->sPerfStat, PERF_CYCLES_GET() - ui32Cycles, ui32Ret != 0);
+
+    return ui32Ret;
+}
+
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 11 Feb 2020
-// Rev.: 14 Apr 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the I2C functions on the ATLAS MDT Trigger Processor (TP)
 // Command Module (CM) MCU.
@@ -15,6 +15,10 @@
 
 
 
+#include "perf.h"
+
+
+
 // Types.
 typedef struct {
     uint32_t ui32PeripheralI2C;
@@ -29,6 +33,7 @@ typedef struct {
     bool     bFast;                 // false = 100 kbps; true = 400 kbps
     uint32_t ui32IntFlags;
     uint32_t ui32Timeout;
+    tPerfStat sPerfStat;            // Duration and errors of the transfers.
 } tI2C;
 
 
@@ -0,0 +1,75 @@
+// File: perf.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Performance counters based on the DWT cycle counter of the ATLAS MDT Trigger
+// Processor (TP) Command Module (CM) MCU.
+//
+// CAUTION: The cycle counter wraps around after 2^32 cycles, i.e. about 35 s
+//          at 120 MHz. Longer durations must be saturated by the caller.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_types.h"
+#include "utils/uartstdio.h"
+#include "perf.h"
+
+
+
+// Enable the DWT cycle counter.
+void PerfInit(void)
+{
+    HWREG(PERF_DEMCR) |= PERF_DEMCR_TRCENA;
+    HWREG(PERF_DWT_CYCCNT) = 0;
+    HWREG(PERF_DWT_CTRL) |= PERF_DWT_CTRL_CYCCNTENA;
+}
+
+
+
+// Add a duration in cycles to the statistics.
+void PerfStatAdd(tPerfStat *psPerfStat, uint32_t ui32Cycles, bool bError)
+{
+    if (!psPerfStat->ui32Count || (ui32Cycles < psPerfStat->ui32CyclesMin))
+        psPerfStat->ui32CyclesMin = ui32Cycles;
+    if (ui32Cycles > psPerfStat->ui32CyclesMax)
+        psPerfStat->ui32CyclesMax = ui32Cycles;
+    psPerfStat->ui32Count++;
+    psPerfStat->ui64CyclesSum += ui32Cycles;
+    if (bError) psPerfStat->ui32Errors++;
+    // Log2 histogram. The CLZ instruction makes this cheap.
+    psPerfStat->pui32Hist[ui32Cycles ? 31 - __builtin_clz(ui32Cycles) : 0]++;
+}
+
+
+
+// Clear the statistics.
+void PerfStatClear(tPerfStat *psPerfStat)
+{
+    memset(psPerfStat, 0, sizeof(tPerfStat));
+}
+
+
+
+// Print the statistics in one line. The times are shown in us, the histogram
+// bins as "log2(cycles):count" for all non-empty bins.
+void PerfStatPrint(char *pcName, tPerfStat *psPerfStat, uint32_t ui32SysClock)
+{
+    uint32_t ui32CyclesPerUs = ui32SysClock / 1000000;
+    uint32_t ui32CyclesMean = 0;
+
+    if (psPerfStat->ui32Count)
+        ui32CyclesMean = psPerfStat->ui64CyclesSum / psPerfStat->ui32Count;
+    UARTprintf("\n%12s: n = %u, err = %u, min/mean/max = %u/%u/%u us, hist:", pcName,
+               psPerfStat->ui32Count, psPerfStat->ui32Errors,
+               psPerfStat->ui32CyclesMin / ui32CyclesPerUs, ui32CyclesMean / ui32CyclesPerUs,
+               psPerfStat->ui32CyclesMax / ui32CyclesPerUs);
+    for (int i = 0; i < PERF_HIST_BIN_NUM; i++) {
+        if (psPerfStat->pui32Hist[i]) UARTprintf(" %d:%u", i, psPerfStat->pui32Hist[i]);
+    }
+}
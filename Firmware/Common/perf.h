@@ -0,0 +1,54 @@
+// File: perf.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file for the performance counters based on the DWT cycle counter of
+// the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __PERF_H__
+#define __PERF_H__
+
+
+
+// Cortex-M4 debug and trace registers.
+#define PERF_DEMCR                      0xE000EDFC  // Debug Exception and Monitor Control
+#define PERF_DEMCR_TRCENA               0x01000000  // Enable DWT and ITM
+#define PERF_DWT_CTRL                   0xE0001000  // DWT Control
+#define PERF_DWT_CTRL_CYCCNTENA         0x00000001  // Enable the cycle counter
+#define PERF_DWT_CYCCNT                 0xE0001004  // DWT Cycle Count
+
+// Read the current value of the cycle counter.
+#define PERF_CYCLES_GET()               HWREG(PERF_DWT_CYCCNT)
+
+// Number of bins of the log2 latency histogram. Bin n counts the durations
+// from 2^n to 2^(n+1)-1 cycles, bin 0 also counts durations of 0 cycles.
+#define PERF_HIST_BIN_NUM               32
+
+
+
+// Types.
+typedef struct {
+    uint32_t ui32Count;
+    uint32_t ui32Errors;
+    uint32_t ui32CyclesMin;
+    uint32_t ui32CyclesMax;
+    uint64_t ui64CyclesSum;
+    uint32_t pui32Hist[PERF_HIST_BIN_NUM];
+} tPerfStat;
+
+
+
+// Function prototypes.
+void PerfInit(void);
+void PerfStatAdd(tPerfStat *psPerfStat, uint32_t ui32Cycles, bool bError);
+void PerfStatClear(tPerfStat *psPerfStat);
+void PerfStatPrint(char *pcName, tPerfStat *psPerfStat, uint32_t ui32SysClock);
+
+
+
+#endif  // __PERF_H__
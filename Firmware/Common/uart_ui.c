@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 07 Feb 2020
-// Rev.: 17 Apr 2020
+// Rev.: 18 Oct 2026
 //
 // UART user interface (UI) for the ATLAS MDT Trigger Processor (TP) Command
 // Module (CM) MCU.
@@ -14,11 +14,21 @@
 #include <stdint.h>
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "uart_ui.h"
 
 
 
+// Receive ring buffer of the active UART user interface. It is written by the
+// interrupt handler and read by the main loop.
+static tUartUi *g_psUartUiRx;
+static uint8_t g_pui8UartUiRx[UART_UI_RX_BUFFER_SIZE];
+static volatile uint32_t g_ui32UartUiRxHead;
+static volatile uint32_t g_ui32UartUiRxTail;
+
+
+
 // Initialize the UART user interface and its pins.
 void UartUiInit(tUartUi *psUartUi)
 {
@@ -37,5 +47,117 @@ void UartUiInit(tUartUi *psUartUi)
 
     // Initialize the UART for console I/O.
     UARTStdioConfig(psUartUi->ui32Port, psUartUi->ui32Baud, psUartUi->ui32SrcClock);
+
+    // Receive the characters in the interrupt handler.
+    g_psUartUiRx = psUartUi;
+    g_ui32UartUiRxHead = g_ui32UartUiRxTail = 0;
+    UARTIntClear(psUartUi->ui32Base, UART_INT_RX | UART_INT_RT);
+    UARTIntRegister(psUartUi->ui32Base, UartUiIntHandler);
+    UARTIntEnable(psUartUi->ui32Base, UART_INT_RX | UART_INT_RT);
+}
+
+
+
+// UART interrupt handler of the user interface. The received characters are
+// put into the ring buffer. Characters which do not fit are dropped.
+void UartUiIntHandler(void)
+{
+    uint32_t ui32Base = g_psUartUiRx->ui32Base;
+    uint32_t ui32Next;
+    int32_t i32Char;
+
+    UARTIntClear(ui32Base, UARTIntStatus(ui32Base, true));
+    while (UARTCharsAvail(ui32Base)) {
+        i32Char = UARTCharGetNonBlocking(ui32Base);
+        ui32Next = (g_ui32UartUiRxHead + 1) % UART_UI_RX_BUFFER_SIZE;
+        if (ui32Next == g_ui32UartUiRxTail) continue;
+        g_pui8UartUiRx[g_ui32UartUiRxHead] = i32Char & 0xff;
+        g_ui32UartUiRxHead = ui32Next;
+    }
 }
 
+
+
+// Check if received characters are waiting in the ring buffer.
+bool UartUiCharsAvail(tUartUi *psUartUi)
+{
+    return g_ui32UartUiRxHead != g_ui32UartUiRxTail;
+}
+
+
+
+// Discard all received characters.
+void UartUiFlushRx(tUartUi *psUartUi)
+{
+    g_ui32UartUiRxTail = g_ui32UartUiRxHead;
+}
+
+
+
+
+// Get a string from the UART user interface without blocking. All characters
+// available in the receive ring buffer are processed like UARTgets does. The
+// number of characters received so far is kept in *pui32Count, which must be 0
+// at the start of a new string. Returns -1 as long as the string is not
+// terminated by CR, LF or ESC. Otherwise the length of the string is returned
+// and *pui32Count is reset to 0.
+int UartUiGetsNonBlocking(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint32_t *pui32Count)
+{
+    static bool bLastWasCR = false;
+    uint32_t ui32Count = *pui32Count;
+    char cChar;
+
+    // Leave space for the trailing null terminator.
+    ui32Len--;
+
+    while (UartUiCharsAvail(psUartUi)) {
+        cChar = g_pui8UartUiRx[g_ui32UartUiRxTail];
+        g_ui32UartUiRxTail = (g_ui32UartUiRxTail + 1) % UART_UI_RX_BUFFER_SIZE;
+        // Backspace: Delete the last character.
+        if (cChar == '\b') {
+            if (ui32Count) {
+                UARTwrite("\b \b", 3);
+                ui32Count--;
+            }
+            continue;
+        }
+        // LF following a CR: EOL processing was already done with the CR.
+        if ((cChar == '\n') && bLastWasCR) {
+            bLastWasCR = false;
+            continue;
+        }
+        bLastWasCR = false;
+        // End of the string.
+        if ((cChar == '\r') || (cChar == '\n') || (cChar == 0x1b)) {
+            if (cChar == '\r') bLastWasCR = true;
+            pcBuf[ui32Count] = 0;
+            *pui32Count = 0;
+            UARTwrite("\r\n", 2);
+            return ui32Count;
+        }
+        // Store and echo the character. Ignore additional characters at the
+        // end of the buffer.
+        if (ui32Count < ui32Len) {
+            pcBuf[ui32Count++] = cChar;
+            UARTCharPut(psUartUi->ui32Base, cChar);
+        }
+    }
+
+    *pui32Count = ui32Count;
+    return -1;
+}
+
+
+
+// Get a string from the UART user interface. Blocks until the string is
+// terminated by CR, LF or ESC like UARTgets does. Returns the length of the
+// string.
+int UartUiGets(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len)
+{
+    uint32_t ui32Count = 0;
+    int iRet;
+
+    while ((iRet = UartUiGetsNonBlocking(psUartUi, pcBuf, ui32Len, &ui32Count)) < 0);
+
+    return iRet;
+}
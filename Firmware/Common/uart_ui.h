@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 07 Feb 2020
-// Rev.: 10 Apr 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the UART user interface (UI) for the ATLAS MDT Trigger
 // Processor (TP) Command Module (CM) MCU.
@@ -15,6 +15,12 @@
 
 
 
+// Size of the receive ring buffer in bytes. The characters are received in the
+// interrupt handler, so they are not lost while the main loop is busy.
+#define UART_UI_RX_BUFFER_SIZE      256
+
+
+
 // Types.
 typedef struct {
     uint32_t ui32PeripheralUart;
@@ -34,6 +40,11 @@ typedef struct {
 
 // Function prototypes.
 void UartUiInit(tUartUi *psUartUi);
+void UartUiIntHandler(void);
+bool UartUiCharsAvail(tUartUi *psUartUi);
+void UartUiFlushRx(tUartUi *psUartUi);
+int UartUiGetsNonBlocking(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint32_t *pui32Count);
+int UartUiGets(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len);
 
 
 
@@ -0,0 +1,121 @@
+// File: bl_boot.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Fast boot path and boot information of the boot loader running on the ATLAS
+// MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// Before a reset, the firmware can request the fast path in the boot
+// information (fw_boot.h). Then the boot loader only sets up the system clock
+// and the power control pins and starts the slot which passed the full check
+// at the last boot, without checking it again and without waiting for the
+// boot loader menu. After the firmware downloaded a new image into the other
+// slot, it requests to start it, which skips only the boot loader menu, while
+// the slots are checked as usual. In any case, the boot loader hands over the
+// system clock setting and the time spent in the boot loader to the firmware.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_types.h"
+#include "fw_boot.h"
+#include "perf.h"
+#include "bl_boot.h"
+
+
+
+// The fast path was requested.
+static bool g_bBootFast;
+// The firmware downloaded a new image and requested to start it.
+static bool g_bBootUpdate;
+
+
+
+// Start measuring the boot time and take the request of the firmware. Called
+// first thing after reset.
+void BL_BootStart(void)
+{
+    volatile tFwBootInfo *psInfo = FW_BOOT_INFO;
+
+    // The cycle counter counts with the internal oscillator until the system
+    // clock is set up.
+    HWREG(PERF_DEMCR) |= PERF_DEMCR_TRCENA;
+    HWREG(PERF_DWT_CYCCNT) = 0;
+    HWREG(PERF_DWT_CTRL) |= PERF_DWT_CTRL_CYCCNTENA;
+
+    // The SRAM content is random after power up.
+    if (psInfo->ui32Magic != FW_BOOT_MAGIC) {
+        psInfo->ui32Request = FW_BOOT_REQ_NONE;
+        psInfo->ui32SlotStart = 0;
+        psInfo->ui32SlotCrc = 0;
+        psInfo->ui32Magic = FW_BOOT_MAGIC;
+    }
+
+    // The request applies to this reset only.
+    g_bBootFast = psInfo->ui32Request == FW_BOOT_REQ_FAST;
+    g_bBootUpdate = psInfo->ui32Request == FW_BOOT_REQ_UPDATE;
+    psInfo->ui32Request = FW_BOOT_REQ_NONE;
+    psInfo->ui32Flags = 0;
+}
+
+
+
+// Check if the fast path was requested.
+bool BL_BootFast(void)
+{
+    return g_bBootFast;
+}
+
+
+
+// Check if the firmware requested to start a new image without the boot loader
+// menu.
+bool BL_BootUpdate(void)
+{
+    return g_bBootUpdate;
+}
+
+
+
+// Fall back to the normal boot, e.g. if the slot changed since the last boot.
+void BL_BootFastCancel(void)
+{
+    g_bBootFast = false;
+}
+
+
+
+// Record the system clock setting for the firmware.
+void BL_BootClockSet(uint32_t ui32SysClock)
+{
+    volatile tFwBootInfo *psInfo = FW_BOOT_INFO;
+
+    psInfo->ui32ClockCycles = PERF_CYCLES_GET();
+    psInfo->ui32SysClock = ui32SysClock;
+    psInfo->ui32Flags |= FW_BOOT_FLAG_CLOCK;
+}
+
+
+
+// Record the slot and the boot time right before starting the firmware. A
+// slot start address of 0 means that the firmware may not be started with the
+// fast path at the next reset.
+void BL_BootFirmwareStart(uint32_t ui32SlotStart, uint32_t ui32SlotCrc)
+{
+    volatile tFwBootInfo *psInfo = FW_BOOT_INFO;
+    uint32_t ui32Cycles = PERF_CYCLES_GET();
+
+    psInfo->ui32SlotStart = ui32SlotStart;
+    psInfo->ui32SlotCrc = ui32SlotCrc;
+    psInfo->ui32StartCycles = ui32Cycles;
+    if (psInfo->ui32Flags & FW_BOOT_FLAG_CLOCK) {
+        psInfo->ui32BootUs = psInfo->ui32ClockCycles / (FW_BOOT_PIOSC_FREQ / 1000000) +
+                             (ui32Cycles - psInfo->ui32ClockCycles) / (psInfo->ui32SysClock / 1000000);
+        psInfo->ui32Flags |= FW_BOOT_FLAG_TIME;
+    }
+    if (g_bBootFast) psInfo->ui32Flags |= FW_BOOT_FLAG_FAST;
+}
@@ -0,0 +1,31 @@
+// File: bl_boot.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the fast boot path and the boot information of the boot
+// loader running on the ATLAS MDT Trigger Processor (TP) Command Module (CM)
+// MCU.
+//
+
+
+
+#ifndef __BL_BOOT_H__
+#define __BL_BOOT_H__
+
+
+
+// ******************************************************************
+// Function prototypes.
+// ******************************************************************
+void BL_BootStart(void);
+bool BL_BootFast(void);
+bool BL_BootUpdate(void);
+void BL_BootFastCancel(void);
+void BL_BootClockSet(uint32_t ui32SysClock);
+void BL_BootFirmwareStart(uint32_t ui32SlotStart, uint32_t ui32SlotCrc);
+
+
+
+#endif  // __BL_BOOT_H__
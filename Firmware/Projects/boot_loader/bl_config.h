@@ -129,6 +129,8 @@
 //
 //*****************************************************************************
 //#define FLASH_RSVD_SPACE        0x00000800
+// Persistent log of the hardware test firmware (FLASH_ADDR_PLOG).
+#define FLASH_RSVD_SPACE        0x00010000
 
 //*****************************************************************************
 //
@@ -139,7 +141,8 @@
 // Requires: None
 //
 //*****************************************************************************
-#define STACK_SIZE              48
+// Increased from 48 words for the user menu hooks in bl_user.c.
+#define STACK_SIZE              128
 
 //*****************************************************************************
 //
@@ -1533,6 +1536,22 @@
 //#define BL_CHECK_UPDATE_FN_HOOK MyCheckUpdateFunc
 #define BL_CHECK_UPDATE_FN_HOOK BL_UserCheckUpdateHook
 
+//*****************************************************************************
+//
+// Allows an application to handle additional boot loader commands.  If hooked,
+// this function will be called for every received command that is not known to
+// the boot loader.  The function must acknowledge the packet and return the
+// new command status, which is reported to the host on COMMAND_GET_STATUS.
+//
+// unsigned long MyCommandFunc(unsigned char *pucData, unsigned long ulSize);
+//
+// Note: This hook is only available with the modified bl_main.c in this
+// project.
+//
+//*****************************************************************************
+//#define BL_COMMAND_FN_HOOK      MyCommandFunc
+#define BL_COMMAND_FN_HOOK      BL_UserCommand
+
 //*****************************************************************************
 //
 // Allows an application to replace the flash block erase function.  If hooked,
@@ -1558,6 +1577,7 @@
 //
 //*****************************************************************************
 //#define BL_FLASH_PROGRAM_FN_HOOK MyFlashProgramFunc
+#define BL_FLASH_PROGRAM_FN_HOOK BL_UserFlashProgram
 
 //*****************************************************************************
 //
@@ -1624,5 +1644,6 @@
 //
 //*****************************************************************************
 //#define BL_FLASH_AD_CHECK_FN_HOOK MyFlashAddrCheckFunc
+#define BL_FLASH_AD_CHECK_FN_HOOK BL_UserFlashAddrCheck
 
 #endif // __BL_CONFIG_H__
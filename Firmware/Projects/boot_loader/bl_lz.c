@@ -0,0 +1,206 @@
+// File: bl_lz.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Streaming decompressor for compressed firmware images of the boot loader
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The compressed data arrives in packets of arbitrary size, so the decoder is
+// a state machine that processes one byte at a time. The decoded data is
+// programmed into the flash in blocks of the flash write buffer size.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bl_lz.h"
+#include "bl_userhooks.h"
+
+
+
+// States of the decoder.
+enum {
+    LZ_STATE_TOKEN,
+    LZ_STATE_LITERAL_LEN,
+    LZ_STATE_LITERAL,
+    LZ_STATE_OFFSET_LO,
+    LZ_STATE_OFFSET_HI,
+    LZ_STATE_MATCH_LEN,
+    LZ_STATE_DONE,
+    LZ_STATE_ERROR,
+};
+
+// Buffer for the decoded data and the flash address of its first byte.
+static uint8_t g_pui8LzBuf[BL_LZ_BUF_SIZE];
+static uint32_t g_ui32LzBufAddr;
+static uint32_t g_ui32LzBufFill;
+
+// Start address of the image and number of bytes still to be decoded.
+static uint32_t g_ui32LzStart;
+static uint32_t g_ui32LzRemaining;
+
+// Decoder state.
+static uint8_t g_ui8LzState;
+static uint8_t g_ui8LzToken;
+static uint32_t g_ui32LzCount;
+static uint32_t g_ui32LzOffset;
+static bool g_bLzFlashFail;
+
+
+
+// Start decoding an image of the given uncompressed length into the flash
+// starting at the given address. The flash must be erased already.
+void BL_LzStart(uint32_t ui32Address, uint32_t ui32Length)
+{
+    g_ui32LzStart = ui32Address;
+    g_ui32LzRemaining = ui32Length;
+    g_ui32LzBufAddr = ui32Address;
+    g_ui32LzBufFill = 0;
+    g_ui8LzState = ui32Length ? LZ_STATE_TOKEN : LZ_STATE_DONE;
+    g_bLzFlashFail = false;
+}
+
+
+
+// Program the buffered data into the flash. The last word is padded with the
+// erased value of the flash.
+static void BL_LzFlush(void)
+{
+    uint32_t ui32Length;
+
+    ui32Length = (g_ui32LzBufFill + 3) & ~3;
+    for (uint32_t i = g_ui32LzBufFill; i < ui32Length; i++) {
+        g_pui8LzBuf[i] = 0xff;
+    }
+    if (BL_UserFlashProgram(g_ui32LzBufAddr, g_pui8LzBuf, ui32Length)) {
+        g_bLzFlashFail = true;
+    }
+    g_ui32LzBufAddr += g_ui32LzBufFill;
+    g_ui32LzBufFill = 0;
+}
+
+
+
+// Append a decoded byte.
+static void BL_LzPut(uint8_t ui8Data)
+{
+    g_pui8LzBuf[g_ui32LzBufFill++] = ui8Data;
+    g_ui32LzRemaining--;
+    if ((g_ui32LzBufFill == BL_LZ_BUF_SIZE) || (g_ui32LzRemaining == 0)) {
+        BL_LzFlush();
+    }
+}
+
+
+
+// Copy a match. The source bytes are either still in the buffer or have
+// already been programmed into the flash.
+static int BL_LzCopy(uint32_t ui32Length)
+{
+    uint32_t ui32Src;
+
+    if (ui32Length > g_ui32LzRemaining) return -1;
+    ui32Src = g_ui32LzBufAddr + g_ui32LzBufFill - g_ui32LzOffset;
+    while (ui32Length--) {
+        if (ui32Src >= g_ui32LzBufAddr) {
+            BL_LzPut(g_pui8LzBuf[ui32Src - g_ui32LzBufAddr]);
+        } else {
+            BL_LzPut(*(volatile uint8_t *) ui32Src);
+        }
+        ui32Src++;
+    }
+
+    return 0;
+}
+
+
+
+// After the literals of a sequence either the stream ends or a match follows.
+static uint8_t BL_LzAfterLiterals(void)
+{
+    return g_ui32LzRemaining ? LZ_STATE_OFFSET_LO : LZ_STATE_DONE;
+}
+
+
+
+// Decode a packet of compressed data into the flash. Returns 0 on success, -1
+// if the compressed data is corrupt and -2 if programming the flash failed.
+int BL_LzDecode(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint8_t ui8Data;
+
+    while (ui32Size--) {
+        ui8Data = *pui8Data++;
+        switch (g_ui8LzState) {
+            case LZ_STATE_TOKEN:
+                g_ui8LzToken = ui8Data;
+                g_ui32LzCount = ui8Data >> 4;
+                if (g_ui32LzCount == 15) g_ui8LzState = LZ_STATE_LITERAL_LEN;
+                else if (g_ui32LzCount) g_ui8LzState = LZ_STATE_LITERAL;
+                else g_ui8LzState = BL_LzAfterLiterals();
+                break;
+            case LZ_STATE_LITERAL_LEN:
+                g_ui32LzCount += ui8Data;
+                if (ui8Data != 255) g_ui8LzState = LZ_STATE_LITERAL;
+                break;
+            case LZ_STATE_LITERAL:
+                if (g_ui32LzCount > g_ui32LzRemaining) {
+                    g_ui8LzState = LZ_STATE_ERROR;
+                    break;
+                }
+                BL_LzPut(ui8Data);
+                if (--g_ui32LzCount == 0) g_ui8LzState = BL_LzAfterLiterals();
+                break;
+            case LZ_STATE_OFFSET_LO:
+                g_ui32LzOffset = ui8Data;
+                g_ui8LzState = LZ_STATE_OFFSET_HI;
+                break;
+            case LZ_STATE_OFFSET_HI:
+                g_ui32LzOffset |= ui8Data << 8;
+                // The match must start inside the image.
+                if ((g_ui32LzOffset == 0) ||
+                    (g_ui32LzOffset > g_ui32LzBufAddr + g_ui32LzBufFill - g_ui32LzStart)) {
+                    g_ui8LzState = LZ_STATE_ERROR;
+                    break;
+                }
+                g_ui32LzCount = g_ui8LzToken & 0x0f;
+                if (g_ui32LzCount == 15) {
+                    g_ui8LzState = LZ_STATE_MATCH_LEN;
+                } else {
+                    g_ui8LzState = BL_LzCopy(g_ui32LzCount + BL_LZ_MATCH_MIN) ?
+                                   LZ_STATE_ERROR : LZ_STATE_TOKEN;
+                }
+                break;
+            case LZ_STATE_MATCH_LEN:
+                g_ui32LzCount += ui8Data;
+                if (ui8Data != 255) {
+                    g_ui8LzState = BL_LzCopy(g_ui32LzCount + BL_LZ_MATCH_MIN) ?
+                                   LZ_STATE_ERROR : LZ_STATE_TOKEN;
+                }
+                break;
+            default:
+                // Data after the end of the stream.
+                g_ui8LzState = LZ_STATE_ERROR;
+                break;
+        }
+        if (g_bLzFlashFail) return -2;
+        if (g_ui8LzState == LZ_STATE_ERROR) return -1;
+        // A match may complete the image.
+        if ((g_ui8LzState == LZ_STATE_TOKEN) && (g_ui32LzRemaining == 0)) {
+            g_ui8LzState = LZ_STATE_DONE;
+        }
+    }
+
+    return 0;
+}
+
+
+
+// Number of bytes still to be decoded.
+uint32_t BL_LzRemaining(void)
+{
+    return g_ui32LzRemaining;
+}
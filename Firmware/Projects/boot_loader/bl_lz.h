@@ -0,0 +1,49 @@
+// File: bl_lz.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the streaming decompressor for compressed firmware images of
+// the boot loader running on the ATLAS MDT Trigger Processor (TP) Command
+// Module (CM) MCU.
+//
+
+
+
+#ifndef __BL_LZ_H__
+#define __BL_LZ_H__
+
+
+
+// ******************************************************************
+// Compression types.
+// ******************************************************************
+
+#define BL_LZ_TYPE_NONE             0
+// LZ77 byte stream similar to the LZ4 block format. Each sequence starts with
+// a token byte. The upper nibble holds the number of literals, the lower
+// nibble the match length minus BL_LZ_MATCH_MIN. A nibble value of 15 is
+// extended by the following bytes, which are added up to and including the
+// first byte below 255. The literals follow, then the 16 bit match offset in
+// little endian order. The stream ends as soon as the uncompressed size is
+// reached, which is either after the literals or after a match.
+#define BL_LZ_TYPE_LZ               1
+#define BL_LZ_MATCH_MIN             4
+// The decoded data is collected in a buffer the size of the flash write buffer
+// (32 words) and then programmed into the flash. Matches are copied from the
+// flash, so the match offset is not limited by the RAM of the boot loader.
+#define BL_LZ_BUF_SIZE              128
+
+
+
+// ******************************************************************
+// Function prototypes.
+// ******************************************************************
+void BL_LzStart(uint32_t ui32Address, uint32_t ui32Length);
+int BL_LzDecode(uint8_t *pui8Data, uint32_t ui32Size);
+uint32_t BL_LzRemaining(void);
+
+
+
+#endif  // __BL_LZ_H__
@@ -0,0 +1,309 @@
+// File: bl_slot.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Application slot selection of the boot loader running on the ATLAS MDT
+// Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The boot loader starts the valid slot with the highest image version. Each
+// boot of a slot which was not confirmed by the firmware yet consumes one boot
+// attempt and arms the watchdog. If the firmware does not confirm the slot
+// within FW_SLOT_BOOT_MAX boots, the slot counts as failed and the boot loader
+// rolls back to the other slot.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+#include "driverlib/crc.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/watchdog.h"
+#include "utils/ustdlib.h"
+#include "fw_boot.h"
+#include "fw_slot.h"
+#include "perf.h"
+#include "bl_config.h"
+#include "boot_loader/bl_crc32.h"
+#include "bl_boot.h"
+#include "bl_slot.h"
+#include "bl_user.h"
+#include "bl_userhooks.h"
+
+
+
+// Configurations of the CRC module for the CRC32 of bl_crc32.c: polynomial
+// 0x04c11db7, reflected input and output, initial value and final XOR
+// 0xffffffff. The words are processed most significant bit first, so the
+// bytes must be reversed to process the first byte first. It is not
+// documented whether the bit reversal applies to each byte or to the whole
+// word, so both variants are tried against the software CRC.
+static const uint32_t g_pui32SlotCrcConfig[] = {
+    CRC_CFG_INIT_1 | CRC_CFG_SIZE_32BIT | CRC_CFG_TYPE_P4C11DB7 | CRC_CFG_IBR |
+    CRC_CFG_OBR | CRC_CFG_RESINV | CRC_CFG_ENDIAN_SBHW | CRC_CFG_ENDIAN_SHW,
+    CRC_CFG_INIT_1 | CRC_CFG_SIZE_32BIT | CRC_CFG_TYPE_P4C11DB7 | CRC_CFG_IBR |
+    CRC_CFG_OBR | CRC_CFG_RESINV,
+};
+
+// Configuration of the CRC module matching the software CRC. 0 if none
+// matches, then the software CRC is used.
+static uint32_t g_ui32SlotCrcConfig;
+
+// State of the slots and time in us to check them.
+static uint8_t g_pui8SlotState[FW_SLOT_NUM];
+static uint32_t g_ui32SlotScanUs;
+
+
+
+// Select the configuration of the CRC module.
+static void BL_SlotCrcInit(void)
+{
+    // CRC32 of "12345678".
+    static const uint32_t pui32Test[2] = {0x34333231, 0x38373635};
+    uint32_t ui32Crc;
+
+    InitCRC32Table();
+    ui32Crc = CalculateCRC32((uint8_t *) pui32Test, sizeof(pui32Test), 0xffffffff) ^ 0xffffffff;
+
+    MAP_SysCtlPeripheralEnable(SYSCTL_PERIPH_CCM0);
+    while (!MAP_SysCtlPeripheralReady(SYSCTL_PERIPH_CCM0));
+    g_ui32SlotCrcConfig = 0;
+    for (int i = 0; i < sizeof(g_pui32SlotCrcConfig) / sizeof(g_pui32SlotCrcConfig[0]); i++) {
+        MAP_CRCConfigSet(CCM0_BASE, g_pui32SlotCrcConfig[i]);
+        if (MAP_CRCDataProcess(CCM0_BASE, (uint32_t *) pui32Test, 2, true) == ui32Crc) {
+            g_ui32SlotCrcConfig = g_pui32SlotCrcConfig[i];
+            break;
+        }
+    }
+}
+
+
+
+// CRC32 of a word aligned flash area. The length must be a multiple of 4.
+static uint32_t BL_SlotCrc(uint32_t ui32Addr, uint32_t ui32Length)
+{
+    if (!g_ui32SlotCrcConfig) {
+        return CalculateCRC32((uint8_t *) ui32Addr, ui32Length, 0xffffffff) ^ 0xffffffff;
+    }
+    // Writing the configuration initializes the CRC.
+    MAP_CRCConfigSet(CCM0_BASE, g_ui32SlotCrcConfig);
+    return MAP_CRCDataProcess(CCM0_BASE, (uint32_t *) ui32Addr, ui32Length / 4, true);
+}
+
+
+
+// Number of boot attempts of a slot.
+static uint32_t BL_SlotBootCount(const tFwSlotHeader *psHeader)
+{
+    uint32_t ui32Count = 0;
+
+    while ((ui32Count < FW_SLOT_BOOT_MAX) && (psHeader->pui32Boot[ui32Count] != FW_SLOT_ERASED)) {
+        ui32Count++;
+    }
+
+    return ui32Count;
+}
+
+
+
+// Check if a vector table holds an initial stack pointer in the SRAM and a
+// reset vector in the given flash area.
+static bool BL_SlotVtableValid(const uint32_t *pui32Vtable, uint32_t ui32Start, uint32_t ui32Length)
+{
+    if ((pui32Vtable[0] <= 0x20000000) || (pui32Vtable[0] > 0x20040000)) return false;
+    if (((pui32Vtable[1] & ~1) < ui32Start) || ((pui32Vtable[1] & ~1) >= ui32Start + ui32Length)) return false;
+
+    return true;
+}
+
+
+
+// Determine the state of a slot.
+static uint8_t BL_SlotCheck(int iSlot)
+{
+    const tFwSlotHeader *psHeader = FW_SLOT_HEADER(iSlot);
+    uint32_t ui32Image = FW_SLOT_START(iSlot) + FW_SLOT_HEADER_SIZE;
+
+    if (psHeader->ui32Magic != FW_SLOT_MAGIC) return BL_SLOT_EMPTY;
+    if ((psHeader->ui32Length < 8) || (psHeader->ui32Length > FW_SLOT_SIZE - FW_SLOT_HEADER_SIZE) ||
+        (psHeader->ui32Length & 3)) {
+        return BL_SLOT_CORRUPT;
+    }
+    if (!BL_SlotVtableValid((const uint32_t *) ui32Image, ui32Image, psHeader->ui32Length)) {
+        return BL_SLOT_CORRUPT;
+    }
+    if (BL_SlotCrc(ui32Image, psHeader->ui32Length) != psHeader->ui32Crc) return BL_SLOT_CORRUPT;
+    if (psHeader->ui32Confirmed == FW_SLOT_CONFIRMED) return BL_SLOT_CONFIRMED;
+    if (BL_SlotBootCount(psHeader) >= FW_SLOT_BOOT_MAX) return BL_SLOT_FAILED;
+
+    return BL_SLOT_TRIAL;
+}
+
+
+
+// Check all slots.
+void BL_SlotScan(void)
+{
+    uint32_t ui32Cycles;
+
+    // Measure the time of the check with the cycle counter.
+    HWREG(PERF_DEMCR) |= PERF_DEMCR_TRCENA;
+    HWREG(PERF_DWT_CTRL) |= PERF_DWT_CTRL_CYCCNTENA;
+    ui32Cycles = PERF_CYCLES_GET();
+
+    BL_SlotCrcInit();
+    for (int i = 0; i < FW_SLOT_NUM; i++) {
+        g_pui8SlotState[i] = BL_SlotCheck(i);
+    }
+
+    g_ui32SlotScanUs = (PERF_CYCLES_GET() - ui32Cycles) / (g_ui32SysClock / 1000000);
+}
+
+
+
+// Show the state of the slots.
+void BL_SlotInfo(uint32_t ui32UartBase)
+{
+    static const char *ppcState[] = {"empty", "corrupt", "failed", "not confirmed", "confirmed"};
+    const tFwSlotHeader *psHeader;
+    char pcStr[64];
+
+    UARTprint(ui32UartBase, "\r\n");
+    for (int i = 0; i < FW_SLOT_NUM; i++) {
+        psHeader = FW_SLOT_HEADER(i);
+        usprintf(pcStr, "Slot %c at 0x%08x: %s", FW_SLOT_NAME(i), FW_SLOT_START(i), ppcState[g_pui8SlotState[i]]);
+        UARTprint(ui32UartBase, pcStr);
+        if (g_pui8SlotState[i] >= BL_SLOT_FAILED) {
+            usprintf(pcStr, ", version %u, %u bytes, %u of %u boots",
+                     psHeader->ui32Version, psHeader->ui32Length,
+                     BL_SlotBootCount(psHeader), FW_SLOT_BOOT_MAX);
+            UARTprint(ui32UartBase, pcStr);
+        }
+        UARTprint(ui32UartBase, ".\r\n");
+    }
+    usprintf(pcStr, "Slots checked in %u us using the %s CRC.\r\n", g_ui32SlotScanUs,
+             g_ui32SlotCrcConfig ? "hardware" : "software");
+    UARTprint(ui32UartBase, pcStr);
+}
+
+
+
+// Select the valid slot with the highest version. With equal versions, a
+// confirmed slot is preferred. Returns the slot number or -1 if no slot is
+// valid.
+int BL_SlotSelect(void)
+{
+    int iSlot = -1;
+
+    for (int i = 0; i < FW_SLOT_NUM; i++) {
+        if (g_pui8SlotState[i] < BL_SLOT_TRIAL) continue;
+        if ((iSlot < 0) ||
+            (FW_SLOT_HEADER(i)->ui32Version > FW_SLOT_HEADER(iSlot)->ui32Version) ||
+            ((FW_SLOT_HEADER(i)->ui32Version == FW_SLOT_HEADER(iSlot)->ui32Version) &&
+             (g_pui8SlotState[i] > g_pui8SlotState[iSlot]))) {
+            iSlot = i;
+        }
+    }
+
+    return iSlot;
+}
+
+
+
+// Start the firmware in the selected slot. Returns -1 if no slot is valid.
+int BL_SlotBoot(void)
+{
+    static uint8_t pui8Zero[4] = {0, 0, 0, 0};
+    const tFwSlotHeader *psHeader;
+    uint32_t ui32Vtable;
+    int iSlot;
+
+    iSlot = BL_SlotSelect();
+    if (iSlot < 0) return -1;
+    psHeader = FW_SLOT_HEADER(iSlot);
+    ui32Vtable = FW_SLOT_START(iSlot) + FW_SLOT_HEADER_SIZE;
+
+    if (g_pui8SlotState[iSlot] == BL_SLOT_TRIAL) {
+        // Count the boot attempt.
+        if (BL_UserFlashProgram((uint32_t) &psHeader->pui32Boot[BL_SlotBootCount(psHeader)], pui8Zero, 4)) {
+            return -1;
+        }
+        // Reset the MCU if the firmware hangs before it confirms the slot.
+        // The watchdog stops while the debugger halts the CPU.
+        MAP_SysCtlPeripheralEnable(SYSCTL_PERIPH_WDOG0);
+        while (!MAP_SysCtlPeripheralReady(SYSCTL_PERIPH_WDOG0));
+        MAP_WatchdogReloadSet(WATCHDOG0_BASE, FW_SLOT_WATCHDOG_LOAD);
+        MAP_WatchdogStallEnable(WATCHDOG0_BASE);
+        MAP_WatchdogResetEnable(WATCHDOG0_BASE);
+        MAP_WatchdogEnable(WATCHDOG0_BASE);
+    }
+
+    // Only a confirmed slot may be started with the fast path at the next
+    // reset.
+    if (g_pui8SlotState[iSlot] == BL_SLOT_CONFIRMED) {
+        BL_BootFirmwareStart(FW_SLOT_START(iSlot), psHeader->ui32Crc);
+    } else {
+        BL_BootFirmwareStart(0, 0);
+    }
+
+    // Like CallApplication in the startup code, but with the vector table of
+    // the selected slot.
+    HWREG(NVIC_VTABLE) = ui32Vtable;
+    __asm volatile ("ldr r1, [%0]\n"
+                    "msr msp, r1\n"
+                    "ldr r1, [%0, #4]\n"
+                    "bx r1\n"
+                    : : "r" (ui32Vtable) : "r1", "memory");
+
+    return -1;
+}
+
+
+
+// Start the slot which passed the full check at the last boot without checking
+// it again. The header must still hold the CRC of that check, so the image has
+// not been replaced since. Returns -1 if the slot cannot be started this way.
+int BL_SlotBootFast(void)
+{
+    const volatile tFwBootInfo *psInfo = FW_BOOT_INFO;
+    const tFwSlotHeader *psHeader;
+    uint32_t ui32Image;
+
+    for (int i = 0; i < FW_SLOT_NUM; i++) {
+        if (FW_SLOT_START(i) != psInfo->ui32SlotStart) continue;
+        psHeader = FW_SLOT_HEADER(i);
+        ui32Image = FW_SLOT_START(i) + FW_SLOT_HEADER_SIZE;
+        if ((psHeader->ui32Magic != FW_SLOT_MAGIC) || (psHeader->ui32Crc != psInfo->ui32SlotCrc) ||
+            (psHeader->ui32Confirmed != FW_SLOT_CONFIRMED) ||
+            !BL_SlotVtableValid((const uint32_t *) ui32Image, ui32Image, psHeader->ui32Length)) {
+            return -1;
+        }
+        // The state of the other slot is unknown, so it is not started.
+        for (int j = 0; j < FW_SLOT_NUM; j++) {
+            g_pui8SlotState[j] = BL_SLOT_EMPTY;
+        }
+        g_pui8SlotState[i] = BL_SLOT_CONFIRMED;
+        return BL_SlotBoot();
+    }
+
+    return -1;
+}
+
+
+
+// Check for firmware without image header at APP_START_ADDRESS, which is
+// started directly by the startup code.
+bool BL_SlotLegacyValid(void)
+{
+    if (*(const uint32_t *) APP_START_ADDRESS == FW_SLOT_MAGIC) return false;
+
+    return BL_SlotVtableValid((const uint32_t *) VTABLE_START_ADDRESS, APP_START_ADDRESS,
+                              FW_SLOT_B_START + FW_SLOT_SIZE - APP_START_ADDRESS);
+}
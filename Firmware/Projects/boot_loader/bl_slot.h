@@ -0,0 +1,42 @@
+// File: bl_slot.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the application slot selection of the boot loader running on
+// the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __BL_SLOT_H__
+#define __BL_SLOT_H__
+
+
+
+// ******************************************************************
+// Slot states.
+// ******************************************************************
+
+#define BL_SLOT_EMPTY               0   // No image header.
+#define BL_SLOT_CORRUPT             1   // Invalid header or CRC error.
+#define BL_SLOT_FAILED              2   // Not confirmed after FW_SLOT_BOOT_MAX boots.
+#define BL_SLOT_TRIAL               3   // Not confirmed yet, boot attempts left.
+#define BL_SLOT_CONFIRMED           4   // Confirmed by the firmware.
+
+
+
+// ******************************************************************
+// Function prototypes.
+// ******************************************************************
+void BL_SlotScan(void);
+void BL_SlotInfo(uint32_t ui32UartBase);
+int BL_SlotSelect(void);
+int BL_SlotBoot(void);
+int BL_SlotBootFast(void);
+bool BL_SlotLegacyValid(void);
+
+
+
+#endif  // __BL_SLOT_H__
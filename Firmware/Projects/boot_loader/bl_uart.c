@@ -0,0 +1,214 @@
+//*****************************************************************************
+//
+// bl_uart.c - Functions to transfer data via the UART port.
+//
+// Copyright (c) 2006-2020 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+// 
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+// 
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+// 
+// This is part of revision 2.2.0.295 of the Tiva Firmware Development Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+// Changes by M. Fras on 18 Oct 2026 to receive the UART data through a ring
+// buffer, which UARTPoll() fills while the boot loader is busy otherwise, e.g.
+// while programming the flash.
+//*****************************************************************************
+
+#include <stdint.h>
+#include "inc/hw_gpio.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "bl_config.h"
+#include "boot_loader/bl_uart.h"
+
+//*****************************************************************************
+//
+//! \addtogroup bl_uart_api
+//! @{
+//
+//*****************************************************************************
+#if defined(UART_ENABLE_UPDATE) || defined(DOXYGEN)
+
+//*****************************************************************************
+//
+// The size of the UART receive ring buffer in bytes.  It must hold all packets
+// that the host sends without waiting for an acknowledge.
+//
+//*****************************************************************************
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     4096
+#endif
+
+//*****************************************************************************
+//
+// The UART receive ring buffer and its read and write indices.
+//
+//*****************************************************************************
+static uint8_t g_pui8UARTRxBuffer[UART_RX_BUFFER_SIZE];
+static uint32_t g_ui32UARTRxWrite;
+static uint32_t g_ui32UARTRxRead;
+
+//*****************************************************************************
+//
+//! Moves received data from the UART FIFO into the receive ring buffer.
+//!
+//! This function must be called often enough to prevent an overrun of the
+//! UART receive FIFO, i.e. at least every 16 characters.  If the ring buffer
+//! is full, the data is left in the FIFO.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTPoll(void)
+{
+    uint32_t ui32Next;
+
+    while(!(HWREG(UARTx_BASE + UART_O_FR) & UART_FR_RXFE))
+    {
+        ui32Next = (g_ui32UARTRxWrite + 1) % UART_RX_BUFFER_SIZE;
+        if(ui32Next == g_ui32UARTRxRead)
+        {
+            break;
+        }
+        g_pui8UARTRxBuffer[g_ui32UARTRxWrite] = HWREG(UARTx_BASE + UART_O_DR);
+        g_ui32UARTRxWrite = ui32Next;
+    }
+}
+
+//*****************************************************************************
+//
+//! Sends data over the UART port.
+//!
+//! \param pui8Data is the buffer containing the data to write out to the UART
+//! port.
+//! \param ui32Size is the number of bytes provided in \e pui8Data buffer that
+//! will be written out to the UART port.
+//!
+//! This function sends \e ui32Size bytes of data from the buffer pointed to by
+//! \e pui8Data via the UART port.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTSend(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    //
+    // Transmit the number of bytes requested on the UART port.
+    //
+    while(ui32Size--)
+    {
+        //
+        // Make sure that the transmit FIFO is not full.
+        //
+        while((HWREG(UARTx_BASE + UART_O_FR) & UART_FR_TXFF))
+        {
+            UARTPoll();
+        }
+
+        //
+        // Send out the next byte.
+        //
+        HWREG(UARTx_BASE + UART_O_DR) = *pui8Data++;
+    }
+
+    //
+    // Wait until the UART is done transmitting.
+    //
+    UARTFlush();
+}
+
+//*****************************************************************************
+//
+//! Waits until all data has been transmitted by the UART port.
+//!
+//! This function waits until all data written to the UART port has been
+//! transmitted.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTFlush(void)
+{
+    //
+    // Wait for the UART FIFO to empty and then wait for the shifter to get the
+    // bytes out the port.
+    //
+    while(!(HWREG(UARTx_BASE + UART_O_FR) & UART_FR_TXFE))
+    {
+        UARTPoll();
+    }
+
+    //
+    // Wait for the FIFO to not be busy so that the shifter completes.
+    //
+    while((HWREG(UARTx_BASE + UART_O_FR) & UART_FR_BUSY))
+    {
+        UARTPoll();
+    }
+}
+
+//*****************************************************************************
+//
+//! Receives data over the UART port.
+//!
+//! \param pui8Data is the buffer to read data into from the UART port.
+//! \param ui32Size is the number of bytes provided in the \e pui8Data buffer
+//! that should be written with data from the UART port.
+//!
+//! This function reads back \e ui32Size bytes of data from the UART port, into
+//! the buffer that is pointed to by \e pui8Data.  This function will not
+//! return until \e ui32Size number of bytes have been received.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTReceive(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    //
+    // Send out the number of bytes requested.
+    //
+    while(ui32Size--)
+    {
+        //
+        // Wait for data in the ring buffer.
+        //
+        while(g_ui32UARTRxRead == g_ui32UARTRxWrite)
+        {
+            UARTPoll();
+        }
+
+        //
+        // Receive a byte from the ring buffer.
+        //
+        *pui8Data++ = g_pui8UARTRxBuffer[g_ui32UARTRxRead];
+        g_ui32UARTRxRead = (g_ui32UARTRxRead + 1) % UART_RX_BUFFER_SIZE;
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+#endif
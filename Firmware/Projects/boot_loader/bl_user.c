@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 26 Aug 2020
-// Rev.: 28 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // User functions of the boot loader running on the ATLAS MDT Trigger Processor
 // (TP) Command Module (CM) MCU.
@@ -21,6 +21,8 @@
 #include "hw/gpio/gpio.h"
 #include "hw/gpio/gpio_pins.h"
 #include "bl_config.h"
+#include "bl_boot.h"
+#include "bl_slot.h"
 #include "bl_user.h"
 #include "bl_user_io.h"
 
@@ -81,23 +83,40 @@ void UARTprintBlInfo(uint32_t ui32UartBase)
 
 
 
+// Set up the system clock. The firmware takes over the setting.
+void UserClockInit(void)
+{
+    g_ui32SysClock = MAP_SysCtlClockFreqSet(SYSTEM_CLOCK_SETTINGS, SYSTEM_CLOCK_FREQ);
+    BL_BootClockSet(g_ui32SysClock);
+}
+
+
+
+// Initialize the power control and reserved GPIO pins on the CM to switch off
+// all switchabel power domains.
+void UserPowerInit(void)
+{
+    GpioInit_PowerCtrl();
+    GpioSet_PowerCtrl(0);
+    GpioInit_Reserved();
+    GpioSet_Reserved(0);
+}
+
+
+
 // Initialize the hardware peripherals.
 int UserHwInit(void)
 {
     // Set up the system clock.
-    g_ui32SysClock = MAP_SysCtlClockFreqSet(SYSTEM_CLOCK_SETTINGS, SYSTEM_CLOCK_FREQ);
+    UserClockInit();
 
     // Initialize the LEDs.
     GpioInit_LedMcuUser();
     // Switch on LED red 1 to indicate activity.
     GpioSet_LedMcuUser(g_ui8Led = LED_USER_RED_1);
 
-    // Initialize the power control and reserved GPIO pins on the CM to switch
-    // off all switchabel power domains.
-    GpioInit_PowerCtrl();
-    GpioSet_PowerCtrl(0);
-    GpioInit_Reserved();
-    GpioSet_Reserved(0);
+    // Switch off all switchable power domains.
+    UserPowerInit();
 
     // Initialize the UART 5, which is connected to the SM SoC.
     #ifdef MDTTP_CM_MCU_BL_UART_FRONTPANEL
@@ -149,6 +168,11 @@ int BL_UserMenu(uint32_t ui32UartBase)
                 // Wait some time for the UART to send out the message.
                 DelayUs(1e4);
                 return 1;
+            case 's':
+            case 'S':
+                BL_SlotScan();
+                BL_SlotInfo(ui32UartBase);
+                break;
             case 'r':
             case 'R':
                 UARTprint(ui32UartBase, "Rebooting the MCU.\r\n");
@@ -176,6 +200,7 @@ int BL_UserMenuHelp(uint32_t ui32UartBase)
     UARTprint(ui32UartBase, "h   Show this help text.\r\n");
     UARTprint(ui32UartBase, "b   Start normal boot process.\r\n");
     UARTprint(ui32UartBase, "f   Force MCU firmware download via the serial boot loader.\r\n");
+    UARTprint(ui32UartBase, "s   Show the application slots.\r\n");
     UARTprint(ui32UartBase, "r   Reboot the MCU.\r\n");
     // Wait some time for the UART to send out the message.
     DelayUs(1e4);
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 26 Aug 2020
-// Rev.: 28 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Header file of the user functions of the boot loader running on the ATLAS
 // MDT Trigger Processor (TP) Command Module (CM) MCU.
@@ -20,8 +20,8 @@
 // ******************************************************************
 
 #define BL_NAME                     "boot loader"
-#define BL_VERSION                  "0.0.3"
-#define BL_RELEASEDATE              "28 Aug 2020"
+#define BL_VERSION                  "0.0.11"
+#define BL_RELEASEDATE              "18 Oct 2026"
 // Timeout in seconds to enter the boot loader at startup.
 #define BL_ACTIVATION_TIMEOUT       5
 // Command prompt of the boot loader.
@@ -56,6 +56,11 @@
 #define LED_USER_RED_0              0x40
 #define LED_USER_RED_1              0x80
 
+// Size of the flash erase blocks. The TM4C129 erases 16 kB blocks, whereas
+// FLASH_PAGE_SIZE in bl_config.h is only the step width of the erase loop of
+// the TivaWare boot loader.
+#define BL_FLASH_ERASE_SIZE         0x4000
+
 
 
 // ******************************************************************
@@ -72,6 +77,8 @@ extern uint8_t g_ui8Led;
 void DelayUs(uint32_t ui32DelayUs);
 void UARTprint(uint32_t ui32UartBase, const char* pcStr);
 void UARTprintBlInfo(uint32_t ui32UartBase);
+void UserClockInit(void);
+void UserPowerInit(void);
 int UserHwInit(void);
 int BL_UserMenu(uint32_t ui32UartBase);
 int BL_UserMenuHelp(uint32_t ui32UartBase);
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 26 Aug 2020
-// Rev.: 28 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // User hook functions of the boot loader running on the ATLAS MDT Trigger
 // Processor (TP) Command Module (CM) MCU.
@@ -12,6 +12,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "inc/hw_flash.h"
 #include "inc/hw_memmap.h"
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
@@ -24,7 +25,18 @@
 #include "utils/ustdlib.h"
 #include "hw/gpio/gpio.h"
 #include "hw/gpio/gpio_pins.h"
+#include "fw_boot.h"
+#include "fw_slot.h"
+#include "fw_update.h"
 #include "bl_config.h"
+#include "boot_loader/bl_commands.h"
+#include "boot_loader/bl_crc32.h"
+#include "boot_loader/bl_flash.h"
+#include "boot_loader/bl_packet.h"
+#include "boot_loader/bl_uart.h"
+#include "bl_boot.h"
+#include "bl_lz.h"
+#include "bl_slot.h"
 #include "bl_user.h"
 #include "bl_userhooks.h"
 
@@ -34,12 +46,44 @@
 // delay.
 extern void Delay(uint32_t ui32Count);
 
+// Sends a no-acknowledge packet. Defined in the boot loader packet handler.
+extern void NakPacket(void);
+
+// Moves received UART data into the receive ring buffer. Defined in bl_uart.c.
+extern void UARTPoll(void);
+
+// Status and transfer state of the boot loader. Defined in bl_main.c.
+extern uint8_t g_ui8Status;
+extern uint32_t g_ui32TransferAddress;
+extern uint32_t g_ui32TransferSize;
+
+// State of the pipelined (windowed) data transfer.
+static uint8_t g_ui8WinSeq;
+static bool g_bWinGap;
+
+// State of the compressed data transfer.
+static uint8_t g_ui8CompType;
+static uint32_t g_ui32CompStart;
+static uint32_t g_ui32CompLength;
+static uint32_t g_ui32CompCrc;
+
 
 
 // Performs application-specific low level hardware initialization on system
 // reset.
 void BL_UserHwInit(void)
 {
+    // Start measuring the boot time and check if the firmware requested the
+    // fast path.
+    BL_BootStart();
+
+    // Fast path: The firmware initializes all other peripherals anyway.
+    if (BL_BootFast()) {
+        UserClockInit();
+        UserPowerInit();
+        return;
+    }
+
     // Initialize the hardware peripherals.
     UserHwInit();
 }
@@ -63,6 +107,12 @@ void BL_Reinit(void)
 // Informs an application that a download is starting.
 void BL_FwDownloadStart(void)
 {
+    // A new download starts with sequence number 0 in the windowed mode.
+    g_ui8WinSeq = 0;
+    g_bWinGap = false;
+    // The data is uncompressed unless declared otherwise.
+    g_ui8CompType = BL_LZ_TYPE_NONE;
+
     // Switch on LED red 0 and red 1 to indicate activity.
     GpioSet_LedMcuUser(g_ui8Led = LED_USER_RED_0 | LED_USER_RED_1);
 }
@@ -94,12 +144,66 @@ void BL_FwDownloadEnd(void)
 
 
 
-// Enable a new firmware download at system start up.
+// Enter the firmware update mode of the boot loader.
+static void BL_UserEnterUpdate(void)
+{
+    // A return value of 1 of the check update hook freezes the boot loader.
+    // The reason is unknown.
+    // Work-around: Use code copied from the EK-TM4C1294XL boot_demo1 example.
+
+    // We must make sure we turn off SysTick and its interrupt before entering 
+    // the boot loader!
+    MAP_SysTickIntDisable(); 
+    MAP_SysTickDisable(); 
+
+    // Disable all processor interrupts.  Instead of disabling them
+    // one at a time, a direct write to NVIC is done to disable all
+    // peripheral interrupts.
+    HWREG(NVIC_DIS0) = 0xffffffff;
+    HWREG(NVIC_DIS1) = 0xffffffff;
+    HWREG(NVIC_DIS2) = 0xffffffff;
+    HWREG(NVIC_DIS3) = 0xffffffff;
+
+    // Return control to the boot loader.  This is a call to the SVC
+    // handler in the boot loader.
+    (*((void (*)(void))(*(uint32_t *)0x2c)))();
+}
+
+
+
+// Enable a new firmware download at system start up. Otherwise start the
+// firmware in the newest valid application slot.
 unsigned long BL_UserCheckUpdateHook(void)
 {
+    int iSlot;
+    char pcStr[40];
+
+    // Fast path: Start the slot started last time right away. This only
+    // returns if the slot changed since.
+    if (BL_BootFast()) {
+        BL_SlotBootFast();
+        BL_BootFastCancel();
+        UserHwInit();
+    }
+
     // Show boot loader info.
     UARTprintBlInfo(UARTx_BASE);
 
+    // Check the application slots and show which one will be started.
+    BL_SlotScan();
+    BL_SlotInfo(UARTx_BASE);
+    iSlot = BL_SlotSelect();
+    if (iSlot >= 0) {
+        usprintf(pcStr, "Starting slot %c.\r\n", FW_SLOT_NAME(iSlot));
+        UARTprint(UARTx_BASE, pcStr);
+    }
+
+    // The firmware downloaded a new image into the other slot. Start the
+    // selected slot right away, so that the firmware is down only briefly.
+    if (BL_BootUpdate() && (iSlot >= 0)) {
+        BL_SlotBoot();
+    }
+
     // Clear all pending characters from the UART to avoid false activation of
     // the boot loader menu.
     while (UARTCharsAvail(UARTx_BASE)) {
@@ -123,33 +227,452 @@ unsigned long BL_UserCheckUpdateHook(void)
     }
     // Enter the boot loader menu.
     if (UARTCharsAvail(UARTx_BASE)) {
-        // A return value of 1 freezes the boot loader. The reason is unknown.
-        //return BL_UserMenu(UARTx_BASE);
-
-        // Work-around: Use code copied from the EK-TM4C1294XL boot_demo1 example.
         if (BL_UserMenu(UARTx_BASE)) {
-            // We must make sure we turn off SysTick and its interrupt before entering 
-            // the boot loader!
-            MAP_SysTickIntDisable(); 
-            MAP_SysTickDisable(); 
-
-            // Disable all processor interrupts.  Instead of disabling them
-            // one at a time, a direct write to NVIC is done to disable all
-            // peripheral interrupts.
-            HWREG(NVIC_DIS0) = 0xffffffff;
-            HWREG(NVIC_DIS1) = 0xffffffff;
-            HWREG(NVIC_DIS2) = 0xffffffff;
-            HWREG(NVIC_DIS3) = 0xffffffff;
-
-            // Return control to the boot loader.  This is a call to the SVC
-            // handler in the boot loader.
-            (*((void (*)(void))(*(uint32_t *)0x2c)))();
+            BL_UserEnterUpdate();
         }
     }
 
     // Turn off all LEDs.
     GpioSet_LedMcuUser(g_ui8Led = 0x00);
 
+    // Start the firmware in the selected slot. This only returns if no slot
+    // is valid.
+    BL_SlotBoot();
+    // Firmware without image header is started by the startup code.
+    if (BL_SlotLegacyValid()) {
+        BL_BootFirmwareStart(0, 0);
+        return 0;
+    }
+
+    UARTprint(UARTx_BASE, "\r\nNo valid firmware found. Waiting for firmware data...\r\n");
+    BL_UserEnterUpdate();
+
     return 0;
 }
 
+
+
+// Check the start address and size of a download. In addition to the
+// addresses accepted by the TivaWare boot loader, the start of application
+// slot B is accepted.
+uint32_t BL_UserFlashAddrCheck(uint32_t ui32Addr, uint32_t ui32Size)
+{
+    if ((ui32Addr == FW_SLOT_B_START) && (ui32Size <= FW_SLOT_SIZE)) return 1;
+
+    return BLInternalFlashStartAddrCheck(ui32Addr, ui32Size);
+}
+
+
+
+// Receive a character from the boot loader UART with a timeout in us. Returns
+// the received character or -1 on timeout or on a receive error.
+static int32_t BL_UserUartGetCharTimeout(uint32_t ui32TimeoutUs)
+{
+    for (uint32_t i = 0; i < ui32TimeoutUs; i += 10) {
+        if (UARTCharsAvail(UARTx_BASE)) {
+            int32_t i32Char = UARTCharGetNonBlocking(UARTx_BASE);
+            // Framing, parity, break or overrun error.
+            if (i32Char & ~0xff) return -1;
+            return i32Char;
+        }
+        DelayUs(10);
+    }
+    return -1;
+}
+
+
+
+// Set the baud rate of the boot loader UART.
+static void BL_UserUartSetBaud(uint32_t ui32Baud)
+{
+    // Wait until all pending data has been sent.
+    while (UARTBusy(UARTx_BASE));
+    UARTConfigSetExpClk(UARTx_BASE, g_ui32SysClock, ui32Baud,
+                        UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE);
+}
+
+
+
+// Wait for a ping packet (size, checksum, command) from the host. Leading
+// zeros are idle bytes and are skipped. Returns true if the ping was received.
+static bool BL_UserBaudPing(void)
+{
+    int32_t i32Char;
+    int i;
+
+    i32Char = BL_UserUartGetCharTimeout(BL_BAUD_CONFIRM_TIMEOUT * 1000);
+    while (i32Char == 0) {
+        i32Char = BL_UserUartGetCharTimeout(BL_BAUD_CONFIRM_TIMEOUT * 1000);
+    }
+    for (i = 0; (i32Char == 3) && (i < 2); i++) {
+        if (BL_UserUartGetCharTimeout(1000) != COMMAND_PING) break;
+    }
+
+    return (i32Char == 3) && (i == 2);
+}
+
+
+
+// Switch the boot loader UART to the baud rate requested by the host. The
+// packet is acknowledged with the old baud rate. Then the host has to confirm
+// the new baud rate with a ping packet within BL_BAUD_CONFIRM_TIMEOUT ms, and
+// with a second one after it received the acknowledge of the first one.
+// Otherwise the old baud rate is restored. This round trip, not the divisor
+// of the baud rate, protects against a baud rate mismatch: The fractional
+// divisor of the UART has an error of up to 0.03% at 120 MHz, but the UART of
+// the host may add an error of its own.
+static uint32_t BL_UserSetBaud(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Baud, ui32BaudOld, ui32Config;
+
+    if (ui32Size != 5) {
+        AckPacket();
+        return COMMAND_RET_INVALID_CMD;
+    }
+    ui32Baud = (pui8Data[1] << 24) | (pui8Data[2] << 16) | (pui8Data[3] << 8) | pui8Data[4];
+    // The UART needs at least 16 clock cycles per bit.
+    if ((ui32Baud < BL_BAUD_MIN) || (ui32Baud > BL_BAUD_MAX) || (ui32Baud > g_ui32SysClock / 16)) {
+        NakPacket();
+        return COMMAND_RET_INVALID_CMD;
+    }
+    UARTConfigGetExpClk(UARTx_BASE, g_ui32SysClock, &ui32BaudOld, &ui32Config);
+
+    // Acknowledge with the old baud rate and switch to the new one.
+    AckPacket();
+    BL_UserUartSetBaud(ui32Baud);
+
+    // The first ping shows that the host sends correctly with the new baud
+    // rate, the second one that it also received the acknowledge of the first
+    // one correctly.
+    if (BL_UserBaudPing()) {
+        AckPacket();
+        if (BL_UserBaudPing()) {
+            AckPacket();
+            return COMMAND_RET_SUCCESS;
+        }
+    }
+
+    // No valid confirmation received. Restore the old baud rate and drop any
+    // garbage that was received in the meantime.
+    BL_UserUartSetBaud(ui32BaudOld);
+    while (UARTCharsAvail(UARTx_BASE)) {
+        UARTCharGetNonBlocking(UARTx_BASE);
+    }
+
+    return COMMAND_RET_INVALID_CMD;
+}
+
+
+
+// Send the cumulative acknowledge of the windowed transfer mode. It is not
+// acknowledged by the host, so the boot loader does not wait for the host.
+static void BL_UserWindowAck(uint8_t ui8Status)
+{
+    uint8_t pui8Ack[4];
+
+    pui8Ack[0] = sizeof(pui8Ack);
+    pui8Ack[1] = ui8Status + g_ui8WinSeq;
+    pui8Ack[2] = ui8Status;
+    pui8Ack[3] = g_ui8WinSeq;
+    UARTSend(pui8Ack, sizeof(pui8Ack));
+}
+
+
+
+// Declare the data of the current download as compressed. The packet holds the
+// compression type and the CRC32 of the uncompressed image.
+static uint32_t BL_UserDownloadComp(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    AckPacket();
+    if ((ui32Size != 6) || (pui8Data[1] != BL_LZ_TYPE_LZ)) {
+        return COMMAND_RET_INVALID_CMD;
+    }
+    // A download must be in progress. Updating the boot loader itself is not
+    // supported, as it is not erased before the first data packet arrives.
+    if ((g_ui32TransferSize == 0) || (g_ui32TransferAddress == 0)) {
+        return COMMAND_RET_INVALID_CMD;
+    }
+
+    g_ui8CompType = pui8Data[1];
+    g_ui32CompStart = g_ui32TransferAddress;
+    g_ui32CompLength = g_ui32TransferSize;
+    g_ui32CompCrc = (pui8Data[2] << 24) | (pui8Data[3] << 16) | (pui8Data[4] << 8) | pui8Data[5];
+    BL_LzStart(g_ui32CompStart, g_ui32CompLength);
+    InitCRC32Table();
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Decompress the data of a packet into the flash. When the image is complete,
+// check the CRC32 of the uncompressed image.
+static uint32_t BL_UserDecompress(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Crc;
+    int iRet;
+
+    iRet = BL_LzDecode(pui8Data, ui32Size);
+    g_ui32TransferSize = BL_LzRemaining();
+    g_ui32TransferAddress = g_ui32CompStart + g_ui32CompLength - g_ui32TransferSize;
+    if (iRet == -2) return COMMAND_RET_FLASH_FAIL;
+    if (iRet) return COMMAND_RET_INVALID_CMD;
+
+    if (g_ui32TransferSize == 0) {
+        ui32Crc = CalculateCRC32((uint8_t *) g_ui32CompStart, g_ui32CompLength, 0xffffffff) ^ 0xffffffff;
+        if (ui32Crc != g_ui32CompCrc) return COMMAND_RET_CRC_FAIL;
+    }
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Return the CRC32 of flash erase blocks. The command packet holds the start
+// address and the number of erase blocks. The answer packet holds the status,
+// the erase block size and the CRC32 of each erase block.
+static uint32_t BL_UserGetPageCrc(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    static uint8_t pui8Reply[1 + 4 + 4 * BL_PAGE_CRC_MAX];
+    uint32_t ui32Status = COMMAND_RET_SUCCESS;
+    uint32_t ui32Addr = 0;
+    uint32_t ui32Count = 0;
+    uint32_t ui32Crc;
+
+    AckPacket();
+    if (ui32Size != 6) {
+        ui32Status = COMMAND_RET_INVALID_CMD;
+    } else {
+        ui32Addr = (pui8Data[1] << 24) | (pui8Data[2] << 16) | (pui8Data[3] << 8) | pui8Data[4];
+        ui32Count = pui8Data[5];
+        if ((ui32Count > BL_PAGE_CRC_MAX) || (ui32Addr & (BL_FLASH_ERASE_SIZE - 1)) ||
+            (ui32Addr > BL_FLASH_SIZE_FN_HOOK()) ||
+            (ui32Count * BL_FLASH_ERASE_SIZE > BL_FLASH_SIZE_FN_HOOK() - ui32Addr)) {
+            ui32Status = COMMAND_RET_INVALID_ADR;
+            ui32Count = 0;
+        }
+    }
+
+    pui8Reply[0] = ui32Status;
+    pui8Reply[1] = BL_FLASH_ERASE_SIZE >> 24;
+    pui8Reply[2] = BL_FLASH_ERASE_SIZE >> 16;
+    pui8Reply[3] = BL_FLASH_ERASE_SIZE >> 8;
+    pui8Reply[4] = BL_FLASH_ERASE_SIZE & 0xff;
+    InitCRC32Table();
+    for (uint32_t i = 0; i < ui32Count; i++) {
+        ui32Crc = CalculateCRC32((uint8_t *) (ui32Addr + i * BL_FLASH_ERASE_SIZE), BL_FLASH_ERASE_SIZE, 0xffffffff) ^ 0xffffffff;
+        pui8Reply[5 + 4 * i] = ui32Crc >> 24;
+        pui8Reply[6 + 4 * i] = ui32Crc >> 16;
+        pui8Reply[7 + 4 * i] = ui32Crc >> 8;
+        pui8Reply[8 + 4 * i] = ui32Crc & 0xff;
+    }
+    SendPacket(pui8Reply, 5 + 4 * ui32Count);
+
+    return ui32Status;
+}
+
+
+
+// Start a download at any erase block in the application area. Only the erase
+// blocks holding the data are erased.
+static uint32_t BL_UserDownloadPages(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Addr, ui32Length, ui32End;
+
+    g_ui32TransferSize = 0;
+    if (ui32Size != 9) {
+        AckPacket();
+        return COMMAND_RET_INVALID_CMD;
+    }
+    ui32Addr = (pui8Data[1] << 24) | (pui8Data[2] << 16) | (pui8Data[3] << 8) | pui8Data[4];
+    ui32Length = (pui8Data[5] << 24) | (pui8Data[6] << 16) | (pui8Data[7] << 8) | pui8Data[8];
+    ui32End = BL_FLASH_SIZE_FN_HOOK() - FLASH_RSVD_SPACE;
+    if ((ui32Addr < APP_START_ADDRESS) || (ui32Addr & (BL_FLASH_ERASE_SIZE - 1)) ||
+        (ui32Length == 0) || (ui32Addr > ui32End) || (ui32Length > ui32End - ui32Addr)) {
+        AckPacket();
+        return COMMAND_RET_INVALID_ADR;
+    }
+
+    // Erase the erase blocks before acknowledging the command, like the
+    // TivaWare boot loader does for COMMAND_DOWNLOAD.
+    BL_FLASH_CL_ERR_FN_HOOK();
+    for (uint32_t ui32Page = ui32Addr; ui32Page < ui32Addr + ui32Length; ui32Page += BL_FLASH_ERASE_SIZE) {
+        BL_FLASH_ERASE_FN_HOOK(ui32Page);
+    }
+    if (BL_FLASH_ERROR_FN_HOOK()) {
+        AckPacket();
+        return COMMAND_RET_FLASH_FAIL;
+    }
+
+    g_ui32TransferAddress = ui32Addr;
+    g_ui32TransferSize = ui32Length;
+    AckPacket();
+    BL_FwDownloadStart();
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Skip blank data of the current download. The flash is erased already, so
+// the skipped bytes keep the erased value.
+static uint32_t BL_UserSkipData(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Count;
+
+    AckPacket();
+    if ((ui32Size != 5) || (g_ui8CompType != BL_LZ_TYPE_NONE)) {
+        return COMMAND_RET_INVALID_CMD;
+    }
+    // Updating the boot loader itself is not supported, as it is not erased
+    // before the first data packet arrives.
+    if (g_ui32TransferAddress == 0) {
+        return COMMAND_RET_INVALID_CMD;
+    }
+    ui32Count = (pui8Data[1] << 24) | (pui8Data[2] << 16) | (pui8Data[3] << 8) | pui8Data[4];
+    if ((ui32Count > g_ui32TransferSize) ||
+        ((ui32Count & 3) && (ui32Count != g_ui32TransferSize))) {
+        return COMMAND_RET_INVALID_ADR;
+    }
+
+    g_ui32TransferAddress += ui32Count;
+    g_ui32TransferSize -= ui32Count;
+    if (ui32Count && (g_ui32TransferSize == 0)) {
+        BL_FwDownloadEnd();
+    }
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Program the data of a packet in the windowed transfer mode. While the flash
+// is programmed, the host keeps on sending the next packets, which are
+// buffered by the UART receive ring buffer.
+static uint32_t BL_UserSendDataWindow(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    int8_t i8SeqDiff;
+    uint32_t ui32Status;
+
+    if (ui32Size < 2) {
+        AckPacket();
+        return COMMAND_RET_INVALID_CMD;
+    }
+    i8SeqDiff = (int8_t) (pui8Data[1] - g_ui8WinSeq);
+    // Old duplicates are sent again by the host if an acknowledge got lost.
+    // Acknowledge only the duplicate of the last programmed packet, which is
+    // part of each resent window, so the host gets one acknowledge per resent
+    // window. Otherwise, if the acknowledge of the last window got lost, the
+    // host would keep on resending it until it gives up.
+    if (i8SeqDiff < 0) {
+        if (i8SeqDiff == -1) BL_UserWindowAck(g_ui8Status);
+        return g_ui8Status;
+    }
+    // A packet is missing. Report the gap only once, as the host goes back to
+    // the expected sequence number anyway.
+    if (i8SeqDiff > 0) {
+        if (!g_bWinGap) BL_UserWindowAck(g_ui8Status);
+        g_bWinGap = true;
+        return g_ui8Status;
+    }
+    g_bWinGap = false;
+
+    ui32Size -= 2;
+    ui32Status = COMMAND_RET_SUCCESS;
+    // Updating the boot loader itself is not supported in the windowed mode.
+    if (g_ui32TransferAddress == 0) {
+        ui32Status = COMMAND_RET_INVALID_CMD;
+    } else if (g_ui8CompType != BL_LZ_TYPE_NONE) {
+        ui32Status = BL_UserDecompress(pui8Data + 2, ui32Size);
+    } else if (g_ui32TransferSize < ui32Size) {
+        ui32Status = COMMAND_RET_INVALID_ADR;
+    } else {
+        // Pad the last word with the erased value of the flash. The packet
+        // buffer has room for the padding behind the largest packet.
+        for (uint32_t i = ui32Size; i & 3; i++) {
+            pui8Data[2 + i] = 0xff;
+        }
+        if (BL_UserFlashProgram(g_ui32TransferAddress, pui8Data + 2, (ui32Size + 3) & ~3)) {
+            ui32Status = COMMAND_RET_FLASH_FAIL;
+        } else {
+            g_ui32TransferAddress += ui32Size;
+            g_ui32TransferSize -= ui32Size;
+        }
+    }
+    if (ui32Status == COMMAND_RET_SUCCESS) {
+        g_ui8WinSeq++;
+        BL_FwDownloadProgress();
+    }
+    BL_UserWindowAck(ui32Status);
+
+    if ((ui32Status == COMMAND_RET_SUCCESS) && (g_ui32TransferSize == 0)) {
+        BL_FwDownloadEnd();
+    }
+
+    return ui32Status;
+}
+
+
+
+// Handle the boot loader commands which are not known to the TivaWare boot
+// loader. The packet must be acknowledged here. Returns the command status.
+uint32_t BL_UserCommand(uint8_t *pui8Data, uint32_t ui32Size)
+{
+    switch (pui8Data[0]) {
+        case COMMAND_SET_BAUD:
+            return BL_UserSetBaud(pui8Data, ui32Size);
+        case COMMAND_SEND_DATA_WIN:
+            return BL_UserSendDataWindow(pui8Data, ui32Size);
+        case COMMAND_DOWNLOAD_COMP:
+            return BL_UserDownloadComp(pui8Data, ui32Size);
+        case COMMAND_GET_PAGE_CRC:
+            return BL_UserGetPageCrc(pui8Data, ui32Size);
+        case COMMAND_DOWNLOAD_PAGES:
+            return BL_UserDownloadPages(pui8Data, ui32Size);
+        case COMMAND_SKIP_DATA:
+            return BL_UserSkipData(pui8Data, ui32Size);
+        default:
+            AckPacket();
+            return COMMAND_RET_UNKNOWN_CMD;
+    }
+}
+
+
+
+// Program data into the flash using the 32 word flash write buffer. Unlike
+// FlashProgram() of the driver library, this polls the UART while the flash
+// controller is busy, so no data is lost if the host sends the next packets
+// in the meantime. The source data does not need to be word aligned.
+uint32_t BL_UserFlashProgram(uint32_t ui32DstAddr, uint8_t *pui8SrcData, uint32_t ui32Length)
+{
+    // Clear the flash access and error interrupts.
+    HWREG(FLASH_FCMISC) = FLASH_FCMISC_AMISC | FLASH_FCMISC_VOLTMISC |
+                          FLASH_FCMISC_INVDMISC | FLASH_FCMISC_PROGMISC;
+
+    while (ui32Length) {
+        // Set the address of this block of words.
+        HWREG(FLASH_FMA) = ui32DstAddr & ~0x7f;
+        // Fill the write buffer with the words in this 32 word block.
+        while (((ui32DstAddr & 0x7c) || (HWREG(FLASH_FWBVAL) == 0)) && (ui32Length != 0)) {
+            HWREG(FLASH_FWBN + (ui32DstAddr & 0x7c)) =
+                pui8SrcData[0] | (pui8SrcData[1] << 8) | (pui8SrcData[2] << 16) | (pui8SrcData[3] << 24);
+            pui8SrcData += 4;
+            ui32DstAddr += 4;
+            ui32Length -= 4;
+        }
+        // Program the write buffer into the flash and keep the UART receiver
+        // going until done.
+        HWREG(FLASH_FMC2) = FLASH_FMC2_WRKEY | FLASH_FMC2_WRBUF;
+        while (HWREG(FLASH_FMC2) & FLASH_FMC2_WRBUF) {
+            UARTPoll();
+        }
+    }
+
+    // Access violation or programming error.
+    if (HWREG(FLASH_FCRIS) & (FLASH_FCRIS_ARIS | FLASH_FCRIS_VOLTRIS |
+                              FLASH_FCRIS_INVDRIS | FLASH_FCRIS_PROGRIS)) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 26 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Header file of the user hook functions of the boot loader running on the
 // ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
@@ -24,6 +24,9 @@ void BL_FwDownloadStart(void);
 void BL_FwDownloadProgress(void);
 void BL_FwDownloadEnd(void);
 unsigned long BL_UserCheckUpdateHook(void);
+uint32_t BL_UserFlashAddrCheck(uint32_t ui32Addr, uint32_t ui32Size);
+uint32_t BL_UserCommand(uint8_t *pui8Data, uint32_t ui32Size);
+uint32_t BL_UserFlashProgram(uint32_t ui32DstAddr, uint8_t *pui8SrcData, uint32_t ui32Length);
 
 
 
@@ -0,0 +1,131 @@
+// File: boot.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Boot information handling for the hardware test firmware running on the
+// ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The boot loader hands over the system clock setting and the time spent in
+// the boot loader in the boot information (fw_boot.h). The firmware takes over
+// the system clock instead of locking the PLL again and measures the time from
+// the reset until it is ready. Before a reset, the firmware can request the
+// fast path of the boot loader, which skips the slot check and the menu.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_sysctl.h"
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sysctl.h"
+#include "utils/uartstdio.h"
+#include "fw_boot.h"
+#include "perf.h"
+#include "cm_mcu_hwtest.h"
+#include "boot.h"
+
+
+
+// System clock frequency. Defined in cm_mcu_hwtest.c.
+extern uint32_t g_ui32SysClock;
+
+// Copy of the boot information of this boot.
+static tFwBootInfo g_sBootInfo;
+
+// The system clock setting was taken over from the boot loader.
+static bool g_bBootClockTakenOver;
+
+// Time in us from the start of the firmware until the system clock is set up
+// and until the firmware is ready.
+static uint32_t g_ui32BootClockUs;
+static uint32_t g_ui32BootReadyUs;
+
+
+
+// Set up the system clock. If the boot loader already set it up the same way,
+// take it over. Must be called first thing in main, as it also measures the
+// time spent in the startup code.
+uint32_t BootClockInit(void)
+{
+    volatile tFwBootInfo *psInfo = FW_BOOT_INFO;
+    uint32_t ui32EntryCycles = PERF_CYCLES_GET();
+    uint32_t ui32SysClock;
+
+    // Take the boot information of this boot. The flags are cleared, so that
+    // they are not taken for valid if the firmware is restarted without the
+    // boot loader, e.g. by the debugger.
+    if (psInfo->ui32Magic == FW_BOOT_MAGIC) {
+        g_sBootInfo = *psInfo;
+        psInfo->ui32Flags = 0;
+    } else {
+        g_sBootInfo.ui32Flags = 0;
+    }
+
+    g_bBootClockTakenOver = (g_sBootInfo.ui32Flags & FW_BOOT_FLAG_CLOCK) &&
+                            (g_sBootInfo.ui32SysClock == SYSTEM_CLOCK_FREQ) &&
+                            (HWREG(SYSCTL_RSCLKCFG) & SYSCTL_RSCLKCFG_USEPLL) &&
+                            (HWREG(SYSCTL_PLLSTAT) & SYSCTL_PLLSTAT_LOCK);
+    if (g_bBootClockTakenOver) {
+        ui32SysClock = g_sBootInfo.ui32SysClock;
+    } else {
+        ui32SysClock = MAP_SysCtlClockFreqSet(SYSTEM_CLOCK_SETTINGS, SYSTEM_CLOCK_FREQ);
+    }
+
+    // The cycle counter keeps on running from the boot loader. The time of
+    // locking the PLL is only approximate, as the MCU runs from the internal
+    // oscillator meanwhile.
+    if (g_sBootInfo.ui32Flags & FW_BOOT_FLAG_TIME) {
+        g_ui32BootClockUs = (PERF_CYCLES_GET() - g_sBootInfo.ui32StartCycles) / (ui32SysClock / 1000000);
+    } else {
+        g_ui32BootClockUs = (PERF_CYCLES_GET() - ui32EntryCycles) / (ui32SysClock / 1000000);
+    }
+
+    return ui32SysClock;
+}
+
+
+
+// Record the time when the firmware is ready. The cycle counter was restarted
+// by PerfInit right after the system clock was set up.
+void BootReady(void)
+{
+    g_ui32BootReadyUs = g_ui32BootClockUs + PERF_CYCLES_GET() / (g_ui32SysClock / 1000000);
+}
+
+
+
+// Show the boot times.
+void BootPrint(void)
+{
+    UARTprintf("System clock %s, set up after %u us.\n",
+               g_bBootClockTakenOver ? "taken over from the boot loader" : "set up by the firmware",
+               g_ui32BootClockUs);
+    if (g_sBootInfo.ui32Flags & FW_BOOT_FLAG_TIME) {
+        UARTprintf("Boot loader %u us%s, firmware ready after %u us, total %u us from reset.",
+                   g_sBootInfo.ui32BootUs,
+                   g_sBootInfo.ui32Flags & FW_BOOT_FLAG_FAST ? " (fast path)" : "",
+                   g_ui32BootReadyUs, g_sBootInfo.ui32BootUs + g_ui32BootReadyUs);
+    } else {
+        UARTprintf("Firmware ready after %u us, boot loader time not available.", g_ui32BootReadyUs);
+    }
+}
+
+
+
+// Send a request to the boot loader for the next reset.
+void BootRequest(uint32_t ui32Request)
+{
+    volatile tFwBootInfo *psInfo = FW_BOOT_INFO;
+
+    if (psInfo->ui32Magic != FW_BOOT_MAGIC) {
+        psInfo->ui32SlotStart = 0;
+        psInfo->ui32SlotCrc = 0;
+        psInfo->ui32Magic = FW_BOOT_MAGIC;
+    }
+    psInfo->ui32Request = ui32Request;
+}
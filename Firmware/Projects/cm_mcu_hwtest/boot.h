@@ -0,0 +1,26 @@
+// File: boot.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the boot information handling for the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __BOOT_H__
+#define __BOOT_H__
+
+
+
+// Function prototypes.
+uint32_t BootClockInit(void);
+void BootReady(void);
+void BootPrint(void);
+void BootRequest(uint32_t ui32Request);
+
+
+
+#endif  // __BOOT_H__
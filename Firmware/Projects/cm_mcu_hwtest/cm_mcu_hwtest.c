@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 08 Apr 2020
-// Rev.: 28 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Hardware test firmware running on the ATLAS MDT Trigger Processor (TP)
 // Command Module (CM) MCU.
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include "inc/hw_types.h"
 #include "driverlib/i2c.h"
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
@@ -26,14 +27,31 @@
 #include "hw/gpio/gpio_pins.h"
 #include "hw/i2c/i2c.h"
 #include "hw/uart/uart.h"
+#include "perf.h"
 #include "uart_ui.h"
 #include "power_control.h"
 #include "sm_cm.h"
+#include "telemetry.h"
+#include "history.h"
+#include "profiler.h"
+#include "stream.h"
+#include "events.h"
+#include "fpga.h"
+#include "dlog.h"
+#include "plog.h"
+#include "fault.h"
+#include "mem.h"
+#include "slot.h"
+#include "boot.h"
+#include "timestamp.h"
+#include "update.h"
 #include "cm_mcu_hwtest.h"
 #include "cm_mcu_hwtest_aux.h"
 #include "cm_mcu_hwtest_gpio.h"
 #include "cm_mcu_hwtest_i2c.h"
 #include "cm_mcu_hwtest_io.h"
+#include "cm_mcu_hwtest_perf.h"
+#include "cpu_load.h"
 #include "cm_mcu_hwtest_uart.h"
 
 
@@ -66,11 +84,25 @@ int main(void)
     char pcUartStr[UI_STR_BUF_SIZE];
     char *pcUartCmd;
     char *pcUartParam;
+    uint32_t ui32UartStrCnt = 0;
+    uint32_t ui32PerfStartMs, ui32PerfStartCycles;
+    bool bCmdValid, bBusy;
 
     uint8_t ui8McuUserLeds;
 
-    // Setup the system clock.
-    g_ui32SysClock = MAP_SysCtlClockFreqSet(SYSTEM_CLOCK_SETTINGS, SYSTEM_CLOCK_FREQ);
+    // Setup the system clock or take it over from the boot loader.
+    g_ui32SysClock = BootClockInit();
+
+    // Start the system uptime counter.
+    SysTickInit();
+    // Enable the cycle counter for the performance counters.
+    PerfInit();
+    // The deferred log can be used from now on, also in interrupt handlers.
+    DlogInit();
+    // Find the end of the persistent log and record the boot.
+    PlogInit();
+    // Save the fault dump of the previous run to the persistent log.
+    FaultInit();
 
     // Initialize the ADCs.
     AdcReset(&g_sAdc_KUP_MGTAVCC_ADC_AUX_TEMP);
@@ -96,6 +128,17 @@ int main(void)
     SmCm_PowerHandshakingInit();
     #endif
 
+    // Initialize the telemetry cache. The sensors are polled in the background.
+    TelemetryInit();
+    HistoryInit();
+    ProfInit();
+    StreamInit();
+
+    // Capture the edges of the status inputs and monitor the FPGA
+    // configuration.
+    EventsInit();
+    FpgaInit();
+
     // Turn on an LED to indicate MCU activity.
     ui8McuUserLeds = 0;
     GpioSet_LedMcuUser(ui8McuUserLeds |= LED_USER_GREEN_0);
@@ -109,9 +152,7 @@ int main(void)
     UARTprintf("\nPress any key to use the front panel USB UART.\n");
     // Clear all pending characters to avoid false activation of the front
     // panel USB UART.
-    while (UARTCharsAvail(g_psUartUi->ui32Base)) {
-        UARTCharGetNonBlocking(g_psUartUi->ui32Base);
-    }
+    UartUiFlushRx(g_psUartUi);
     // Wait for key press on the front panel USB UART.
     for (int i = UI_UART_SELECT_TIMEOUT; i >= 0; i--) {
         UARTprintf("%d ", i);
@@ -121,10 +162,10 @@ int main(void)
         DelayUs(5e5);
         GpioSet_LedMcuUser(ui8McuUserLeds |= LED_USER_BLUE_0);
         // Character received on the UART UI.
-        if (UARTCharsAvail(g_psUartUi->ui32Base)) break;
+        if (UartUiCharsAvail(g_psUartUi)) break;
     }
     // No character received. => Switch to the SM SoC UART.
-    if (!UARTCharsAvail(g_psUartUi->ui32Base)) {
+    if (!UartUiCharsAvail(g_psUartUi)) {
         UARTprintf("\nSwitching to the SM SoC UART. This port will be disabled now.\n");
         // Wait some time for UART to send out the last message.
         DelayUs(1e5);
@@ -151,26 +192,74 @@ int main(void)
     g_psUartUi->ui32SrcClock = g_ui32SysClock;
     UartUiInit(g_psUartUi);
 
+    // The receive interrupt of the UART UI wakes up the idle loop.
+    CpuLoadInit(g_psUartUi);
+
     // Send initial information to the UART UI.
     UARTprintf("\n\n*******************************************************************************\n");
     UARTprintf("MDT-TP CM MCU `%s' firmware version %s, release date: %s\n", FW_NAME, FW_VERSION, FW_RELEASEDATE);
     UARTprintf("*******************************************************************************\n\n");
-    UARTprintf("Type `help' to get an overview of available commands.\n");
+    BootReady();
+    BootPrint();
+    UARTprintf("\nType `help' to get an overview of available commands.\n");
+    FaultReport();
+
+    // The firmware is up and running. Confirm the application slot, so that
+    // the boot loader does not roll back to the other slot.
+    if (SlotConfirm()) {
+        UARTprintf("%s: Cannot confirm the application slot!\n", UI_STR_ERROR);
+    }
 
     GpioSet_LedMcuUser(ui8McuUserLeds |= LED_USER_GREEN_1);
 
     while(1)
     {
+        // Firmware update in the background. The UART UI receives the update
+        // data meanwhile, so the tasks which send data to it are paused. The
+        // persistent log is written afterwards, as the CPU stalls while the
+        // flash is busy, so received data could get lost.
+        if (UpdateActive()) {
+            bBusy = UpdatePoll() > 0;
+            bBusy |= TelemetryPoll() > 0;
+            bBusy |= HistoryPoll() > 0;
+            bBusy |= FpgaPoll() > 0;
+            if (!bBusy) CpuLoadIdle();
+            continue;
+        }
         UARTprintf("%s", UI_COMMAND_PROMPT);
-        UARTgets(pcUartStr, UI_STR_BUF_SIZE);
+        // Run the background tasks while waiting for user input. Pause them
+        // while a command is being received to keep the echo responsive. The
+        // user input is processed only after a stream frame was sent
+        // completely, so the echo does not end up inside the frame.
+        while (StreamBusy() || UartUiGetsNonBlocking(g_psUartUi, pcUartStr, UI_STR_BUF_SIZE, &ui32UartStrCnt) < 0) {
+            bBusy = false;
+            if (!ui32UartStrCnt) {
+                bBusy |= TelemetryPoll() > 0;
+                bBusy |= HistoryPoll() > 0;
+                bBusy |= StreamPoll() > 0;
+                bBusy |= FpgaPoll() > 0;
+                if (!StreamBusy()) bBusy |= DlogPoll() > 0;
+                bBusy |= PlogPoll() > 0;
+            }
+            // Sleep until the next interrupt if no work is pending.
+            if (!bBusy) CpuLoadIdle();
+        }
         pcUartCmd = strtok(pcUartStr, UI_STR_DELIMITER);
         pcUartParam = strtok(NULL, UI_STR_DELIMITER);
-        if (pcUartCmd == NULL) {
-            continue;
-        } else if (!strcasecmp(pcUartCmd, "help")) {
+        if (pcUartCmd == NULL) continue;
+        // Record the active command in a fault dump.
+        g_pcFaultCmd = pcUartCmd;
+        // Measure the execution time of the command.
+        bCmdValid = true;
+        ui32PerfStartMs = GetUptimeMs();
+        ui32PerfStartCycles = PERF_CYCLES_GET();
+        if (!strcasecmp(pcUartCmd, "help")) {
             Help();
         } else if (!strcasecmp(pcUartCmd, "info")) {
             Info();
+        // CPU load.
+        } else if (!strcasecmp(pcUartCmd, "load")) {
+            CpuLoadCmd(pcUartCmd, pcUartParam);
         // Delay execution for a given number of microseconds.
         } else if (!strcasecmp(pcUartCmd, "delay")) {
             DelayUsCmd(pcUartCmd, pcUartParam);
@@ -191,6 +280,44 @@ int main(void)
         // Analog temperature functions.
         } else if (!strcasecmp(pcUartCmd, "temp-a")) {
             TemperatureAnalog(pcUartCmd, pcUartParam);
+        // Telemetry cache and history.
+        } else if (!strcasecmp(pcUartCmd, "telemetry")) {
+            TelemetryCmd(pcUartCmd, pcUartParam);
+        } else if (!strcasecmp(pcUartCmd, "history")) {
+            HistoryCmd(pcUartCmd, pcUartParam);
+        } else if (!strcasecmp(pcUartCmd, "stream")) {
+            StreamCmd(pcUartCmd, pcUartParam);
+        // GPIO edge events.
+        } else if (!strcasecmp(pcUartCmd, "events")) {
+            EventsCmd(pcUartCmd, pcUartParam);
+        } else if (!strcasecmp(pcUartCmd, "fpga")) {
+            FpgaCmd(pcUartCmd, pcUartParam);
+        // Deferred binary log.
+        } else if (!strcasecmp(pcUartCmd, "dlog")) {
+            DlogCmd(pcUartCmd, pcUartParam);
+        // Memory usage.
+        } else if (!strcasecmp(pcUartCmd, "mem")) {
+            MemCmd(pcUartCmd, pcUartParam);
+        // Fault dump of the previous run.
+        } else if (!strcasecmp(pcUartCmd, "fault")) {
+            FaultCmd(pcUartCmd, pcUartParam);
+        // Persistent log in the flash.
+        } else if (!strcasecmp(pcUartCmd, "log")) {
+            PlogCmd(pcUartCmd, pcUartParam);
+        // Application slots.
+        } else if (!strcasecmp(pcUartCmd, "slot")) {
+            SlotCmd(pcUartCmd, pcUartParam);
+        // Firmware update in the background.
+        } else if (!strcasecmp(pcUartCmd, "update")) {
+            UpdateCmd(pcUartCmd, pcUartParam);
+        // Time base.
+        } else if (!strcasecmp(pcUartCmd, "time")) {
+            TimeCmd(pcUartCmd, pcUartParam);
+        // Performance counters.
+        } else if (!strcasecmp(pcUartCmd, "perf")) {
+            PerfCmd(pcUartCmd, pcUartParam);
+        } else if (!strcasecmp(pcUartCmd, "prof")) {
+            ProfCmd(pcUartCmd, pcUartParam);
         // UART based functions.
         } else if (!strcasecmp(pcUartCmd, "uart")) {
             UartAccess(pcUartCmd, pcUartParam);
@@ -202,7 +329,12 @@ int main(void)
         // Unknown command.
         } else {
             UARTprintf("ERROR: Unknown command `%s'.", pcUartCmd);
+            bCmdValid = false;
+        }
+        if (bCmdValid) {
+            PerfCmdRecord(pcUartCmd, PERF_CYCLES_GET() - ui32PerfStartCycles, GetUptimeMs() - ui32PerfStartMs);
         }
+        g_pcFaultCmd = NULL;
         UARTprintf("\n");
         // Update the status LEDs.
         if ((!strcasecmp(pcUartCmd, "gpio")) || (!strcasecmp(pcUartCmd, "power"))) {
@@ -220,13 +352,31 @@ void Help(void)
     UARTprintf("  help                                Show this help text.\n");
     UARTprintf("  bootldr                             Enter the boot loader for firmware update.\n");
     UARTprintf("  delay   MICROSECONDS                Delay execution.\n");
+    UARTprintf("  dlog    [status|show|dump|clear]    Deferred binary log.\n");
+    UARTprintf("  dlog    auto on|off                 Send new log entries automatically.\n");
+    UARTprintf("  events  [show|status|clear]         Edges captured on the status inputs.\n");
+    UARTprintf("  fault   [show|dump|clear|test]      Fault dump of the previous run.\n");
+    UARTprintf("  fpga    [kup|zup] [prog|por]        FPGA configuration monitor.\n");
     UARTprintf("  gpio    TYPE [VALUE]                Get/Set the value of a GPIO type.\n");
+    UARTprintf("  gpio    all|set TYPE=VALUE ...      Read all / set several GPIO types at once.\n");
+    UARTprintf("  history [status|clear|read]         Telemetry history.\n");
     UARTprintf("  i2c     PORT SLV-ADR ACC NUM|DATA   I2C access (ACC bits: R/W, Sr, nP, Q).\n");
     UARTprintf("  i2c-det PORT [MODE]                 I2C detect devices (MODE: 0 = auto,\n");
     UARTprintf("                                          1 = quick command, 2 = read).\n");
     UARTprintf("  info                                Show information about this firmware.\n");
-    UARTprintf("  reset                               Reset the MCU.\n");
+    UARTprintf("  load    [show|reset]                Show the CPU load.\n");
+    UARTprintf("  log     [status|read|dump [COUNT]]  Persistent log in the flash.\n");
+    UARTprintf("  log     clear                       Erase the persistent log.\n");
+    UARTprintf("  mem     [show|reset]                Memory usage and stack high-water mark.\n");
+    UARTprintf("  perf    [show] [reset]              Command and I2C performance counters.\n");
+    UARTprintf("  prof    [start [RATE]|stop|dump]    PC-sampling profiler.\n");
+    UARTprintf("  reset   [fast]                      Reset the MCU (fast: skip the boot loader menu).\n");
+    UARTprintf("  slot    [show|confirm]              Application slots (A/B) of the firmware.\n");
+    UARTprintf("  stream  [GROUP|all PERIOD|off]      Push telemetry frames periodically.\n");
+    UARTprintf("  telemetry [text|bin|rate]           Show the telemetry snapshot.\n");
     UARTprintf("  temp-a  [COUNT]                     Read analog temperatures.\n");
+    UARTprintf("  time    [show|get|sync|adjust]      Time base and host time synchronization.\n");
+    UARTprintf("  update  [start]                     Firmware update while the firmware keeps running.\n");
     UARTprintf("  uart    PORT R/W NUM|DATA           UART access (R/W: 0 = write, 1 = read).\n");
     UARTprintf("  uart-s  PORT BAUD [PARITY] [LOOP]   Set up the UART port.\n");
     UARTprintf("  power   DOMAIN [MODE]               Power domain control (0 = down, 1 = up).");
@@ -238,6 +388,7 @@ void Help(void)
 void Info(void)
 {
     UARTprintf("MDT-TP CM MCU `%s' firmware version %s, release date: %s\n", FW_NAME, FW_VERSION, FW_RELEASEDATE);
-    UARTprintf("It was compiled using gcc %s at %s on %s.", __VERSION__, __TIME__, __DATE__);
+    UARTprintf("It was compiled using gcc %s at %s on %s.\n", __VERSION__, __TIME__, __DATE__);
+    BootPrint();
 }
 
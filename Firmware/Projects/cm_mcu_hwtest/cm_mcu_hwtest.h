@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 08 Apr 2020
-// Rev.: 21 Jan 2021
+// Rev.: 18 Oct 2026
 //
 // Header file of the firmware running on the ATLAS MDT Trigger Processor (TP)
 // Command Module (CM) MCU.
@@ -36,6 +36,9 @@
 #define SYSTEM_CLOCK_SETTINGS       (SYSCTL_OSC_INT | SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480)
 #define SYSTEM_CLOCK_FREQ           120000000
 
+// SysTick rate for the system uptime counter.
+#define SYSTICK_RATE_HZ             1000
+
 
 
 // ******************************************************************
@@ -92,6 +95,24 @@
 #define SM_CM_POWER_HANDSHAKING_ENABLE
 #define SM_CM_POWER_HANDSHAKING_SHOW_MESSAGE
 
+// Performance counters of the commands. Commands beyond PERF_CMD_NUM are not
+// recorded. The command names are truncated to PERF_CMD_NAME_LEN - 1.
+#define PERF_CMD_NUM                32
+#define PERF_CMD_NAME_LEN           12
+
+// Layout of the internal EEPROM (6 kB). Addresses and sizes must be multiples
+// of 4.
+#define EEPROM_ADDR_FPGA_STAT       0x0000
+#define EEPROM_SIZE_FPGA_STAT       0x0100
+
+// Layout of the internal flash (1 MB, erase sectors of 16 kB). The persistent
+// log at the top of the flash is excluded from the application in the linker
+// script and reserved in the boot loader (FLASH_RSVD_SPACE), so that it
+// survives firmware updates.
+#define FLASH_SECTOR_SIZE           0x00004000
+#define FLASH_ADDR_PLOG             0x000f0000
+#define FLASH_SIZE_PLOG             0x00010000
+
 
 
 // ******************************************************************
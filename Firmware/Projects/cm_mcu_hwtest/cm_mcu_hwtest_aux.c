@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 27 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Auxiliary functions of the hardware test firmware running on the ATLAS MDT
 // Trigger Processor (TP) Command Module (CM) MCU.
@@ -18,9 +18,11 @@
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
 #include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/rom.h"
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
 #include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "utils/ustdlib.h"
@@ -29,9 +31,11 @@
 #include "hw/gpio/gpio_pins.h"
 #include "hw/i2c/i2c.h"
 #include "hw/uart/uart.h"
+#include "fw_boot.h"
 #include "uart_ui.h"
 #include "power_control.h"
 #include "sm_cm.h"
+#include "boot.h"
 #include "cm_mcu_hwtest.h"
 #include "cm_mcu_hwtest_aux.h"
 #include "cm_mcu_hwtest_io.h"
@@ -41,6 +45,78 @@
 // Global variables.
 extern uint32_t g_ui32SysClock;
 extern tUartUi *g_psUartUi;
+volatile uint32_t g_ui32UptimeMs = 0;
+volatile uint64_t g_ui64UptimeUs = 0;
+
+
+
+// Set up the SysTick timer as system uptime counter.
+void SysTickInit(void)
+{
+    MAP_SysTickPeriodSet(g_ui32SysClock / SYSTICK_RATE_HZ);
+    SysTickIntRegister(SysTickIntHandler);
+    MAP_SysTickIntEnable();
+    MAP_SysTickEnable();
+}
+
+
+
+// SysTick interrupt handler.
+void SysTickIntHandler(void)
+{
+    g_ui32UptimeMs += 1000 / SYSTICK_RATE_HZ;
+    g_ui64UptimeUs += 1000000 / SYSTICK_RATE_HZ;
+}
+
+
+
+// Get the system uptime in ms.
+uint32_t GetUptimeMs(void)
+{
+    return g_ui32UptimeMs;
+}
+
+
+
+// Get the system uptime in us. The SysTick interrupts count the full periods,
+// the current value of the SysTick counter yields the fraction of a period.
+// This function can be called from interrupt handlers and with interrupts
+// disabled. It does not overflow for more than 500000 years.
+//
+// CAUTION: The SysTick only flags one pending wrap. If the interrupts are
+// masked, a wrap is only counted if this function is called before the next
+// one, i.e. the interrupts must not be masked for longer than one SysTick
+// period (1 ms) without calling it. Busy waiting with DelayUs is fine, as it
+// keeps on calling this function.
+uint64_t GetUptimeUs(void)
+{
+    uint64_t ui64UptimeUs;
+    uint32_t ui32Period, ui32Value;
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    // The counter wrapped, but the SysTick interrupt was not serviced yet.
+    // Count the period here and clear the pending interrupt, so that the next
+    // wrap is detected, too, if the interrupts stay masked.
+    if (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET) {
+        HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PENDSTCLR;
+        SysTickIntHandler();
+    }
+    ui64UptimeUs = g_ui64UptimeUs;
+    ui32Value = HWREG(NVIC_ST_CURRENT);
+    // The counter wrapped after the check above.
+    if (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET) {
+        ui64UptimeUs += 1000000 / SYSTICK_RATE_HZ;
+        ui32Value = HWREG(NVIC_ST_CURRENT);
+    }
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    // The SysTick counts down from the reload value to 0.
+    ui32Period = HWREG(NVIC_ST_RELOAD) + 1;
+    ui64UptimeUs += ((uint64_t) (ui32Period - 1 - ui32Value) * (1000000 / SYSTICK_RATE_HZ)) / ui32Period;
+
+    return ui64UptimeUs;
+}
 
 
 
@@ -49,10 +125,16 @@ int DelayUs(uint32_t ui32DelayUs)
 {
     // Limit the delay to max. 10 seconds.
     if (ui32DelayUs > 1e7) ui32DelayUs = 1e7;
+    // Use the SysTick time base if it is running. This does not depend on
+    // the flash wait states and interrupts do not extend the delay.
+    if (HWREG(NVIC_ST_CTRL) & NVIC_ST_CTRL_ENABLE) {
+        uint64_t ui64StartUs = GetUptimeUs();
+        while (GetUptimeUs() - ui64StartUs < ui32DelayUs);
     // CAUTION: Calling SysCtlDelay(0) will hang the system.
-    if (ui32DelayUs > 0)
+    } else if (ui32DelayUs > 0) {
         // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
         SysCtlDelay((g_ui32SysClock / 3e6) * ui32DelayUs);
+    }
 
     return 0;
 }
@@ -69,12 +151,7 @@ int DelayUsCmd(char *pcCmd, char *pcParam)
         return -1;
     }
     ui32DelayUs = strtoul(pcParam, (char **) NULL, 0);
-    // Limit the delay to max. 10 seconds.
-    if (ui32DelayUs > 1e7) ui32DelayUs = 1e7;
-    // CAUTION: Calling SysCtlDelay(0) will hang the system.
-    if (ui32DelayUs > 0)
-        // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-        SysCtlDelay((g_ui32SysClock / 3e6) * ui32DelayUs);
+    DelayUs(ui32DelayUs);
 
     UARTprintf("%s.", UI_STR_OK);
 
@@ -87,15 +164,27 @@ int DelayUsCmd(char *pcCmd, char *pcParam)
 int McuReset(char *pcCmd, char *pcParam)
 {
     char pcUartStr[4];
+    bool bFast = false;
+
+    if (pcParam != NULL) {
+        if (strcasecmp(pcParam, "fast")) {
+            UARTprintf("%s: Unknown parameter `%s'!", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        bFast = true;
+    }
 
     UARTprintf("Do you really want to reset the MCU (yes/no)? ");
-    UARTgets(pcUartStr, 4);
+    UartUiGets(g_psUartUi, pcUartStr, 4);
 
     if (!strcasecmp(pcUartStr, "yes")) {
         UARTprintf("%s. Resetting the MCU.", UI_STR_OK);
         // Wait some time for the UART to send out the last message.
         SysCtlDelay((g_ui32SysClock / 3e6) * 1e5);
 
+        // Ask the boot loader to start this firmware again right away.
+        if (bFast) BootRequest(FW_BOOT_REQ_FAST);
+
         SysCtlReset();
     } else {
         UARTprintf("Reset aborted.");
@@ -113,7 +202,7 @@ int JumpToBootLoader(char *pcCmd, char *pcParam)
     char pcUartStr[4];
 
     UARTprintf("Do you really want to jump to the serial boot loader (yes/no)? ");
-    UARTgets(pcUartStr, 4);
+    UartUiGets(g_psUartUi, pcUartStr, 4);
 
     if (!strcasecmp(pcUartStr, "yes")) {
         UARTprintf("%s. Entering the serial boot loader on UART %d.\n", UI_STR_OK, g_psUartUi->ui32Port);
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 27 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the auxiliary functions of the firmware running on the ATLAS
 // MDT Trigger Processor (TP) Command Module (CM) MCU.
@@ -19,6 +19,10 @@
 // Function prototypes.
 // ******************************************************************
 
+void SysTickInit(void);
+void SysTickIntHandler(void);
+uint32_t GetUptimeMs(void);
+uint64_t GetUptimeUs(void);
 int DelayUs(uint32_t ui32DelayUs);
 int DelayUsCmd(char *pcCmd, char *pcParam);
 int McuReset(char *pcCmd, char *pcParam);
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 27 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // GPIO functions of the hardware test firmware running on the ATLAS MDT
 // Trigger Processor (TP) Command Module (CM) MCU.
@@ -16,6 +16,7 @@
 #include <string.h>
 #include <strings.h>
 #include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
@@ -35,10 +36,43 @@
 
 
 
+// GPIO types.
+tGpioType g_psGpioType[GPIO_TYPE_NUM] = {
+    {"sm-pwr-en",   &g_sGpioGroup_SmPowerEna},
+    {"cm-ready",    &g_sGpioGroup_CmReady},
+    {"led-status",  &g_sGpioGroup_LedCmStatus},
+    {"led-user",    &g_sGpioGroup_LedMcuUser},
+    {"mux-hs-sel",  &g_sGpioGroup_MuxSel},
+    {"mux-hs-pd",   &g_sGpioGroup_MuxPD},
+    {"mux-clk-sel", &g_sGpioGroup_ClockSel},
+    {"power",       &g_sGpioGroup_PowerCtrl},
+    {"kup",         &g_sGpioGroup_KupCtrlStat},
+    {"zup",         &g_sGpioGroup_ZupCtrlStat},
+    {"reset",       &g_sGpioGroup_Reset},
+    {"reserved",    &g_sGpioGroup_Reserved},
+    {"pe-int",      &g_sGpioGroup_PEInt},
+    {"spare",       &g_sGpioGroup_SpareKupZup}
+};
+
+
+
+// Find a GPIO type by its name.
+tGpioType *GpioTypeFind(char *pcName)
+{
+    for (int i = 0; i < GPIO_TYPE_NUM; i++) {
+        if (!strcasecmp(pcName, g_psGpioType[i].pcName)) return &g_psGpioType[i];
+    }
+
+    return NULL;
+}
+
+
+
 // Get/Set the value of a GPIO type.
 int GpioGetSet(char *pcCmd, char *pcParam)
 {
     char *pcGpioType = pcParam;
+    tGpioType *psGpioType;
     bool bGpioWrite;
     uint32_t ui32GpioSet = 0, ui32GpioGet = 0;
 
@@ -47,6 +81,14 @@ int GpioGetSet(char *pcCmd, char *pcParam)
         GpioGetSetHelp();
         return -1;
     }
+    // Snapshot of all GPIO types.
+    if (!strcasecmp(pcGpioType, "all")) {
+        return GpioGetAll();
+    }
+    // Set several GPIO types at once.
+    if (!strcasecmp(pcGpioType, "set")) {
+        return GpioSetMulti(pcCmd, strtok(NULL, UI_STR_DELIMITER));
+    }
     pcParam = strtok(NULL, UI_STR_DELIMITER);
     // Read the current value of the user GPIO pins if no parameter is given.
     if (pcParam == NULL) {
@@ -59,59 +101,21 @@ int GpioGetSet(char *pcCmd, char *pcParam)
     if (!strcasecmp(pcGpioType, "help")) {
         GpioGetSetHelp();
         return 0;
-    } else if (!strcasecmp(pcGpioType, "sm-pwr-en")) {
-        if (bGpioWrite) {
-            UARTprintf("%s: GPIO %s is read-only!", UI_STR_WARNING, pcGpioType);
-            return 1;
-        }
-        ui32GpioGet = GpioGet_SmPowerEna();
-    } else if (!strcasecmp(pcGpioType, "cm-ready")) {
-        if (bGpioWrite) GpioSet_CmReady(ui32GpioSet);
-        ui32GpioGet =  GpioGet_CmReady();
-    } else if (!strcasecmp(pcGpioType, "led-status")) {
-        if (bGpioWrite) GpioSet_LedCmStatus(ui32GpioSet);
-        ui32GpioGet = GpioGet_LedCmStatus();
-    } else if (!strcasecmp(pcGpioType, "led-user")) {
-        if (bGpioWrite) GpioSet_LedMcuUser(ui32GpioSet);
-        ui32GpioGet = GpioGet_LedMcuUser();
-    } else if (!strcasecmp(pcGpioType, "mux-hs-sel")) {
-        if (bGpioWrite) GpioSet_MuxSel(ui32GpioSet);
-        ui32GpioGet = GpioGet_MuxSel();
-    } else if (!strcasecmp(pcGpioType, "mux-hs-pd")) {
-        if (bGpioWrite) GpioSet_MuxPD(ui32GpioSet);
-        ui32GpioGet =  GpioGet_MuxPD();
-    } else if (!strcasecmp(pcGpioType, "mux-clk-sel")) {
-        if (bGpioWrite) GpioSet_ClockSel(ui32GpioSet);
-        ui32GpioGet = GpioGet_ClockSel();
-    } else if (!strcasecmp(pcGpioType, "power")) {
-        if (bGpioWrite) GpioSet_PowerCtrl(ui32GpioSet);
-        ui32GpioGet = GpioGet_PowerCtrl();
-    } else if (!strcasecmp(pcGpioType, "kup")) {
-        if (bGpioWrite) GpioSet_KupCtrlStat(ui32GpioSet);
-        ui32GpioGet = GpioGet_KupCtrlStat();
-    } else if (!strcasecmp(pcGpioType, "zup")) {
-        if (bGpioWrite) GpioSet_ZupCtrlStat(ui32GpioSet);
-        ui32GpioGet = GpioGet_ZupCtrlStat();
-    } else if (!strcasecmp(pcGpioType, "reset")) {
-        if (bGpioWrite) GpioSet_Reset(ui32GpioSet);
-        ui32GpioGet = GpioGet_Reset();
-    } else if (!strcasecmp(pcGpioType, "reserved")) {
-        if (bGpioWrite) GpioSet_Reserved(ui32GpioSet);
-        ui32GpioGet = GpioGet_Reserved();        
-    } else if (!strcasecmp(pcGpioType, "pe-int")) {
-        if (bGpioWrite) {
-            UARTprintf("%s: GPIO %s is read-only!", UI_STR_WARNING, pcGpioType);
-            return 1;
-        }
-        ui32GpioGet = GpioGet_PEInt();
-    } else if (!strcasecmp(pcGpioType, "spare")) {
-        if (bGpioWrite) GpioSet_SpareKupZup(ui32GpioSet);
-        ui32GpioGet = GpioGet_SpareKupZup();
-    } else {
+    }
+    psGpioType = GpioTypeFind(pcGpioType);
+    if (psGpioType == NULL) {
         UARTprintf("%s: Unknown GPIO type `%s'!\n", UI_STR_ERROR, pcGpioType);
         GpioGetSetHelp();
         return -1;
     }
+    if (bGpioWrite) {
+        if (!GpioGroupMaskOut(psGpioType->psGroup)) {
+            UARTprintf("%s: GPIO %s is read-only!", UI_STR_WARNING, pcGpioType);
+            return 1;
+        }
+        GpioGroupSet(psGpioType->psGroup, ui32GpioSet);
+    }
+    ui32GpioGet = GpioGroupGet(psGpioType->psGroup);
     if (bGpioWrite) {
         if (ui32GpioGet == ui32GpioSet) {
             UARTprintf("%s: GPIO %s set to 0x%02x.", UI_STR_OK, pcGpioType, ui32GpioGet);
@@ -127,11 +131,106 @@ int GpioGetSet(char *pcCmd, char *pcParam)
 
 
 
+// Read all GPIO types at once. All groups are read with interrupts masked, so
+// the values are a consistent snapshot.
+int GpioGetAll(void)
+{
+    uint32_t pui32GpioGet[GPIO_TYPE_NUM];
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    for (int i = 0; i < GPIO_TYPE_NUM; i++) {
+        pui32GpioGet[i] = GpioGroupGet(g_psGpioType[i].psGroup);
+    }
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    UARTprintf("%s: GPIO all:", UI_STR_OK);
+    for (int i = 0; i < GPIO_TYPE_NUM; i++) {
+        UARTprintf(" %s=0x%02x", g_psGpioType[i].pcName, pui32GpioGet[i]);
+    }
+
+    return 0;
+}
+
+
+
+// Set several GPIO types at once. All parameters are checked before any GPIO
+// is changed. The GPIOs are then set with interrupts masked.
+int GpioSetMulti(char *pcCmd, char *pcParam)
+{
+    tGpioType *ppsGpioType[GPIO_TYPE_NUM];
+    uint32_t pui32GpioSet[GPIO_TYPE_NUM];
+    uint32_t pui32GpioGet[GPIO_TYPE_NUM];
+    uint32_t ui32Mask;
+    char *pcValue;
+    int iNum = 0, iErrors = 0;
+    bool bIntMasked;
+
+    if (pcParam == NULL) {
+        UARTprintf("%s: Parameters TYPE=VALUE required after command `%s set'.", UI_STR_ERROR, pcCmd);
+        return -1;
+    }
+    // Parse all parameters.
+    for (; pcParam != NULL; pcParam = strtok(NULL, UI_STR_DELIMITER)) {
+        pcValue = strchr(pcParam, '=');
+        if (pcValue == NULL) {
+            UARTprintf("%s: Parameter `%s' is not of the form TYPE=VALUE!", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        *pcValue++ = 0;
+        if (iNum >= GPIO_TYPE_NUM) {
+            UARTprintf("%s: Too many GPIO types given! Maximum is %d.", UI_STR_ERROR, GPIO_TYPE_NUM);
+            return -1;
+        }
+        ppsGpioType[iNum] = GpioTypeFind(pcParam);
+        if (ppsGpioType[iNum] == NULL) {
+            UARTprintf("%s: Unknown GPIO type `%s'!", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        if (!GpioGroupMaskOut(ppsGpioType[iNum]->psGroup)) {
+            UARTprintf("%s: GPIO %s is read-only!", UI_STR_ERROR, ppsGpioType[iNum]->pcName);
+            return -1;
+        }
+        pui32GpioSet[iNum] = strtol(pcValue, (char **) NULL, 0);
+        iNum++;
+    }
+
+    // Set all GPIO types and read them back.
+    bIntMasked = MAP_IntMasterDisable();
+    for (int i = 0; i < iNum; i++) {
+        GpioGroupSet(ppsGpioType[i]->psGroup, pui32GpioSet[i]);
+    }
+    for (int i = 0; i < iNum; i++) {
+        pui32GpioGet[i] = GpioGroupGet(ppsGpioType[i]->psGroup);
+    }
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    // Check the outputs.
+    for (int i = 0; i < iNum; i++) {
+        ui32Mask = GpioGroupMaskOut(ppsGpioType[i]->psGroup);
+        if ((pui32GpioGet[i] & ui32Mask) != (pui32GpioSet[i] & ui32Mask)) {
+            UARTprintf("%s: Setting GPIO %s to 0x%02x failed! It was set to 0x%02x instead.\n",
+                       UI_STR_ERROR, ppsGpioType[i]->pcName, pui32GpioSet[i], pui32GpioGet[i]);
+            iErrors++;
+        }
+    }
+    UARTprintf("%s: GPIO set:", iErrors ? UI_STR_ERROR : UI_STR_OK);
+    for (int i = 0; i < iNum; i++) {
+        UARTprintf(" %s=0x%02x", ppsGpioType[i]->pcName, pui32GpioGet[i]);
+    }
+
+    return iErrors ? -1 : 0;
+}
+
+
+
 // Show help on GPIO command.
 void GpioGetSetHelp(void)
 {
     UARTprintf("Available GPIO types:\n");
     UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  all                                 Read all GPIO types at once.\n");
+    UARTprintf("  set TYPE=VALUE [TYPE=VALUE ...]     Set several GPIO types at once.\n");
     UARTprintf("  sm-pwr-en                           SM power enable driven to CM.\n");
     UARTprintf("  cm-ready                            CM ready signal driven to SM.\n");
     UARTprintf("  led-status                          CM status LEDs.\n");
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 27 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the FPIO functions of the firmware running on the ATLAS MDT
 // Trigger Processor (TP) Command Module (CM) MCU.
@@ -15,11 +15,27 @@
 
 
 
+// Number of GPIO types.
+#define GPIO_TYPE_NUM                   14
+
+
+
+// Types.
+typedef struct {
+    char *pcName;
+    const tGpioGroup *psGroup;
+} tGpioType;
+
+
+
 // ******************************************************************
 // Function prototypes.
 // ******************************************************************
 
+tGpioType *GpioTypeFind(char *pcName);
 int GpioGetSet(char *pcCmd, char *pcParam);
+int GpioGetAll(void);
+int GpioSetMulti(char *pcCmd, char *pcParam);
 void GpioGetSetHelp(void);
 
 
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 27 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // I2C functions of the hardware test firmware running on the ATLAS MDT Trigger
 // Processor (TP) Command Module (CM) MCU.
@@ -35,6 +35,14 @@
 
 
 
+// I2C ports with a transaction of the host that was not terminated by a stop
+// condition yet. The background tasks must not access these ports, as they
+// would break the transaction, e.g. between a write and a read with repeated
+// start.
+bool g_pbI2CHostOpen[I2C_MASTER_NUM];
+
+
+
 // I2C access.
 int I2CAccess(char *pcCmd, char *pcParam)
 {
@@ -112,6 +120,9 @@ int I2CAccess(char *pcCmd, char *pcParam)
             ui32I2CMasterStatus = I2CMasterReadAdv(psI2C, ui8I2CSlaveAddr, pui8I2CData, ui8I2CDataNum, bI2CRepeatedStart, bI2CStop);
         }
     }
+    // The transaction stays open if no stop condition was generated. On error,
+    // the stop condition is always generated.
+    g_pbI2CHostOpen[ui8I2CPort] = !ui32I2CMasterStatus && !bI2CStop && !bI2CQuickCmd;
     // Check the I2C status.
     if (ui32I2CMasterStatus) {
         UARTprintf("%s: Error flags from I2C the master %d: 0x%08x", UI_STR_ERROR, ui8I2CPort, ui32I2CMasterStatus);
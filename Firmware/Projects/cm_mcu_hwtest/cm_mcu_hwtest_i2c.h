@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 27 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for the I2C functions of the firmware running on the ATLAS MDT
 // Trigger Processor (TP) Command Module (CM) MCU.
@@ -15,6 +15,11 @@
 
 
 
+// Globals.
+extern bool g_pbI2CHostOpen[I2C_MASTER_NUM];
+
+
+
 // ******************************************************************
 // Function prototypes.
 // ******************************************************************
@@ -0,0 +1,134 @@
+// File: cm_mcu_hwtest_perf.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Performance counters of the hardware test firmware running on the ATLAS MDT
+// Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The command dispatcher in main() records the execution time of each command
+// handler, including its UART output. The I2C driver records the duration of
+// each transfer per I2C master.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_types.h"
+#include "utils/uartstdio.h"
+#include "utils/ustdlib.h"
+#include "hw/i2c/i2c.h"
+#include "perf.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_io.h"
+#include "cm_mcu_hwtest_perf.h"
+
+
+
+// Global variables.
+extern uint32_t g_ui32SysClock;
+tPerfCmd g_psPerfCmd[PERF_CMD_NUM];
+
+
+
+// Record the execution time of a command. The cycle counter wraps around
+// after about 35 s, so longer durations are saturated using the uptime.
+void PerfCmdRecord(char *pcCmd, uint32_t ui32Cycles, uint32_t ui32DurationMs)
+{
+    int i;
+
+    if (ui32DurationMs >= 0xffffffff / (g_ui32SysClock / 1000)) ui32Cycles = 0xffffffff;
+    for (i = 0; i < PERF_CMD_NUM; i++) {
+        if (!g_psPerfCmd[i].pcName[0]) {
+            strncpy(g_psPerfCmd[i].pcName, pcCmd, PERF_CMD_NAME_LEN - 1);
+            break;
+        }
+        if (!strncasecmp(g_psPerfCmd[i].pcName, pcCmd, PERF_CMD_NAME_LEN - 1)) break;
+    }
+    // Table full.
+    if (i >= PERF_CMD_NUM) return;
+    PerfStatAdd(&g_psPerfCmd[i].sPerfStat, ui32Cycles, false);
+}
+
+
+
+// Reset all performance counters.
+void PerfReset(void)
+{
+    memset(g_psPerfCmd, 0, sizeof(g_psPerfCmd));
+    for (int i = 0; i < I2C_MASTER_NUM; i++) {
+        PerfStatClear(&g_psI2C[i].sPerfStat);
+    }
+}
+
+
+
+// Show the performance counters.
+void PerfShow(void)
+{
+    char pcName[PERF_CMD_NAME_LEN];
+
+    UARTprintf("%s: Performance counters (times in us, histogram bins log2(cycles):count).", UI_STR_OK);
+    UARTprintf("\nCommands:");
+    for (int i = 0; (i < PERF_CMD_NUM) && g_psPerfCmd[i].pcName[0]; i++) {
+        PerfStatPrint(g_psPerfCmd[i].pcName, &g_psPerfCmd[i].sPerfStat, g_ui32SysClock);
+    }
+    UARTprintf("\nI2C transfers:");
+    for (int i = 0; i < I2C_MASTER_NUM; i++) {
+        if (!g_psI2C[i].sPerfStat.ui32Count) continue;
+        usprintf(pcName, "i2c %d", i);
+        PerfStatPrint(pcName, &g_psI2C[i].sPerfStat, g_ui32SysClock);
+    }
+}
+
+
+
+// Performance counters command.
+int PerfCmd(char *pcCmd, char *pcParam)
+{
+    bool bShow = false, bReset = false;
+
+    if (pcParam == NULL) {
+        bShow = true;
+    }
+    while (pcParam != NULL) {
+        if (!strcasecmp(pcParam, "show")) {
+            bShow = true;
+        } else if (!strcasecmp(pcParam, "reset")) {
+            bReset = true;
+        } else if (!strcasecmp(pcParam, "help")) {
+            PerfHelp();
+            return 0;
+        } else {
+            UARTprintf("%s: Unknown perf command `%s'!\n", UI_STR_ERROR, pcParam);
+            PerfHelp();
+            return -1;
+        }
+        pcParam = strtok(NULL, UI_STR_DELIMITER);
+    }
+
+    if (bShow) PerfShow();
+    if (bReset) {
+        PerfReset();
+        if (!bShow) UARTprintf("%s.", UI_STR_OK);
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the perf command.
+void PerfHelp(void)
+{
+    UARTprintf("Available perf commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show the performance counters (default).\n");
+    UARTprintf("  reset                               Reset the performance counters.\n");
+    UARTprintf("  show reset                          Show and reset the performance counters.");
+}
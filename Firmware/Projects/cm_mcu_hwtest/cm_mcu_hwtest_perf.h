@@ -0,0 +1,37 @@
+// File: cm_mcu_hwtest_perf.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file for the performance counters of the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __CM_MCU_HWTEST_PERF_H__
+#define __CM_MCU_HWTEST_PERF_H__
+
+
+
+// Types.
+typedef struct {
+    char      pcName[PERF_CMD_NAME_LEN];
+    tPerfStat sPerfStat;
+} tPerfCmd;
+
+
+
+// ******************************************************************
+// Function prototypes.
+// ******************************************************************
+
+void PerfCmdRecord(char *pcCmd, uint32_t ui32Cycles, uint32_t ui32DurationMs);
+void PerfReset(void);
+int PerfCmd(char *pcCmd, char *pcParam);
+void PerfHelp(void);
+
+
+
+#endif  // __CM_MCU_HWTEST_PERF_H__
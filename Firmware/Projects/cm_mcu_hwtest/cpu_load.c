@@ -0,0 +1,129 @@
+// File: cpu_load.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Idle loop and CPU load measurement for the hardware test firmware running on
+// the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// When no background task has work pending, the main loop sleeps with WFI
+// until the next interrupt. The SysTick wakes up the CPU every ms, the UART
+// receive interrupt of the user interface as soon as a character arrives. The
+// time spent sleeping is measured with the us time base, so no extra timer is
+// required like for the TivaWare utils/cpu_usage.c.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "utils/uartstdio.h"
+#include "uart_ui.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "cpu_load.h"
+
+
+
+// Global variables.
+tCpuLoad g_sCpuLoad;
+tUartUi *g_psCpuLoadUartUi;
+
+
+
+// Initialize the CPU load measurement. The idle loop does not sleep while
+// received characters of the UART user interface are waiting.
+void CpuLoadInit(tUartUi *psUartUi)
+{
+    g_psCpuLoadUartUi = psUartUi;
+    CpuLoadReset();
+}
+
+
+
+// Reset the CPU load measurement.
+void CpuLoadReset(void)
+{
+    uint64_t ui64NowUs = GetUptimeUs();
+
+    memset(&g_sCpuLoad, 0, sizeof(g_sCpuLoad));
+    g_sCpuLoad.ui64WindowStartUs = ui64NowUs;
+    g_sCpuLoad.ui64TotalStartUs = ui64NowUs;
+}
+
+
+
+// Sleep until the next interrupt and account the idle time. The interrupts
+// are masked while sleeping, so the time spent in the interrupt handler that
+// woke up the CPU is not counted as idle.
+void CpuLoadIdle(void)
+{
+    uint64_t ui64StartUs, ui64StopUs, ui64WindowUs;
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    ui64StartUs = GetUptimeUs();
+    // A pending interrupt terminates the WFI immediately. Only the characters
+    // received before masking the interrupts would be missed.
+    if (!UartUiCharsAvail(g_psCpuLoadUartUi)) __asm("    wfi\n");
+    ui64StopUs = GetUptimeUs();
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    g_sCpuLoad.ui64IdleUs += ui64StopUs - ui64StartUs;
+    g_sCpuLoad.ui64TotalIdleUs += ui64StopUs - ui64StartUs;
+
+    // Evaluate the current window.
+    ui64WindowUs = ui64StopUs - g_sCpuLoad.ui64WindowStartUs;
+    if (ui64WindowUs >= CPU_LOAD_WINDOW_US) {
+        g_sCpuLoad.ui32Load = 1000 - (g_sCpuLoad.ui64IdleUs * 1000) / ui64WindowUs;
+        if (g_sCpuLoad.ui32Load > g_sCpuLoad.ui32LoadPeak) g_sCpuLoad.ui32LoadPeak = g_sCpuLoad.ui32Load;
+        g_sCpuLoad.ui64IdleUs = 0;
+        g_sCpuLoad.ui64WindowStartUs = ui64StopUs;
+    }
+}
+
+
+
+// CPU load command.
+int CpuLoadCmd(char *pcCmd, char *pcParam)
+{
+    uint64_t ui64TotalUs = GetUptimeUs() - g_sCpuLoad.ui64TotalStartUs;
+    uint32_t ui32LoadAverage = 0;
+
+    if ((pcParam != NULL) && !strcasecmp(pcParam, "help")) {
+        CpuLoadHelp();
+        return 0;
+    } else if ((pcParam != NULL) && strcasecmp(pcParam, "show") && strcasecmp(pcParam, "reset")) {
+        UARTprintf("%s: Unknown load command `%s'!\n", UI_STR_ERROR, pcParam);
+        CpuLoadHelp();
+        return -1;
+    }
+
+    if (ui64TotalUs) ui32LoadAverage = 1000 - (g_sCpuLoad.ui64TotalIdleUs * 1000) / ui64TotalUs;
+    UARTprintf("%s: CPU load: current %d.%d %%, peak %d.%d %%, average %d.%d %% over %d s.", UI_STR_OK,
+               g_sCpuLoad.ui32Load / 10, g_sCpuLoad.ui32Load % 10,
+               g_sCpuLoad.ui32LoadPeak / 10, g_sCpuLoad.ui32LoadPeak % 10,
+               ui32LoadAverage / 10, ui32LoadAverage % 10, (uint32_t) (ui64TotalUs / 1000000));
+    if ((pcParam != NULL) && !strcasecmp(pcParam, "reset")) CpuLoadReset();
+
+    return 0;
+}
+
+
+
+// Show help on the load command.
+void CpuLoadHelp(void)
+{
+    UARTprintf("Available load commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show the current, peak and average CPU load\n");
+    UARTprintf("                                          (default).\n");
+    UARTprintf("  reset                               Show and reset the CPU load measurement.");
+}
@@ -0,0 +1,49 @@
+// File: cpu_load.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the idle loop and the CPU load measurement for the hardware
+// test firmware running on the ATLAS MDT Trigger Processor (TP) Command Module
+// (CM) MCU.
+//
+
+
+
+#ifndef __CPU_LOAD_H__
+#define __CPU_LOAD_H__
+
+
+
+// ******************************************************************
+// CPU load parameters.
+// ******************************************************************
+
+// Measurement window of the current CPU load in us.
+#define CPU_LOAD_WINDOW_US              1000000
+
+
+
+// Types.
+typedef struct {
+    uint64_t ui64IdleUs;            // Idle time in the current window.
+    uint64_t ui64WindowStartUs;     // Start of the current window.
+    uint64_t ui64TotalIdleUs;       // Idle time since the last reset.
+    uint64_t ui64TotalStartUs;      // Time of the last reset.
+    uint32_t ui32Load;              // CPU load of the last window in 0.1 %.
+    uint32_t ui32LoadPeak;          // Peak CPU load since the last reset in 0.1 %.
+} tCpuLoad;
+
+
+
+// Function prototypes.
+void CpuLoadInit(tUartUi *psUartUi);
+void CpuLoadReset(void);
+void CpuLoadIdle(void);
+int CpuLoadCmd(char *pcCmd, char *pcParam);
+void CpuLoadHelp(void);
+
+
+
+#endif  // __CPU_LOAD_H__
@@ -0,0 +1,225 @@
+// File: dlog.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Deferred binary log for the hardware test firmware running on the ATLAS MDT
+// Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The DLOG macro can be used in interrupt handlers. Writers reserve an entry
+// of the ring buffer with an atomic increment of the head, so they need no
+// lock and can preempt each other. If the ring buffer is full, the oldest
+// entries are overwritten. The reader detects entries that were overwritten or
+// are still being written by their sequence number.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "utils/uartstdio.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "dlog.h"
+#include "telemetry.h"
+#include "timestamp.h"
+
+
+
+// Start of the format strings (linker script).
+extern const char _dlog_fmt[];
+
+// Global variables.
+tDlog g_sDlog;
+
+
+
+// Initialize the deferred log.
+void DlogInit(void)
+{
+    memset(&g_sDlog, 0, sizeof(g_sDlog));
+    for (int i = 0; i < DLOG_BUF_SIZE; i++) {
+        g_sDlog.psEntry[i].ui32Seq = DLOG_SEQ_INVALID;
+    }
+}
+
+
+
+// Write an entry into the ring buffer. Use the DLOG macro instead of calling
+// this function directly.
+void DlogWrite(const char *pcFmt, uint32_t ui32Nargs, uint32_t ui32Arg0, uint32_t ui32Arg1, uint32_t ui32Arg2, uint32_t ui32Arg3)
+{
+    uint32_t ui32Seq;
+    tDlogEntry *psEntry;
+
+    ui32Seq = __atomic_fetch_add(&g_sDlog.ui32Head, 1, __ATOMIC_RELAXED);
+    psEntry = &g_sDlog.psEntry[ui32Seq & (DLOG_BUF_SIZE - 1)];
+    psEntry->ui32Seq = DLOG_SEQ_INVALID;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    psEntry->ui16FmtId = pcFmt - _dlog_fmt;
+    psEntry->ui8Nargs = ui32Nargs;
+    psEntry->ui64UptimeUs = GetUptimeUs();
+    psEntry->pui32Arg[0] = ui32Arg0;
+    psEntry->pui32Arg[1] = ui32Arg1;
+    psEntry->pui32Arg[2] = ui32Arg2;
+    psEntry->pui32Arg[3] = ui32Arg3;
+    // Publish the entry only after it was written completely.
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    psEntry->ui32Seq = ui32Seq;
+}
+
+
+
+// Read the next entry from the ring buffer. Returns 1 if an entry was read, 0
+// if no complete entry is available.
+int DlogRead(tDlogEntry *psEntry)
+{
+    tDlogEntry *psSlot;
+    uint32_t ui32Seq;
+
+    while (g_sDlog.ui32Tail != g_sDlog.ui32Head) {
+        // Skip entries which were already overwritten.
+        if (g_sDlog.ui32Head - g_sDlog.ui32Tail > DLOG_BUF_SIZE) {
+            g_sDlog.ui32Lost += g_sDlog.ui32Head - g_sDlog.ui32Tail - DLOG_BUF_SIZE;
+            g_sDlog.ui32Tail = g_sDlog.ui32Head - DLOG_BUF_SIZE;
+        }
+        psSlot = &g_sDlog.psEntry[g_sDlog.ui32Tail & (DLOG_BUF_SIZE - 1)];
+        ui32Seq = psSlot->ui32Seq;
+        // The entry is still being written.
+        if (ui32Seq != g_sDlog.ui32Tail) {
+            if (ui32Seq == DLOG_SEQ_INVALID) return 0;
+            // The entry was overwritten in the meantime.
+            g_sDlog.ui32Lost++;
+            g_sDlog.ui32Tail++;
+            continue;
+        }
+        memcpy(psEntry, psSlot, sizeof(tDlogEntry));
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        g_sDlog.ui32Tail++;
+        // The entry was overwritten while it was copied.
+        if (psSlot->ui32Seq != ui32Seq) {
+            g_sDlog.ui32Lost++;
+            continue;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+
+
+// Print an entry as hexadecimal string. All values are little endian:
+// - uint32_t sequence number
+// - uint16_t format ID
+// - uint8_t  number of arguments N
+// - uint64_t uptime in us
+// - N x uint32_t arguments
+void DlogPrintHex(tDlogEntry *psEntry)
+{
+    TelemetryPrintHex(psEntry->ui32Seq, 4);
+    TelemetryPrintHex(psEntry->ui16FmtId, 2);
+    TelemetryPrintHex(psEntry->ui8Nargs, 1);
+    TelemetryPrintHex(psEntry->ui64UptimeUs, 4);
+    TelemetryPrintHex(psEntry->ui64UptimeUs >> 32, 4);
+    for (int i = 0; i < psEntry->ui8Nargs; i++) {
+        TelemetryPrintHex(psEntry->pui32Arg[i], 4);
+    }
+}
+
+
+
+// Send new entries as frames in the automatic mode. The frames start with
+// DLOG_FRAME_START and are followed by the command prompt like the telemetry
+// stream frames.
+int DlogPoll(void)
+{
+    tDlogEntry sEntry;
+    int iNum;
+
+    if (!g_sDlog.bAuto) return 0;
+
+    for (iNum = 0; iNum < DLOG_POLL_MAX; iNum++) {
+        if (!DlogRead(&sEntry)) break;
+        UARTprintf("\r%c", DLOG_FRAME_START);
+        DlogPrintHex(&sEntry);
+        UARTprintf("\n%s", UI_COMMAND_PROMPT);
+    }
+
+    return iNum;
+}
+
+
+
+// Deferred log command.
+int DlogCmd(char *pcCmd, char *pcParam)
+{
+    tDlogEntry sEntry;
+    char *pcMode;
+    uint32_t ui32Lost;
+    int iNum;
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "status")) {
+        UARTprintf("%s: Deferred log: format version %d, %d entries written, %d pending, %d lost, automatic mode %s.",
+                   UI_STR_OK, DLOG_FORMAT_VERSION, g_sDlog.ui32Head, g_sDlog.ui32Head - g_sDlog.ui32Tail,
+                   g_sDlog.ui32Lost, g_sDlog.bAuto ? "on" : "off");
+    } else if (!strcasecmp(pcParam, "help")) {
+        DlogHelp();
+    // Read all pending entries as hexadecimal strings, one per line.
+    } else if (!strcasecmp(pcParam, "dump")) {
+        ui32Lost = g_sDlog.ui32Lost;
+        UARTprintf("%s: ", UI_STR_OK);
+        TelemetryPrintHex(DLOG_FORMAT_VERSION, 1);
+        for (iNum = 0; DlogRead(&sEntry); iNum++) {
+            UARTprintf("\n");
+            DlogPrintHex(&sEntry);
+        }
+        if (g_sDlog.ui32Lost != ui32Lost) UARTprintf("\n%s: %d entries lost.", UI_STR_WARNING, g_sDlog.ui32Lost - ui32Lost);
+    // The pending entries are expanded on the MCU. This requires the format
+    // strings in the flash.
+    } else if (!strcasecmp(pcParam, "show")) {
+        UARTprintf("%s: Deferred log:", UI_STR_OK);
+        while (DlogRead(&sEntry)) {
+            UARTprintf("\n");
+            TimestampPrint(TimestampFromUptimeUs(sEntry.ui64UptimeUs));
+            UARTprintf(" ");
+            UARTprintf(_dlog_fmt + sEntry.ui16FmtId, sEntry.pui32Arg[0], sEntry.pui32Arg[1], sEntry.pui32Arg[2], sEntry.pui32Arg[3]);
+        }
+    } else if (!strcasecmp(pcParam, "clear")) {
+        while (DlogRead(&sEntry));
+        g_sDlog.ui32Lost = 0;
+        UARTprintf("%s.", UI_STR_OK);
+    } else if (!strcasecmp(pcParam, "auto")) {
+        pcMode = strtok(NULL, UI_STR_DELIMITER);
+        if ((pcMode == NULL) || (strcasecmp(pcMode, "on") && strcasecmp(pcMode, "off"))) {
+            UARTprintf("%s: Automatic mode `on' or `off' required after command `%s %s'.", UI_STR_ERROR, pcCmd, pcParam);
+            return -1;
+        }
+        g_sDlog.bAuto = !strcasecmp(pcMode, "on");
+        UARTprintf("%s.", UI_STR_OK);
+    } else {
+        UARTprintf("%s: Unknown dlog command `%s'!\n", UI_STR_ERROR, pcParam);
+        DlogHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the deferred log command.
+void DlogHelp(void)
+{
+    UARTprintf("Available dlog commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  status                              Show the log status (default).\n");
+    UARTprintf("  show                                Show and remove the pending entries.\n");
+    UARTprintf("  dump                                Read the pending entries in binary format.\n");
+    UARTprintf("  clear                               Discard all pending entries.\n");
+    UARTprintf("  auto    on|off                      Send new entries automatically as frames.");
+}
@@ -0,0 +1,97 @@
+// File: dlog.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the deferred binary log for the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __DLOG_H__
+#define __DLOG_H__
+
+
+
+// ******************************************************************
+// Deferred log parameters.
+// ******************************************************************
+
+// Version of the binary entry format. Increment on every change!
+#define DLOG_FORMAT_VERSION             1
+
+// Number of entries in the ring buffer. Must be a power of 2.
+#define DLOG_BUF_SIZE                   256
+
+// Maximum number of arguments of a log entry.
+#define DLOG_ARG_MAX                    4
+
+// Start character of the frames sent in the automatic mode.
+#define DLOG_FRAME_START                '#'
+
+// Maximum number of frames sent per call of DlogPoll.
+#define DLOG_POLL_MAX                   4
+
+// Sequence number of an entry which is being written.
+#define DLOG_SEQ_INVALID                0xffffffff
+
+
+
+// Log a message with up to DLOG_ARG_MAX integer arguments. Only the ID of the
+// format string, a timestamp and the arguments are stored. The format strings
+// are collected in the section .dlog_fmt. Their offset in this section is the
+// format ID. The host expands the messages with the table extracted from the
+// firmware at build time. The format strings must only contain integer
+// conversions (%d, %u, %x, %c).
+#define DLOG(pcFmt, ...) do { \
+    static const char pcDlogFmt[] __attribute__((section(".dlog_fmt"), used)) = pcFmt; \
+    DlogWrite(pcDlogFmt, DLOG_NARGS(__VA_ARGS__), DLOG_ARGS(__VA_ARGS__)); \
+} while (0)
+
+// Count the arguments. More than DLOG_ARG_MAX arguments give a compile error.
+#define DLOG_NARGS(...)                 DLOG_NARGS_(0, ##__VA_ARGS__, DLOG_TOO_MANY_ARGUMENTS, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, N, ...) N
+// Pad the arguments with zeros to DLOG_ARG_MAX.
+#define DLOG_ARGS(...)                  DLOG_ARGS_(0, ##__VA_ARGS__, 0, 0, 0, 0)
+#define DLOG_ARGS_(_0, a0, a1, a2, a3, ...) a0, a1, a2, a3
+
+
+
+// Types.
+typedef struct {
+    volatile uint32_t ui32Seq;      // Sequence number. DLOG_SEQ_INVALID while being written.
+    uint16_t ui16FmtId;             // Offset of the format string in the section .dlog_fmt.
+    uint8_t  ui8Nargs;
+    uint8_t  ui8Reserved;
+    uint64_t ui64UptimeUs;
+    uint32_t pui32Arg[DLOG_ARG_MAX];
+} tDlogEntry;
+
+typedef struct {
+    tDlogEntry psEntry[DLOG_BUF_SIZE];
+    volatile uint32_t ui32Head;     // Next sequence number to write.
+    uint32_t ui32Tail;              // Next sequence number to read.
+    uint32_t ui32Lost;              // Entries overwritten before they were read.
+    bool     bAuto;                 // Send new entries automatically.
+} tDlog;
+
+
+
+// Global variables.
+extern tDlog g_sDlog;
+
+
+
+// Function prototypes.
+void DlogInit(void);
+void DlogWrite(const char *pcFmt, uint32_t ui32Nargs, uint32_t ui32Arg0, uint32_t ui32Arg1, uint32_t ui32Arg2, uint32_t ui32Arg3);
+int DlogRead(tDlogEntry *psEntry);
+int DlogPoll(void);
+int DlogCmd(char *pcCmd, char *pcParam);
+void DlogHelp(void);
+
+
+
+#endif  // __DLOG_H__
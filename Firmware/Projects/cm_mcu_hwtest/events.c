@@ -0,0 +1,278 @@
+// File: events.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// GPIO edge event capture for the hardware test firmware running on the ATLAS
+// MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// All status inputs generate an interrupt on both edges. This includes the
+// open-drain INIT_B outputs, which are released (high) during normal operation,
+// so the edges driven by the FPGAs are captured. The interrupt handler
+// stores the uptime in us, the input and its new level in a ring buffer, which
+// is drained by the events command. The GPIO interrupts all have the same
+// priority, so they do not preempt each other. Hence, the ring buffer has a
+// single producer and a single consumer and needs no lock.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "utils/uartstdio.h"
+#include "hw/gpio/gpio.h"
+#include "hw/gpio/gpio_pins.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "events.h"
+#include "timestamp.h"
+
+
+
+// Event sources. The pins are taken from the table generated from
+// gpio_pins.txt.
+const tGpioPin *g_ppsEventSource[] = {
+    &g_psGpioPin[GPIO_SIG_SM_PWR_ENA],
+    &g_psGpioPin[GPIO_SIG_KUP_INIT_B_3V3],
+    &g_psGpioPin[GPIO_SIG_KUP_DONE_3V3],
+    &g_psGpioPin[GPIO_SIG_ZUP_PS_INIT_B],
+    &g_psGpioPin[GPIO_SIG_ZUP_PS_DONE],
+    &g_psGpioPin[GPIO_SIG_ZUP_PS_ERR_STATUS],
+    &g_psGpioPin[GPIO_SIG_ZUP_PS_ERR_OUT],
+    &g_psGpioPin[GPIO_SIG_MCU_PEx_nINT]
+};
+#define EVENTS_SOURCE_NUM               (sizeof(g_ppsEventSource) / sizeof(g_ppsEventSource[0]))
+
+// Global variables.
+tEventRing g_sEventRing;
+tEventsHook g_pfnEventsHook = NULL;
+uint8_t g_pui8EventsLastLevel[EVENTS_SOURCE_NUM];
+
+
+
+// Enable both edge interrupts of all event sources.
+void EventsInit(void)
+{
+    const tGpioPin *psSource;
+
+    memset(&g_sEventRing, 0, sizeof(g_sEventRing));
+    for (int i = 0; i < EVENTS_SOURCE_NUM; i++) {
+        psSource = g_ppsEventSource[i];
+        g_pui8EventsLastLevel[i] = EventsSourceLevel(i);
+        #ifdef SM_CM_POWER_HANDSHAKING_ENABLE
+        // The interrupt of the SM_PWR_ENA input is handled by the Service
+        // Module power handshaking, which forwards the edges.
+        if (psSource == &g_psGpioPin[GPIO_SIG_SM_PWR_ENA]) continue;
+        #endif
+        GPIOIntTypeSet(psSource->ui32Port, psSource->ui8Pin, GPIO_BOTH_EDGES);
+        GPIOIntClear(psSource->ui32Port, psSource->ui8Pin);
+        GPIOIntEnable(psSource->ui32Port, psSource->ui8Pin);
+        // Ports K and N have one interrupt for all pins, ports P and Q have one
+        // interrupt per pin.
+        switch (psSource->ui32Port) {
+            case GPIO_PORTK_BASE:
+                GPIOIntRegister(GPIO_PORTK_BASE, EventsIntHandlerPortK);
+                break;
+            case GPIO_PORTN_BASE:
+                GPIOIntRegister(GPIO_PORTN_BASE, EventsIntHandlerPortN);
+                break;
+            case GPIO_PORTP_BASE:
+                GPIOIntRegisterPin(GPIO_PORTP_BASE, __builtin_ctz(psSource->ui8Pin), EventsIntHandlerPortP);
+                break;
+            case GPIO_PORTQ_BASE:
+                GPIOIntRegisterPin(GPIO_PORTQ_BASE, __builtin_ctz(psSource->ui8Pin), EventsIntHandlerPortQ);
+                break;
+        }
+    }
+}
+
+
+
+// Find an event source by its name. Returns -1 if it does not exist.
+int EventsSourceFind(const char *pcName)
+{
+    for (int i = 0; i < EVENTS_SOURCE_NUM; i++) {
+        if (!strcmp(pcName, g_ppsEventSource[i]->pcName)) return i;
+    }
+
+    return -1;
+}
+
+
+
+// Read the current level of an event source.
+int EventsSourceLevel(int iSource)
+{
+    if ((iSource < 0) || (iSource >= EVENTS_SOURCE_NUM)) return -1;
+
+    return GPIOPinRead(g_ppsEventSource[iSource]->ui32Port, g_ppsEventSource[iSource]->ui8Pin) ? 1 : 0;
+}
+
+
+
+// Set the hook called for every captured edge. The hook runs in interrupt
+// context.
+void EventsHookSet(tEventsHook pfnHook)
+{
+    g_pfnEventsHook = pfnHook;
+}
+
+
+
+// Store the edges of all event sources of a port in the ring buffer. Must only
+// be called from the GPIO interrupt handlers.
+void EventsCapture(uint32_t ui32Port, uint32_t ui32IntStatus)
+{
+    const tGpioPin *psSource;
+    tEvent *psEvent;
+    uint64_t ui64UptimeUs = GetUptimeUs();
+    uint32_t ui32Head;
+    uint8_t ui8Level;
+
+    ui8Level = GPIOPinRead(ui32Port, 0xff);
+    for (int i = 0; i < EVENTS_SOURCE_NUM; i++) {
+        psSource = g_ppsEventSource[i];
+        if ((psSource->ui32Port != ui32Port) || !(ui32IntStatus & psSource->ui8Pin)) continue;
+        if (g_pfnEventsHook != NULL) g_pfnEventsHook(i, (ui8Level & psSource->ui8Pin) ? 1 : 0, ui64UptimeUs);
+        ui32Head = g_sEventRing.ui32Head;
+        if (ui32Head - g_sEventRing.ui32Tail >= EVENTS_BUF_SIZE) {
+            g_sEventRing.ui32Overflows++;
+            continue;
+        }
+        psEvent = &g_sEventRing.psEvent[ui32Head & (EVENTS_BUF_SIZE - 1)];
+        psEvent->ui64UptimeUs = ui64UptimeUs;
+        psEvent->ui8Source = i;
+        psEvent->ui8Level = (ui8Level & psSource->ui8Pin) ? 1 : 0;
+        // Publish the event only after it was written completely.
+        __atomic_signal_fence(__ATOMIC_RELEASE);
+        g_sEventRing.ui32Head = ui32Head + 1;
+    }
+}
+
+
+
+// Interrupt handler of GPIO port K.
+void EventsIntHandlerPortK(void)
+{
+    uint32_t ui32IntStatus = GPIOIntStatus(GPIO_PORTK_BASE, true);
+
+    GPIOIntClear(GPIO_PORTK_BASE, ui32IntStatus);
+    EventsCapture(GPIO_PORTK_BASE, ui32IntStatus);
+}
+
+
+
+// Interrupt handler of GPIO port N.
+void EventsIntHandlerPortN(void)
+{
+    uint32_t ui32IntStatus = GPIOIntStatus(GPIO_PORTN_BASE, true);
+
+    GPIOIntClear(GPIO_PORTN_BASE, ui32IntStatus);
+    EventsCapture(GPIO_PORTN_BASE, ui32IntStatus);
+}
+
+
+
+// Interrupt handler of the GPIO port P pins.
+void EventsIntHandlerPortP(void)
+{
+    uint32_t ui32IntStatus = GPIOIntStatus(GPIO_PORTP_BASE, true);
+
+    GPIOIntClear(GPIO_PORTP_BASE, ui32IntStatus);
+    EventsCapture(GPIO_PORTP_BASE, ui32IntStatus);
+}
+
+
+
+// Interrupt handler of the GPIO port Q pins.
+void EventsIntHandlerPortQ(void)
+{
+    uint32_t ui32IntStatus = GPIOIntStatus(GPIO_PORTQ_BASE, true);
+
+    GPIOIntClear(GPIO_PORTQ_BASE, ui32IntStatus);
+    EventsCapture(GPIO_PORTQ_BASE, ui32IntStatus);
+}
+
+
+
+// Show and remove captured events from the ring buffer.
+int EventsShow(void)
+{
+    tEvent *psEvent;
+    uint32_t ui32Tail, ui32Num;
+
+    ui32Tail = g_sEventRing.ui32Tail;
+    ui32Num = g_sEventRing.ui32Head - ui32Tail;
+    // Read the events only after their publication by the head.
+    __atomic_signal_fence(__ATOMIC_ACQUIRE);
+    if (ui32Num > EVENTS_SHOW_MAX) ui32Num = EVENTS_SHOW_MAX;
+    UARTprintf("%s: %d event(s), %d overflow(s).", UI_STR_OK, ui32Num, g_sEventRing.ui32Overflows);
+    for (uint32_t i = 0; i < ui32Num; i++, ui32Tail++) {
+        psEvent = &g_sEventRing.psEvent[ui32Tail & (EVENTS_BUF_SIZE - 1)];
+        UARTprintf("\n");
+        TimestampPrint(TimestampFromUptimeUs(psEvent->ui64UptimeUs));
+        UARTprintf(" %s %d", g_ppsEventSource[psEvent->ui8Source]->pcName, psEvent->ui8Level);
+        // The input changed twice before the interrupt handler read its level.
+        if (psEvent->ui8Level == g_pui8EventsLastLevel[psEvent->ui8Source]) UARTprintf(" glitch");
+        g_pui8EventsLastLevel[psEvent->ui8Source] = psEvent->ui8Level;
+    }
+    // Release the ring buffer entries only after they were read.
+    __atomic_signal_fence(__ATOMIC_RELEASE);
+    g_sEventRing.ui32Tail = ui32Tail;
+    g_sEventRing.ui32Total += ui32Num;
+
+    return 0;
+}
+
+
+
+// Events command.
+int EventsCmd(char *pcCmd, char *pcParam)
+{
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "show")) {
+        return EventsShow();
+    } else if (!strcasecmp(pcParam, "help")) {
+        EventsHelp();
+        return 0;
+    } else if (!strcasecmp(pcParam, "status")) {
+        UARTprintf("%s: %d event(s) pending, %d event(s) shown, %d overflow(s).", UI_STR_OK,
+                   g_sEventRing.ui32Head - g_sEventRing.ui32Tail, g_sEventRing.ui32Total, g_sEventRing.ui32Overflows);
+        for (int i = 0; i < EVENTS_SOURCE_NUM; i++) {
+            UARTprintf("\n%s %d", g_ppsEventSource[i]->pcName, EventsSourceLevel(i));
+        }
+        return 0;
+    } else if (!strcasecmp(pcParam, "clear")) {
+        // Remember the current levels for the glitch detection.
+        for (int i = 0; i < EVENTS_SOURCE_NUM; i++) {
+            g_pui8EventsLastLevel[i] = EventsSourceLevel(i);
+        }
+        g_sEventRing.ui32Tail = g_sEventRing.ui32Head;
+        g_sEventRing.ui32Overflows = 0;
+        g_sEventRing.ui32Total = 0;
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+
+    UARTprintf("%s: Unknown events command `%s'!\n", UI_STR_ERROR, pcParam);
+    EventsHelp();
+    return -1;
+}
+
+
+
+// Show help on the events command.
+void EventsHelp(void)
+{
+    UARTprintf("Available events commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show and remove the captured edges of the\n");
+    UARTprintf("                                          status inputs (default).\n");
+    UARTprintf("  status                              Show the event counters and input levels.\n");
+    UARTprintf("  clear                               Discard all captured events.");
+}
@@ -0,0 +1,65 @@
+// File: events.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the GPIO edge event capture for the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __EVENTS_H__
+#define __EVENTS_H__
+
+
+
+// ******************************************************************
+// Event capture parameters.
+// ******************************************************************
+
+// Size of the event ring buffer. Must be a power of 2.
+#define EVENTS_BUF_SIZE                 128
+
+// Maximum number of events shown by one events command.
+#define EVENTS_SHOW_MAX                 EVENTS_BUF_SIZE
+
+
+
+// Types.
+typedef struct {
+    uint64_t ui64UptimeUs;          // Uptime in us when the edge was captured.
+    uint8_t  ui8Source;             // Index of the event source.
+    uint8_t  ui8Level;              // Level of the input after the edge.
+} tEvent;
+
+// Hook called by the interrupt handlers for every captured edge.
+typedef void (*tEventsHook)(uint32_t ui32Source, uint8_t ui8Level, uint64_t ui64UptimeUs);
+
+typedef struct {
+    tEvent   psEvent[EVENTS_BUF_SIZE];
+    volatile uint32_t ui32Head;     // Written only by the interrupt handlers.
+    volatile uint32_t ui32Tail;     // Written only by the main loop.
+    volatile uint32_t ui32Overflows;
+    uint32_t ui32Total;
+} tEventRing;
+
+
+
+// Function prototypes.
+void EventsInit(void);
+int EventsSourceFind(const char *pcName);
+int EventsSourceLevel(int iSource);
+void EventsHookSet(tEventsHook pfnHook);
+void EventsCapture(uint32_t ui32Port, uint32_t ui32IntStatus);
+void EventsIntHandlerPortK(void);
+void EventsIntHandlerPortN(void);
+void EventsIntHandlerPortP(void);
+void EventsIntHandlerPortQ(void);
+int EventsCmd(char *pcCmd, char *pcParam);
+void EventsHelp(void);
+
+
+
+#endif  // __EVENTS_H__
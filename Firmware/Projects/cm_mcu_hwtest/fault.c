@@ -0,0 +1,259 @@
+// File: fault.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Fault dump capture for the hardware test firmware running on the ATLAS MDT
+// Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The fault handlers in startup_gcc.c switch to a separate stack and call
+// FaultCapture. It stores the stacked registers, the fault status registers,
+// the active command, a part of the stack and the recent deferred log entries
+// in the SRAM section .noinit, which is not initialized at startup, and resets
+// the MCU. At the next boot, the dump is saved to the persistent log and
+// reported on the console.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sw_crc.h"
+#include "utils/uartstdio.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "dlog.h"
+#include "fault.h"
+#include "plog.h"
+#include "telemetry.h"
+
+
+
+// SRAM range for checking the stack pointer.
+#define FAULT_SRAM_START                0x20000000
+#define FAULT_SRAM_END                  0x20040000
+
+// Start of the main stack (linker script).
+extern uint32_t _stack;
+
+// Fault dump. It survives the reset.
+tFaultDump g_sFaultDump __attribute__((section(".noinit")));
+
+// Stack of the fault handler.
+uint32_t g_pui32FaultStack[FAULT_STACK_SIZE];
+uint32_t * const g_pui32FaultStackTop = g_pui32FaultStack + FAULT_STACK_SIZE;
+
+// Command being executed. Set by the main loop.
+const char *g_pcFaultCmd;
+
+// A dump of the previous run is to be reported.
+bool g_bFaultReport;
+
+
+
+// Calculate the CRC-32 of the fault dump.
+uint32_t FaultCrc(void)
+{
+    return MAP_Crc32(0xffffffff, (const uint8_t *) &g_sFaultDump.ui32Version,
+                     sizeof(tFaultDump) - offsetof(tFaultDump, ui32Version)) ^ 0xffffffff;
+}
+
+
+
+// Check for a fault dump of the previous run and save it to the persistent
+// log. Call this after PlogInit.
+void FaultInit(void)
+{
+    tPlogFault sPlogFault;
+    uint32_t ui32Offset;
+
+    g_pcFaultCmd = NULL;
+    g_bFaultReport = false;
+    if ((g_sFaultDump.ui32Magic != FAULT_MAGIC_NEW) || (g_sFaultDump.ui32Crc != FaultCrc())) return;
+
+    g_bFaultReport = true;
+    sPlogFault.ui8PartNum = (sizeof(tFaultDump) + FAULT_PLOG_DATA_SIZE - 1) / FAULT_PLOG_DATA_SIZE;
+    sPlogFault.ui16Reserved = 0;
+    for (int i = 0; i < sPlogFault.ui8PartNum; i++) {
+        ui32Offset = i * FAULT_PLOG_DATA_SIZE;
+        memset(sPlogFault.pui8Data, 0, FAULT_PLOG_DATA_SIZE);
+        memcpy(sPlogFault.pui8Data, (uint8_t *) &g_sFaultDump + ui32Offset,
+               sizeof(tFaultDump) - ui32Offset < FAULT_PLOG_DATA_SIZE ? sizeof(tFaultDump) - ui32Offset : FAULT_PLOG_DATA_SIZE);
+        sPlogFault.ui8Part = i;
+        PlogWrite(PLOG_TYPE_FAULT, &sPlogFault, sizeof(sPlogFault));
+    }
+    // Keep the dump for the fault command, but do not save it again.
+    g_sFaultDump.ui32Magic = FAULT_MAGIC_SAVED;
+}
+
+
+
+// Capture the fault dump and reset the MCU. This is called by the fault
+// handlers with the stack frame of the exception and the EXC_RETURN value.
+void FaultCapture(uint32_t *pui32Frame, uint32_t ui32ExcReturn)
+{
+    tFaultDump *psDump = &g_sFaultDump;
+    uint32_t ui32Ipsr, ui32Head;
+    const uint32_t *pui32Sp;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ui32Ipsr));
+    memset(psDump, 0, sizeof(tFaultDump));
+    psDump->ui32Version = FAULT_FORMAT_VERSION;
+    psDump->ui32ExcReturn = ui32ExcReturn;
+    psDump->ui32Ipsr = ui32Ipsr & 0x1ff;
+    psDump->ui32Cfsr = HWREG(NVIC_FAULT_STAT);
+    psDump->ui32Hfsr = HWREG(NVIC_HFAULT_STAT);
+    psDump->ui32Mmfar = HWREG(NVIC_MM_ADDR);
+    psDump->ui32Bfar = HWREG(NVIC_FAULT_ADDR);
+    psDump->ui32Shcsr = HWREG(NVIC_SYS_HND_CTRL);
+    psDump->ui64UptimeUs = GetUptimeUs();
+
+    // The stack frame is only readable if the stack pointer was valid.
+    if (((uint32_t) pui32Frame >= FAULT_SRAM_START) && ((uint32_t) pui32Frame <= FAULT_SRAM_END - 8 * 4)) {
+        psDump->ui32R0 = pui32Frame[0];
+        psDump->ui32R1 = pui32Frame[1];
+        psDump->ui32R2 = pui32Frame[2];
+        psDump->ui32R3 = pui32Frame[3];
+        psDump->ui32R12 = pui32Frame[4];
+        psDump->ui32Lr = pui32Frame[5];
+        psDump->ui32Pc = pui32Frame[6];
+        psDump->ui32Xpsr = pui32Frame[7];
+        // Stack pointer before the exception: basic or extended frame and
+        // alignment padding.
+        pui32Sp = pui32Frame + 8;
+        if (!(ui32ExcReturn & 0x10)) {
+            psDump->ui32Flags |= FAULT_FLAG_FPU_FRAME;
+            pui32Sp += 18;
+        }
+        if (psDump->ui32Xpsr & 0x200) pui32Sp++;
+        psDump->ui32Sp = (uint32_t) pui32Sp;
+        for (int i = 0; (i < FAULT_STACK_DUMP_SIZE) && ((uint32_t) &pui32Sp[i] < FAULT_SRAM_END); i++) {
+            psDump->pui32Stack[i] = pui32Sp[i];
+        }
+    } else {
+        psDump->ui32Flags |= FAULT_FLAG_FRAME_INVALID;
+        psDump->ui32Sp = (uint32_t) pui32Frame;
+    }
+    if ((uint32_t) pui32Frame < (uint32_t) &_stack) psDump->ui32Flags |= FAULT_FLAG_STACK_OVERFLOW;
+
+    // Active command. It is located in the SRAM buffer of the main loop.
+    if (((uint32_t) g_pcFaultCmd >= FAULT_SRAM_START) && ((uint32_t) g_pcFaultCmd < FAULT_SRAM_END - FAULT_CMD_LEN)) {
+        strncpy(psDump->pcCmd, g_pcFaultCmd, FAULT_CMD_LEN - 1);
+    }
+
+    // Recent deferred log entries, oldest first.
+    ui32Head = g_sDlog.ui32Head;
+    for (int i = 0; i < FAULT_DLOG_NUM; i++) {
+        psDump->psDlog[i] = g_sDlog.psEntry[(ui32Head - FAULT_DLOG_NUM + i) & (DLOG_BUF_SIZE - 1)];
+    }
+
+    psDump->ui32Crc = FaultCrc();
+    psDump->ui32Magic = FAULT_MAGIC_NEW;
+
+    HWREG(NVIC_APINT) = NVIC_APINT_VECTKEY | NVIC_APINT_SYSRESETREQ;
+    while (1);
+}
+
+
+
+// Print the summary of the fault dump.
+void FaultPrint(void)
+{
+    tFaultDump *psDump = &g_sFaultDump;
+
+    UARTprintf("Fault dump: exception %d at uptime ", psDump->ui32Ipsr);
+    UARTprintf("%u.%06u s", (uint32_t) (psDump->ui64UptimeUs / 1000000), (uint32_t) (psDump->ui64UptimeUs % 1000000));
+    if (psDump->pcCmd[0]) UARTprintf(" during command `%s'", psDump->pcCmd);
+    UARTprintf(".\n");
+    if (psDump->ui32Flags & FAULT_FLAG_FRAME_INVALID) {
+        UARTprintf("  Stack frame not readable, SP = 0x%08x.\n", psDump->ui32Sp);
+    } else {
+        UARTprintf("  PC   = 0x%08x  LR   = 0x%08x  SP   = 0x%08x  xPSR = 0x%08x\n",
+                   psDump->ui32Pc, psDump->ui32Lr, psDump->ui32Sp, psDump->ui32Xpsr);
+        UARTprintf("  R0   = 0x%08x  R1   = 0x%08x  R2   = 0x%08x  R3   = 0x%08x  R12 = 0x%08x\n",
+                   psDump->ui32R0, psDump->ui32R1, psDump->ui32R2, psDump->ui32R3, psDump->ui32R12);
+    }
+    if (psDump->ui32Flags & FAULT_FLAG_STACK_OVERFLOW) UARTprintf("  The stack overflowed! Increase STACK_SIZE.\n");
+    UARTprintf("  CFSR = 0x%08x  HFSR = 0x%08x  MMFAR = 0x%08x  BFAR = 0x%08x\n",
+               psDump->ui32Cfsr, psDump->ui32Hfsr, psDump->ui32Mmfar, psDump->ui32Bfar);
+    UARTprintf("  Use `pyMcuFault.py' to decode the dump against the ELF file.");
+}
+
+
+
+// Report a fault dump of the previous run on the console.
+void FaultReport(void)
+{
+    if (!g_bFaultReport) return;
+    UARTprintf("\n%s: The MCU was reset after a fault!\n", UI_STR_WARNING);
+    FaultPrint();
+    UARTprintf("\n");
+}
+
+
+
+// Fault command.
+int FaultCmd(char *pcCmd, char *pcParam)
+{
+    bool bValid;
+
+    bValid = ((g_sFaultDump.ui32Magic == FAULT_MAGIC_NEW) || (g_sFaultDump.ui32Magic == FAULT_MAGIC_SAVED)) &&
+             (g_sFaultDump.ui32Crc == FaultCrc());
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "show")) {
+        if (!bValid) {
+            UARTprintf("%s: No fault dump available.", UI_STR_OK);
+            return 0;
+        }
+        UARTprintf("%s: ", UI_STR_OK);
+        FaultPrint();
+    } else if (!strcasecmp(pcParam, "help")) {
+        FaultHelp();
+    // Export the complete dump as hexadecimal string.
+    } else if (!strcasecmp(pcParam, "dump")) {
+        if (!bValid) {
+            UARTprintf("%s: No fault dump available.", UI_STR_ERROR);
+            return -1;
+        }
+        UARTprintf("%s: ", UI_STR_OK);
+        for (int i = 0; i < sizeof(tFaultDump) / 4; i++) {
+            TelemetryPrintHex(((uint32_t *) &g_sFaultDump)[i], 4);
+        }
+    } else if (!strcasecmp(pcParam, "clear")) {
+        g_sFaultDump.ui32Magic = 0;
+        UARTprintf("%s.", UI_STR_OK);
+    // Cause a bus fault by reading from a reserved address.
+    } else if (!strcasecmp(pcParam, "test")) {
+        UARTprintf("Causing a fault by reading from address 0xfffffff0.\n");
+        DelayUs(1e5);
+        bValid = *(volatile uint32_t *) 0xfffffff0;
+    } else {
+        UARTprintf("%s: Unknown fault command `%s'!\n", UI_STR_ERROR, pcParam);
+        FaultHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the fault command.
+void FaultHelp(void)
+{
+    UARTprintf("Available fault commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show the last fault dump (default).\n");
+    UARTprintf("  dump                                Export the last fault dump in binary format.\n");
+    UARTprintf("  clear                               Discard the last fault dump.\n");
+    UARTprintf("  test                                Cause a fault to test the capture.");
+}
@@ -0,0 +1,104 @@
+// File: fault.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the fault dump capture for the hardware test firmware running
+// on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __FAULT_H__
+#define __FAULT_H__
+
+
+
+// ******************************************************************
+// Fault dump parameters.
+// ******************************************************************
+
+// Version of the binary dump format. Increment on every change!
+#define FAULT_FORMAT_VERSION            1
+
+// Magic words of a new fault dump and of a dump already saved in the
+// persistent log.
+#define FAULT_MAGIC_NEW                 0x464c5431  // "FLT1"
+#define FAULT_MAGIC_SAVED               0x464c5453  // "FLTS"
+
+// Size of the stack used by the fault handler in words. The fault handler
+// switches to this stack, as the stack overflow may have caused the fault.
+#define FAULT_STACK_SIZE                64
+
+// Words of the stack before the exception and recent deferred log entries
+// stored in the dump.
+#define FAULT_STACK_DUMP_SIZE           32
+#define FAULT_DLOG_NUM                  8
+
+// Maximum length of the active command including the terminating zero.
+#define FAULT_CMD_LEN                   16
+
+// Data bytes of the dump per persistent log record.
+#define FAULT_PLOG_DATA_SIZE            40
+
+// Flags of the dump.
+#define FAULT_FLAG_FRAME_INVALID        0x01    // Stacked registers not readable.
+#define FAULT_FLAG_FPU_FRAME            0x02    // Extended frame with FPU registers.
+#define FAULT_FLAG_STACK_OVERFLOW       0x04    // Stack pointer below the stack.
+
+
+
+// Types.
+typedef struct {
+    uint32_t ui32Magic;
+    uint32_t ui32Crc;               // CRC-32 of all following bytes.
+    uint32_t ui32Version;
+    uint32_t ui32Flags;
+    uint32_t ui32R0;                // Registers stacked on exception entry.
+    uint32_t ui32R1;
+    uint32_t ui32R2;
+    uint32_t ui32R3;
+    uint32_t ui32R12;
+    uint32_t ui32Lr;
+    uint32_t ui32Pc;
+    uint32_t ui32Xpsr;
+    uint32_t ui32Sp;                // Stack pointer before the exception.
+    uint32_t ui32ExcReturn;
+    uint32_t ui32Ipsr;              // Number of the active exception.
+    uint32_t ui32Cfsr;
+    uint32_t ui32Hfsr;
+    uint32_t ui32Mmfar;
+    uint32_t ui32Bfar;
+    uint32_t ui32Shcsr;
+    uint64_t ui64UptimeUs;
+    char     pcCmd[FAULT_CMD_LEN];
+    uint32_t pui32Stack[FAULT_STACK_DUMP_SIZE];
+    tDlogEntry psDlog[FAULT_DLOG_NUM];
+} tFaultDump;
+
+// Persistent log data of a part of the fault dump.
+typedef struct {
+    uint8_t  ui8Part;
+    uint8_t  ui8PartNum;
+    uint16_t ui16Reserved;
+    uint8_t  pui8Data[FAULT_PLOG_DATA_SIZE];
+} tPlogFault;
+
+
+
+// Global variables.
+extern const char *g_pcFaultCmd;
+
+
+
+// Function prototypes.
+void FaultInit(void);
+void FaultReport(void);
+void FaultCapture(uint32_t *pui32Frame, uint32_t ui32ExcReturn);
+int FaultCmd(char *pcCmd, char *pcParam);
+void FaultHelp(void);
+
+
+
+#endif  // __FAULT_H__
@@ -0,0 +1,355 @@
+// File: fpga.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// FPGA configuration monitor for the hardware test firmware running on the
+// ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// A configuration starts with the release of PROG_B by the MCU, or with the
+// falling edge of INIT_B if the configuration was started otherwise, e.g. by
+// powering up the FPGA. The edges of INIT_B and DONE are timestamped by the
+// GPIO edge event capture. The statistics of the configuration times and
+// failures are kept in the EEPROM for trending across power cycles.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/eeprom.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sysctl.h"
+#include "utils/uartstdio.h"
+#include "hw/gpio/gpio.h"
+#include "hw/gpio/gpio_pins.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "dlog.h"
+#include "events.h"
+#include "fpga.h"
+#include "plog.h"
+#include "timestamp.h"
+
+
+
+// FPGAs. The pins are taken from the table generated from gpio_pins.txt.
+tFpga g_psFpga[FPGA_NUM] = {
+    {
+        "KU15P",
+        &g_psGpioPin[GPIO_SIG_KUP_PROG_B_3V3],
+        NULL,
+        &g_psGpioPin[GPIO_SIG_KUP_INIT_B_3V3],
+        &g_psGpioPin[GPIO_SIG_KUP_DONE_3V3],
+    },
+    {
+        "ZU11EG",
+        &g_psGpioPin[GPIO_SIG_ZUP_PS_PROG_B],
+        &g_psGpioPin[GPIO_SIG_ZUP_PS_nPOR],
+        &g_psGpioPin[GPIO_SIG_ZUP_PS_INIT_B],
+        &g_psGpioPin[GPIO_SIG_ZUP_PS_DONE],
+    }
+};
+
+// Configuration statistics.
+tFpgaStat g_psFpgaStat[FPGA_NUM];
+bool g_bFpgaEepromOk = false;
+
+// Names of the states and failure reasons.
+const char *g_ppcFpgaState[] = {"unconfigured", "clearing", "configuring", "configured", "failed"};
+const char *g_ppcFpgaFail[] = {"none", "INIT_B timeout", "DONE timeout", "INIT_B low"};
+
+
+
+// Clear the statistics of an FPGA.
+void FpgaStatClear(tFpgaStat *psStat)
+{
+    memset(psStat, 0, sizeof(tFpgaStat));
+    psStat->ui32Magic = FPGA_STAT_MAGIC;
+    psStat->ui32ConfigUsMin = UINT32_MAX;
+}
+
+
+
+// Store the statistics of an FPGA in the EEPROM.
+void FpgaStatSave(int iFpga)
+{
+    if (!g_bFpgaEepromOk) return;
+    EEPROMProgram((uint32_t *) &g_psFpgaStat[iFpga], EEPROM_ADDR_FPGA_STAT + iFpga * sizeof(tFpgaStat), sizeof(tFpgaStat));
+}
+
+
+
+// Initialize the FPGA configuration monitor.
+void FpgaInit(void)
+{
+    tFpga *psFpga;
+
+    // Load the statistics from the EEPROM.
+    MAP_SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    while (!MAP_SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0));
+    g_bFpgaEepromOk = (EEPROMInit() == EEPROM_INIT_OK);
+    if (g_bFpgaEepromOk) {
+        EEPROMRead((uint32_t *) g_psFpgaStat, EEPROM_ADDR_FPGA_STAT, sizeof(g_psFpgaStat));
+    }
+    for (int i = 0; i < FPGA_NUM; i++) {
+        if (g_psFpgaStat[i].ui32Magic != FPGA_STAT_MAGIC) {
+            FpgaStatClear(&g_psFpgaStat[i]);
+            FpgaStatSave(i);
+        }
+    }
+
+    // Get the current state.
+    for (int i = 0; i < FPGA_NUM; i++) {
+        psFpga = &g_psFpga[i];
+        psFpga->iInitSource = EventsSourceFind(psFpga->psInit->pcName);
+        psFpga->iDoneSource = EventsSourceFind(psFpga->psDone->pcName);
+        if (EventsSourceLevel(psFpga->iDoneSource) == 1) psFpga->ui32State = FPGA_STATE_CONFIGURED;
+        else psFpga->ui32State = FPGA_STATE_UNCONFIGURED;
+    }
+
+    EventsHookSet(FpgaEventHook);
+}
+
+
+
+// Abort a configuration. Must be called from an interrupt handler or with
+// interrupts masked.
+void FpgaFail(tFpga *psFpga, uint32_t ui32FailReason)
+{
+    psFpga->ui32State = FPGA_STATE_FAILED;
+    psFpga->ui32FailReason = ui32FailReason;
+    psFpga->bFinished = true;
+}
+
+
+
+// Track the configuration state with the edges of INIT_B and DONE. This is
+// called by the GPIO interrupt handlers.
+void FpgaEventHook(uint32_t ui32Source, uint8_t ui8Level, uint64_t ui64UptimeUs)
+{
+    tFpga *psFpga;
+
+    for (int i = 0; i < FPGA_NUM; i++) {
+        psFpga = &g_psFpga[i];
+        // INIT_B released: The configuration memory is cleared.
+        if ((ui32Source == psFpga->iInitSource) && ui8Level) {
+            if (psFpga->ui32State == FPGA_STATE_CLEARING) {
+                psFpga->ui64InitUs = ui64UptimeUs;
+                psFpga->ui32State = FPGA_STATE_CONFIGURING;
+            }
+        // INIT_B low: Start of a configuration or configuration error.
+        } else if (ui32Source == psFpga->iInitSource) {
+            if (psFpga->ui32State == FPGA_STATE_CONFIGURING) {
+                FpgaFail(psFpga, FPGA_FAIL_INIT_B_LOW);
+            } else if (psFpga->ui32State != FPGA_STATE_CLEARING) {
+                psFpga->ui64StartUs = ui64UptimeUs;
+                psFpga->ui64InitUs = 0;
+                psFpga->ui32State = FPGA_STATE_CLEARING;
+                psFpga->bTriggered = false;
+            }
+        // DONE asserted: Configuration finished.
+        } else if ((ui32Source == psFpga->iDoneSource) && ui8Level) {
+            if ((psFpga->ui32State == FPGA_STATE_CLEARING) || (psFpga->ui32State == FPGA_STATE_CONFIGURING)) {
+                psFpga->ui64DoneUs = ui64UptimeUs;
+                psFpga->ui32FailReason = FPGA_FAIL_NONE;
+                psFpga->bFinished = true;
+            }
+            psFpga->ui32State = FPGA_STATE_CONFIGURED;
+        // DONE deasserted.
+        } else if (ui32Source == psFpga->iDoneSource) {
+            if (psFpga->ui32State == FPGA_STATE_CONFIGURED) psFpga->ui32State = FPGA_STATE_UNCONFIGURED;
+        }
+    }
+}
+
+
+
+// Check the timeouts and update the statistics of finished configurations.
+// Returns the number of finished configurations.
+int FpgaPoll(void)
+{
+    tFpga *psFpga;
+    tFpgaStat *psStat;
+    uint64_t ui64UptimeUs = GetUptimeUs();
+    uint64_t ui64StartUs, ui64InitUs, ui64DoneUs;
+    uint32_t ui32State, ui32FailReason, ui32ConfigUs;
+    tPlogFpga sPlogFpga;
+    bool bIntMasked, bFinished;
+    int iFinished = 0;
+
+    for (int i = 0; i < FPGA_NUM; i++) {
+        psFpga = &g_psFpga[i];
+        bIntMasked = MAP_IntMasterDisable();
+        if ((psFpga->ui32State == FPGA_STATE_CLEARING) && (ui64UptimeUs > psFpga->ui64StartUs + FPGA_INIT_TIMEOUT_US)) {
+            // INIT_B stays low if the FPGA is powered down. This is only a
+            // failure if the MCU started the configuration.
+            if (psFpga->bTriggered) FpgaFail(psFpga, FPGA_FAIL_INIT_TIMEOUT);
+            else psFpga->ui32State = FPGA_STATE_UNCONFIGURED;
+        } else if ((psFpga->ui32State == FPGA_STATE_CONFIGURING) && (ui64UptimeUs > psFpga->ui64InitUs + FPGA_DONE_TIMEOUT_US)) {
+            FpgaFail(psFpga, FPGA_FAIL_DONE_TIMEOUT);
+        }
+        bFinished = psFpga->bFinished;
+        psFpga->bFinished = false;
+        ui32State = psFpga->ui32State;
+        ui32FailReason = psFpga->ui32FailReason;
+        ui64StartUs = psFpga->ui64StartUs;
+        ui64InitUs = psFpga->ui64InitUs;
+        ui64DoneUs = psFpga->ui64DoneUs;
+        if (!bIntMasked) MAP_IntMasterEnable();
+        if (!bFinished) continue;
+
+        // Update the statistics.
+        psStat = &g_psFpgaStat[i];
+        if (ui32State == FPGA_STATE_CONFIGURED) {
+            ui32ConfigUs = ui64DoneUs - ui64StartUs;
+            psStat->ui32Count++;
+            psStat->ui32InitUsLast = ui64InitUs ? ui64InitUs - ui64StartUs : 0;
+            psStat->ui32ConfigUsLast = ui32ConfigUs;
+            if (ui32ConfigUs < psStat->ui32ConfigUsMin) psStat->ui32ConfigUsMin = ui32ConfigUs;
+            if (ui32ConfigUs > psStat->ui32ConfigUsMax) psStat->ui32ConfigUsMax = ui32ConfigUs;
+            psStat->ui64ConfigUsSum += ui32ConfigUs;
+            DLOG("FPGA %d configured in %u us.", i, ui32ConfigUs);
+        } else {
+            psStat->ui32Failures++;
+            psStat->ui32FailReasonLast = ui32FailReason;
+            DLOG("FPGA %d configuration failed with reason %d.", i, ui32FailReason);
+        }
+        FpgaStatSave(i);
+        sPlogFpga.ui8Fpga = i;
+        sPlogFpga.ui8State = ui32State;
+        sPlogFpga.ui8FailReason = ui32FailReason;
+        sPlogFpga.ui8Reserved = 0;
+        sPlogFpga.ui32ConfigUs = ui32State == FPGA_STATE_CONFIGURED ? ui32ConfigUs : 0;
+        PlogWrite(PLOG_TYPE_FPGA, &sPlogFpga, sizeof(sPlogFpga));
+        iFinished++;
+    }
+
+    return iFinished;
+}
+
+
+
+// Start the configuration of an FPGA by pulsing PROG_B or POR_B low.
+int FpgaStart(tFpga *psFpga, const tGpioPin *psPin, uint32_t ui32PulseUs)
+{
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    psFpga->ui32State = FPGA_STATE_CLEARING;
+    psFpga->bTriggered = true;
+    psFpga->bFinished = false;
+    psFpga->ui64InitUs = 0;
+    GPIOPinWrite(psPin->ui32Port, psPin->ui8Pin, 0);
+    DelayUs(ui32PulseUs);
+    GPIOPinWrite(psPin->ui32Port, psPin->ui8Pin, psPin->ui8Pin);
+    psFpga->ui64StartUs = GetUptimeUs();
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    return 0;
+}
+
+
+
+// Show the state and the statistics of an FPGA.
+void FpgaShow(int iFpga)
+{
+    tFpga *psFpga = &g_psFpga[iFpga];
+    tFpgaStat *psStat = &g_psFpgaStat[iFpga];
+
+    UARTprintf("\n%s: %s, INIT_B = %d, DONE = %d.", psFpga->pcName, g_ppcFpgaState[psFpga->ui32State],
+               EventsSourceLevel(psFpga->iInitSource), EventsSourceLevel(psFpga->iDoneSource));
+    UARTprintf("\n  Configurations: %d, failures: %d", psStat->ui32Count, psStat->ui32Failures);
+    if (psStat->ui32Failures) UARTprintf(" (last: %s)", g_ppcFpgaFail[psStat->ui32FailReasonLast]);
+    UARTprintf(".");
+    if (!psStat->ui32Count) return;
+    UARTprintf("\n  Last configuration: INIT_B after ");
+    TimestampPrint(psStat->ui32InitUsLast);
+    UARTprintf(" s, DONE after ");
+    TimestampPrint(psStat->ui32ConfigUsLast);
+    UARTprintf(" s.\n  Configuration time: min ");
+    TimestampPrint(psStat->ui32ConfigUsMin);
+    UARTprintf(" s, mean ");
+    TimestampPrint(psStat->ui64ConfigUsSum / psStat->ui32Count);
+    UARTprintf(" s, max ");
+    TimestampPrint(psStat->ui32ConfigUsMax);
+    UARTprintf(" s.");
+}
+
+
+
+// FPGA command.
+int FpgaCmd(char *pcCmd, char *pcParam)
+{
+    char *pcAction;
+    tFpga *psFpga;
+    int iFpga;
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "status")) {
+        UARTprintf("%s: FPGA configuration monitor", UI_STR_OK);
+        if (!g_bFpgaEepromOk) UARTprintf(" (EEPROM not available, statistics not stored)");
+        UARTprintf(".");
+        for (int i = 0; i < FPGA_NUM; i++) FpgaShow(i);
+        return 0;
+    } else if (!strcasecmp(pcParam, "help")) {
+        FpgaHelp();
+        return 0;
+    } else if (!strcasecmp(pcParam, "clear")) {
+        for (int i = 0; i < FPGA_NUM; i++) {
+            FpgaStatClear(&g_psFpgaStat[i]);
+            FpgaStatSave(i);
+        }
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    } else if (!strcasecmp(pcParam, FPGA_CMD_KUP)) {
+        iFpga = FPGA_KUP;
+    } else if (!strcasecmp(pcParam, FPGA_CMD_ZUP)) {
+        iFpga = FPGA_ZUP;
+    } else {
+        UARTprintf("%s: Unknown FPGA command `%s'!\n", UI_STR_ERROR, pcParam);
+        FpgaHelp();
+        return -1;
+    }
+
+    psFpga = &g_psFpga[iFpga];
+    pcAction = strtok(NULL, UI_STR_DELIMITER);
+    if ((pcAction == NULL) || !strcasecmp(pcAction, "status")) {
+        UARTprintf("%s: FPGA configuration monitor.", UI_STR_OK);
+        FpgaShow(iFpga);
+    } else if (!strcasecmp(pcAction, "prog")) {
+        FpgaStart(psFpga, psFpga->psProg, FPGA_PROG_B_PULSE_US);
+        UARTprintf("%s: Configuration of the %s started by pulsing PROG_B.", UI_STR_OK, psFpga->pcName);
+    } else if (!strcasecmp(pcAction, "por") && (psFpga->psPor != NULL)) {
+        FpgaStart(psFpga, psFpga->psPor, FPGA_POR_B_PULSE_US);
+        UARTprintf("%s: Configuration of the %s started by pulsing POR_B.", UI_STR_OK, psFpga->pcName);
+    } else {
+        UARTprintf("%s: Unknown action `%s' for the %s!\n", UI_STR_ERROR, pcAction, psFpga->pcName);
+        FpgaHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the FPGA command.
+void FpgaHelp(void)
+{
+    UARTprintf("Available FPGA commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  status                              Show the configuration state and statistics\n");
+    UARTprintf("                                          of all FPGAs (default).\n");
+    UARTprintf("  clear                               Clear the configuration statistics.\n");
+    UARTprintf("  kup|zup [status]                    Show the state and statistics of an FPGA.\n");
+    UARTprintf("  kup|zup prog                        Reconfigure an FPGA by pulsing PROG_B.\n");
+    UARTprintf("  zup por                             Reset the ZU11EG PS by pulsing PS_POR_B.");
+}
@@ -0,0 +1,103 @@
+// File: fpga.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the FPGA configuration monitor for the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __FPGA_H__
+#define __FPGA_H__
+
+
+
+// ******************************************************************
+// FPGA configuration monitor parameters.
+// ******************************************************************
+
+// FPGAs.
+#define FPGA_KUP                        0
+#define FPGA_ZUP                        1
+#define FPGA_NUM                        2
+
+// Width of the PROG_B pulse in us. The minimum T_PROGRAM of the UltraScale+
+// devices is 250 ns.
+#define FPGA_PROG_B_PULSE_US            10
+// Width of the PS_POR_B pulse of the ZU11EG in us.
+#define FPGA_POR_B_PULSE_US             100
+
+// Timeouts for the release of INIT_B after the start of the configuration and
+// for the assertion of DONE after the release of INIT_B.
+#define FPGA_INIT_TIMEOUT_US            1000000
+#define FPGA_DONE_TIMEOUT_US            60000000
+
+// Configuration states.
+#define FPGA_STATE_UNCONFIGURED         0
+#define FPGA_STATE_CLEARING             1   // Waiting for the release of INIT_B.
+#define FPGA_STATE_CONFIGURING          2   // Waiting for DONE.
+#define FPGA_STATE_CONFIGURED           3
+#define FPGA_STATE_FAILED               4
+
+// Failure reasons.
+#define FPGA_FAIL_NONE                  0
+#define FPGA_FAIL_INIT_TIMEOUT          1
+#define FPGA_FAIL_DONE_TIMEOUT          2
+#define FPGA_FAIL_INIT_B_LOW            3   // E.g. CRC error.
+
+// Magic word of the statistics stored in the EEPROM. Change it when changing
+// the tFpgaStat type!
+#define FPGA_STAT_MAGIC                 0x46504731  // "FPG1"
+
+// Names of the FPGAs in the fpga command.
+#define FPGA_CMD_KUP                    "kup"
+#define FPGA_CMD_ZUP                    "zup"
+
+
+
+// Types.
+// Configuration statistics. They are kept in the EEPROM across power cycles.
+typedef struct {
+    uint32_t ui32Magic;
+    uint32_t ui32Count;             // Successful configurations.
+    uint32_t ui32Failures;
+    uint32_t ui32FailReasonLast;
+    uint32_t ui32InitUsLast;        // Time from start until INIT_B release.
+    uint32_t ui32ConfigUsLast;      // Time from start until DONE.
+    uint32_t ui32ConfigUsMin;
+    uint32_t ui32ConfigUsMax;
+    uint64_t ui64ConfigUsSum;
+} tFpgaStat;
+
+typedef struct {
+    char     *pcName;
+    const tGpioPin *psProg;         // PROG_B output.
+    const tGpioPin *psPor;          // Optional POR_B output. NULL = none.
+    const tGpioPin *psInit;         // Event sources of INIT_B and DONE.
+    const tGpioPin *psDone;
+    int      iInitSource;
+    int      iDoneSource;
+    volatile uint32_t ui32State;
+    volatile uint32_t ui32FailReason;
+    volatile uint64_t ui64StartUs;
+    volatile uint64_t ui64InitUs;
+    volatile uint64_t ui64DoneUs;
+    volatile bool bTriggered;       // Configuration started by the MCU.
+    volatile bool bFinished;        // Configuration finished, statistics not yet updated.
+} tFpga;
+
+
+
+// Function prototypes.
+void FpgaInit(void);
+void FpgaEventHook(uint32_t ui32Source, uint8_t ui8Level, uint64_t ui64UptimeUs);
+int FpgaPoll(void);
+int FpgaCmd(char *pcCmd, char *pcParam);
+void FpgaHelp(void);
+
+
+
+#endif  // __FPGA_H__
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# File: fw_slot.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 18 Oct 2026
+# Rev.: 18 Oct 2026
+#
+# Python script to fill in the image header of the firmware running on the
+# ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU. The binary image
+# starts with the header (tFwSlotHeader in fw_slot.h), which holds only the
+# magic number after linking. The version, the length and the CRC32 of the
+# image after the header are filled in.
+#
+
+
+
+# System modules.
+import struct
+import sys
+import time
+import zlib
+
+
+
+# Message prefixes and separators.
+prefixError             = "ERROR: {0:s}: ".format(__file__)
+prefixDebug             = "DEBUG: {0:s}: ".format(__file__)
+
+# Image header (fw_slot.h).
+slotMagic               = 0x57464d43
+slotHeaderSize          = 0x400
+slotSize                = 0x74000
+
+
+
+# Fill in the image header. Returns the image.
+def fill_header(image, version):
+    magic, = struct.unpack_from("<I", image, 0)
+    if len(image) < slotHeaderSize + 8 or magic != slotMagic:
+        raise ValueError("No image header found.")
+    # The boot loader checks the CRC word by word.
+    image += b'\xff' * (-len(image) % 4)
+    if len(image) > slotSize:
+        raise ValueError("The image of {0:d} bytes does not fit into a slot of {1:d} bytes.".format(len(image), slotSize))
+    length = len(image) - slotHeaderSize
+    crc = zlib.crc32(image[slotHeaderSize:]) & 0xffffffff
+    return image[:4] + struct.pack("<III", version, length, crc) + image[16:]
+
+
+
+if __name__ == "__main__":
+    # Command line arguments.
+    import argparse
+    parser = argparse.ArgumentParser(description='Fill in the image header of the firmware.')
+    parser.add_argument('binFileName', action='store', type=str, metavar='BIN_FILE',
+                        help='Binary image with the empty image header.')
+    parser.add_argument('-o', '--output', action='store', type=str,
+                        dest='outFileName', required=True, metavar='IMAGE_FILE',
+                        help='Image with the filled in header.')
+    parser.add_argument('-V', '--image-version', action='store', type=lambda x: int(x, 0),
+                        dest='version', default=None, metavar='VERSION',
+                        help='Image version. The boot loader starts the valid slot with the highest version. The default is the current time in seconds since the epoch.')
+    parser.add_argument('-v', '--verbosity', action='store', type=int,
+                        dest='verbosity', default="1", choices=range(0, 5),
+                        help='Set the verbosity level. The default is 1.')
+    args = parser.parse_args()
+
+    version = args.version if args.version is not None else int(time.time())
+    try:
+        with open(args.binFileName, "rb") as f:
+            image = fill_header(f.read(), version)
+        with open(args.outFileName, "wb") as f:
+            f.write(image)
+    except (OSError, ValueError, struct.error) as e:
+        print(prefixError + "Error creating the image `{0:s}': {1:s}".format(args.outFileName, str(e)))
+        sys.exit(-1)
+    if args.verbosity >= 1:
+        print("Image `{0:s}': version {1:d}, {2:d} bytes.".format(args.outFileName, version, len(image) - slotHeaderSize))
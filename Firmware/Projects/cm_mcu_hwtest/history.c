@@ -0,0 +1,333 @@
+// File: history.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Telemetry history for the hardware test firmware running on the ATLAS MDT
+// Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The telemetry cache is sampled once per second into ring buffers in SRAM.
+// Each tier has its own accumulators, so the min/max/mean values of the coarser
+// tiers are calculated exactly from the 1 second samples.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "utils/uartstdio.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "telemetry.h"
+#include "history.h"
+#include "plog.h"
+
+
+
+// History data.
+int16_t g_pi16HistoryTier0[HISTORY_TIER0_SIZE * TELEMETRY_CH_NUM];
+int16_t g_pi16HistoryTier1[HISTORY_TIER1_SIZE * TELEMETRY_CH_NUM * HISTORY_VAL_NUM];
+int16_t g_pi16HistoryTier2[HISTORY_TIER2_SIZE * TELEMETRY_CH_NUM * HISTORY_VAL_NUM];
+
+// History tiers.
+tHistoryTier g_psHistoryTier[HISTORY_TIER_NUM] = {
+    {"1s",  HISTORY_TIER0_PERIOD, HISTORY_TIER0_SIZE, 1,               g_pi16HistoryTier0},
+    {"1m",  HISTORY_TIER1_PERIOD, HISTORY_TIER1_SIZE, HISTORY_VAL_NUM, g_pi16HistoryTier1},
+    {"15m", HISTORY_TIER2_PERIOD, HISTORY_TIER2_SIZE, HISTORY_VAL_NUM, g_pi16HistoryTier2},
+};
+
+// History time in s and uptime in ms of the last sample.
+uint32_t g_ui32HistoryTimeS;
+uint32_t g_ui32HistoryLastMs;
+
+
+
+// Reset the accumulator of a tier for one channel.
+void HistoryAccuReset(tHistoryAccu *psAccu)
+{
+    psAccu->i32Min = INT32_MAX;
+    psAccu->i32Max = INT32_MIN;
+    psAccu->i32Sum = 0;
+    psAccu->ui32Cnt = 0;
+}
+
+
+
+// Initialize the history.
+void HistoryInit(void)
+{
+    tHistoryTier *psTier;
+
+    for (int i = 0; i < HISTORY_TIER_NUM; i++) {
+        psTier = &g_psHistoryTier[i];
+        psTier->ui32Head = 0;
+        psTier->ui32Count = 0;
+        psTier->ui32TimeS = 0;
+        for (int j = 0; j < TELEMETRY_CH_NUM; j++) {
+            HistoryAccuReset(&psTier->psAccu[j]);
+        }
+    }
+    g_ui32HistoryTimeS = 0;
+    g_ui32HistoryLastMs = GetUptimeMs();
+}
+
+
+
+// Store the accumulated values of a tier as new entry.
+void HistoryTierPush(tHistoryTier *psTier)
+{
+    tHistoryAccu *psAccu;
+    int16_t *pi16Entry;
+
+    pi16Entry = psTier->pi16Data + psTier->ui32Head * TELEMETRY_CH_NUM * psTier->ui32ValNum;
+    for (int i = 0; i < TELEMETRY_CH_NUM; i++) {
+        psAccu = &psTier->psAccu[i];
+        if (psAccu->ui32Cnt) {
+            pi16Entry[HISTORY_VAL_MEAN] = psAccu->i32Sum / (int32_t) psAccu->ui32Cnt;
+            if (psTier->ui32ValNum > HISTORY_VAL_MIN) pi16Entry[HISTORY_VAL_MIN] = psAccu->i32Min;
+            if (psTier->ui32ValNum > HISTORY_VAL_MAX) pi16Entry[HISTORY_VAL_MAX] = psAccu->i32Max;
+        } else {
+            for (int j = 0; j < psTier->ui32ValNum; j++) {
+                pi16Entry[j] = HISTORY_INVALID;
+            }
+        }
+        HistoryAccuReset(psAccu);
+        pi16Entry += psTier->ui32ValNum;
+    }
+    // Keep the maximum values of the coarsest tier in the persistent log.
+    if (psTier == &g_psHistoryTier[HISTORY_TIER_NUM - 1]) {
+        pi16Entry = psTier->pi16Data + psTier->ui32Head * TELEMETRY_CH_NUM * psTier->ui32ValNum;
+        PlogTelemetry(pi16Entry + HISTORY_VAL_MAX, psTier->ui32ValNum);
+    }
+    psTier->ui32Head = (psTier->ui32Head + 1) % psTier->ui32Size;
+    if (psTier->ui32Count < psTier->ui32Size) psTier->ui32Count++;
+    psTier->ui32TimeS = g_ui32HistoryTimeS;
+}
+
+
+
+// Add a 1 second sample of the telemetry cache to all tiers. If bValid is
+// false, the sample is recorded as missing, e.g. for seconds during which the
+// main loop was blocked.
+void HistorySample(bool bValid)
+{
+    tTelemetryValue *psValue;
+    tHistoryAccu *psAccu;
+    uint32_t ui32Now = GetUptimeMs();
+    int32_t i32Value;
+
+    g_ui32HistoryTimeS++;
+    for (int i = 0; i < TELEMETRY_CH_NUM; i++) {
+        psValue = &g_sTelemetryCache.psValue[i];
+        if (!bValid || !(psValue->ui8Flags & TELEMETRY_FLAG_VALID) ||
+            (ui32Now - psValue->ui32Timestamp > HISTORY_MAX_AGE_MS)) continue;
+        // Limit the value to the int16_t range without the invalid marker.
+        i32Value = psValue->i32Value;
+        if (i32Value > INT16_MAX) i32Value = INT16_MAX;
+        if (i32Value <= HISTORY_INVALID) i32Value = HISTORY_INVALID + 1;
+        for (int j = 0; j < HISTORY_TIER_NUM; j++) {
+            psAccu = &g_psHistoryTier[j].psAccu[i];
+            if (i32Value < psAccu->i32Min) psAccu->i32Min = i32Value;
+            if (i32Value > psAccu->i32Max) psAccu->i32Max = i32Value;
+            psAccu->i32Sum += i32Value;
+            psAccu->ui32Cnt++;
+        }
+    }
+    for (int j = 0; j < HISTORY_TIER_NUM; j++) {
+        if (!(g_ui32HistoryTimeS % g_psHistoryTier[j].ui32PeriodS)) {
+            HistoryTierPush(&g_psHistoryTier[j]);
+        }
+    }
+}
+
+
+
+// Take a sample once per second. Returns 1 if a sample was taken.
+int HistoryPoll(void)
+{
+    uint32_t ui32Now = GetUptimeMs();
+
+    if (ui32Now - g_ui32HistoryLastMs < 1000) return 0;
+    // Record the seconds missed, e.g. during a long command, as invalid.
+    while (ui32Now - g_ui32HistoryLastMs >= 2000) {
+        g_ui32HistoryLastMs += 1000;
+        HistorySample(false);
+    }
+    g_ui32HistoryLastMs += 1000;
+    HistorySample(true);
+
+    return 1;
+}
+
+
+
+// Send a byte of the binary export as hexadecimal string. A new line is started
+// after every HISTORY_EXPORT_LINE_BYTES bytes.
+static void HistoryPrintByte(uint8_t ui8Value, uint32_t *pui32Bytes)
+{
+    if (*pui32Bytes % HISTORY_EXPORT_LINE_BYTES == 0) UARTprintf("\n");
+    UARTprintf("%02x", ui8Value);
+    (*pui32Bytes)++;
+}
+
+
+
+// Send an unsigned value as variable length quantity (7 bits per byte, least
+// significant group first, bit 7 set if more bytes follow).
+void HistoryPrintVarint(uint32_t ui32Value, uint32_t *pui32Bytes)
+{
+    while (ui32Value >= 0x80) {
+        HistoryPrintByte((ui32Value & 0x7f) | 0x80, pui32Bytes);
+        ui32Value >>= 7;
+    }
+    HistoryPrintByte(ui32Value, pui32Bytes);
+}
+
+
+
+// Export a window of the history in binary format. The binary data are sent as
+// hexadecimal string to keep the UART UI line based. The header is sent on the
+// status line, the entries follow on lines of HISTORY_EXPORT_LINE_BYTES bytes.
+// The header is little endian:
+// - uint8_t  format version (HISTORY_FORMAT_VERSION)
+// - uint8_t  tier
+// - uint8_t  values per entry (mean[, min, max])
+// - uint8_t  first channel
+// - uint8_t  number of channels
+// - uint16_t number of entries
+// - uint32_t period of an entry in s
+// - uint32_t history time in s of the newest entry
+// - uint32_t current history time in s
+// For each channel and value, the entries follow from oldest to newest as
+// varint of (zigzag(value - previous value) + 1). A code of 0 marks a missing
+// entry, which does not change the previous value. The first previous value
+// is 0.
+void HistoryExport(uint32_t ui32Tier, uint32_t ui32ChFirst, uint32_t ui32ChNum, uint32_t ui32Count)
+{
+    tHistoryTier *psTier = &g_psHistoryTier[ui32Tier];
+    uint32_t ui32Start, ui32Idx, ui32Code;
+    uint32_t ui32Bytes = 0;
+    int32_t i32Value, i32Prev, i32Delta;
+
+    if (ui32Count > psTier->ui32Count) ui32Count = psTier->ui32Count;
+    ui32Start = (psTier->ui32Head + psTier->ui32Size - ui32Count) % psTier->ui32Size;
+
+    UARTprintf("%s: ", UI_STR_OK);
+    TelemetryPrintHex(HISTORY_FORMAT_VERSION, 1);
+    TelemetryPrintHex(ui32Tier, 1);
+    TelemetryPrintHex(psTier->ui32ValNum, 1);
+    TelemetryPrintHex(ui32ChFirst, 1);
+    TelemetryPrintHex(ui32ChNum, 1);
+    TelemetryPrintHex(ui32Count, 2);
+    TelemetryPrintHex(psTier->ui32PeriodS, 4);
+    TelemetryPrintHex(psTier->ui32TimeS, 4);
+    TelemetryPrintHex(g_ui32HistoryTimeS, 4);
+    for (uint32_t ui32Ch = ui32ChFirst; ui32Ch < ui32ChFirst + ui32ChNum; ui32Ch++) {
+        for (uint32_t ui32Val = 0; ui32Val < psTier->ui32ValNum; ui32Val++) {
+            i32Prev = 0;
+            for (uint32_t i = 0; i < ui32Count; i++) {
+                ui32Idx = (ui32Start + i) % psTier->ui32Size;
+                i32Value = psTier->pi16Data[(ui32Idx * TELEMETRY_CH_NUM + ui32Ch) * psTier->ui32ValNum + ui32Val];
+                if (i32Value == HISTORY_INVALID) {
+                    ui32Code = 0;
+                } else {
+                    i32Delta = i32Value - i32Prev;
+                    ui32Code = (((uint32_t) i32Delta << 1) ^ (uint32_t) (i32Delta >> 31)) + 1;
+                    i32Prev = i32Value;
+                }
+                HistoryPrintVarint(ui32Code, &ui32Bytes);
+            }
+        }
+    }
+}
+
+
+
+// Show the status of the history.
+void HistoryStatus(void)
+{
+    tHistoryTier *psTier;
+
+    UARTprintf("%s: History time: %u s.", UI_STR_OK, g_ui32HistoryTimeS);
+    for (int i = 0; i < HISTORY_TIER_NUM; i++) {
+        psTier = &g_psHistoryTier[i];
+        UARTprintf(" Tier %d (%s): %d of %d entries.", i, psTier->pcName, psTier->ui32Count, psTier->ui32Size);
+    }
+}
+
+
+
+// History command.
+int HistoryCmd(char *pcCmd, char *pcParam)
+{
+    uint32_t ui32Tier, ui32ChFirst, ui32ChNum, ui32Count;
+    char *pcTier, *pcCh, *pcCount;
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "status")) {
+        HistoryStatus();
+        return 0;
+    } else if (!strcasecmp(pcParam, "help")) {
+        HistoryHelp();
+        return 0;
+    } else if (!strcasecmp(pcParam, "clear")) {
+        HistoryInit();
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    } else if (strcasecmp(pcParam, "read")) {
+        UARTprintf("%s: Unknown history command `%s'!\n", UI_STR_ERROR, pcParam);
+        HistoryHelp();
+        return -1;
+    }
+
+    // Read a window of the history.
+    pcTier = strtok(NULL, UI_STR_DELIMITER);
+    pcCh = strtok(NULL, UI_STR_DELIMITER);
+    pcCount = strtok(NULL, UI_STR_DELIMITER);
+    if ((pcTier == NULL) || (pcCh == NULL)) {
+        UARTprintf("%s: Tier and channel required after command `%s %s'.", UI_STR_ERROR, pcCmd, pcParam);
+        return -1;
+    }
+    for (ui32Tier = 0; ui32Tier < HISTORY_TIER_NUM; ui32Tier++) {
+        if (!strcasecmp(pcTier, g_psHistoryTier[ui32Tier].pcName)) break;
+    }
+    if (ui32Tier >= HISTORY_TIER_NUM) {
+        UARTprintf("%s: Unknown history tier `%s'!", UI_STR_ERROR, pcTier);
+        return -1;
+    }
+    if (!strcasecmp(pcCh, "all")) {
+        ui32ChFirst = 0;
+        ui32ChNum = TELEMETRY_CH_NUM;
+    } else {
+        ui32ChFirst = strtoul(pcCh, (char **) NULL, 0);
+        ui32ChNum = 1;
+        if (ui32ChFirst >= TELEMETRY_CH_NUM) {
+            UARTprintf("%s: Channel %d out of valid range 0..%d!", UI_STR_ERROR, ui32ChFirst, TELEMETRY_CH_NUM - 1);
+            return -1;
+        }
+    }
+    if (pcCount == NULL) {
+        ui32Count = g_psHistoryTier[ui32Tier].ui32Size;
+    } else {
+        ui32Count = strtoul(pcCount, (char **) NULL, 0);
+    }
+    HistoryExport(ui32Tier, ui32ChFirst, ui32ChNum, ui32Count);
+
+    return 0;
+}
+
+
+
+// Show help on the history command.
+void HistoryHelp(void)
+{
+    UARTprintf("Available history commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  status                              Show the history status (default).\n");
+    UARTprintf("  clear                               Clear the history.\n");
+    UARTprintf("  read    TIER CH|all [COUNT]         Export the latest COUNT entries of a tier\n");
+    UARTprintf("                                          (1s, 1m, 15m) in binary format.");
+}
@@ -0,0 +1,86 @@
+// File: history.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the telemetry history for the hardware test firmware running
+// on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+
+
+// ******************************************************************
+// History parameters.
+// ******************************************************************
+
+// Version of the binary export format. Increment on every change!
+#define HISTORY_FORMAT_VERSION          1
+
+// Tiers of the history. Tier 0 holds the 1 second samples, the coarser tiers
+// hold the min/max/mean aggregation of the 1 second samples.
+// CAUTION: The SRAM usage is (sizes * values per entry * 2 bytes * number of
+//          telemetry channels), currently about 93 kB.
+#define HISTORY_TIER_NUM                3
+#define HISTORY_TIER0_PERIOD            1       // 1 s for 10 minutes.
+#define HISTORY_TIER0_SIZE              600
+#define HISTORY_TIER1_PERIOD            60      // 1 min for 4 hours.
+#define HISTORY_TIER1_SIZE              240
+#define HISTORY_TIER2_PERIOD            900     // 15 min for 24 hours.
+#define HISTORY_TIER2_SIZE              96
+
+// Values per entry.
+#define HISTORY_VAL_MEAN                0
+#define HISTORY_VAL_MIN                 1
+#define HISTORY_VAL_MAX                 2
+#define HISTORY_VAL_NUM                 3
+
+// Marker for missing or invalid samples.
+#define HISTORY_INVALID                 INT16_MIN
+
+// Maximum age of a telemetry value to be recorded in the history.
+#define HISTORY_MAX_AGE_MS              10000
+
+// Bytes per line of the binary export. The hexadecimal lines must not exceed
+// the maximum line length of the host (100 characters).
+#define HISTORY_EXPORT_LINE_BYTES       48
+
+
+
+// Types.
+typedef struct {
+    int32_t  i32Min;
+    int32_t  i32Max;
+    int32_t  i32Sum;
+    uint32_t ui32Cnt;
+} tHistoryAccu;
+
+typedef struct {
+    char     *pcName;
+    uint32_t ui32PeriodS;           // Period of an entry in s.
+    uint32_t ui32Size;              // Number of entries.
+    uint32_t ui32ValNum;            // Values per entry and channel.
+    int16_t  *pi16Data;             // Entries: [ui32Size][TELEMETRY_CH_NUM][ui32ValNum]
+    uint32_t ui32Head;              // Index of the next entry to write.
+    uint32_t ui32Count;             // Number of stored entries.
+    uint32_t ui32TimeS;             // History time in s of the newest entry.
+    tHistoryAccu psAccu[TELEMETRY_CH_NUM];
+} tHistoryTier;
+
+
+
+// Function prototypes.
+void HistoryInit(void);
+int HistoryPoll(void);
+void HistorySample(bool bValid);
+int HistoryCmd(char *pcCmd, char *pcParam);
+void HistoryHelp(void);
+
+
+
+#endif  // __HISTORY_H__
@@ -0,0 +1,122 @@
+// File: mem.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Memory usage and stack high-water mark for the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "utils/uartstdio.h"
+#include "cm_mcu_hwtest.h"
+#include "mem.h"
+
+
+
+// Sections of the flash and the SRAM (linker script).
+extern uint32_t _text;
+extern uint32_t _etext;
+extern uint32_t _data;
+extern uint32_t _edata;
+extern uint32_t _bss;
+extern uint32_t _ebss;
+extern uint32_t _stack;
+extern uint32_t _estack;
+extern uint32_t _sram_end;
+
+
+
+// Get the current stack pointer.
+static inline uint32_t MemStackPointer(void)
+{
+    uint32_t ui32Sp;
+
+    __asm volatile ("mov %0, sp" : "=r" (ui32Sp));
+
+    return ui32Sp;
+}
+
+
+
+// Get the maximum stack usage in bytes since the reset or the last `mem reset'.
+uint32_t MemStackUsed(void)
+{
+    uint32_t *pui32Addr = &_stack;
+
+    while ((pui32Addr < &_estack) && (*pui32Addr == MEM_STACK_PAINT)) pui32Addr++;
+
+    return (uint32_t) &_estack - (uint32_t) pui32Addr;
+}
+
+
+
+// Paint the unused stack again to restart the high-water mark measurement.
+// Interrupts are masked, as their stack frames are placed below the current
+// stack pointer.
+void MemStackReset(void)
+{
+    uint32_t *pui32Addr;
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    for (pui32Addr = &_stack; (uint32_t) pui32Addr < MemStackPointer() - MEM_STACK_MARGIN * 4; pui32Addr++) {
+        *pui32Addr = MEM_STACK_PAINT;
+    }
+    if (!bIntMasked) MAP_IntMasterEnable();
+}
+
+
+
+// Memory usage command.
+int MemCmd(char *pcCmd, char *pcParam)
+{
+    uint32_t ui32StackSize, ui32StackUsed, ui32StackCur;
+
+    if ((pcParam != NULL) && !strcasecmp(pcParam, "help")) {
+        MemHelp();
+        return 0;
+    } else if ((pcParam != NULL) && strcasecmp(pcParam, "show") && strcasecmp(pcParam, "reset")) {
+        UARTprintf("%s: Unknown mem command `%s'!\n", UI_STR_ERROR, pcParam);
+        MemHelp();
+        return -1;
+    }
+
+    ui32StackSize = (uint32_t) &_estack - (uint32_t) &_stack;
+    ui32StackUsed = MemStackUsed();
+    ui32StackCur = (uint32_t) &_estack - MemStackPointer();
+    UARTprintf("%s: Memory usage in bytes:\n", UI_STR_OK);
+    UARTprintf("  .text  %6d  (flash)\n", (uint32_t) &_etext - (uint32_t) &_text);
+    UARTprintf("  .data  %6d\n", (uint32_t) &_edata - (uint32_t) &_data);
+    UARTprintf("  .bss   %6d\n", (uint32_t) &_ebss - (uint32_t) &_bss);
+    UARTprintf("  stack  %6d  high-water mark %d (%d %%), current %d\n", ui32StackSize,
+               ui32StackUsed, ui32StackUsed * 100 / ui32StackSize, ui32StackCur);
+    UARTprintf("  free   %6d", (uint32_t) &_sram_end - (uint32_t) &_ebss);
+    if (ui32StackUsed >= ui32StackSize) {
+        UARTprintf("\n%s: The stack overflowed! Increase STACK_SIZE.", UI_STR_WARNING);
+    }
+    if ((pcParam != NULL) && !strcasecmp(pcParam, "reset")) MemStackReset();
+
+    return 0;
+}
+
+
+
+// Show help on the mem command.
+void MemHelp(void)
+{
+    UARTprintf("Available mem commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show the memory usage (default).\n");
+    UARTprintf("  reset                               Show and reset the stack high-water mark.");
+}
@@ -0,0 +1,39 @@
+// File: mem.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the memory usage and stack high-water mark for the hardware
+// test firmware running on the ATLAS MDT Trigger Processor (TP) Command Module
+// (CM) MCU.
+//
+
+
+
+#ifndef __MEM_H__
+#define __MEM_H__
+
+
+
+// ******************************************************************
+// Memory usage parameters.
+// ******************************************************************
+
+// Pattern of the unused stack. It must match the pattern in ResetISR of
+// startup_gcc.c.
+#define MEM_STACK_PAINT                 0xa5a5a5a5
+
+// Words below the current stack pointer not painted again by `mem reset'.
+#define MEM_STACK_MARGIN                16
+
+
+
+// Function prototypes.
+uint32_t MemStackUsed(void);
+int MemCmd(char *pcCmd, char *pcParam);
+void MemHelp(void);
+
+
+
+#endif  // __MEM_H__
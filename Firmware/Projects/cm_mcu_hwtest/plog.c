@@ -0,0 +1,355 @@
+// File: plog.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Persistent log in the internal flash for the hardware test firmware running
+// on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The log is an append-only ring of fixed size records in the flash sectors
+// reserved at FLASH_ADDR_PLOG. Each record is protected by a CRC-32 and has a
+// sequence number, so the newest record is found again after a reset. When
+// the ring wraps, the sector with the oldest records is erased. All sectors
+// are therefore erased equally often. Records are queued in SRAM by
+// PlogWrite, which is safe in interrupt handlers, and written to the flash in
+// the background by PlogPoll.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "driverlib/flash.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sw_crc.h"
+#include "driverlib/sysctl.h"
+#include "utils/uartstdio.h"
+#include "hw/gpio/gpio.h"
+#include "fw_slot.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "fpga.h"
+#include "plog.h"
+#include "telemetry.h"
+#include "timestamp.h"
+
+
+
+// Record in the flash.
+#define PLOG_RECORD(i)                  ((const tPlogRecord *) (FLASH_ADDR_PLOG + (i) * PLOG_RECORD_SIZE))
+
+// Queue of records to be written.
+tPlogRecord g_psPlogQueue[PLOG_QUEUE_SIZE];
+volatile uint32_t g_ui32PlogQueueHead;
+volatile uint32_t g_ui32PlogQueueTail;
+uint32_t g_ui32PlogQueueLost;
+
+// Index of the next record in the flash, next sequence number and boot counter.
+uint32_t g_ui32PlogNext;
+uint32_t g_ui32PlogSeq;
+uint16_t g_ui16PlogBoot;
+uint32_t g_ui32PlogErrors;
+
+
+
+// Calculate the CRC-32 of a record (same as zlib.crc32).
+uint32_t PlogCrc(const tPlogRecord *psRecord)
+{
+    return MAP_Crc32(0xffffffff, (const uint8_t *) psRecord, offsetof(tPlogRecord, ui32Crc)) ^ 0xffffffff;
+}
+
+
+
+// Check if a record was written completely.
+bool PlogValid(const tPlogRecord *psRecord)
+{
+    return (psRecord->ui32Seq != PLOG_SEQ_BLANK) && (psRecord->ui32Crc == PlogCrc(psRecord));
+}
+
+
+
+// Check if a flash area is erased.
+bool PlogBlank(const void *pvAddr, uint32_t ui32Size)
+{
+    const uint32_t *pui32Addr = pvAddr;
+
+    for (int i = 0; i < ui32Size / 4; i++) {
+        if (pui32Addr[i] != 0xffffffff) return false;
+    }
+
+    return true;
+}
+
+
+
+// Find the newest record and queue a boot record with the reset cause.
+void PlogInit(void)
+{
+    const tPlogRecord *psRecord;
+    uint32_t ui32Last = PLOG_RECORD_NUM;
+    uint32_t ui32ResetCause;
+
+    g_ui32PlogQueueHead = 0;
+    g_ui32PlogQueueTail = 0;
+    g_ui32PlogQueueLost = 0;
+    g_ui32PlogSeq = 0;
+    g_ui16PlogBoot = 0;
+    g_ui32PlogErrors = 0;
+    for (int i = 0; i < PLOG_RECORD_NUM; i++) {
+        psRecord = PLOG_RECORD(i);
+        if (!PlogValid(psRecord) || (psRecord->ui32Seq < g_ui32PlogSeq)) continue;
+        ui32Last = i;
+        g_ui32PlogSeq = psRecord->ui32Seq + 1;
+        g_ui16PlogBoot = psRecord->ui16Boot + 1;
+    }
+    g_ui32PlogNext = ui32Last < PLOG_RECORD_NUM ? (ui32Last + 1) % PLOG_RECORD_NUM : 0;
+    // Skip records which were written partially, e.g. on a power loss. At the
+    // start of a sector, PlogPoll erases the sector if required.
+    while ((g_ui32PlogNext % PLOG_RECORDS_PER_SECTOR) && !PlogBlank(PLOG_RECORD(g_ui32PlogNext), PLOG_RECORD_SIZE)) {
+        g_ui32PlogNext = (g_ui32PlogNext + 1) % PLOG_RECORD_NUM;
+    }
+
+    ui32ResetCause = MAP_SysCtlResetCauseGet();
+    MAP_SysCtlResetCauseClear(ui32ResetCause);
+    PlogWrite(PLOG_TYPE_BOOT, &ui32ResetCause, sizeof(ui32ResetCause));
+}
+
+
+
+// Queue a record. This function can be called from interrupt handlers.
+// Returns -1 if the data is too long or the queue is full.
+int PlogWrite(uint8_t ui8Type, const void *pvData, uint32_t ui32Len)
+{
+    tPlogRecord *psRecord;
+    bool bIntMasked;
+
+    if (ui32Len > PLOG_DATA_SIZE) return -1;
+
+    bIntMasked = MAP_IntMasterDisable();
+    if (g_ui32PlogQueueHead - g_ui32PlogQueueTail >= PLOG_QUEUE_SIZE) {
+        g_ui32PlogQueueLost++;
+        if (!bIntMasked) MAP_IntMasterEnable();
+        return -1;
+    }
+    psRecord = &g_psPlogQueue[g_ui32PlogQueueHead % PLOG_QUEUE_SIZE];
+    memset(psRecord, 0, sizeof(tPlogRecord));
+    psRecord->ui8Type = ui8Type | (TimestampIsSynced() ? PLOG_FLAG_SYNCED : 0);
+    psRecord->ui8Len = ui32Len;
+    psRecord->ui64TimestampUs = TimestampFromUptimeUs(GetUptimeUs());
+    memcpy(psRecord->pui8Data, pvData, ui32Len);
+    g_ui32PlogQueueHead++;
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    return 0;
+}
+
+
+
+// Write one queued record to the flash. Returns 1 if a record was written.
+int PlogPoll(void)
+{
+    tPlogRecord *psRecord;
+    const tPlogRecord *psFlash;
+
+    if (g_ui32PlogQueueTail == g_ui32PlogQueueHead) return 0;
+
+    psRecord = &g_psPlogQueue[g_ui32PlogQueueTail % PLOG_QUEUE_SIZE];
+    psFlash = PLOG_RECORD(g_ui32PlogNext);
+    // Erase the sector with the oldest records when entering it.
+    if (!(g_ui32PlogNext % PLOG_RECORDS_PER_SECTOR) && !PlogBlank(psFlash, FLASH_SECTOR_SIZE)) {
+        if (MAP_FlashErase((uint32_t) psFlash)) g_ui32PlogErrors++;
+    }
+    psRecord->ui32Seq = g_ui32PlogSeq++;
+    psRecord->ui16Boot = g_ui16PlogBoot;
+    psRecord->ui32Crc = PlogCrc(psRecord);
+    if (MAP_FlashProgram((uint32_t *) psRecord, (uint32_t) psFlash, PLOG_RECORD_SIZE) ||
+        memcmp(psFlash, psRecord, PLOG_RECORD_SIZE)) {
+        g_ui32PlogErrors++;
+    }
+    g_ui32PlogNext = (g_ui32PlogNext + 1) % PLOG_RECORD_NUM;
+    g_ui32PlogQueueTail++;
+
+    return 1;
+}
+
+
+
+// Queue a telemetry summary with the maximum temperature of each channel in
+// degC. Channels without valid values are stored as INT8_MIN.
+void PlogTelemetry(const int16_t *pi16Max, uint32_t ui32Stride)
+{
+    int8_t pi8Max[TELEMETRY_CH_NUM];
+    int32_t i32Value;
+
+    for (int i = 0; i < TELEMETRY_CH_NUM; i++) {
+        i32Value = pi16Max[i * ui32Stride];
+        if (i32Value == INT16_MIN) {
+            pi8Max[i] = INT8_MIN;
+            continue;
+        }
+        // Round to degC and limit to the int8_t range without the invalid marker.
+        i32Value = (i32Value + (i32Value < 0 ? -50 : 50)) / 100;
+        if (i32Value > INT8_MAX) i32Value = INT8_MAX;
+        if (i32Value <= INT8_MIN) i32Value = INT8_MIN + 1;
+        pi8Max[i] = i32Value;
+    }
+    PlogWrite(PLOG_TYPE_TELEMETRY, pi8Max, sizeof(pi8Max));
+}
+
+
+
+// Print a record as text.
+void PlogPrint(const tPlogRecord *psRecord)
+{
+    const tPlogFpga *psFpga;
+    uint32_t ui32Value;
+
+    UARTprintf("\n%8u %5u ", psRecord->ui32Seq, psRecord->ui16Boot);
+    if (!(psRecord->ui8Type & PLOG_FLAG_SYNCED)) UARTprintf("up ");
+    TimestampPrint(psRecord->ui64TimestampUs);
+    UARTprintf(": ");
+    switch (psRecord->ui8Type & PLOG_TYPE_MASK) {
+        case PLOG_TYPE_BOOT:
+            memcpy(&ui32Value, psRecord->pui8Data, sizeof(ui32Value));
+            UARTprintf("Boot, reset cause 0x%08x.", ui32Value);
+            break;
+        case PLOG_TYPE_POWER:
+            UARTprintf("Power %s requested by the SM.", psRecord->pui8Data[0] ? "up" : "down");
+            break;
+        case PLOG_TYPE_FPGA:
+            psFpga = (const tPlogFpga *) psRecord->pui8Data;
+            UARTprintf("FPGA %s ", psFpga->ui8Fpga == FPGA_KUP ? FPGA_CMD_KUP : FPGA_CMD_ZUP);
+            if (psFpga->ui8State == FPGA_STATE_CONFIGURED) UARTprintf("configured in %u us.", psFpga->ui32ConfigUs);
+            else UARTprintf("configuration failed with reason %d.", psFpga->ui8FailReason);
+            break;
+        case PLOG_TYPE_TELEMETRY:
+            UARTprintf("Telemetry max. [degC]:");
+            for (int i = 0; i < psRecord->ui8Len; i++) {
+                if ((int8_t) psRecord->pui8Data[i] == INT8_MIN) UARTprintf(" -");
+                else UARTprintf(" %d", (int8_t) psRecord->pui8Data[i]);
+            }
+            break;
+        case PLOG_TYPE_FAULT:
+            UARTprintf("Fault dump part %d of %d.", psRecord->pui8Data[0] + 1, psRecord->pui8Data[1]);
+            break;
+        case PLOG_TYPE_SLOT:
+            memcpy(&ui32Value, psRecord->pui8Data + 4, sizeof(ui32Value));
+            UARTprintf("Slot %c version %u confirmed.", FW_SLOT_NAME(psRecord->pui8Data[0]), ui32Value);
+            break;
+        default:
+            UARTprintf("Type %d, %d bytes.", psRecord->ui8Type & PLOG_TYPE_MASK, psRecord->ui8Len);
+            break;
+    }
+}
+
+
+
+// Print a record as hexadecimal string.
+void PlogPrintHex(const tPlogRecord *psRecord)
+{
+    const uint32_t *pui32Record = (const uint32_t *) psRecord;
+
+    for (int i = 0; i < PLOG_RECORD_SIZE / 4; i++) {
+        TelemetryPrintHex(pui32Record[i], 4);
+    }
+}
+
+
+
+// Count the valid records.
+uint32_t PlogCount(void)
+{
+    uint32_t ui32Count = 0;
+
+    for (int i = 0; i < PLOG_RECORD_NUM; i++) {
+        if (PlogValid(PLOG_RECORD(i))) ui32Count++;
+    }
+
+    return ui32Count;
+}
+
+
+
+// Persistent log command.
+int PlogCmd(char *pcCmd, char *pcParam)
+{
+    const tPlogRecord *psRecord;
+    char *pcCount;
+    uint32_t ui32Count, ui32Skip;
+    bool bHex;
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "status")) {
+        UARTprintf("%s: Persistent log: format version %d, %d of %d records used, boot %d, %d queued, %d lost, %d flash errors.",
+                   UI_STR_OK, PLOG_FORMAT_VERSION, PlogCount(), PLOG_RECORD_NUM, g_ui16PlogBoot,
+                   g_ui32PlogQueueHead - g_ui32PlogQueueTail, g_ui32PlogQueueLost, g_ui32PlogErrors);
+    } else if (!strcasecmp(pcParam, "help")) {
+        PlogHelp();
+    // Read the records from the oldest to the newest one, as text or as
+    // hexadecimal strings for the export.
+    } else if (!strcasecmp(pcParam, "read") || !strcasecmp(pcParam, "dump")) {
+        bHex = !strcasecmp(pcParam, "dump");
+        ui32Count = PlogCount();
+        ui32Skip = 0;
+        pcCount = strtok(NULL, UI_STR_DELIMITER);
+        if (pcCount != NULL) {
+            ui32Skip = strtoul(pcCount, (char **) NULL, 0);
+            ui32Skip = ui32Skip < ui32Count ? ui32Count - ui32Skip : 0;
+        }
+        UARTprintf("%s: ", UI_STR_OK);
+        if (bHex) TelemetryPrintHex(PLOG_FORMAT_VERSION, 1);
+        else UARTprintf("Persistent log:");
+        // The oldest record is in the sector of the next record.
+        for (int i = 0; i < PLOG_RECORD_NUM; i++) {
+            psRecord = PLOG_RECORD((g_ui32PlogNext + i) % PLOG_RECORD_NUM);
+            if (!PlogValid(psRecord)) continue;
+            if (ui32Skip) {
+                ui32Skip--;
+                continue;
+            }
+            if (bHex) {
+                UARTprintf("\n");
+                PlogPrintHex(psRecord);
+            } else {
+                PlogPrint(psRecord);
+            }
+        }
+    } else if (!strcasecmp(pcParam, "clear")) {
+        // Drop the queued records that were not yet written.
+        g_ui32PlogQueueTail = g_ui32PlogQueueHead;
+        for (int i = 0; i < FLASH_SIZE_PLOG; i += FLASH_SECTOR_SIZE) {
+            if (MAP_FlashErase(FLASH_ADDR_PLOG + i)) {
+                g_ui32PlogErrors++;
+                UARTprintf("%s: Error erasing the flash sector at 0x%08x!", UI_STR_ERROR, FLASH_ADDR_PLOG + i);
+                return -1;
+            }
+        }
+        g_ui32PlogNext = 0;
+        UARTprintf("%s.", UI_STR_OK);
+    } else {
+        UARTprintf("%s: Unknown log command `%s'!\n", UI_STR_ERROR, pcParam);
+        PlogHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the persistent log command.
+void PlogHelp(void)
+{
+    UARTprintf("Available log commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  status                              Show the log status (default).\n");
+    UARTprintf("  read    [COUNT]                     Show the newest COUNT records (default: all).\n");
+    UARTprintf("  dump    [COUNT]                     Export the records in binary format.\n");
+    UARTprintf("  clear                               Erase all records.");
+}
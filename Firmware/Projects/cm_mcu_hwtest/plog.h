@@ -0,0 +1,84 @@
+// File: plog.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the persistent log in the internal flash for the hardware
+// test firmware running on the ATLAS MDT Trigger Processor (TP) Command Module
+// (CM) MCU.
+//
+
+
+
+#ifndef __PLOG_H__
+#define __PLOG_H__
+
+
+
+// ******************************************************************
+// Persistent log parameters.
+// ******************************************************************
+
+// Version of the record format. Increment on every change!
+#define PLOG_FORMAT_VERSION             1
+
+// Size of a record and of its data in bytes.
+#define PLOG_RECORD_SIZE                64
+#define PLOG_DATA_SIZE                  44
+#define PLOG_RECORD_NUM                 (FLASH_SIZE_PLOG / PLOG_RECORD_SIZE)
+#define PLOG_RECORDS_PER_SECTOR         (FLASH_SECTOR_SIZE / PLOG_RECORD_SIZE)
+
+// Records waiting to be written to the flash by PlogPoll. A fault dump takes
+// 13 records.
+#define PLOG_QUEUE_SIZE                 16
+
+// Sequence number of a blank record.
+#define PLOG_SEQ_BLANK                  0xffffffff
+
+// Record types.
+#define PLOG_TYPE_BOOT                  1   // Data: reset cause.
+#define PLOG_TYPE_POWER                 2   // Data: power up (1) or down (0) requested by the SM.
+#define PLOG_TYPE_FPGA                  3   // Data: FPGA, state, failure reason, configuration time.
+#define PLOG_TYPE_TELEMETRY             4   // Data: max. temperature per channel of 15 minutes.
+#define PLOG_TYPE_FAULT                 5   // Data: part of a fault dump.
+#define PLOG_TYPE_SLOT                  6   // Data: application slot and version confirmed.
+#define PLOG_TYPE_MASK                  0x7f
+// Flag: The timestamp was synchronized with the host.
+#define PLOG_FLAG_SYNCED                0x80
+
+
+
+// Types.
+typedef struct {
+    uint32_t ui32Seq;               // Sequence number. PLOG_SEQ_BLANK = not written.
+    uint16_t ui16Boot;              // Boot counter.
+    uint8_t  ui8Type;               // PLOG_TYPE_* | PLOG_FLAG_SYNCED.
+    uint8_t  ui8Len;                // Number of data bytes used.
+    uint64_t ui64TimestampUs;       // Timestamp or uptime in us.
+    uint8_t  pui8Data[PLOG_DATA_SIZE];
+    uint32_t ui32Crc;               // CRC-32 of all preceding bytes.
+} tPlogRecord;
+
+// Persistent log data of a FPGA configuration.
+typedef struct {
+    uint8_t  ui8Fpga;
+    uint8_t  ui8State;
+    uint8_t  ui8FailReason;
+    uint8_t  ui8Reserved;
+    uint32_t ui32ConfigUs;
+} tPlogFpga;
+
+
+
+// Function prototypes.
+void PlogInit(void);
+int PlogWrite(uint8_t ui8Type, const void *pvData, uint32_t ui32Len);
+int PlogPoll(void);
+void PlogTelemetry(const int16_t *pi16Max, uint32_t ui32Stride);
+int PlogCmd(char *pcCmd, char *pcParam);
+void PlogHelp(void);
+
+
+
+#endif  // __PLOG_H__
@@ -0,0 +1,217 @@
+// File: profiler.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Statistical PC-sampling profiler for the hardware test firmware running on
+// the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// A timer interrupt with the highest priority samples the program counter
+// (PC) stacked on exception entry into a histogram bucketed by the flash
+// address. The buckets are exported with `prof dump' and symbolized on the
+// host against the ELF file cm_mcu_hwtest.axf.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "utils/uartstdio.h"
+#include "cm_mcu_hwtest.h"
+#include "telemetry.h"
+#include "profiler.h"
+
+
+
+// Global variables.
+extern uint32_t g_ui32SysClock;
+tProf g_sProf;
+
+// Code section of the firmware, defined by the linker script.
+extern uint32_t _text;
+extern uint32_t _etext;
+
+
+
+// Initialize the profiler and its timer.
+void ProfInit(void)
+{
+    memset(&g_sProf, 0, sizeof(g_sProf));
+    g_sProf.ui32Base = (uint32_t) &_text;
+    // Smallest bucket size that covers the firmware code.
+    while ((((uint32_t) &_etext - g_sProf.ui32Base) >> g_sProf.ui32Shift) >= PROF_BUCKET_NUM) {
+        g_sProf.ui32Shift++;
+    }
+
+    MAP_SysCtlPeripheralEnable(PROF_TIMER_PERIPH);
+    MAP_TimerDisable(PROF_TIMER_BASE, TIMER_A);
+    MAP_TimerConfigure(PROF_TIMER_BASE, TIMER_CFG_PERIODIC);
+    TimerIntRegister(PROF_TIMER_BASE, TIMER_A, ProfTimerIntHandler);
+    // Highest priority to sample also inside other interrupt handlers.
+    MAP_IntPrioritySet(PROF_TIMER_INT, 0x00);
+}
+
+
+
+// Clear the histogram and start sampling.
+int ProfStart(uint32_t ui32RateHz)
+{
+    if ((ui32RateHz < PROF_RATE_MIN) || (ui32RateHz > PROF_RATE_MAX)) return -1;
+
+    ProfStop();
+    g_sProf.ui32RateHz = ui32RateHz;
+    g_sProf.ui32Samples = 0;
+    g_sProf.ui32SamplesRom = 0;
+    g_sProf.ui32SamplesOther = 0;
+    memset(g_sProf.pui16Bucket, 0, sizeof(g_sProf.pui16Bucket));
+    MAP_TimerLoadSet(PROF_TIMER_BASE, TIMER_A, g_ui32SysClock / ui32RateHz - 1);
+    MAP_TimerIntClear(PROF_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    MAP_TimerIntEnable(PROF_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    g_sProf.bRunning = true;
+    MAP_TimerEnable(PROF_TIMER_BASE, TIMER_A);
+
+    return 0;
+}
+
+
+
+// Stop sampling. The histogram is kept.
+void ProfStop(void)
+{
+    MAP_TimerDisable(PROF_TIMER_BASE, TIMER_A);
+    MAP_TimerIntDisable(PROF_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    g_sProf.bRunning = false;
+}
+
+
+
+// Timer interrupt handler. Pass the exception stack frame of the interrupted
+// code to ProfSample. The EXC_RETURN value in LR tells which stack was used.
+void __attribute__((naked)) ProfTimerIntHandler(void)
+{
+    __asm("    tst     lr, #4\n"
+          "    ite     eq\n"
+          "    mrseq   r0, msp\n"
+          "    mrsne   r0, psp\n"
+          "    b       ProfSample\n");
+}
+
+
+
+// Record the PC of an exception stack frame: R0, R1, R2, R3, R12, LR, PC, xPSR.
+void ProfSample(uint32_t *pui32Frame)
+{
+    uint32_t ui32Pc = pui32Frame[6];
+    uint32_t ui32Bucket;
+
+    MAP_TimerIntClear(PROF_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+
+    g_sProf.ui32Samples++;
+    ui32Bucket = (ui32Pc - g_sProf.ui32Base) >> g_sProf.ui32Shift;
+    if ((ui32Pc >= g_sProf.ui32Base) && (ui32Bucket < PROF_BUCKET_NUM)) {
+        // Saturate the bucket.
+        if (g_sProf.pui16Bucket[ui32Bucket] < 0xffff) g_sProf.pui16Bucket[ui32Bucket]++;
+    } else if ((ui32Pc >= PROF_ROM_START) && (ui32Pc < PROF_ROM_END)) {
+        g_sProf.ui32SamplesRom++;
+    } else {
+        g_sProf.ui32SamplesOther++;
+    }
+}
+
+
+
+// Dump the histogram. Only the non-empty buckets are sent as hexadecimal
+// string. All values are little endian:
+// - uint8_t  format version (PROF_FORMAT_VERSION)
+// - uint8_t  log2 of the bucket size in bytes
+// - uint16_t number of non-empty buckets
+// - uint32_t start address of the first bucket
+// - uint32_t sampling rate in Hz
+// - uint32_t total number of samples
+// - uint32_t samples in the internal ROM
+// - uint32_t samples outside of the code
+// - per non-empty bucket:
+//   - uint16_t bucket index
+//   - uint16_t number of samples (saturated at 0xffff)
+void ProfDump(void)
+{
+    uint32_t ui32Used = 0;
+
+    for (int i = 0; i < PROF_BUCKET_NUM; i++) {
+        if (g_sProf.pui16Bucket[i]) ui32Used++;
+    }
+    UARTprintf("%s: ", UI_STR_OK);
+    TelemetryPrintHex(PROF_FORMAT_VERSION, 1);
+    TelemetryPrintHex(g_sProf.ui32Shift, 1);
+    TelemetryPrintHex(ui32Used, 2);
+    TelemetryPrintHex(g_sProf.ui32Base, 4);
+    TelemetryPrintHex(g_sProf.ui32RateHz, 4);
+    TelemetryPrintHex(g_sProf.ui32Samples, 4);
+    TelemetryPrintHex(g_sProf.ui32SamplesRom, 4);
+    TelemetryPrintHex(g_sProf.ui32SamplesOther, 4);
+    for (int i = 0; i < PROF_BUCKET_NUM; i++) {
+        if (!g_sProf.pui16Bucket[i]) continue;
+        TelemetryPrintHex(i, 2);
+        TelemetryPrintHex(g_sProf.pui16Bucket[i], 2);
+    }
+}
+
+
+
+// Profiler command.
+int ProfCmd(char *pcCmd, char *pcParam)
+{
+    uint32_t ui32RateHz = PROF_RATE_DEFAULT;
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "status")) {
+        UARTprintf("%s: Profiler %s. Rate: %d Hz, bucket size: %d bytes, samples: %u (ROM: %u, other: %u).",
+                   UI_STR_OK, g_sProf.bRunning ? "running" : "stopped", g_sProf.ui32RateHz,
+                   1 << g_sProf.ui32Shift, g_sProf.ui32Samples, g_sProf.ui32SamplesRom, g_sProf.ui32SamplesOther);
+    } else if (!strcasecmp(pcParam, "start")) {
+        pcParam = strtok(NULL, UI_STR_DELIMITER);
+        if (pcParam != NULL) ui32RateHz = strtoul(pcParam, (char **) NULL, 0);
+        if (ProfStart(ui32RateHz)) {
+            UARTprintf("%s: The sampling rate must be between %d and %d Hz.", UI_STR_ERROR, PROF_RATE_MIN, PROF_RATE_MAX);
+            return -1;
+        }
+        UARTprintf("%s: Profiler started at %d Hz.", UI_STR_OK, ui32RateHz);
+    } else if (!strcasecmp(pcParam, "stop")) {
+        ProfStop();
+        UARTprintf("%s: Profiler stopped after %u samples.", UI_STR_OK, g_sProf.ui32Samples);
+    } else if (!strcasecmp(pcParam, "dump")) {
+        ProfDump();
+    } else if (!strcasecmp(pcParam, "help")) {
+        ProfHelp();
+    } else {
+        UARTprintf("%s: Unknown prof command `%s'!\n", UI_STR_ERROR, pcParam);
+        ProfHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the prof command.
+void ProfHelp(void)
+{
+    UARTprintf("Available prof commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  status                              Show the profiler status (default).\n");
+    UARTprintf("  start   [RATE]                      Clear and start sampling with RATE Hz.\n");
+    UARTprintf("  stop                                Stop sampling.\n");
+    UARTprintf("  dump                                Dump the histogram as hex string.");
+}
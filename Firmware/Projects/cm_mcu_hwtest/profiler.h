@@ -0,0 +1,72 @@
+// File: profiler.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the statistical PC-sampling profiler for the hardware test
+// firmware running on the ATLAS MDT Trigger Processor (TP) Command Module (CM)
+// MCU.
+//
+
+
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+
+
+// ******************************************************************
+// Profiler parameters.
+// ******************************************************************
+
+// Version of the binary dump format. Increment on every change!
+#define PROF_FORMAT_VERSION             1
+
+// Sampling timer.
+#define PROF_TIMER_PERIPH               SYSCTL_PERIPH_TIMER0
+#define PROF_TIMER_BASE                 TIMER0_BASE
+#define PROF_TIMER_INT                  INT_TIMER0A
+
+// Sampling rate in Hz.
+#define PROF_RATE_DEFAULT               10000
+#define PROF_RATE_MIN                   100
+#define PROF_RATE_MAX                   100000
+
+// Number of histogram buckets covering the firmware code from _text to
+// _etext. The bucket size is the smallest power of 2 that covers the code.
+// CAUTION: The SRAM usage is 2 bytes per bucket.
+#define PROF_BUCKET_NUM                 4096
+
+// Address range of the internal ROM (TivaWare driver library).
+#define PROF_ROM_START                  0x01000000
+#define PROF_ROM_END                    0x01010000
+
+
+
+// Types.
+typedef struct {
+    bool     bRunning;
+    uint32_t ui32RateHz;
+    uint32_t ui32Base;              // Start address of the first bucket.
+    uint32_t ui32Shift;             // log2 of the bucket size in bytes.
+    uint32_t ui32Samples;           // Total number of samples.
+    uint32_t ui32SamplesRom;        // Samples in the internal ROM.
+    uint32_t ui32SamplesOther;      // Samples outside of the code, e.g. SRAM.
+    uint16_t pui16Bucket[PROF_BUCKET_NUM];
+} tProf;
+
+
+
+// Function prototypes.
+void ProfInit(void);
+int ProfStart(uint32_t ui32RateHz);
+void ProfStop(void);
+void ProfTimerIntHandler(void);
+void ProfSample(uint32_t *pui32Frame);
+int ProfCmd(char *pcCmd, char *pcParam);
+void ProfHelp(void);
+
+
+
+#endif  // __PROFILER_H__
@@ -0,0 +1,152 @@
+// File: slot.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Application slot handling for the hardware test firmware running on the
+// ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The firmware is linked for one of the two application slots (fw_slot.h).
+// The boot loader starts the valid slot with the highest version. A new image
+// must be confirmed by the firmware once it is up and running. Otherwise the
+// boot loader falls back to the other slot after FW_SLOT_BOOT_MAX boots.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/flash.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sw_crc.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/watchdog.h"
+#include "utils/uartstdio.h"
+#include "fw_slot.h"
+#include "cm_mcu_hwtest.h"
+#include "plog.h"
+#include "slot.h"
+
+
+
+// Image header of the firmware. The linker script places it at the start of
+// the slot. The version, length and CRC are filled in by fw_slot.py.
+__attribute__ ((section(".fw_slot_header"), used))
+const tFwSlotHeader g_sFwSlotHeader =
+{
+    FW_SLOT_MAGIC,
+    FW_SLOT_ERASED,
+    FW_SLOT_ERASED,
+    FW_SLOT_ERASED,
+    {FW_SLOT_ERASED, FW_SLOT_ERASED, FW_SLOT_ERASED, FW_SLOT_ERASED},
+    FW_SLOT_ERASED,
+    {FW_SLOT_ERASED, FW_SLOT_ERASED, FW_SLOT_ERASED},
+};
+
+
+
+// Get the number of the slot the firmware is running in.
+int SlotActive(void)
+{
+    return (uint32_t) &g_sFwSlotHeader == FW_SLOT_B_START;
+}
+
+
+
+// Confirm the slot the firmware is running in, so that the boot loader keeps
+// starting it. This also stops the watchdog armed by the boot loader from
+// resetting the MCU.
+int SlotConfirm(void)
+{
+    const tFwSlotHeader *psHeader = FW_SLOT_HEADER(SlotActive());
+    uint32_t pui32Data[2];
+
+    if (psHeader->ui32Confirmed != FW_SLOT_ERASED) return 0;
+
+    pui32Data[0] = FW_SLOT_CONFIRMED;
+    if (MAP_FlashProgram(pui32Data, (uint32_t) &psHeader->ui32Confirmed, 4)) return -1;
+    if (MAP_SysCtlPeripheralReady(SYSCTL_PERIPH_WDOG0)) {
+        if (MAP_WatchdogLockState(WATCHDOG0_BASE)) MAP_WatchdogUnlock(WATCHDOG0_BASE);
+        MAP_WatchdogResetDisable(WATCHDOG0_BASE);
+    }
+
+    pui32Data[0] = SlotActive();
+    pui32Data[1] = psHeader->ui32Version;
+    PlogWrite(PLOG_TYPE_SLOT, pui32Data, sizeof(pui32Data));
+
+    return 0;
+}
+
+
+
+// Show the state of a slot.
+void SlotPrint(int iSlot)
+{
+    const tFwSlotHeader *psHeader = FW_SLOT_HEADER(iSlot);
+    const uint8_t *pui8Image = (const uint8_t *) (FW_SLOT_START(iSlot) + FW_SLOT_HEADER_SIZE);
+    uint32_t ui32Boots = 0;
+
+    UARTprintf("\nSlot %c at 0x%08x: ", FW_SLOT_NAME(iSlot), FW_SLOT_START(iSlot));
+    if (psHeader->ui32Magic != FW_SLOT_MAGIC) {
+        UARTprintf("empty.");
+        return;
+    }
+    if (psHeader->ui32Length > FW_SLOT_SIZE - FW_SLOT_HEADER_SIZE) {
+        UARTprintf("invalid length %u.", psHeader->ui32Length);
+        return;
+    }
+    while ((ui32Boots < FW_SLOT_BOOT_MAX) && (psHeader->pui32Boot[ui32Boots] != FW_SLOT_ERASED)) ui32Boots++;
+    UARTprintf("version %u, %u bytes, CRC %s, ", psHeader->ui32Version, psHeader->ui32Length,
+               (MAP_Crc32(0xffffffff, pui8Image, psHeader->ui32Length) ^ 0xffffffff) == psHeader->ui32Crc ?
+               "OK" : "error");
+    if (psHeader->ui32Confirmed == FW_SLOT_CONFIRMED) UARTprintf("confirmed");
+    else if (ui32Boots >= FW_SLOT_BOOT_MAX) UARTprintf("failed");
+    else UARTprintf("not confirmed");
+    UARTprintf(", %u of %u boots", ui32Boots, FW_SLOT_BOOT_MAX);
+    if (iSlot == SlotActive()) UARTprintf(", running");
+    UARTprintf(".");
+}
+
+
+
+// Slot command.
+int SlotCmd(char *pcCmd, char *pcParam)
+{
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "show")) {
+        UARTprintf("%s: Application slots:", UI_STR_OK);
+        for (int i = 0; i < FW_SLOT_NUM; i++) {
+            SlotPrint(i);
+        }
+    } else if (!strcasecmp(pcParam, "help")) {
+        SlotHelp();
+    } else if (!strcasecmp(pcParam, "confirm")) {
+        if (SlotConfirm()) {
+            UARTprintf("%s: Cannot confirm slot %c!", UI_STR_ERROR, FW_SLOT_NAME(SlotActive()));
+            return -1;
+        }
+        UARTprintf("%s: Slot %c confirmed.", UI_STR_OK, FW_SLOT_NAME(SlotActive()));
+    } else {
+        UARTprintf("%s: Unknown slot command `%s'!\n", UI_STR_ERROR, pcParam);
+        SlotHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the slot command.
+void SlotHelp(void)
+{
+    UARTprintf("Available slot commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show the application slots (default).\n");
+    UARTprintf("  confirm                             Confirm the running slot.");
+}
@@ -0,0 +1,26 @@
+// File: slot.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the application slot handling for the hardware test firmware
+// running on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __SLOT_H__
+#define __SLOT_H__
+
+
+
+// Function prototypes.
+int SlotActive(void);
+int SlotConfirm(void);
+int SlotCmd(char *pcCmd, char *pcParam);
+void SlotHelp(void);
+
+
+
+#endif  // __SLOT_H__
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 04 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Functions for interfacing the Service Module and the Command Module in the
 // hardware test firmware running on the ATLASfirmware running on the ATLAS MDT
@@ -20,6 +20,9 @@
 #include "utils/uartstdio.h"
 #include "hw/gpio/gpio.h"
 #include "hw/gpio/gpio_pins.h"
+#include "dlog.h"
+#include "plog.h"
+#include "events.h"
 #include "power_control.h"
 #include "sm_cm.h"
 #include "cm_mcu_hwtest.h"
@@ -33,7 +36,7 @@
 int SmCm_PowerHandshakingInit(void)
 {
     // Register interrupt routine for the SM_PWR_ENA input.
-    GpioInitIntr(&g_sGpio_SmPowerEna, SmCm_IntHandlerSmPowerEna);
+    GpioInitIntr(&g_psGpio_SmPowerEna[0], SmCm_IntHandlerSmPowerEna);
 
     return 0;
 }
@@ -44,13 +47,17 @@ int SmCm_PowerHandshakingInit(void)
 void SmCm_IntHandlerSmPowerEna(void)
 {
     uint32_t ui32IntStatusSmPowerEna;
+    uint8_t ui8PowerUp;
 
-    ui32IntStatusSmPowerEna = GPIOIntStatus(g_sGpio_SmPowerEna.ui32Port, true);
-    GPIOIntClear(g_sGpio_SmPowerEna.ui32Port, ui32IntStatusSmPowerEna);
+    ui32IntStatusSmPowerEna = GPIOIntStatus(g_psGpio_SmPowerEna[0].ui32Port, true);
+    GPIOIntClear(g_psGpio_SmPowerEna[0].ui32Port, ui32IntStatusSmPowerEna);
+    EventsCapture(g_psGpio_SmPowerEna[0].ui32Port, ui32IntStatusSmPowerEna);
 
-    if ((ui32IntStatusSmPowerEna & g_sGpio_SmPowerEna.ui8Pins) == g_sGpio_SmPowerEna.ui8Pins) {
+    if ((ui32IntStatusSmPowerEna & g_psGpio_SmPowerEna[0].ui8Pins) == g_psGpio_SmPowerEna[0].ui8Pins) {
+        ui8PowerUp = GpioGet_SmPowerEna() ? 1 : 0;
+        PlogWrite(PLOG_TYPE_POWER, &ui8PowerUp, sizeof(ui8PowerUp));
         // CM power up requested by SM.
-        if (GpioGet_SmPowerEna()) {
+        if (ui8PowerUp) {
             // Turn on the CM power domains.
 //            PowerControl_All(true, 1);
             PowerControl_Clock(true, 1);
@@ -60,7 +67,7 @@ void SmCm_IntHandlerSmPowerEna(void)
             // Drive the CM_READY output high.
             GpioSet_CmReady(1);
             #ifdef SM_CM_POWER_HANDSHAKING_SHOW_MESSAGE
-            UARTprintf("\nPower up requested from SM by driving SM_PWR_ENA high. Driving CM_READY high.\n");
+            DLOG("Power up requested from SM by driving SM_PWR_ENA high. Driving CM_READY high.");
             #endif
         // CM power down requested by SM.
         } else {
@@ -73,7 +80,7 @@ void SmCm_IntHandlerSmPowerEna(void)
             // Drive the CM_READY output low.
             GpioSet_CmReady(0);
             #ifdef SM_CM_POWER_HANDSHAKING_SHOW_MESSAGE
-            UARTprintf("\nPower down requested from SM by driving SM_PWR_ENA low. Driving CM_READY low.\n");
+            DLOG("Power down requested from SM by driving SM_PWR_ENA low. Driving CM_READY low.");
             #endif
         }
         // Update the status LEDs.
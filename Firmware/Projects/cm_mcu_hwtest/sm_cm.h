@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 04 Aug 2020
-// Rev.: 04 Aug 2020
+// Rev.: 18 Oct 2026
 //
 // Header file for interfacing the Service Module and the Command Module in the
 // hardware test firmware running on the ATLASfirmware running on the ATLAS MDT
@@ -16,10 +16,6 @@
 
 
 
-// Globals.
-extern tGPIO g_sGpio_SmPowerEna;
-
-
 // Function prototypes.
 int SmCm_PowerHandshakingInit(void);
 void SmCm_IntHandlerSmPowerEna(void);
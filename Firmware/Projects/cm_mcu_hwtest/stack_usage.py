@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+#
+# File: stack_usage.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 18 Oct 2026
+# Rev.: 18 Oct 2026
+#
+# Python script to estimate the worst-case stack usage of the firmware running
+# on the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU. The stack
+# usage of each function is read from the .su files written by gcc with the
+# option -fstack-usage. The call graph is read from the disassembly of the ELF
+# file. Indirect calls (function pointers, ROM functions) are not followed.
+#
+
+
+
+# System modules.
+import os
+import re
+import subprocess
+import sys
+
+
+
+# Message prefixes and separators.
+prefixError             = "ERROR: {0:s}: ".format(__file__)
+prefixDebug             = "DEBUG: {0:s}: ".format(__file__)
+
+# Stack frame of an exception entry with FPU registers in bytes.
+exceptionFrameSize      = 104
+
+# Disassembly: function start and direct calls or tail calls.
+regexFunction           = re.compile(r"^[0-9a-f]+ <([^>]+)>:$")
+regexCall               = re.compile(r"\t(bl|blx|b[a-z]{0,2}(?:\.[wn])?)\s+[0-9a-f]+ <([^>+]+)(\+0x[0-9a-f]+)?>")
+
+
+
+# Read the stack usage of the functions from the .su files.
+# Returns a dictionary {function: (bytes, qualifier)}.
+def read_stack_usage(dirName):
+    usage = {}
+    for root, dirs, files in os.walk(dirName):
+        for fileName in files:
+            if not fileName.endswith(".su"):
+                continue
+            with open(os.path.join(root, fileName)) as f:
+                for line in f:
+                    # FILE:LINE:COLUMN:FUNCTION<TAB>BYTES<TAB>QUALIFIER
+                    fields = line.rstrip('\n').split('\t')
+                    if len(fields) != 3:
+                        continue
+                    name = fields[0].split(':')[-1]
+                    usage[name] = (int(fields[1]), fields[2])
+    return usage
+
+
+
+# Read the direct calls from the disassembly of the ELF file.
+# Returns a dictionary {function: set of called functions}.
+def read_call_graph(elfFileName, objdumpTool):
+    try:
+        output = subprocess.run([objdumpTool, "-d", elfFileName], stdout=subprocess.PIPE,
+                                check=True, universal_newlines=True).stdout
+    except Exception as e:
+        print(prefixError + "Error disassembling `{0:s}': {1:s}".format(elfFileName, str(e)))
+        return None
+    calls = {}
+    function = None
+    for line in output.splitlines():
+        match = regexFunction.match(line)
+        if match:
+            function = match.group(1)
+            calls[function] = set()
+            continue
+        match = regexCall.search(line)
+        # Branches within the function are no calls.
+        if match and function and match.group(2) != function:
+            calls[function].add(match.group(2))
+    return calls
+
+
+
+# Calculate the worst-case stack usage of a function including its callees.
+# Returns a tuple (bytes, call path, flags).
+def worst_case(function, usage, calls, cache, active):
+    if function in cache:
+        return cache[function]
+    own, qualifier = usage.get(function, (0, "unknown"))
+    flags = set()
+    if qualifier != "static":
+        flags.add(qualifier)
+    if function in active:
+        return (0, [function + " (recursion)"], {"recursion"})
+    active.add(function)
+    worstBytes, worstPath = 0, []
+    for callee in sorted(calls.get(function, [])):
+        calleeBytes, calleePath, calleeFlags = worst_case(callee, usage, calls, cache, active)
+        flags |= calleeFlags
+        if calleeBytes > worstBytes or not worstPath:
+            worstBytes, worstPath = calleeBytes, calleePath
+    active.discard(function)
+    cache[function] = (own + worstBytes, [function] + worstPath, flags)
+    return cache[function]
+
+
+
+# Estimate the stack usage.
+if __name__ == "__main__":
+    # Command line arguments.
+    import argparse
+    parser = argparse.ArgumentParser(description='Estimate the worst-case stack usage per call graph root.')
+    parser.add_argument('elfFileName', action='store', type=str, metavar='ELF_FILE',
+                        help='ELF file of the firmware.')
+    parser.add_argument('-d', '--dir', action='store', type=str,
+                        dest='dirName', default='gcc', metavar='DIR',
+                        help='Directory with the .su files. The default is `gcc\'.')
+    parser.add_argument('-o', '--objdump', action='store', type=str,
+                        dest='objdumpTool', default='arm-none-eabi-objdump', metavar='OBJDUMP',
+                        help='Tool to disassemble the ELF file.')
+    parser.add_argument('-s', '--stack-size', action='store', type=lambda x: int(x, 0),
+                        dest='stackSize', default=0, metavar='BYTES',
+                        help='Size of the stack to compare with.')
+    parser.add_argument('-l', '--lines', action='store', type=int,
+                        dest='lines', default=20,
+                        help='Number of call graph roots to show. The default is 20.')
+    parser.add_argument('-v', '--verbosity', action='store', type=int,
+                        dest='verbosity', default="1", choices=range(0, 5),
+                        help='Set the verbosity level. The default is 1.')
+    args = parser.parse_args()
+
+    usage = read_stack_usage(args.dirName)
+    calls = read_call_graph(args.elfFileName, args.objdumpTool)
+    if not usage or calls is None:
+        print(prefixError + "No stack usage or call graph information found!")
+        sys.exit(-1)
+    if args.verbosity >= 2:
+        print(prefixDebug + "{0:d} functions with stack usage, {1:d} functions in the call graph.".format(len(usage), len(calls)))
+
+    # Roots are functions not called directly, e.g. main and the interrupt
+    # handlers.
+    called = set()
+    for callees in calls.values():
+        called |= callees
+    cache = {}
+    roots = [(worst_case(function, usage, calls, cache, set()), function) for function in calls if function not in called]
+    roots.sort(key=lambda root: root[0][0], reverse=True)
+
+    print("   Bytes  Root                            Flags / worst-case call path")
+    for (worstBytes, path, flags), function in roots[:args.lines]:
+        print("{0:8d}  {1:30s}  {2:s}".format(worstBytes, function, " ".join(sorted(flags)) or "-"))
+        if args.verbosity >= 1:
+            print("          " + " > ".join(path))
+
+    # Main plus the deepest interrupt handler with its exception frame.
+    mainBytes = cache.get("main", (0, [], set()))[0]
+    isrBytes = max([root[0][0] for root in roots if root[1] != "main" and root[1] != "ResetISR"] or [0])
+    totalBytes = mainBytes + isrBytes + exceptionFrameSize
+    print("Estimated worst case: main {0:d} + interrupt {1:d} + exception frame {2:d} = {3:d} bytes.".format(
+          mainBytes, isrBytes, exceptionFrameSize, totalBytes))
+    if args.stackSize:
+        print("Stack size: {0:d} bytes, {1:s}.".format(args.stackSize,
+              "OK" if totalBytes <= args.stackSize else "WARNING: too small"))
+    print("Functions marked `dynamic' or `unknown' (e.g. from libraries) and indirect calls are not fully accounted for.")
@@ -25,7 +25,6 @@
 #include <stdint.h>
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
-#include "utils/uartstdio.h"
 
 //*****************************************************************************
 //
@@ -36,7 +35,15 @@ void ResetISR(void);
 static void NmiSR(void);
 static void FaultISR(void);
 static void IntDefaultHandler(void);
-static void FatalErrorMessage(void);
+
+//*****************************************************************************
+//
+// The fault dump capture of the application and the stack of the fault
+// handler.
+//
+//*****************************************************************************
+extern void FaultCapture(uint32_t *pui32Frame, uint32_t ui32ExcReturn);
+extern uint32_t * const g_pui32FaultStackTop;
 
 //*****************************************************************************
 //
@@ -47,10 +54,11 @@ extern int main(void);
 
 //*****************************************************************************
 //
-// Reserve space for the system stack.
+// The system stack is reserved in the linker script (STACK_SIZE).
 //
 //*****************************************************************************
-static uint32_t pui32Stack[128];
+extern uint32_t _stack;
+extern uint32_t _estack;
 
 //*****************************************************************************
 //
@@ -61,7 +69,7 @@ static uint32_t pui32Stack[128];
 __attribute__ ((section(".isr_vector")))
 void (* const g_pfnVectors[])(void) =
 {
-    (void (*)(void))((uint32_t)pui32Stack + sizeof(pui32Stack)),
+    (void (*)(void))&_estack,
                                             // The initial stack pointer
     ResetISR,                               // The reset handler
     NmiSR,                                  // The NMI handler
@@ -220,6 +228,20 @@ ResetISR(void)
 {
     uint32_t *pui32Src, *pui32Dest;
 
+    //
+    // Paint the unused part of the stack to measure its high-water mark.  The
+    // pattern must match MEM_STACK_PAINT in mem.h.
+    //
+    __asm("    ldr     r0, =_stack\n"
+          "    mov     r1, sp\n"
+          "    ldr     r2, =0xa5a5a5a5\n"
+          "    .thumb_func\n"
+          "paint_loop:\n"
+          "        cmp     r0, r1\n"
+          "        it      lt\n"
+          "        strlt   r2, [r0], #4\n"
+          "        blt     paint_loop");
+
     //
     // Copy the data segment initializers from flash to SRAM.
     //
@@ -264,69 +286,49 @@ ResetISR(void)
 
 //*****************************************************************************
 //
-// This is the code that gets called when the processor receives a NMI.  This
-// simply enters an infinite loop, preserving the system state for examination
-// by a debugger.
+// This is the code that gets called when the processor receives a NMI.  It is
+// handled like a fault.
 //
 //*****************************************************************************
-static void
+static void __attribute__((naked))
 NmiSR(void)
 {
-    FatalErrorMessage();
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
-    {
-    }
+    __asm("    b       FaultISR");
 }
 
 //*****************************************************************************
 //
 // This is the code that gets called when the processor receives a fault
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
+// interrupt.  It passes the stack frame of the exception and the EXC_RETURN
+// value to FaultCapture, which stores a fault dump and resets the MCU.  The
+// handler switches to a separate stack first, since the fault may have been
+// caused by a stack overflow.
 //
 //*****************************************************************************
-static void
+static void __attribute__((naked))
 FaultISR(void)
 {
-    FatalErrorMessage();
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
-    {
-    }
+    __asm("    tst     lr, #4\n"
+          "    ite     eq\n"
+          "    mrseq   r0, msp\n"
+          "    mrsne   r0, psp\n"
+          "    mov     r1, lr\n"
+          "    ldr     r2, =g_pui32FaultStackTop\n"
+          "    ldr     r2, [r2]\n"
+          "    mov     sp, r2\n"
+          "    b       FaultCapture");
 }
 
 //*****************************************************************************
 //
 // This is the code that gets called when the processor receives an unexpected
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
+// interrupt.  It is handled like a fault.  The number of the interrupt is
+// recorded in the fault dump.
 //
 //*****************************************************************************
-static void
+static void __attribute__((naked))
 IntDefaultHandler(void)
 {
-    FatalErrorMessage();
-    //
-    // Go into an infinite loop.
-    //
-    while(1)
-    {
-    }
-}
-
-//*****************************************************************************
-//
-// Print fatal error message to UART (console).
-//
-//*****************************************************************************
-static void
-FatalErrorMessage(void)
-{
-    UARTprintf("\nFATAL ERROR. System halted.\n");
+    __asm("    b       FaultISR");
 }
 
@@ -0,0 +1,250 @@
+// File: stream.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Push-mode telemetry streaming for the hardware test firmware running on the
+// ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The host subscribes to sensor groups of the telemetry cache with a given
+// period. The frames are sent from the main loop only while it waits for user
+// input, so they are paused automatically while a command is being received or
+// executed. A frame is sent in chunks that fit into the UART TX FIFO, so the
+// main loop never waits for the UART.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "driverlib/uart.h"
+#include "utils/uartstdio.h"
+#include "utils/ustdlib.h"
+#include "uart_ui.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "telemetry.h"
+#include "stream.h"
+
+
+
+// Subscriptions per sensor group.
+tStreamSubscription g_psStreamSubscription[TELEMETRY_GROUP_NUM];
+
+// Sequence number of the next frame and uptime of the last frame.
+uint16_t g_ui16StreamSeq;
+uint32_t g_ui32StreamLastMs;
+
+// Frame being sent, its length and the number of characters already sent.
+char g_pcStreamFrame[STREAM_FRAME_BUF_SIZE];
+uint32_t g_ui32StreamFrameLen;
+uint32_t g_ui32StreamFrameSent;
+
+// UART user interface.
+extern tUartUi *g_psUartUi;
+
+
+
+// Initialize the streaming. All subscriptions are off.
+void StreamInit(void)
+{
+    memset(g_psStreamSubscription, 0, sizeof(g_psStreamSubscription));
+    g_ui16StreamSeq = 0;
+    g_ui32StreamLastMs = GetUptimeMs();
+    g_ui32StreamFrameLen = g_ui32StreamFrameSent = 0;
+}
+
+
+
+// Check if a frame is still being sent. The UART UI must not be used for
+// anything else meanwhile.
+bool StreamBusy(void)
+{
+    return g_ui32StreamFrameSent < g_ui32StreamFrameLen;
+}
+
+
+
+// Append a value as little-endian hexadecimal bytes to the frame.
+void StreamFrameHex(uint32_t ui32Value, int iBytes)
+{
+    for (int i = 0; i < iBytes; i++) {
+        if (g_ui32StreamFrameLen + 3 > STREAM_FRAME_BUF_SIZE) return;
+        g_ui32StreamFrameLen += usprintf(&g_pcStreamFrame[g_ui32StreamFrameLen], "%02x", (ui32Value >> (8 * i)) & 0xff);
+    }
+}
+
+
+
+// Send as much of the frame as fits into the UART TX FIFO. Returns 1 if
+// characters were sent.
+int StreamSendPending(void)
+{
+    int iSent = 0;
+
+    while (StreamBusy()) {
+        if (!UARTCharPutNonBlocking(g_psUartUi->ui32Base, g_pcStreamFrame[g_ui32StreamFrameSent])) break;
+        g_ui32StreamFrameSent++;
+        iSent = 1;
+    }
+
+    return iSent;
+}
+
+
+
+// Start sending a frame with the telemetry values of a sensor group. The binary
+// data are sent as hexadecimal string in one line starting with
+// STREAM_FRAME_START, followed by the command prompt. The rest of the frame is
+// sent by StreamPoll. All values are little endian:
+// - uint8_t  format version (STREAM_FORMAT_VERSION)
+// - uint16_t sequence number
+// - uint32_t uptime in ms
+// - uint8_t  sensor group
+// - uint8_t  first channel
+// - uint8_t  number of channels
+// - per channel:
+//   - int16_t  value in units of 0.01 degC
+//   - uint16_t age of the value in ms (saturated at 0xffff)
+//   - uint8_t  flags (TELEMETRY_FLAG_*)
+void StreamSendFrame(uint32_t ui32Group, uint32_t ui32Now)
+{
+    tTelemetryGroup *psGroup = &g_psTelemetryGroup[ui32Group];
+    tTelemetryValue *psValue;
+    uint32_t ui32Age;
+
+    g_ui32StreamFrameSent = 0;
+    g_ui32StreamFrameLen = usprintf(g_pcStreamFrame, "\r%c", STREAM_FRAME_START);
+    StreamFrameHex(STREAM_FORMAT_VERSION, 1);
+    StreamFrameHex(g_ui16StreamSeq++, 2);
+    StreamFrameHex(ui32Now, 4);
+    StreamFrameHex(ui32Group, 1);
+    StreamFrameHex(psGroup->ui32ChFirst, 1);
+    StreamFrameHex(psGroup->ui32ChNum, 1);
+    for (int i = 0; i < psGroup->ui32ChNum; i++) {
+        psValue = &g_sTelemetryCache.psValue[psGroup->ui32ChFirst + i];
+        ui32Age = ui32Now - psValue->ui32Timestamp;
+        if (ui32Age > 0xffff) ui32Age = 0xffff;
+        StreamFrameHex((uint16_t) ((int16_t) psValue->i32Value), 2);
+        StreamFrameHex(ui32Age, 2);
+        StreamFrameHex(psValue->ui8Flags, 1);
+    }
+    // The UART UI sends CR LF as line end.
+    if (g_ui32StreamFrameLen + 3 + sizeof(UI_COMMAND_PROMPT) <= STREAM_FRAME_BUF_SIZE) {
+        g_ui32StreamFrameLen += usprintf(&g_pcStreamFrame[g_ui32StreamFrameLen], "\r\n%s", UI_COMMAND_PROMPT);
+    }
+    StreamSendPending();
+}
+
+
+
+// Continue sending the current frame or start at most one due frame. Returns 1
+// if characters were sent.
+int StreamPoll(void)
+{
+    tStreamSubscription *psSubscription;
+    uint32_t ui32Now = GetUptimeMs();
+
+    if (StreamBusy()) return StreamSendPending();
+
+    // Global rate limit.
+    if (ui32Now - g_ui32StreamLastMs < STREAM_FRAME_GAP_MS) return 0;
+
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        psSubscription = &g_psStreamSubscription[i];
+        if (!psSubscription->ui32PeriodMs) continue;
+        if (ui32Now - psSubscription->ui32LastMs >= psSubscription->ui32PeriodMs) {
+            psSubscription->ui32LastMs = ui32Now;
+            g_ui32StreamLastMs = ui32Now;
+            StreamSendFrame(i, ui32Now);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+// Show the subscriptions.
+void StreamStatus(void)
+{
+    UARTprintf("%s: Next sequence number: %d. Subscriptions:", UI_STR_OK, g_ui16StreamSeq);
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        UARTprintf(" %s = %d ms", g_psTelemetryGroup[i].pcName, g_psStreamSubscription[i].ui32PeriodMs);
+        if (i < TELEMETRY_GROUP_NUM - 1) UARTprintf(",");
+    }
+}
+
+
+
+// Stream command.
+int StreamCmd(char *pcCmd, char *pcParam)
+{
+    uint32_t ui32PeriodMs;
+    int iGroup;
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "status")) {
+        StreamStatus();
+        return 0;
+    } else if (!strcasecmp(pcParam, "help")) {
+        StreamHelp();
+        return 0;
+    } else if (!strcasecmp(pcParam, "off")) {
+        for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+            g_psStreamSubscription[i].ui32PeriodMs = 0;
+        }
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+
+    // Subscribe to a sensor group or to all sensor groups.
+    if (!strcasecmp(pcParam, "all")) {
+        iGroup = -1;
+    } else {
+        for (iGroup = 0; iGroup < TELEMETRY_GROUP_NUM; iGroup++) {
+            if (!strcasecmp(pcParam, g_psTelemetryGroup[iGroup].pcName)) break;
+        }
+        if (iGroup >= TELEMETRY_GROUP_NUM) {
+            UARTprintf("%s: Unknown sensor group `%s'!\n", UI_STR_ERROR, pcParam);
+            StreamHelp();
+            return -1;
+        }
+    }
+    pcParam = strtok(NULL, UI_STR_DELIMITER);
+    if (pcParam == NULL) {
+        UARTprintf("%s: Period required after sensor group.", UI_STR_ERROR);
+        return -1;
+    }
+    ui32PeriodMs = strtoul(pcParam, (char **) NULL, 0);
+    if (ui32PeriodMs && (ui32PeriodMs < STREAM_PERIOD_MIN_MS)) {
+        UARTprintf("%s: Period limited to the minimum of %d ms. ", UI_STR_WARNING, STREAM_PERIOD_MIN_MS);
+        ui32PeriodMs = STREAM_PERIOD_MIN_MS;
+    }
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        if ((iGroup < 0) || (iGroup == i)) {
+            g_psStreamSubscription[i].ui32PeriodMs = ui32PeriodMs;
+            g_psStreamSubscription[i].ui32LastMs = GetUptimeMs() - ui32PeriodMs;
+        }
+    }
+    StreamStatus();
+
+    return 0;
+}
+
+
+
+// Show help on the stream command.
+void StreamHelp(void)
+{
+    UARTprintf("Available stream commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  status                              Show the subscriptions (default).\n");
+    UARTprintf("  off                                 Cancel all subscriptions.\n");
+    UARTprintf("  GROUP|all PERIOD                    Subscribe to a sensor group (adc, board,\n");
+    UARTprintf("                                          firefly) with PERIOD ms (0 = off).");
+}
@@ -0,0 +1,57 @@
+// File: stream.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the push-mode telemetry streaming for the hardware test
+// firmware running on the ATLAS MDT Trigger Processor (TP) Command Module (CM)
+// MCU.
+//
+
+
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+
+
+// ******************************************************************
+// Stream parameters.
+// ******************************************************************
+
+// Version of the binary frame format. Increment on every change!
+#define STREAM_FORMAT_VERSION           1
+
+// First character of a stream frame line. It allows the host to separate
+// stream frames from command responses.
+#define STREAM_FRAME_START              '@'
+
+// Rate limits.
+#define STREAM_PERIOD_MIN_MS            100     // Minimum period of a subscription.
+#define STREAM_FRAME_GAP_MS             20      // Minimum gap between two frames.
+
+// Size of the frame buffer in characters. It must hold the frame of the
+// largest sensor group including the command prompt.
+#define STREAM_FRAME_BUF_SIZE           256
+
+
+
+// Types.
+typedef struct {
+    uint32_t ui32PeriodMs;          // Period of the subscription. 0 = off.
+    uint32_t ui32LastMs;            // Uptime of the last frame.
+} tStreamSubscription;
+
+
+
+// Function prototypes.
+void StreamInit(void);
+bool StreamBusy(void);
+int StreamPoll(void);
+int StreamCmd(char *pcCmd, char *pcParam);
+void StreamHelp(void);
+
+
+
+#endif  // __STREAM_H__
@@ -0,0 +1,390 @@
+// File: telemetry.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Telemetry cache for the hardware test firmware running on the ATLAS MDT
+// Trigger Processor (TP) Command Module (CM) MCU.
+//
+// All sensors are polled in the background from the main loop while it waits
+// for user input. Only one sensor is accessed per call of TelemetryPoll to
+// keep the user interface responsive. The cache is only written and read from
+// the main loop, so a snapshot is always consistent. A sensor group is paused
+// while the host has an I2C transaction open on its port.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "utils/uartstdio.h"
+#include "hw/adc/adc.h"
+#include "hw/i2c/i2c.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "cm_mcu_hwtest_i2c.h"
+#include "cm_mcu_hwtest_io.h"
+#include "telemetry.h"
+
+
+
+// Telemetry cache.
+tTelemetryCache g_sTelemetryCache;
+
+// Sensor groups.
+tTelemetryGroup g_psTelemetryGroup[TELEMETRY_GROUP_NUM] = {
+    {"adc",     TELEMETRY_CH_ADC,        TELEMETRY_ADC_NUM,                             -1,                          TELEMETRY_PERIOD_ADC,     0, 0},
+    {"board",   TELEMETRY_CH_MCP9903,    TELEMETRY_MCP9903_NUM + TELEMETRY_MCP9808_NUM, TELEMETRY_I2C_PORT_TEMP_MON, TELEMETRY_PERIOD_BOARD,   0, 0},
+    {"firefly", TELEMETRY_CH_FIREFLY_RX, 2 * TELEMETRY_FIREFLY_NUM,                     TELEMETRY_I2C_PORT_FIREFLY,  TELEMETRY_PERIOD_FIREFLY, 0, 0},
+};
+
+// ADCs for the analog temperatures of the power modules.
+tADC *g_psTelemetryAdc[TELEMETRY_ADC_NUM] = {
+    &g_sAdc_KUP_MGTAVCC_ADC_AUX_TEMP,
+    &g_sAdc_KUP_MGTAVTT_TEMP,
+    &g_sAdc_KUP_DDR4_IO_EXP_MISC_TEMP,
+    &g_sAdc_ZUP_MGTAVCC_MGTAVTT_TEMP,
+    &g_sAdc_ZUP_DDR4_IO_ETH_USB_SD_LDO_TEMP,
+};
+
+// Names of the telemetry channels.
+char *g_pcTelemetryName[TELEMETRY_CH_NUM] = {
+    "KUP MGTAVCC/ADC/AUX",
+    "KUP MGTAVTT",
+    "KUP DDR4/IO/Exp. Con./Misc.",
+    "ZUP MGTAVCC/MGTAVTT",
+    "ZUP DDR4/IO/LDO/Misc.",
+    "Board 1 (IC39 MCP9903)",
+    "KU15P (IC39 MCP9903)",
+    "ZU11EG (IC39 MCP9903)",
+    "Board 2 (IC34 MCP9808)",
+    "Board 3 (IC35 MCP9808)",
+    "Board 4 (IC36 MCP9808)",
+    "Board 5 (IC37 MCP9808)",
+    "Board 6 (IC38 MCP9808)",
+    "FireFly 1 RX",
+    "FireFly 2 RX",
+    "FireFly 3 RX",
+    "FireFly 4 RX",
+    "FireFly 5 RX",
+    "FireFly 6 RX",
+    "FireFly 7 RX",
+    "FireFly 8 RX",
+    "FireFly 1 TX",
+    "FireFly 2 TX",
+    "FireFly 3 TX",
+    "FireFly 4 TX",
+    "FireFly 5 TX",
+    "FireFly 6 TX",
+    "FireFly 7 TX",
+    "FireFly 8 TX",
+};
+
+// MCP9903 integer and fractional temperature registers.
+uint8_t g_pui8TelemetryMcp9903Reg[TELEMETRY_MCP9903_NUM][2] = {
+    {TELEMETRY_MCP9903_REG_INT,  TELEMETRY_MCP9903_REG_INT_FRACT},
+    {TELEMETRY_MCP9903_REG_EXT1, TELEMETRY_MCP9903_REG_EXT1_FRACT},
+    {TELEMETRY_MCP9903_REG_EXT2, TELEMETRY_MCP9903_REG_EXT2_FRACT},
+};
+
+
+
+// Initialize the telemetry cache.
+void TelemetryInit(void)
+{
+    uint32_t ui32Now = GetUptimeMs();
+
+    memset(&g_sTelemetryCache, 0, sizeof(g_sTelemetryCache));
+    // Start the first polling pass of all sensor groups immediately.
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        g_psTelemetryGroup[i].ui32LastMs = ui32Now - g_psTelemetryGroup[i].ui32PeriodMs;
+        g_psTelemetryGroup[i].ui32ChNext = g_psTelemetryGroup[i].ui32ChNum;
+    }
+}
+
+
+
+// Check if the host has an I2C transaction open on the port of a sensor group.
+bool TelemetryGroupBlocked(tTelemetryGroup *psGroup)
+{
+    return (psGroup->iI2CPort >= 0) && g_pbI2CHostOpen[psGroup->iI2CPort];
+}
+
+
+
+// Poll the next telemetry channel. Returns 1 if a sensor was accessed and 0 if
+// no sensor group is due.
+int TelemetryPoll(void)
+{
+    tTelemetryGroup *psGroup;
+    uint32_t ui32Now;
+
+    // Continue a polling pass that is already in progress.
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        psGroup = &g_psTelemetryGroup[i];
+        if (TelemetryGroupBlocked(psGroup)) continue;
+        if (psGroup->ui32ChNext < psGroup->ui32ChNum) {
+            TelemetryUpdateChannel(psGroup->ui32ChFirst + psGroup->ui32ChNext++);
+            return 1;
+        }
+    }
+
+    // Start a new polling pass of the next sensor group which is due.
+    ui32Now = GetUptimeMs();
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        psGroup = &g_psTelemetryGroup[i];
+        if (!psGroup->ui32PeriodMs || TelemetryGroupBlocked(psGroup)) continue;
+        if (ui32Now - psGroup->ui32LastMs >= psGroup->ui32PeriodMs) {
+            psGroup->ui32LastMs = ui32Now;
+            psGroup->ui32ChNext = 1;
+            TelemetryUpdateChannel(psGroup->ui32ChFirst);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+// Read a register of an I2C device using a write followed by a read with
+// repeated start.
+uint32_t TelemetryI2CReadReg(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t ui8Reg, uint8_t *pui8Data, uint8_t ui8Length)
+{
+    uint32_t ui32Status;
+
+    ui32Status = I2CMasterWriteAdv(psI2C, ui8SlaveAddr, &ui8Reg, 1, false, false);
+    if (ui32Status) return ui32Status;
+
+    return I2CMasterReadAdv(psI2C, ui8SlaveAddr, pui8Data, ui8Length, true, true);
+}
+
+
+
+// Read the temperature of a FireFly module behind a PCA9547 I2C mux. The
+// previous mux setting is restored afterwards, so that an I2C access sequence
+// of the host is not disturbed by the background polling.
+uint32_t TelemetryReadFireFly(uint8_t ui8MuxAddr, uint8_t ui8MuxChannel, uint8_t ui8SlaveAddr, uint8_t *pui8Temp)
+{
+    tI2C *psI2C = &g_psI2C[TELEMETRY_I2C_PORT_FIREFLY];
+    uint8_t ui8MuxBackup, ui8MuxSet;
+    uint32_t ui32Status;
+
+    ui32Status = I2CMasterRead(psI2C, ui8MuxAddr, &ui8MuxBackup, 1);
+    if (ui32Status) return ui32Status;
+    ui8MuxSet = (ui8MuxChannel & 0x07) | TELEMETRY_PCA9547_ENABLE;
+    ui32Status = I2CMasterWrite(psI2C, ui8MuxAddr, &ui8MuxSet, 1);
+    if (!ui32Status) {
+        ui32Status = TelemetryI2CReadReg(psI2C, ui8SlaveAddr, TELEMETRY_FIREFLY_REG_TEMP, pui8Temp, 1);
+    }
+    I2CMasterWrite(psI2C, ui8MuxAddr, &ui8MuxBackup, 1);
+
+    return ui32Status;
+}
+
+
+
+// Measure a telemetry channel and update the cache.
+int TelemetryUpdateChannel(uint32_t ui32Ch)
+{
+    tI2C *psI2C = &g_psI2C[TELEMETRY_I2C_PORT_TEMP_MON];
+    tTelemetryValue *psValue;
+    uint32_t ui32Status = 0;
+    uint8_t pui8Data[2] = {0, 0};
+    int32_t i32Value = 0;
+    int32_t i32Raw;
+    uint32_t i;
+
+    if (ui32Ch >= TELEMETRY_CH_NUM) return -1;
+
+    // Analog temperatures of the power modules.
+    if (ui32Ch < TELEMETRY_CH_MCP9903) {
+        i32Value = (int32_t) (Adc2Temp(AdcConvert(g_psTelemetryAdc[ui32Ch - TELEMETRY_CH_ADC])) * 100);
+    // MCP9903: Integer part and fraction in steps of 0.125 degC (bits 7..5).
+    } else if (ui32Ch < TELEMETRY_CH_MCP9808) {
+        i = ui32Ch - TELEMETRY_CH_MCP9903;
+        ui32Status = TelemetryI2CReadReg(psI2C, TELEMETRY_I2C_ADR_MCP9903, g_pui8TelemetryMcp9903Reg[i][0], &pui8Data[0], 1);
+        if (!ui32Status)
+            ui32Status = TelemetryI2CReadReg(psI2C, TELEMETRY_I2C_ADR_MCP9903, g_pui8TelemetryMcp9903Reg[i][1], &pui8Data[1], 1);
+        i32Value = (int8_t) pui8Data[0] * 100 + ((pui8Data[1] >> 5) * 25) / 2;
+    // MCP9808: 13 bit two's complement value in steps of 0.0625 degC.
+    } else if (ui32Ch < TELEMETRY_CH_FIREFLY_RX) {
+        i = ui32Ch - TELEMETRY_CH_MCP9808;
+        ui32Status = TelemetryI2CReadReg(psI2C, TELEMETRY_I2C_ADR_MCP9808 + i, TELEMETRY_MCP9808_REG_TEMP, pui8Data, 2);
+        i32Raw = ((pui8Data[0] << 8) | pui8Data[1]) & 0x1fff;
+        if (i32Raw & 0x1000) i32Raw -= 0x2000;
+        i32Value = (i32Raw * 25) / 4;
+    // FireFly modules: Signed value in degC.
+    } else if (ui32Ch < TELEMETRY_CH_FIREFLY_TX) {
+        i = ui32Ch - TELEMETRY_CH_FIREFLY_RX;
+        ui32Status = TelemetryReadFireFly(TELEMETRY_I2C_ADR_FIREFLY_MUX_RX, i, TELEMETRY_I2C_ADR_FIREFLY_RX, pui8Data);
+        i32Value = (int8_t) pui8Data[0] * 100;
+    } else {
+        i = ui32Ch - TELEMETRY_CH_FIREFLY_TX;
+        ui32Status = TelemetryReadFireFly(TELEMETRY_I2C_ADR_FIREFLY_MUX_TX, i, TELEMETRY_I2C_ADR_FIREFLY_TX, pui8Data);
+        i32Value = (int8_t) pui8Data[0] * 100;
+    }
+
+    // Update the cache. On error, keep the last valid value but mark it.
+    psValue = &g_sTelemetryCache.psValue[ui32Ch];
+    if (ui32Status) {
+        psValue->ui8Flags = (psValue->ui8Flags & ~TELEMETRY_FLAG_VALID) | TELEMETRY_FLAG_ERROR;
+    } else {
+        psValue->i32Value = i32Value;
+        psValue->ui8Flags = TELEMETRY_FLAG_VALID;
+    }
+    psValue->ui32Timestamp = GetUptimeMs();
+    g_sTelemetryCache.ui32Version++;
+
+    return ui32Status ? -1 : 0;
+}
+
+
+
+// Print a value in units of 0.01 as a decimal number.
+void TelemetryPrintValue(int32_t i32Value)
+{
+    if (i32Value < 0) {
+        UARTprintf("-");
+        i32Value = -i32Value;
+    }
+    UARTprintf("%d.%02d", i32Value / 100, i32Value % 100);
+}
+
+
+
+// Print a value as little-endian hexadecimal bytes.
+void TelemetryPrintHex(uint32_t ui32Value, int iBytes)
+{
+    for (int i = 0; i < iBytes; i++) {
+        UARTprintf("%02x", (ui32Value >> (8 * i)) & 0xff);
+    }
+}
+
+
+
+// Show the telemetry snapshot in text format.
+void TelemetryShowText(void)
+{
+    tTelemetryValue *psValue;
+    uint32_t ui32Now = GetUptimeMs();
+
+    UARTprintf("%s: Telemetry snapshot version %u at uptime %u ms.", UI_STR_OK, g_sTelemetryCache.ui32Version, ui32Now);
+    for (int i = 0; i < TELEMETRY_CH_NUM; i++) {
+        psValue = &g_sTelemetryCache.psValue[i];
+        UARTprintf("\n%28s: ", g_pcTelemetryName[i]);
+        if (psValue->ui8Flags & TELEMETRY_FLAG_VALID) {
+            TelemetryPrintValue(psValue->i32Value);
+            UARTprintf(" degC, age %u ms", ui32Now - psValue->ui32Timestamp);
+        } else if (psValue->ui8Flags & TELEMETRY_FLAG_ERROR) {
+            UARTprintf("error");
+        } else {
+            UARTprintf("n/a");
+        }
+    }
+}
+
+
+
+// Show the telemetry snapshot in binary format. The binary data are sent as
+// hexadecimal string to keep the UART UI line based. All values are little
+// endian:
+// - uint8_t  format version (TELEMETRY_FORMAT_VERSION)
+// - uint8_t  number of channels
+// - uint32_t cache version
+// - uint32_t uptime in ms
+// - per channel:
+//   - int16_t  value in units of 0.01 degC
+//   - uint32_t timestamp (uptime in ms)
+//   - uint8_t  flags (TELEMETRY_FLAG_*)
+void TelemetryShowBinary(void)
+{
+    tTelemetryValue *psValue;
+
+    UARTprintf("%s: ", UI_STR_OK);
+    TelemetryPrintHex(TELEMETRY_FORMAT_VERSION, 1);
+    TelemetryPrintHex(TELEMETRY_CH_NUM, 1);
+    TelemetryPrintHex(g_sTelemetryCache.ui32Version, 4);
+    TelemetryPrintHex(GetUptimeMs(), 4);
+    for (int i = 0; i < TELEMETRY_CH_NUM; i++) {
+        psValue = &g_sTelemetryCache.psValue[i];
+        TelemetryPrintHex((uint16_t) ((int16_t) psValue->i32Value), 2);
+        TelemetryPrintHex(psValue->ui32Timestamp, 4);
+        TelemetryPrintHex(psValue->ui8Flags, 1);
+    }
+}
+
+
+
+// Show or set the polling periods of the sensor groups.
+int TelemetryRate(char *pcCmd, char *pcParam)
+{
+    tTelemetryGroup *psGroup = NULL;
+    char *pcGroup = pcParam;
+
+    // Show the polling periods of all sensor groups.
+    if (pcGroup == NULL) {
+        UARTprintf("%s: Polling periods:", UI_STR_OK);
+        for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+            UARTprintf(" %s = %d ms", g_psTelemetryGroup[i].pcName, g_psTelemetryGroup[i].ui32PeriodMs);
+            if (i < TELEMETRY_GROUP_NUM - 1) UARTprintf(",");
+        }
+        return 0;
+    }
+    for (int i = 0; i < TELEMETRY_GROUP_NUM; i++) {
+        if (!strcasecmp(pcGroup, g_psTelemetryGroup[i].pcName)) {
+            psGroup = &g_psTelemetryGroup[i];
+            break;
+        }
+    }
+    if (psGroup == NULL) {
+        UARTprintf("%s: Unknown sensor group `%s'!", UI_STR_ERROR, pcGroup);
+        return -1;
+    }
+    pcParam = strtok(NULL, UI_STR_DELIMITER);
+    if (pcParam != NULL) {
+        psGroup->ui32PeriodMs = strtoul(pcParam, (char **) NULL, 0);
+    }
+    UARTprintf("%s: Polling period of sensor group %s: %d ms", UI_STR_OK, psGroup->pcName, psGroup->ui32PeriodMs);
+
+    return 0;
+}
+
+
+
+// Telemetry command.
+int TelemetryCmd(char *pcCmd, char *pcParam)
+{
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "text")) {
+        TelemetryShowText();
+    } else if (!strcasecmp(pcParam, "help")) {
+        TelemetryHelp();
+    } else if (!strcasecmp(pcParam, "bin")) {
+        TelemetryShowBinary();
+    } else if (!strcasecmp(pcParam, "rate")) {
+        return TelemetryRate(pcCmd, strtok(NULL, UI_STR_DELIMITER));
+    } else {
+        UARTprintf("%s: Unknown telemetry command `%s'!\n", UI_STR_ERROR, pcParam);
+        TelemetryHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the telemetry command.
+void TelemetryHelp(void)
+{
+    UARTprintf("Available telemetry commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  text                                Show the telemetry snapshot as text (default).\n");
+    UARTprintf("  bin                                 Show the telemetry snapshot in binary format.\n");
+    UARTprintf("  rate    [GROUP [PERIOD]]            Get/Set the polling period in ms of a sensor\n");
+    UARTprintf("                                          group (adc, board, firefly; 0 = off).");
+}
@@ -0,0 +1,118 @@
+// File: telemetry.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the telemetry cache for the hardware test firmware running on
+// the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+
+
+// ******************************************************************
+// Telemetry parameters.
+// ******************************************************************
+
+// Version of the binary snapshot format. Increment on every change!
+#define TELEMETRY_FORMAT_VERSION        1
+
+// Default polling periods of the sensor groups in ms. A period of 0 disables
+// the polling of a sensor group.
+#define TELEMETRY_PERIOD_ADC            1000
+#define TELEMETRY_PERIOD_BOARD          1000
+#define TELEMETRY_PERIOD_FIREFLY        5000
+
+// I2C ports and slave addresses of the sensors.
+#define TELEMETRY_I2C_PORT_FIREFLY      2
+#define TELEMETRY_I2C_PORT_TEMP_MON     4
+#define TELEMETRY_I2C_ADR_MCP9903       0x5c    // IC39 (MCP9903).
+#define TELEMETRY_I2C_ADR_MCP9808       0x18    // IC34..IC38 (MCP9808): 0x18..0x1c.
+#define TELEMETRY_I2C_ADR_FIREFLY_MUX_RX 0x70   // IC24 (PCA9547PW).
+#define TELEMETRY_I2C_ADR_FIREFLY_MUX_TX 0x71   // IC25 (PCA9547PW).
+#define TELEMETRY_I2C_ADR_FIREFLY_RX    0x54
+#define TELEMETRY_I2C_ADR_FIREFLY_TX    0x50
+
+// Sensor registers.
+#define TELEMETRY_MCP9903_REG_INT       0x00
+#define TELEMETRY_MCP9903_REG_INT_FRACT 0x29
+#define TELEMETRY_MCP9903_REG_EXT1      0x01
+#define TELEMETRY_MCP9903_REG_EXT1_FRACT 0x10
+#define TELEMETRY_MCP9903_REG_EXT2      0x23
+#define TELEMETRY_MCP9903_REG_EXT2_FRACT 0x24
+#define TELEMETRY_MCP9808_REG_TEMP      0x05
+#define TELEMETRY_FIREFLY_REG_TEMP      22
+#define TELEMETRY_PCA9547_ENABLE        0x08
+
+// Number of sensors.
+#define TELEMETRY_ADC_NUM               5
+#define TELEMETRY_MCP9903_NUM           3
+#define TELEMETRY_MCP9808_NUM           5
+#define TELEMETRY_FIREFLY_NUM           8
+
+// Sensor groups.
+#define TELEMETRY_GROUP_ADC             0
+#define TELEMETRY_GROUP_BOARD           1
+#define TELEMETRY_GROUP_FIREFLY         2
+#define TELEMETRY_GROUP_NUM             3
+
+// Telemetry channels. The channels of a sensor group are consecutive.
+#define TELEMETRY_CH_ADC                0
+#define TELEMETRY_CH_MCP9903            (TELEMETRY_CH_ADC + TELEMETRY_ADC_NUM)
+#define TELEMETRY_CH_MCP9808            (TELEMETRY_CH_MCP9903 + TELEMETRY_MCP9903_NUM)
+#define TELEMETRY_CH_FIREFLY_RX         (TELEMETRY_CH_MCP9808 + TELEMETRY_MCP9808_NUM)
+#define TELEMETRY_CH_FIREFLY_TX         (TELEMETRY_CH_FIREFLY_RX + TELEMETRY_FIREFLY_NUM)
+#define TELEMETRY_CH_NUM                (TELEMETRY_CH_FIREFLY_TX + TELEMETRY_FIREFLY_NUM)
+
+// Status flags of a telemetry value.
+#define TELEMETRY_FLAG_VALID            0x01
+#define TELEMETRY_FLAG_ERROR            0x02
+
+
+
+// Types.
+typedef struct {
+    int32_t  i32Value;              // Value in units of 0.01 degC.
+    uint32_t ui32Timestamp;         // Uptime in ms when the value was measured.
+    uint8_t  ui8Flags;              // TELEMETRY_FLAG_*.
+} tTelemetryValue;
+
+typedef struct {
+    uint32_t ui32Version;           // Incremented on every update of the cache.
+    tTelemetryValue psValue[TELEMETRY_CH_NUM];
+} tTelemetryCache;
+
+typedef struct {
+    char     *pcName;
+    uint32_t ui32ChFirst;           // First telemetry channel of the group.
+    uint32_t ui32ChNum;             // Number of telemetry channels.
+    int      iI2CPort;              // I2C port of the sensors. -1 = none.
+    uint32_t ui32PeriodMs;          // Polling period in ms. 0 = disabled.
+    uint32_t ui32LastMs;            // Start of the last polling pass.
+    uint32_t ui32ChNext;            // Next channel to poll in the current pass.
+} tTelemetryGroup;
+
+
+
+// Globals.
+extern tTelemetryCache g_sTelemetryCache;
+extern tTelemetryGroup g_psTelemetryGroup[TELEMETRY_GROUP_NUM];
+
+
+
+// Function prototypes.
+void TelemetryInit(void);
+int TelemetryPoll(void);
+int TelemetryUpdateChannel(uint32_t ui32Ch);
+void TelemetryPrintHex(uint32_t ui32Value, int iBytes);
+int TelemetryCmd(char *pcCmd, char *pcParam);
+void TelemetryHelp(void);
+
+
+
+#endif  // __TELEMETRY_H__
@@ -0,0 +1,187 @@
+// File: timestamp.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Timestamps for the hardware test firmware running on the ATLAS MDT Trigger
+// Processor (TP) Command Module (CM) MCU.
+//
+// The timestamps are based on the 64 bit monotonic system uptime in us. The
+// host can set an epoch offset with the `time sync' command, e.g. to the UNIX
+// time in us, in order to correlate the events of the CM with the logs of the
+// Service Module (SM) and the IPMC. Before the first synchronization the
+// timestamps are equal to the system uptime.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "utils/uartstdio.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "timestamp.h"
+
+
+
+// Epoch offset in us and uptime in us of the last synchronization. The offset
+// is read in interrupt handlers, so it is accessed with interrupts masked, as
+// the 64 bit access takes two instructions.
+int64_t g_i64TimestampOffsetUs = 0;
+uint64_t g_ui64TimestampSyncUs = 0;
+bool g_bTimestampSynced = false;
+
+
+
+// Get the current timestamp in us. This function can be called from interrupt
+// handlers.
+uint64_t TimestampGetUs(void)
+{
+    return TimestampFromUptimeUs(GetUptimeUs());
+}
+
+
+
+// Convert a system uptime in us into a timestamp in us.
+uint64_t TimestampFromUptimeUs(uint64_t ui64UptimeUs)
+{
+    int64_t i64OffsetUs;
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    i64OffsetUs = g_i64TimestampOffsetUs;
+    if (!bIntMasked) MAP_IntMasterEnable();
+
+    return ui64UptimeUs + i64OffsetUs;
+}
+
+
+
+// Add a correction to the epoch offset.
+static void TimestampOffsetAdd(int64_t i64CorrectionUs)
+{
+    bool bIntMasked;
+
+    bIntMasked = MAP_IntMasterDisable();
+    g_i64TimestampOffsetUs += i64CorrectionUs;
+    if (!bIntMasked) MAP_IntMasterEnable();
+}
+
+
+
+// Check if the timestamps were synchronized with the host.
+bool TimestampIsSynced(void)
+{
+    return g_bTimestampSynced;
+}
+
+
+
+// Print a timestamp in seconds with us resolution.
+void TimestampPrint(uint64_t ui64TimestampUs)
+{
+    UARTprintf("%u.%06u", (uint32_t) (ui64TimestampUs / 1000000), (uint32_t) (ui64TimestampUs % 1000000));
+}
+
+
+
+// Print a signed 64 bit value.
+void TimestampPrintSigned(int64_t i64Value)
+{
+    uint64_t ui64Value;
+
+    if (i64Value < 0) {
+        UARTprintf("-");
+        ui64Value = -i64Value;
+    } else {
+        ui64Value = i64Value;
+    }
+    // The UARTprintf function only supports 32 bit values.
+    if (ui64Value >= 1000000000) {
+        UARTprintf("%u%09u", (uint32_t) (ui64Value / 1000000000), (uint32_t) (ui64Value % 1000000000));
+    } else {
+        UARTprintf("%u", (uint32_t) ui64Value);
+    }
+}
+
+
+
+// Time command.
+int TimeCmd(char *pcCmd, char *pcParam)
+{
+    uint64_t ui64UptimeUs, ui64TimestampUs;
+    int64_t i64Skew;
+
+    // Sample the time base as early as possible.
+    ui64UptimeUs = GetUptimeUs();
+    ui64TimestampUs = TimestampFromUptimeUs(ui64UptimeUs);
+
+    if ((pcParam == NULL) || !strcasecmp(pcParam, "show")) {
+        UARTprintf("%s: Uptime: ", UI_STR_OK);
+        TimestampPrint(ui64UptimeUs);
+        UARTprintf(" s, time: ");
+        TimestampPrint(ui64TimestampUs);
+        if (g_bTimestampSynced) {
+            UARTprintf(" s, last sync: ");
+            TimestampPrint(ui64UptimeUs - g_ui64TimestampSyncUs);
+            UARTprintf(" s ago.");
+        } else {
+            UARTprintf(" s, not synchronized.");
+        }
+    // Raw timestamp in us for the host.
+    } else if (!strcasecmp(pcParam, "get")) {
+        UARTprintf("%s: ", UI_STR_OK);
+        TimestampPrintSigned(ui64TimestampUs);
+    // Set the timestamp. Show the skew to the previous time.
+    } else if (!strcasecmp(pcParam, "sync")) {
+        pcParam = strtok(NULL, UI_STR_DELIMITER);
+        if (pcParam == NULL) {
+            UARTprintf("%s: Time in us required after `%s sync'.", UI_STR_ERROR, pcCmd);
+            return -1;
+        }
+        i64Skew = ui64TimestampUs - strtoull(pcParam, (char **) NULL, 0);
+        TimestampOffsetAdd(-i64Skew);
+        g_ui64TimestampSyncUs = ui64UptimeUs;
+        g_bTimestampSynced = true;
+        UARTprintf("%s: Skew: ", UI_STR_OK);
+        TimestampPrintSigned(i64Skew);
+        UARTprintf(" us.");
+    // Adjust the timestamp, e.g. by the skew measured by the host.
+    } else if (!strcasecmp(pcParam, "adjust")) {
+        pcParam = strtok(NULL, UI_STR_DELIMITER);
+        if (pcParam == NULL) {
+            UARTprintf("%s: Correction in us required after `%s adjust'.", UI_STR_ERROR, pcCmd);
+            return -1;
+        }
+        TimestampOffsetAdd(strtoll(pcParam, (char **) NULL, 0));
+        UARTprintf("%s.", UI_STR_OK);
+    } else if (!strcasecmp(pcParam, "help")) {
+        TimeHelp();
+    } else {
+        UARTprintf("%s: Unknown time command `%s'!\n", UI_STR_ERROR, pcParam);
+        TimeHelp();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+// Show help on the time command.
+void TimeHelp(void)
+{
+    UARTprintf("Available time commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  show                                Show the uptime and time (default).\n");
+    UARTprintf("  get                                 Get the time in us.\n");
+    UARTprintf("  sync    TIME_US                     Set the time in us and show the skew.\n");
+    UARTprintf("  adjust  CORRECTION_US               Add a correction in us to the time.");
+}
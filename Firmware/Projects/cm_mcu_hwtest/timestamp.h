@@ -0,0 +1,28 @@
+// File: timestamp.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the timestamps for the hardware test firmware running on the
+// ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+
+
+
+#ifndef __TIMESTAMP_H__
+#define __TIMESTAMP_H__
+
+
+
+// Function prototypes.
+uint64_t TimestampGetUs(void);
+uint64_t TimestampFromUptimeUs(uint64_t ui64UptimeUs);
+bool TimestampIsSynced(void);
+void TimestampPrint(uint64_t ui64TimestampUs);
+int TimeCmd(char *pcCmd, char *pcParam);
+void TimeHelp(void);
+
+
+
+#endif  // __TIMESTAMP_H__
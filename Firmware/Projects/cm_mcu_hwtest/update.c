@@ -0,0 +1,529 @@
+// File: update.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Firmware update in the background for the hardware test firmware running on
+// the ATLAS MDT Trigger Processor (TP) Command Module (CM) MCU.
+//
+// The command `update' switches the UART UI to the packet protocol of the
+// serial boot loader, so the new image is downloaded with sflash into the
+// application slot which is not running. Meanwhile, the firmware keeps on
+// monitoring the hardware and the power domains stay as they are. At the end
+// of the download, sflash sends the reset command. If the new image is valid,
+// the firmware requests the boot loader to start it without waiting for the
+// boot loader menu (fw_boot.h) and resets the MCU. Otherwise the UART UI is
+// restored. The windowed transfer and the compressed download are not
+// supported, sflash detects this and sends one packet at a time.
+//
+// The flash is erased and programmed while sflash waits for the acknowledge,
+// as the CPU stalls while the flash is busy.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/flash.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/sw_crc.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
+#include "utils/uartstdio.h"
+#include "boot_loader/bl_commands.h"
+#include "fw_boot.h"
+#include "fw_slot.h"
+#include "fw_update.h"
+#include "uart_ui.h"
+#include "cm_mcu_hwtest.h"
+#include "cm_mcu_hwtest_aux.h"
+#include "boot.h"
+#include "cpu_load.h"
+#include "slot.h"
+#include "update.h"
+
+
+
+// UART UI. Defined in cm_mcu_hwtest.c.
+extern tUartUi *g_psUartUi;
+
+// States of the packet receiver.
+#define UPDATE_RX_SIZE                  0
+#define UPDATE_RX_CHECKSUM              1
+#define UPDATE_RX_DATA                  2
+
+// The update is in progress.
+static bool g_bUpdateActive;
+// Slot which is updated.
+static int g_iUpdateSlot;
+
+// Receive ring buffer, filled by the UART interrupt handler.
+static volatile uint8_t g_pui8UpdateRx[UPDATE_RX_BUFFER_SIZE];
+static volatile uint32_t g_ui32UpdateRxHead;
+static volatile uint32_t g_ui32UpdateRxTail;
+
+// Packet receiver.
+static uint32_t g_ui32UpdateRxState;
+static uint8_t g_pui8UpdatePacket[256];
+static uint32_t g_ui32UpdatePacketSize;
+static uint32_t g_ui32UpdatePacketCount;
+static uint8_t g_ui8UpdatePacketCheckSum;
+static uint32_t g_ui32UpdateByteMs;
+static uint32_t g_ui32UpdatePacketMs;
+
+// Last packet sent to the host. It is sent again if the host does not
+// acknowledge it.
+static uint8_t g_pui8UpdateReply[1 + 4 + 4 * BL_PAGE_CRC_MAX];
+static uint32_t g_ui32UpdateReplySize;
+static bool g_bUpdateReplyPending;
+
+// Status of the last command and the current download.
+static uint8_t g_ui8UpdateStatus;
+static uint32_t g_ui32UpdateAddress;
+static uint32_t g_ui32UpdateSize;
+// End of the erased part of the current download.
+static uint32_t g_ui32UpdateErased;
+
+
+
+// UART interrupt handler while the update is in progress. The received data is
+// put into the ring buffer. Data which does not fit is dropped, the packet is
+// rejected then and sent again by the host.
+static void UpdateUartIntHandler(void)
+{
+    uint32_t ui32Base = g_psUartUi->ui32Base;
+    uint32_t ui32Next;
+
+    MAP_UARTIntClear(ui32Base, MAP_UARTIntStatus(ui32Base, true));
+    while (MAP_UARTCharsAvail(ui32Base)) {
+        ui32Next = (g_ui32UpdateRxHead + 1) % UPDATE_RX_BUFFER_SIZE;
+        if (ui32Next == g_ui32UpdateRxTail) {
+            MAP_UARTCharGetNonBlocking(ui32Base);
+            continue;
+        }
+        g_pui8UpdateRx[g_ui32UpdateRxHead] = MAP_UARTCharGetNonBlocking(ui32Base) & 0xff;
+        g_ui32UpdateRxHead = ui32Next;
+    }
+}
+
+
+
+// Send data to the host.
+static void UpdateSend(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    for (uint32_t i = 0; i < ui32Size; i++) {
+        MAP_UARTCharPut(g_psUartUi->ui32Base, pui8Data[i]);
+    }
+}
+
+
+
+// Acknowledge a packet of the host.
+static void UpdateAck(void)
+{
+    uint8_t pui8Ack[2] = {0, COMMAND_ACK};
+
+    UpdateSend(pui8Ack, sizeof(pui8Ack));
+}
+
+
+
+// Reject a packet of the host.
+static void UpdateNak(void)
+{
+    uint8_t pui8Nak[2] = {0, COMMAND_NAK};
+
+    UpdateSend(pui8Nak, sizeof(pui8Nak));
+}
+
+
+
+// Send the reply packet (size, checksum, data). The host acknowledges it.
+static void UpdateSendReply(void)
+{
+    uint8_t pui8Header[2];
+
+    pui8Header[0] = g_ui32UpdateReplySize + 2;
+    pui8Header[1] = 0;
+    for (uint32_t i = 0; i < g_ui32UpdateReplySize; i++) {
+        pui8Header[1] += g_pui8UpdateReply[i];
+    }
+    UpdateSend(pui8Header, sizeof(pui8Header));
+    UpdateSend(g_pui8UpdateReply, g_ui32UpdateReplySize);
+    g_bUpdateReplyPending = true;
+}
+
+
+
+// Get a 32 bit value in big endian order from a packet.
+static uint32_t UpdateGetWord(const uint8_t *pui8Data)
+{
+    return (pui8Data[0] << 24) | (pui8Data[1] << 16) | (pui8Data[2] << 8) | pui8Data[3];
+}
+
+
+
+// Erase the flash of the current download up to the given address.
+static int UpdateErase(uint32_t ui32End)
+{
+    while (g_ui32UpdateErased < ui32End) {
+        if (MAP_FlashErase(g_ui32UpdateErased)) return -1;
+        g_ui32UpdateErased += FLASH_SECTOR_SIZE;
+    }
+
+    return 0;
+}
+
+
+
+// Start a download. It must start at an erase block in the slot which is
+// updated. The flash is erased while the data is programmed, so that the
+// firmware is not stalled for the whole slot at once.
+static uint8_t UpdateDownload(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Start = FW_SLOT_START(g_iUpdateSlot);
+    uint32_t ui32Addr, ui32Length;
+
+    g_ui32UpdateSize = 0;
+    if (ui32Size != 9) return COMMAND_RET_INVALID_CMD;
+    ui32Addr = UpdateGetWord(pui8Data + 1);
+    ui32Length = UpdateGetWord(pui8Data + 5);
+    if ((ui32Addr < ui32Start) || (ui32Addr & (FLASH_SECTOR_SIZE - 1)) || (ui32Length == 0) ||
+        (ui32Addr >= ui32Start + FW_SLOT_SIZE) || (ui32Length > ui32Start + FW_SLOT_SIZE - ui32Addr)) {
+        return COMMAND_RET_INVALID_ADR;
+    }
+
+    g_ui32UpdateAddress = ui32Addr;
+    g_ui32UpdateSize = ui32Length;
+    g_ui32UpdateErased = ui32Addr;
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Program the data of a packet.
+static uint8_t UpdateSendData(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t pui32Data[64];
+
+    ui32Size--;
+    if ((ui32Size == 0) || (ui32Size > g_ui32UpdateSize) || (g_ui32UpdateAddress & 3)) {
+        return COMMAND_RET_INVALID_ADR;
+    }
+    // The flash is programmed in words. Fill up the last word with the erased
+    // value.
+    memset(pui32Data, 0xff, sizeof(pui32Data));
+    memcpy(pui32Data, pui8Data + 1, ui32Size);
+    if (UpdateErase(g_ui32UpdateAddress + ui32Size) ||
+        MAP_FlashProgram(pui32Data, g_ui32UpdateAddress, (ui32Size + 3) & ~3)) {
+        return COMMAND_RET_FLASH_FAIL;
+    }
+    g_ui32UpdateAddress += ui32Size;
+    g_ui32UpdateSize -= ui32Size;
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Skip blank data of the current download, which is left erased.
+static uint8_t UpdateSkipData(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Count;
+
+    if (ui32Size != 5) return COMMAND_RET_INVALID_CMD;
+    ui32Count = UpdateGetWord(pui8Data + 1);
+    if ((ui32Count > g_ui32UpdateSize) || ((ui32Count & 3) && (ui32Count != g_ui32UpdateSize))) {
+        return COMMAND_RET_INVALID_ADR;
+    }
+    if (UpdateErase(g_ui32UpdateAddress + ui32Count)) return COMMAND_RET_FLASH_FAIL;
+    g_ui32UpdateAddress += ui32Count;
+    g_ui32UpdateSize -= ui32Count;
+
+    return COMMAND_RET_SUCCESS;
+}
+
+
+
+// Prepare the reply with the CRC32 of erase blocks of the slot which is
+// updated. The format is the same as the one of the boot loader.
+static uint8_t UpdateGetPageCrc(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Start = FW_SLOT_START(g_iUpdateSlot);
+    uint8_t ui8Status = COMMAND_RET_SUCCESS;
+    uint32_t ui32Addr = 0;
+    uint32_t ui32Count = 0;
+    uint32_t ui32Crc;
+
+    if (ui32Size != 6) {
+        ui8Status = COMMAND_RET_INVALID_CMD;
+    } else {
+        ui32Addr = UpdateGetWord(pui8Data + 1);
+        ui32Count = pui8Data[5];
+        if ((ui32Count > BL_PAGE_CRC_MAX) || (ui32Addr & (FLASH_SECTOR_SIZE - 1)) ||
+            (ui32Addr < ui32Start) || (ui32Addr > ui32Start + FW_SLOT_SIZE) ||
+            (ui32Count * FLASH_SECTOR_SIZE > ui32Start + FW_SLOT_SIZE - ui32Addr)) {
+            ui8Status = COMMAND_RET_INVALID_ADR;
+            ui32Count = 0;
+        }
+    }
+
+    g_pui8UpdateReply[0] = ui8Status;
+    g_pui8UpdateReply[1] = FLASH_SECTOR_SIZE >> 24;
+    g_pui8UpdateReply[2] = FLASH_SECTOR_SIZE >> 16;
+    g_pui8UpdateReply[3] = FLASH_SECTOR_SIZE >> 8;
+    g_pui8UpdateReply[4] = FLASH_SECTOR_SIZE & 0xff;
+    for (uint32_t i = 0; i < ui32Count; i++) {
+        ui32Crc = MAP_Crc32(0xffffffff, (const uint8_t *) (ui32Addr + i * FLASH_SECTOR_SIZE), FLASH_SECTOR_SIZE) ^ 0xffffffff;
+        g_pui8UpdateReply[5 + 4 * i] = ui32Crc >> 24;
+        g_pui8UpdateReply[6 + 4 * i] = ui32Crc >> 16;
+        g_pui8UpdateReply[7 + 4 * i] = ui32Crc >> 8;
+        g_pui8UpdateReply[8 + 4 * i] = ui32Crc & 0xff;
+    }
+    g_ui32UpdateReplySize = 5 + 4 * ui32Count;
+
+    return ui8Status;
+}
+
+
+
+// Check the image in the slot which was updated. Returns NULL if the boot
+// loader will start it, otherwise the reason why not.
+static const char *UpdateCheck(void)
+{
+    const tFwSlotHeader *psHeader = FW_SLOT_HEADER(g_iUpdateSlot);
+    const tFwSlotHeader *psActive = FW_SLOT_HEADER(SlotActive());
+    const uint32_t *pui32Vectors = (const uint32_t *) (FW_SLOT_START(g_iUpdateSlot) + FW_SLOT_HEADER_SIZE);
+
+    if (g_ui32UpdateSize) return "download incomplete";
+    if (psHeader->ui32Magic != FW_SLOT_MAGIC) return "no image header";
+    if (psHeader->ui32Length > FW_SLOT_SIZE - FW_SLOT_HEADER_SIZE) return "invalid length";
+    if ((MAP_Crc32(0xffffffff, (const uint8_t *) pui32Vectors, psHeader->ui32Length) ^ 0xffffffff) != psHeader->ui32Crc) {
+        return "CRC error";
+    }
+    // The reset vector must point into the slot, i.e. the image must be
+    // linked for it.
+    if ((pui32Vectors[1] < FW_SLOT_START(g_iUpdateSlot)) ||
+        (pui32Vectors[1] >= FW_SLOT_START(g_iUpdateSlot) + FW_SLOT_SIZE)) {
+        return "image linked for the other slot";
+    }
+    // The boot loader starts the slot with the highest version. A running
+    // firmware without image header, e.g. loaded by the debugger, is treated
+    // like an empty slot by the boot loader, so any valid image replaces it.
+    if ((psActive->ui32Magic == FW_SLOT_MAGIC) && (psHeader->ui32Version <= psActive->ui32Version)) {
+        return "version not newer than the running firmware";
+    }
+
+    return NULL;
+}
+
+
+
+// Stop the update and restore the UART UI.
+static void UpdateStop(void)
+{
+    UARTIntRegister(g_psUartUi->ui32Base, UartUiIntHandler);
+    g_bUpdateActive = false;
+}
+
+
+
+// Start the new image if it is valid. Otherwise restore the UART UI.
+static void UpdateFinish(void)
+{
+    const char *pcError = UpdateCheck();
+
+    if (pcError == NULL) {
+        // Wait for the UART to send out the acknowledge.
+        while (MAP_UARTBusy(g_psUartUi->ui32Base));
+        BootRequest(FW_BOOT_REQ_UPDATE);
+        SysCtlReset();
+    }
+
+    UpdateStop();
+    UARTprintf("\n%s: Slot %c not started: %s.\n", UI_STR_ERROR, FW_SLOT_NAME(g_iUpdateSlot), pcError);
+}
+
+
+
+// Handle a packet of the host. Each packet is acknowledged after the command
+// was executed.
+static void UpdatePacket(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    switch (pui8Data[0]) {
+        case COMMAND_PING:
+            g_ui8UpdateStatus = COMMAND_RET_SUCCESS;
+            UpdateAck();
+            break;
+        case COMMAND_GET_STATUS:
+            UpdateAck();
+            g_pui8UpdateReply[0] = g_ui8UpdateStatus;
+            g_ui32UpdateReplySize = 1;
+            UpdateSendReply();
+            break;
+        case COMMAND_DOWNLOAD:
+        case COMMAND_DOWNLOAD_PAGES:
+            g_ui8UpdateStatus = UpdateDownload(pui8Data, ui32Size);
+            UpdateAck();
+            break;
+        case COMMAND_SEND_DATA:
+            g_ui8UpdateStatus = UpdateSendData(pui8Data, ui32Size);
+            UpdateAck();
+            break;
+        case COMMAND_SKIP_DATA:
+            g_ui8UpdateStatus = UpdateSkipData(pui8Data, ui32Size);
+            UpdateAck();
+            break;
+        case COMMAND_GET_PAGE_CRC:
+            UpdateAck();
+            g_ui8UpdateStatus = UpdateGetPageCrc(pui8Data, ui32Size);
+            UpdateSendReply();
+            break;
+        // The baud rate of the UART UI is kept.
+        case COMMAND_SET_BAUD:
+            g_ui8UpdateStatus = COMMAND_RET_INVALID_CMD;
+            UpdateNak();
+            break;
+        case COMMAND_RUN:
+        case COMMAND_RESET:
+            UpdateAck();
+            UpdateFinish();
+            break;
+        // Windowed transfer, compressed download and unknown commands.
+        default:
+            g_ui8UpdateStatus = COMMAND_RET_UNKNOWN_CMD;
+            UpdateAck();
+            break;
+    }
+}
+
+
+
+// Check if the update is in progress.
+bool UpdateActive(void)
+{
+    return g_bUpdateActive;
+}
+
+
+
+// Receive and handle the packets of the host. Called in the main loop instead
+// of reading the UART UI while the update is in progress. Returns 1 if a
+// packet was handled.
+int UpdatePoll(void)
+{
+    uint32_t ui32Now = GetUptimeMs();
+    uint8_t ui8Byte;
+
+    if (!g_bUpdateActive) return 0;
+
+    if (ui32Now - g_ui32UpdatePacketMs >= UPDATE_IDLE_TIMEOUT_MS) {
+        UpdateStop();
+        UARTprintf("\n%s: No update data received for %d s. Update aborted.\n", UI_STR_WARNING,
+                   UPDATE_IDLE_TIMEOUT_MS / 1000);
+        return 0;
+    }
+    // Drop a partially received packet if the host stopped sending.
+    if ((g_ui32UpdateRxState != UPDATE_RX_SIZE) && (g_ui32UpdateRxTail == g_ui32UpdateRxHead) &&
+        (ui32Now - g_ui32UpdateByteMs >= UPDATE_BYTE_TIMEOUT_MS)) {
+        g_ui32UpdateRxState = UPDATE_RX_SIZE;
+    }
+
+    while (g_ui32UpdateRxTail != g_ui32UpdateRxHead) {
+        ui8Byte = g_pui8UpdateRx[g_ui32UpdateRxTail];
+        g_ui32UpdateRxTail = (g_ui32UpdateRxTail + 1) % UPDATE_RX_BUFFER_SIZE;
+        g_ui32UpdateByteMs = ui32Now;
+
+        switch (g_ui32UpdateRxState) {
+            case UPDATE_RX_SIZE:
+                // Leading zeros are idle bytes.
+                if (ui8Byte == 0) break;
+                // Acknowledge of the host for the last reply.
+                if (g_bUpdateReplyPending) {
+                    g_bUpdateReplyPending = false;
+                    if (ui8Byte == COMMAND_NAK) UpdateSendReply();
+                    break;
+                }
+                if (ui8Byte < 3) {
+                    UpdateNak();
+                    break;
+                }
+                g_ui32UpdatePacketSize = ui8Byte - 2;
+                g_ui32UpdateRxState = UPDATE_RX_CHECKSUM;
+                break;
+            case UPDATE_RX_CHECKSUM:
+                g_ui8UpdatePacketCheckSum = ui8Byte;
+                g_ui32UpdatePacketCount = 0;
+                g_ui32UpdateRxState = UPDATE_RX_DATA;
+                break;
+            case UPDATE_RX_DATA:
+                g_pui8UpdatePacket[g_ui32UpdatePacketCount++] = ui8Byte;
+                g_ui8UpdatePacketCheckSum -= ui8Byte;
+                if (g_ui32UpdatePacketCount < g_ui32UpdatePacketSize) break;
+                g_ui32UpdateRxState = UPDATE_RX_SIZE;
+                if (g_ui8UpdatePacketCheckSum) {
+                    UpdateNak();
+                    break;
+                }
+                g_ui32UpdatePacketMs = ui32Now;
+                UpdatePacket(g_pui8UpdatePacket, g_ui32UpdatePacketSize);
+                // Let the other tasks run after each packet.
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+// Update command.
+int UpdateCmd(char *pcCmd, char *pcParam)
+{
+    if ((pcParam != NULL) && !strcasecmp(pcParam, "help")) {
+        UpdateHelp();
+        return 0;
+    } else if ((pcParam != NULL) && strcasecmp(pcParam, "start")) {
+        UARTprintf("%s: Unknown update command `%s'!\n", UI_STR_ERROR, pcParam);
+        UpdateHelp();
+        return -1;
+    }
+
+    g_iUpdateSlot = !SlotActive();
+    g_ui32UpdateRxHead = g_ui32UpdateRxTail = 0;
+    g_ui32UpdateRxState = UPDATE_RX_SIZE;
+    g_bUpdateReplyPending = false;
+    g_ui8UpdateStatus = COMMAND_RET_SUCCESS;
+    g_ui32UpdateSize = 0;
+    g_ui32UpdatePacketMs = GetUptimeMs();
+
+    UARTprintf("%s: Waiting for the update of slot %c at 0x%08x, e.g. `make sflash SLOT=%c'.\n", UI_STR_OK,
+               FW_SLOT_NAME(g_iUpdateSlot), FW_SLOT_START(g_iUpdateSlot), FW_SLOT_NAME(g_iUpdateSlot) + 'a' - 'A');
+    UARTprintf("Quit the terminal program now. The update is aborted after %d s without data.",
+               UPDATE_IDLE_TIMEOUT_MS / 1000);
+    // Wait for the UART to send out the message before taking it over.
+    while (MAP_UARTBusy(g_psUartUi->ui32Base));
+    UARTIntRegister(g_psUartUi->ui32Base, UpdateUartIntHandler);
+    g_bUpdateActive = true;
+
+    return 0;
+}
+
+
+
+// Show help on the update command.
+void UpdateHelp(void)
+{
+    UARTprintf("Available update commands:\n");
+    UARTprintf("  help                                Show this help text.\n");
+    UARTprintf("  start                               Download a new firmware into the slot which\n");
+    UARTprintf("                                          is not running with sflash, then start\n");
+    UARTprintf("                                          it (default).");
+}
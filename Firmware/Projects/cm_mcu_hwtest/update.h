@@ -0,0 +1,44 @@
+// File: update.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 18 Oct 2026
+// Rev.: 18 Oct 2026
+//
+// Header file of the firmware update in the background for the hardware test
+// firmware running on the ATLAS MDT Trigger Processor (TP) Command Module (CM)
+// MCU.
+//
+
+
+
+#ifndef __UPDATE_H__
+#define __UPDATE_H__
+
+
+
+// ******************************************************************
+// Update parameters.
+// ******************************************************************
+
+// Size of the receive ring buffer of the UART UI in bytes. It holds all
+// packets in flight when sflash tries the windowed transfer (up to 16).
+#define UPDATE_RX_BUFFER_SIZE           4096
+// Time in ms without a valid packet after which the update is aborted and the
+// UART UI is restored.
+#define UPDATE_IDLE_TIMEOUT_MS          30000
+// Time in ms without a byte after which a partially received packet is
+// dropped. It must be shorter than the time sflash waits before it sends the
+// next packet after an error.
+#define UPDATE_BYTE_TIMEOUT_MS          100
+
+
+
+// Function prototypes.
+bool UpdateActive(void);
+int UpdatePoll(void);
+int UpdateCmd(char *pcCmd, char *pcParam);
+void UpdateHelp(void);
+
+
+
+#endif  // __UPDATE_H__
@@ -2,7 +2,7 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 15 Jun 2020
-# Rev.: 15 Jun 2020
+# Rev.: 18 Oct 2026
 #
 # Python class for setting and rading the GPIO pins of a given type.
 #
@@ -34,10 +34,13 @@ class McuGpio:
                    "kup",
                    "zup",
                    "reset",
+                   "reserved",
                    "pe-int",
                    "spare"]
     hwMarkDataPatternWrite = "GPIO {0:s} set to"
     hwMarkDataPatternRead = "Current GPIO {0:s} value:"
+    hwMarkDataAll = "GPIO all:"
+    hwMarkDataMulti = "GPIO set:"
 
 
 
@@ -175,3 +178,93 @@ class McuGpio:
     def bits_set(self, gpioType, bitsSet):
         return self.bits_mod(gpioType, 0, bitsSet)
 
+
+
+    # Parse a list of TYPE=VALUE pairs.
+    def parse_pairs(self, dataStr):
+        values = {}
+        for pair in filter(None, dataStr.split(" ")):
+            gpioType, sep, val = pair.partition("=")
+            if not sep:
+                return None
+            values[gpioType] = int(val, 0)
+        return values
+
+
+
+    # Get the current values of all GPIO types with a single command.
+    def get_all(self):
+        if self.debugLevel >= 2:
+            print(self.prefixDebug + "Getting the current values of all GPIO types.")
+        cmd = "gpio all"
+        # Debug: Show command.
+        if self.debugLevel >= 3:
+            print(self.prefixDebug + "Sending command for GPIO: " + cmd)
+        # Send command.
+        self.mcuSer.send(cmd)
+        # Evaluate response.
+        ret = self.mcuSer.eval()
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Error sending command for GPIO!")
+            if self.debugLevel >= 1:
+                print(self.prefixError + "Command sent to MCU: " + cmd)
+                print(self.prefixError + "Response from MCU:")
+                print(self.mcuSer.get_full())
+            return ret, {}
+        # Get and parse response from MCU.
+        dataStr = self.mcuSer.get()
+        dataPos = dataStr.find(self.hwMarkDataAll)
+        values = None
+        if dataPos >= 0:
+            values = self.parse_pairs(dataStr[dataPos+len(self.hwMarkDataAll):].strip())
+        if not values:
+            self.errorCount += 1
+            print(self.prefixError + "Error parsing data read from all GPIO types!")
+            if self.debugLevel >= 1:
+                print(self.prefixError + "Command sent to MCU: " + cmd)
+                print(self.prefixError + "Response from MCU:")
+                print(self.mcuSer.get_full())
+            return -1, {}
+        if self.debugLevel >= 2:
+            for gpioType, val in values.items():
+                print(self.prefixDebug + "GPIO {0:s}: 0x{1:02x}".format(gpioType, val))
+        return 0, values
+
+
+
+    # Set several GPIO types with a single command. The MCU sets all of them
+    # at once. Returns the values read back.
+    def set_multi(self, values):
+        for gpioType in values:
+            if self.check_gpio_type(gpioType):
+                return 1, {}
+        if not values:
+            return 0, {}
+        cmd = "gpio set " + " ".join("{0:s}=0x{1:02x}".format(gpioType, val) for gpioType, val in values.items())
+        # Debug: Show command.
+        if self.debugLevel >= 3:
+            print(self.prefixDebug + "Sending command for GPIO: " + cmd)
+        # Send command.
+        self.mcuSer.send(cmd)
+        # Evaluate response.
+        ret = self.mcuSer.eval()
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Error setting several GPIO types!")
+            if self.debugLevel >= 1:
+                print(self.prefixError + "Command sent to MCU: " + cmd)
+                print(self.prefixError + "Response from MCU:")
+                print(self.mcuSer.get_full())
+            return ret, {}
+        # Get and parse the values read back.
+        dataStr = self.mcuSer.get()
+        dataPos = dataStr.find(self.hwMarkDataMulti)
+        valuesRead = None
+        if dataPos >= 0:
+            valuesRead = self.parse_pairs(dataStr[dataPos+len(self.hwMarkDataMulti):].strip())
+        if valuesRead is None:
+            self.errorCount += 1
+            print(self.prefixError + "Error parsing the values read back from the GPIO types!")
+            return -1, {}
+        return 0, valuesRead
@@ -2,15 +2,23 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 24 Apr 2020
-# Rev.: 04 Aug 2020
+# Rev.: 18 Oct 2026
 #
 # Python class for communicating with the TM4C1290NCPDT MCU over a serial port
 # (UART).
 #
+# Telemetry frames pushed by the MCU (`stream' command) are separated from the
+# command responses. Either start the reader thread with a callback using
+# start_reader(), or the frames are passed to the callback (if any) while
+# waiting for a command response. Entries of the deferred log (`dlog auto on')
+# are separated the same way and passed to the log callback.
+#
 
 
 
+import queue
 import serial
+import threading
 
 
 
@@ -18,6 +26,8 @@ class McuSerial:
 
     # MCU-specific variables and parameters.
     mcuCmdPrompt = "> "
+    mcuStreamFrameStart     = "\r@"
+    mcuLogFrameStart        = "\r#"
     mcuReadLineMax          = 100
     mcuResponse             = ""
     mcuResponseOk           = "OK"
@@ -64,6 +74,15 @@ class McuSerial:
         self.accessWrite = 0
         self.bytesRead = 0
         self.bytesWritten = 0
+        self.streamCallback = None
+        self.streamFrameCount = 0
+        self.streamDropPrompt = False
+        self.readBuf = ""
+        self.logCallback = None
+        self.logFrameCount = 0
+        self.readerThread = None
+        self.readerRun = False
+        self.readerQueue = queue.Queue()
 
         try:
             if port:
@@ -117,7 +136,8 @@ class McuSerial:
             cnt = 0
             while cnt < self.mcuReadLineMax:
                 cnt += 1
-                self.ser.readline()
+                self.readline()
+            self.readBuf = ""
             return 0
         except Exception as e:
             self.errorCount += 1
@@ -195,6 +215,8 @@ class McuSerial:
         try:
             if self.debugLevel >= 2:
                 print(self.prefixDebug + "Sending MCU command: " + cmd)
+            # Discard stale data of the reader thread, e.g. idle prompts.
+            self.flush_reader()
             self.ser.write((cmd + "\r").encode('utf-8'))
             self.ser.flush()
             self.accessWrite += 1
@@ -213,8 +235,7 @@ class McuSerial:
             self.ser.timeout = 0.05
             while line == "":
                 cnt += 1
-                line = self.ser.readline().decode('utf-8')
-                self.bytesRead += len(line)
+                line = self.readline()
                 if cnt > self.mcuReadLineMax:
                     break
             self.ser.timeout = serTimeoutBackup
@@ -222,8 +243,7 @@ class McuSerial:
             self.mcuResponse = ""
             while line != self.mcuCmdPrompt:
                 cnt += 1
-                line = self.ser.readline().decode('utf-8')
-                self.bytesRead += len(line)
+                line = self.readline()
                 if line == self.mcuCmdPrompt:
                     return 0
                 elif cnt > self.mcuReadLineMax:
@@ -238,3 +258,129 @@ class McuSerial:
             print(self.prefixError + "Error reading from serial port `" + self.ser.portstr + "': " + str(e))
             return -1
 
+
+
+
+    # Split a telemetry or log frame pushed by the MCU from a line read from the
+    # serial port. The frame is passed to the callback function and the
+    # remaining part of the line is returned. The command prompt sent after a
+    # frame is dropped.
+    def filter_frame(self, line):
+        if self.streamDropPrompt and line:
+            self.streamDropPrompt = False
+            if line.startswith(self.mcuCmdPrompt):
+                line = line[len(self.mcuCmdPrompt):]
+        pos = line.find(self.mcuStreamFrameStart)
+        if pos >= 0:
+            self.streamFrameCount += 1
+            frameType, frameStart, callback = "Stream", self.mcuStreamFrameStart, self.streamCallback
+        else:
+            pos = line.find(self.mcuLogFrameStart)
+            if pos < 0:
+                return line
+            self.logFrameCount += 1
+            frameType, frameStart, callback = "Log", self.mcuLogFrameStart, self.logCallback
+        # The frame ends with the line. The command prompt follows it, either
+        # in the same or in the next read.
+        end = line.find('\n', pos)
+        if end < 0:
+            end = len(line)
+        frame = line[pos + len(frameStart):end].rstrip('\n\r')
+        rest = line[end + 1:]
+        if rest.startswith(self.mcuCmdPrompt):
+            rest = rest[len(self.mcuCmdPrompt):]
+        else:
+            self.streamDropPrompt = True
+        if self.debugLevel >= 3:
+            print(self.prefixDebug + frameType + " frame received: " + frame)
+        if callback:
+            try:
+                callback(frame)
+            except Exception as e:
+                self.errorCount += 1
+                print(self.prefixError + "Error in " + frameType.lower() + " callback: " + str(e))
+        return line[:pos] + rest
+
+
+
+    # Read a line from the serial port or the reader thread. Returns an empty
+    # string on timeout. Like in the reader thread, the data are buffered until
+    # a complete line or the command prompt was received, so that a frame
+    # split across several reads is not mistaken for a command response.
+    def readline(self):
+        if self.readerRun:
+            try:
+                return self.readerQueue.get(timeout=max(self.ser.timeout, 0.001))
+            except queue.Empty:
+                return ""
+        data = self.ser.readline().decode('utf-8', errors='replace')
+        self.bytesRead += len(data)
+        self.readBuf += data
+        if not self.readBuf.endswith('\n') and not self.readBuf.endswith(self.mcuCmdPrompt):
+            return ""
+        line = self.filter_frame(self.readBuf)
+        self.readBuf = ""
+        return line
+
+
+
+    # Reader thread. Complete lines and the command prompt are put into the
+    # queue, telemetry frames are passed to the callback function.
+    def reader(self):
+        buf = ""
+        while self.readerRun:
+            try:
+                data = self.ser.readline().decode('utf-8', errors='replace')
+            except Exception as e:
+                self.errorCount += 1
+                print(self.prefixError + "Error reading from serial port `" + self.ser.portstr + "': " + str(e))
+                break
+            self.bytesRead += len(data)
+            buf += data
+            if not buf.endswith('\n') and not buf.endswith(self.mcuCmdPrompt):
+                continue
+            line = self.filter_frame(buf)
+            buf = ""
+            if line:
+                self.readerQueue.put(line)
+
+
+
+    # Start the reader thread. The callback functions are called with the
+    # hexadecimal string of each telemetry or log frame pushed by the MCU.
+    def start_reader(self, callback=None, logCallback=None):
+        if callback:
+            self.streamCallback = callback
+        if logCallback:
+            self.logCallback = logCallback
+        if self.simulateHwAccess or self.readerRun:
+            return 0
+        if self.debugLevel >= 2:
+            print(self.prefixDebug + "Starting the reader thread.")
+        self.readerRun = True
+        self.readerThread = threading.Thread(target=self.reader, daemon=True)
+        self.readerThread.start()
+        return 0
+
+
+
+    # Stop the reader thread.
+    def stop_reader(self):
+        if not self.readerRun:
+            return 0
+        if self.debugLevel >= 2:
+            print(self.prefixDebug + "Stopping the reader thread.")
+        self.readerRun = False
+        self.readerThread.join()
+        self.readerThread = None
+        return 0
+
+
+
+    # Discard all data received by the reader thread.
+    def flush_reader(self):
+        while True:
+            try:
+                self.readerQueue.get_nowait()
+            except queue.Empty:
+                return 0
@@ -4,7 +4,7 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 04 Aug 2020
-# Rev.: 10 Nov 2020
+# Rev.: 18 Oct 2026
 #
 # Python class for accessing the ATLAS MDT Trigger Processor (TP) Command
 # Module (CM) via the TI Tiva TM4C1290 MCU UART.
@@ -13,6 +13,8 @@
 
 
 import os
+import struct
+import time
 import McuGpio
 import McuI2C
 import McuSerial
@@ -44,6 +46,24 @@ class MdtTp_CM:
     i2cBusNum           = 10
     fireFlyNum          = 8
 
+    # Telemetry cache of the MCU firmware.
+    telemetryFormatVersion  = 1
+    telemetryFlagValid      = 0x01
+    telemetryFlagError      = 0x02
+    historyFormatVersion    = 1
+    historyTiers            = ["1s", "1m", "15m"]
+    historyValueNames       = ["mean", "min", "max"]
+    historyReadLineMax      = 10000     # The export of all channels has more than 1000 lines.
+    streamFormatVersion     = 1
+    streamGroups            = ["adc", "board", "firefly"]
+    telemetryChannelNames   = ["KUP MGTAVCC/ADC/AUX", "KUP MGTAVTT", "KUP DDR4/IO/Exp. Con./Misc.",
+                               "ZUP MGTAVCC/MGTAVTT", "ZUP DDR4/IO/LDO/Misc.",
+                               "Board 1 (IC39 MCP9903)", "KU15P (IC39 MCP9903)", "ZU11EG (IC39 MCP9903)",
+                               "Board 2 (IC34 MCP9808)", "Board 3 (IC35 MCP9808)", "Board 4 (IC36 MCP9808)",
+                               "Board 5 (IC37 MCP9808)", "Board 6 (IC38 MCP9808)"] + \
+                              ["FireFly {0:d} RX".format(i + 1) for i in range(0, fireFlyNum)] + \
+                              ["FireFly {0:d} TX".format(i + 1) for i in range(0, fireFlyNum)]
+
 
 
     # Initialize the Command Module class.
@@ -52,6 +72,8 @@ class MdtTp_CM:
         self.debugLevel = debugLevel
         self.warningCount = 0
         self.errorCount = 0
+        self.streamSeq = None
+        self.streamDropCount = 0
         self.init_hw()
 
 
@@ -59,6 +81,8 @@ class MdtTp_CM:
     # Initialize the hardware components.
     def init_hw(self):
         # Define the MCU peripherals.
+        self.mcuGpio = McuGpio.McuGpio(self.mcuSer)
+        self.mcuGpio.debugLevel = self.debugLevel
         self.init_hw_i2c()
 
 
@@ -289,7 +313,50 @@ class MdtTp_CM:
 
 
 
-    # Read the serial number of the board
+    # Show the values of all GPIO types. They are read with a single command.
+    def gpio_status(self):
+        if self.debugLevel >= 1:
+            print(self.prefixDebug + "Reading all GPIO types.")
+        ret, values = self.mcuGpio.get_all()
+        if ret:
+            self.errorCount += 1
+            return ret
+        for gpioType, val in values.items():
+            print("{0:12s}: 0x{1:02x}".format(gpioType, val))
+        return 0
+
+
+
+    # Set several GPIO types at once, e.g. {"power": 0xff, "kup": 0x3}.
+    def gpio_set(self, values):
+        if self.debugLevel >= 1:
+            print(self.prefixDebug + "Setting the GPIO types: " + ", ".join(values))
+        ret, valuesRead = self.mcuGpio.set_multi(values)
+        if ret:
+            self.errorCount += 1
+            return ret
+        for gpioType, val in valuesRead.items():
+            print("{0:12s}: 0x{1:02x}".format(gpioType, val))
+        return 0
+
+
+
+    # Show the FPGA configuration state and statistics, or start the
+    # configuration of an FPGA, e.g. fpga("kup", "prog").
+    def fpga(self, fpgaName=None, action=None):
+        cmd = "fpga"
+        if fpgaName:
+            cmd += " " + fpgaName
+        if action:
+            cmd += " " + action
+        if self.debugLevel >= 1:
+            print(self.prefixDebug + "Sending FPGA command: " + cmd)
+        ret, fpgaStr = self.mcu_cmd_raw(cmd)
+        print(fpgaStr)
+        return ret
+
+
+
     def serial_number(self):
         if self.debugLevel >= 1:
             print(self.prefixDebug + "Reading the serial number from the DS28CM00 device.")
@@ -346,6 +413,269 @@ class MdtTp_CM:
 
 
 
+    # Read the telemetry snapshot from the MCU in one command.
+    # Returns the error code, the uptime of the MCU in ms and a list of
+    # (name, temperature in degC, age in ms, flags) tuples.
+    def telemetry_read(self):
+        cmd = "telemetry bin"
+        ret, dataStr = self.mcu_cmd_raw(cmd)
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Reading the telemetry snapshot from the MCU failed!")
+            return -1, 0, []
+        try:
+            data = bytes.fromhex(dataStr)
+            formatVersion, channelNum, cacheVersion, uptime = struct.unpack_from("<BBII", data, 0)
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error decoding the telemetry snapshot: " + str(e))
+            return -1, 0, []
+        if formatVersion != self.telemetryFormatVersion:
+            self.errorCount += 1
+            print(self.prefixError + "Unsupported telemetry format version {0:d}!".format(formatVersion))
+            return -1, 0, []
+        if self.debugLevel >= 2:
+            print(self.prefixDebug + "Telemetry cache version: {0:d}".format(cacheVersion))
+        values = []
+        for i in range(0, channelNum):
+            value, timestamp, flags = struct.unpack_from("<hIB", data, 10 + 7 * i)
+            if i < len(self.telemetryChannelNames):
+                name = self.telemetryChannelNames[i]
+            else:
+                name = "Channel {0:d}".format(i)
+            values.append((name, value / 100, (uptime - timestamp) & 0xffffffff, flags))
+        return 0, uptime, values
+
+
+
+    # Monitor the temperatures using the telemetry cache of the MCU.
+    def mon_telemetry(self):
+        if self.debugLevel >= 1:
+            print(self.prefixDebug + "Reading the telemetry snapshot from the MCU.")
+        ret, uptime, values = self.telemetry_read()
+        if ret:
+            return ret
+        for name, temperature, age, flags in values:
+            if flags & self.telemetryFlagValid:
+                print("{0:28s}: {1:7.2f} degC (age: {2:d} ms)".format(name, temperature, age))
+            elif flags & self.telemetryFlagError:
+                print("{0:28s}: error".format(name))
+            else:
+                print("{0:28s}: n/a".format(name))
+        return 0
+
+
+
+    # Read a window of the telemetry history from the MCU in one command.
+    # Returns the error code, the period of an entry in s, the age in s of
+    # the newest entry and a dictionary {channel name: [entries]}, where each
+    # entry is a list of the values (mean[, min, max]) in degC or None.
+    def history_read(self, tier, channel="all", count=None):
+        cmd = "history read {0:s} {1:s}".format(str(tier), str(channel))
+        if count:
+            cmd += " {0:d}".format(count)
+        # The export is split into lines of max. 100 characters.
+        readLineMaxBackup = self.mcuSer.mcuReadLineMax
+        self.mcuSer.mcuReadLineMax = max(readLineMaxBackup, self.historyReadLineMax)
+        ret, dataStr = self.mcu_cmd_raw(cmd)
+        self.mcuSer.mcuReadLineMax = readLineMaxBackup
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Reading the telemetry history from the MCU failed!")
+            return -1, 0, 0, {}
+        try:
+            data = bytes.fromhex("".join(dataStr.split()))
+            formatVersion, tierNum, valueNum, channelFirst, channelNum, entryNum, period, timeNewest, timeNow = \
+                struct.unpack_from("<BBBBBHIII", data, 0)
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error decoding the telemetry history: " + str(e))
+            return -1, 0, 0, {}
+        if formatVersion != self.historyFormatVersion:
+            self.errorCount += 1
+            print(self.prefixError + "Unsupported history format version {0:d}!".format(formatVersion))
+            return -1, 0, 0, {}
+        # Decode the varint/delta encoded values.
+        pos = struct.calcsize("<BBBBBHIII")
+        history = {}
+        for channel in range(channelFirst, channelFirst + channelNum):
+            entries = [[None] * valueNum for i in range(0, entryNum)]
+            for valueIdx in range(0, valueNum):
+                previous = 0
+                for entryIdx in range(0, entryNum):
+                    code = 0
+                    shift = 0
+                    while True:
+                        byte = data[pos]
+                        pos += 1
+                        code |= (byte & 0x7f) << shift
+                        shift += 7
+                        if not byte & 0x80:
+                            break
+                    if code:
+                        code -= 1
+                        previous += (code >> 1) ^ -(code & 1)
+                        entries[entryIdx][valueIdx] = previous / 100
+            if channel < len(self.telemetryChannelNames):
+                name = self.telemetryChannelNames[channel]
+            else:
+                name = "Channel {0:d}".format(channel)
+            history[name] = entries
+        return 0, period, timeNow - timeNewest, history
+
+
+
+    # Print a window of the telemetry history as comma separated values.
+    def mon_history(self, tier, channel="all", count=None):
+        ret, period, ageNewest, history = self.history_read(tier, channel, count)
+        if ret:
+            return ret
+        for name, entries in history.items():
+            for i, entry in enumerate(entries):
+                # Age of the entry in s relative to now.
+                age = ageNewest + (len(entries) - 1 - i) * period
+                print("{0:s}, -{1:d} s".format(name, age), end='')
+                for value in entry:
+                    print(", " + ("{0:.2f}".format(value) if value is not None else "n/a"), end='')
+                print()
+        return 0
+
+
+
+    # Subscribe to telemetry frames pushed by the MCU. The group is one of
+    # streamGroups or "all", the period is given in ms. The callback function
+    # is called with the MCU uptime in ms, the group name and a list of
+    # (name, temperature in degC, age in ms, flags) tuples for each frame.
+    def stream_subscribe(self, group, period, callback):
+        self.streamSeq = None
+        self.streamDropCount = 0
+        self.mcuSer.start_reader(lambda frame: self.stream_decode(frame, callback))
+        ret, response = self.mcu_cmd_raw("stream {0:s} {1:d}".format(group, period))
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Subscribing to the telemetry stream failed!")
+            self.mcuSer.stop_reader()
+            return -1
+        if self.debugLevel >= 1:
+            print(self.prefixDebug + "Telemetry stream: " + response)
+        return 0
+
+
+
+    # Cancel all subscriptions and stop the reader thread.
+    def stream_unsubscribe(self):
+        ret, response = self.mcu_cmd_raw("stream off")
+        self.mcuSer.stop_reader()
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Unsubscribing from the telemetry stream failed!")
+            return -1
+        if self.debugLevel >= 1 and self.streamDropCount:
+            print(self.prefixWarning + "Lost {0:d} telemetry frames.".format(self.streamDropCount))
+        return 0
+
+
+
+    # Decode a telemetry frame and pass it to the callback function. Lost
+    # frames are detected by gaps in the sequence number.
+    def stream_decode(self, frame, callback):
+        try:
+            data = bytes.fromhex(frame)
+            formatVersion, seq, uptime, group, channelFirst, channelNum = struct.unpack_from("<BHIBBB", data, 0)
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error decoding the telemetry frame: " + str(e))
+            return -1
+        if formatVersion != self.streamFormatVersion:
+            self.errorCount += 1
+            print(self.prefixError + "Unsupported stream format version {0:d}!".format(formatVersion))
+            return -1
+        if self.streamSeq is not None and seq != self.streamSeq:
+            lost = (seq - self.streamSeq) & 0xffff
+            self.streamDropCount += lost
+            self.warningCount += 1
+            print(self.prefixWarning + "Lost {0:d} telemetry frame(s) before sequence number {1:d}.".format(lost, seq))
+        self.streamSeq = (seq + 1) & 0xffff
+        values = []
+        pos = struct.calcsize("<BHIBBB")
+        for channel in range(channelFirst, channelFirst + channelNum):
+            value, age, flags = struct.unpack_from("<hHB", data, pos)
+            pos += struct.calcsize("<hHB")
+            if channel < len(self.telemetryChannelNames):
+                name = self.telemetryChannelNames[channel]
+            else:
+                name = "Channel {0:d}".format(channel)
+            values.append((name, value / 100, age, flags))
+        if group < len(self.streamGroups):
+            groupName = self.streamGroups[group]
+        else:
+            groupName = "group {0:d}".format(group)
+        callback(uptime, groupName, values)
+        return 0
+
+
+
+    # Print telemetry frames pushed by the MCU until interrupted by Ctrl-C.
+    def mon_stream(self, group, period):
+        def print_frame(uptime, groupName, values):
+            for name, temperature, age, flags in values:
+                if flags & self.telemetryFlagValid:
+                    value = "{0:.2f}".format(temperature)
+                elif flags & self.telemetryFlagError:
+                    value = "error"
+                else:
+                    value = "n/a"
+                print("{0:d}, {1:s}, {2:s}, {3:s}, {4:d}".format(uptime, groupName, name, value, age))
+        ret = self.stream_subscribe(group, period, print_frame)
+        if ret:
+            return ret
+        try:
+            while True:
+                time.sleep(1)
+        except KeyboardInterrupt:
+            pass
+        return self.stream_unsubscribe()
+
+
+
+    # Synchronize the time of the MCU with the host time (UNIX time in us).
+    # The MCU time is set first, then the remaining skew is measured several
+    # times. The measurement with the shortest round trip is used to correct
+    # the MCU time. Returns the error code, the corrected skew in us and the
+    # round trip time in us.
+    def time_sync(self, measurements=10):
+        ret, response = self.mcu_cmd_raw("time sync {0:d}".format(int(time.time() * 1e6)))
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Setting the MCU time failed!")
+            return -1, 0, 0
+        if self.debugLevel >= 1:
+            print(self.prefixDebug + "MCU time set. Skew to previous MCU time: " + response)
+        roundTripBest = None
+        for i in range(0, measurements):
+            timeSend = time.time() * 1e6
+            ret, response = self.mcu_cmd_raw("time get")
+            timeReceive = time.time() * 1e6
+            if ret:
+                self.errorCount += 1
+                print(self.prefixError + "Reading the MCU time failed!")
+                return -1, 0, 0
+            roundTrip = timeReceive - timeSend
+            if roundTripBest is None or roundTrip < roundTripBest:
+                roundTripBest = roundTrip
+                # Assume that the MCU sampled the time in the middle of the round trip.
+                skew = int(response) - int((timeSend + timeReceive) / 2)
+        ret, response = self.mcu_cmd_raw("time adjust {0:d}".format(-skew))
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Adjusting the MCU time failed!")
+            return -1, 0, 0
+        if self.debugLevel >= 1:
+            print("MCU time synchronized. Corrected skew: {0:d} us, round trip: {1:d} us.".format(skew, int(roundTripBest)))
+        return 0, skew, int(roundTripBest)
+
+
+
     # Monitor the FireFly temperatures.
     def firefly_temp(self):
         for i in range(0, self.fireFlyNum):
@@ -4,7 +4,7 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 29 May 2020
-# Rev.: 10 Nov 2020
+# Rev.: 18 Oct 2026
 #
 # Python script to access the ATLAS MDT Trigger Processor (TP) Command Module
 # (CM) via the TI Tiva TM4C1290 MCU.
@@ -44,8 +44,8 @@ if __name__ == "__main__":
     import argparse
     parser = argparse.ArgumentParser(description='Run an automated set of MCU tests.')
     parser.add_argument('-c', '--command', action='store', type=str,
-                        choices=['power_up', 'power_down', 'sn', 'init', 'status', 'mon_temp',
-                                 'firefly_temp', 'firefly_temp_time', 'firefly_status',
+                        choices=['power_up', 'power_down', 'sn', 'init', 'status', 'mon_temp', 'telemetry', 'history',
+                                 'stream', 'time_sync', 'gpio', 'fpga', 'firefly_temp', 'firefly_temp_time', 'firefly_status',
                                  'clk_setup', 'i2c_reset', 'i2c_detect'],
                         dest='command', default='status',
                         help='Command to execute on the CM.')
@@ -82,6 +82,50 @@ if __name__ == "__main__":
         mdtTp_CM.clk_prog_all()
     elif command == "mon_temp":
         mdtTp_CM.mon_temp()
+    elif command == "telemetry":
+        mdtTp_CM.mon_telemetry()
+    elif command == "history":
+        # Parameters: TIER [CHANNEL [COUNT]]
+        if not commandParameters:
+            print(prefixError, "Please specify the history tier ({0:s}).".format(", ".join(mdtTp_CM.historyTiers)))
+            print(prefixError, "E.g.: -p 1m all 60")
+        else:
+            tier = commandParameters[0]
+            channel = commandParameters[1] if len(commandParameters) > 1 else "all"
+            count = int(commandParameters[2], 0) if len(commandParameters) > 2 else None
+            mdtTp_CM.mon_history(tier, channel, count)
+    elif command == "stream":
+        # Parameters: GROUP|all PERIOD
+        if not commandParameters or len(commandParameters) != 2:
+            print(prefixError, "Please specify the sensor group ({0:s}, all) and the period in ms.".format(", ".join(mdtTp_CM.streamGroups)))
+            print(prefixError, "E.g.: -p all 1000")
+        else:
+            mdtTp_CM.mon_stream(commandParameters[0], int(commandParameters[1], 0))
+    elif command == "time_sync":
+        mdtTp_CM.time_sync()
+    elif command == "gpio":
+        # Parameters: [TYPE=VALUE ...]
+        if not commandParameters:
+            mdtTp_CM.gpio_status()
+        else:
+            values = {}
+            for param in commandParameters:
+                gpioType, sep, val = param.partition("=")
+                if not sep:
+                    print(prefixError, "Please specify the GPIO values as TYPE=VALUE.")
+                    print(prefixError, "E.g.: -p power=0xff kup=0x3")
+                    values = None
+                    break
+                values[gpioType] = int(val, 0)
+            if values:
+                mdtTp_CM.gpio_set(values)
+    elif command == "fpga":
+        # Parameters: [kup|zup [prog|por]]
+        if commandParameters and len(commandParameters) > 2:
+            print(prefixError, "Please specify the FPGA (kup, zup) and optionally the action (prog, por).")
+            print(prefixError, "E.g.: -p kup prog")
+        else:
+            mdtTp_CM.fpga(*(commandParameters or []))
     elif command == "firefly_temp":
         mdtTp_CM.firefly_temp()
     elif command == "firefly_temp_time":
@@ -120,9 +164,13 @@ if __name__ == "__main__":
         print("============")
         mdtTp_CM.power_status()
         print()
+        print("GPIO Status")
+        print("===========")
+        mdtTp_CM.gpio_status()
+        print()
         print("Temperatures")
         print("============")
-        mdtTp_CM.mon_temp()
+        mdtTp_CM.mon_telemetry()
     else:
         print(prefixError + "Command `{0:s}' not supported!".format(command))
 
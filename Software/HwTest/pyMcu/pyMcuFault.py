@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+#
+# File: pyMcuFault.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 18 Oct 2026
+# Rev.: 18 Oct 2026
+#
+# Python script to read the fault dump of the hardware test firmware on the TI
+# Tiva TM4C1290 MCU on the ATLAS MDT Trigger Processor (TP) Command Module (CM)
+# and to decode it against the ELF file of the firmware.
+#
+
+
+
+# Append hardware classes folder to Python path.
+import os
+import sys
+sys.path.append(os.path.relpath(os.path.join(os.path.dirname(__file__), 'hw')))
+
+
+
+# System modules.
+import bisect
+import struct
+import zlib
+
+
+
+# Hardware classes.
+import McuSerial
+
+# Helper functions of the profiler and log tools.
+import pyMcuLog
+import pyMcuProf
+
+
+
+# Message prefixes and separators.
+prefixError             = "ERROR: {0:s}: ".format(__file__)
+prefixDebug             = "DEBUG: {0:s}: ".format(__file__)
+
+# Fault dump parameters.
+faultFormatVersion      = 1
+faultMagic              = (0x464c5431, 0x464c5453)
+faultRegs               = ["magic", "crc", "version", "flags", "r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr",
+                           "sp", "excReturn", "ipsr", "cfsr", "hfsr", "mmfar", "bfar", "shcsr"]
+faultHeaderFormat       = "<20IQ16s"
+faultStackSize          = 32
+faultDlogNum            = 8
+faultDlogEntryFormat    = "<IHBBQ4I"
+faultFlagFrameInvalid   = 0x01
+faultFlagFpuFrame       = 0x02
+faultFlagStackOverflow  = 0x04
+plogTypeFault           = 5
+
+# Address range of the application code in the flash.
+codeStart               = 0x00004000
+codeEnd                 = 0x000f0000
+
+# Exception names.
+exceptionNames          = {2: "NMI", 3: "HardFault", 4: "MemManage", 5: "BusFault", 6: "UsageFault",
+                           11: "SVCall", 12: "DebugMon", 14: "PendSV", 15: "SysTick"}
+
+# Bits of the CFSR and HFSR.
+cfsrBits                = {0: "IACCVIOL", 1: "DACCVIOL", 3: "MUNSTKERR", 4: "MSTKERR", 5: "MLSPERR", 7: "MMARVALID",
+                           8: "IBUSERR", 9: "PRECISERR", 10: "IMPRECISERR", 11: "UNSTKERR", 12: "STKERR", 13: "LSPERR", 15: "BFARVALID",
+                           16: "UNDEFINSTR", 17: "INVSTATE", 18: "INVPC", 19: "NOCP", 24: "UNALIGNED", 25: "DIVBYZERO"}
+hfsrBits                = {1: "VECTTBL", 30: "FORCED", 31: "DEBUGEVT"}
+
+
+
+# Decode the fault dump.
+# Returns a dictionary with the registers, the command, the stack words and the
+# deferred log entries, or None on error.
+def decode_dump(data):
+    try:
+        values = struct.unpack_from(faultHeaderFormat, data, 0)
+        dump = dict(zip(faultRegs, values[:20]))
+        dump["uptimeUs"] = values[20]
+        dump["cmd"] = values[21].split(b"\0")[0].decode('utf-8', errors='replace')
+        pos = struct.calcsize(faultHeaderFormat)
+        dump["stack"] = struct.unpack_from("<{0:d}I".format(faultStackSize), data, pos)
+        pos += 4 * faultStackSize
+        dump["dlog"] = []
+        for i in range(0, faultDlogNum):
+            seq, fmtId, nargs, reserved, uptimeUs, *args = struct.unpack_from(faultDlogEntryFormat, data, pos)
+            pos += struct.calcsize(faultDlogEntryFormat)
+            dump["dlog"].append((seq, fmtId, uptimeUs, tuple(args[:min(nargs, 4)])))
+    except Exception as e:
+        print(prefixError + "Error decoding the fault dump: " + str(e))
+        return None
+    if dump["magic"] not in faultMagic:
+        print(prefixError + "Invalid magic word 0x{0:08x} of the fault dump!".format(dump["magic"]))
+        return None
+    if dump["version"] != faultFormatVersion:
+        print(prefixError + "Unsupported fault dump format version {0:d}!".format(dump["version"]))
+        return None
+    if dump["crc"] != zlib.crc32(data[8:pos]):
+        print(prefixError + "CRC error of the fault dump!")
+        return None
+    return dump
+
+
+
+# Read the fault dump from the MCU.
+def read_dump_mcu(mcuSer, verbosity):
+    ret, dataStr = pyMcuLog.mcu_cmd(mcuSer, "fault dump", verbosity)
+    if ret:
+        return None
+    return bytes.fromhex(dataStr)
+
+
+
+# Read the newest fault dump from the persistent log.
+def read_dump_log(mcuSer, verbosity):
+    ret, dataStr = pyMcuLog.mcu_cmd(mcuSer, "log dump", verbosity)
+    if ret:
+        return None
+    parts = {}
+    for line in dataStr.splitlines()[1:]:
+        seq, boot, recType, length, timestampUs, recData, crc = struct.unpack(pyMcuLog.plogRecordFormat, bytes.fromhex(line.strip()))
+        if recType & pyMcuLog.plogTypeMask != plogTypeFault:
+            continue
+        part, partNum = recData[0], recData[1]
+        # A new dump starts with part 0.
+        if part == 0:
+            parts = {}
+        parts[part] = recData[4:length]
+    if not parts or len(parts) != partNum:
+        print(prefixError + "No complete fault dump found in the persistent log.")
+        return None
+    return b"".join([parts[i] for i in range(0, partNum)])
+
+
+
+# Symbolize a code address.
+def symbolize(address, symbols):
+    address &= ~1
+    i = bisect.bisect_right([symbol[0] for symbol in symbols], address) - 1
+    if i >= 0 and address < symbols[i][0] + max(symbols[i][1], 1):
+        return "{0:s}+0x{1:x}".format(symbols[i][2], address - symbols[i][0])
+    return "?"
+
+
+
+# Name the bits set in a status register.
+def bit_names(value, bits):
+    return " ".join([name for bit, name in sorted(bits.items()) if value & (1 << bit)]) or "-"
+
+
+
+# Print the decoded fault dump.
+def print_dump(dump, symbols, formats):
+    ipsr = dump["ipsr"]
+    name = exceptionNames.get(ipsr, "IRQ {0:d}".format(ipsr - 16) if ipsr >= 16 else "exception {0:d}".format(ipsr))
+    print("Fault: {0:s} at uptime {1:.6f} s{2:s}.".format(name, dump["uptimeUs"] / 1e6,
+          " during command `{0:s}'".format(dump["cmd"]) if dump["cmd"] else ""))
+    print("CFSR  = 0x{0:08x}: {1:s}".format(dump["cfsr"], bit_names(dump["cfsr"], cfsrBits)))
+    print("HFSR  = 0x{0:08x}: {1:s}".format(dump["hfsr"], bit_names(dump["hfsr"], hfsrBits)))
+    if dump["cfsr"] & (1 << 7):
+        print("MMFAR = 0x{0:08x}".format(dump["mmfar"]))
+    if dump["cfsr"] & (1 << 15):
+        print("BFAR  = 0x{0:08x}".format(dump["bfar"]))
+    if dump["flags"] & faultFlagStackOverflow:
+        print("The stack overflowed! Increase STACK_SIZE in the Makefile.")
+    if dump["flags"] & faultFlagFrameInvalid:
+        print("Stack frame not readable, SP = 0x{0:08x}.".format(dump["sp"]))
+    else:
+        print("PC    = 0x{0:08x}  {1:s}".format(dump["pc"], symbolize(dump["pc"], symbols)))
+        print("LR    = 0x{0:08x}  {1:s}".format(dump["lr"], symbolize(dump["lr"], symbols)))
+        print("SP    = 0x{0:08x}{1:s}".format(dump["sp"], "  (FPU frame)" if dump["flags"] & faultFlagFpuFrame else ""))
+        print("xPSR  = 0x{0:08x}".format(dump["xpsr"]))
+        print("R0    = 0x{0:08x}  R1 = 0x{1:08x}  R2 = 0x{2:08x}  R3 = 0x{3:08x}  R12 = 0x{4:08x}".format(
+              dump["r0"], dump["r1"], dump["r2"], dump["r3"], dump["r12"]))
+        print("Stack:")
+        for i, word in enumerate(dump["stack"]):
+            # Return addresses in the application code have the Thumb bit set.
+            code = symbolize(word, symbols) if (word & 1) and codeStart <= word < codeEnd else ""
+            print("  0x{0:08x}: 0x{1:08x}  {2:s}".format(dump["sp"] + 4 * i, word, code).rstrip())
+    print("Recent deferred log entries:")
+    for entry in dump["dlog"]:
+        if entry[0] != 0xffffffff:
+            print("  " + pyMcuLog.format_entry(entry, formats))
+
+
+
+# Read and decode the fault dump.
+if __name__ == "__main__":
+    # Command line arguments.
+    import argparse
+    parser = argparse.ArgumentParser(description='Read and decode the fault dump of the MCU.')
+    parser.add_argument('-c', '--command', action='store', type=str,
+                        choices=['mcu', 'log'],
+                        dest='command', default='mcu',
+                        help='Source of the fault dump: the SRAM of the MCU or the persistent log.')
+    parser.add_argument('-d', '--device', action='store', type=str,
+                        dest='serialDevice', default='/dev/ttyUL1', metavar='SERIAL_DEVICE',
+                        help='Serial device to access the MCU.')
+    parser.add_argument('-e', '--elf', action='store', type=str,
+                        dest='elfFileName', default=pyMcuProf.elfFileDefault, metavar='ELF_FILE',
+                        help='ELF file of the firmware running on the MCU.')
+    parser.add_argument('-f', '--formats', action='store', type=str,
+                        dest='fmtFileName', default=pyMcuLog.fmtFileDefault, metavar='FORMAT_FILE',
+                        help='Format string table of the deferred log.')
+    parser.add_argument('-n', '--nm', action='store', type=str,
+                        dest='nmTool', default=pyMcuProf.nmToolDefault, metavar='NM',
+                        help='Tool to read the symbols of the ELF file.')
+    parser.add_argument('-v', '--verbosity', action='store', type=int,
+                        dest='verbosity', default="1", choices=range(0, 5),
+                        help='Set the verbosity level. The default is 1.')
+    args = parser.parse_args()
+
+    # Open the MCU serial interface.
+    mcuSer = McuSerial.McuSerial(args.serialDevice)
+    mcuSer.debugLevel = args.verbosity
+    mcuSer.clear()
+    mcuSer.mcuReadLineMax = 2000
+    mcuSer.ser.timeout = 0.05
+
+    if args.command == "mcu":
+        data = read_dump_mcu(mcuSer, args.verbosity)
+    else:
+        data = read_dump_log(mcuSer, args.verbosity)
+    dump = decode_dump(data) if data else None
+    if not dump:
+        sys.exit(-1)
+    symbols = pyMcuProf.read_symbols(args.elfFileName, args.nmTool)
+    formats = pyMcuLog.read_formats(args.fmtFileName, args.elfFileName, pyMcuLog.objcopyToolDefault)
+    print_dump(dump, symbols, formats)
+    sys.exit(0)
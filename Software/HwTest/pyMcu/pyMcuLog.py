@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+#
+# File: pyMcuLog.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 18 Oct 2026
+# Rev.: 18 Oct 2026
+#
+# Python script to read the deferred binary log of the hardware test firmware
+# on the TI Tiva TM4C1290 MCU on the ATLAS MDT Trigger Processor (TP) Command
+# Module (CM) and to expand the format IDs with the format string table
+# extracted from the firmware at build time. It also exports the persistent
+# log from the flash of the MCU.
+#
+
+
+
+# Append hardware classes folder to Python path.
+import os
+import sys
+sys.path.append(os.path.relpath(os.path.join(os.path.dirname(__file__), 'hw')))
+
+
+
+# System modules.
+import re
+import struct
+import subprocess
+import tempfile
+import time
+import zlib
+
+
+
+# Hardware classes.
+import McuSerial
+
+
+
+# Message prefixes and separators.
+prefixError             = "ERROR: {0:s}: ".format(__file__)
+prefixDebug             = "DEBUG: {0:s}: ".format(__file__)
+
+# Deferred log parameters.
+dlogFormatVersion       = 1
+dlogEntryFormat         = "<IHBQ"
+
+# Persistent log parameters.
+plogFormatVersion       = 1
+plogRecordFormat        = "<IHBBQ44sI"
+plogTypeMask            = 0x7f
+plogFlagSynced          = 0x80
+plogTypes               = {1: "boot", 2: "power", 3: "fpga", 4: "telemetry", 5: "fault"}
+fpgaNames               = ["kup", "zup"]
+
+# Default format string table and ELF file of the firmware, and tool to extract
+# the table from the ELF file.
+fmtFileDefault          = os.path.join(os.path.dirname(__file__), "../../../Firmware/Projects/cm_mcu_hwtest/gcc/cm_mcu_hwtest.dlog")
+elfFileDefault          = os.path.join(os.path.dirname(__file__), "../../../Firmware/Projects/cm_mcu_hwtest/gcc/cm_mcu_hwtest.axf")
+objcopyToolDefault      = "arm-none-eabi-objcopy"
+
+# Conversion specifications of the format strings.
+fmtConvRegex            = re.compile(r"%([0-9]*)([dicuxXs%])")
+
+
+
+# Send an MCU command and return the response without the status.
+def mcu_cmd(mcuSer, cmd, verbosity):
+    if verbosity >= 2:
+        print(prefixDebug + "Sending MCU command: " + cmd)
+    ret = mcuSer.send(cmd)
+    if ret or mcuSer.eval():
+        print(prefixError + "Error executing MCU command `{0:s}'!".format(cmd))
+        if verbosity >= 1:
+            print(prefixError + "Response from MCU: " + mcuSer.get_full())
+        return -1, ""
+    return 0, mcuSer.get()
+
+
+
+# Read the format string table. It is read from the table file written by the
+# firmware build or extracted from the ELF file if the table file does not
+# exist. Returns a dictionary of the format strings indexed by their ID, which
+# is the offset of the string in the table.
+def read_formats(fmtFileName, elfFileName, objcopyTool):
+    try:
+        if os.path.isfile(fmtFileName):
+            with open(fmtFileName, "rb") as f:
+                data = f.read()
+        else:
+            with tempfile.NamedTemporaryFile() as f:
+                subprocess.run([objcopyTool, "-O", "binary", "--only-section=.dlog_fmt", elfFileName, f.name], check=True)
+                data = f.read()
+    except Exception as e:
+        print(prefixError + "Error reading the format string table: " + str(e))
+        return {}
+    formats = {}
+    pos = 0
+    while pos < len(data):
+        end = data.find(b"\0", pos)
+        if end < 0:
+            end = len(data)
+        # Skip the padding between the strings.
+        if end > pos:
+            formats[pos] = data[pos:end].decode('utf-8', errors='replace')
+        pos = end + 1
+    return formats
+
+
+
+# Decode a log entry from its hexadecimal string.
+# Returns a tuple (sequence number, format ID, uptime in us, arguments) or None.
+def decode_entry(entryStr):
+    try:
+        data = bytes.fromhex(entryStr)
+        seq, fmtId, nargs, uptimeUs = struct.unpack_from(dlogEntryFormat, data, 0)
+        args = struct.unpack_from("<{0:d}I".format(nargs), data, struct.calcsize(dlogEntryFormat))
+    except Exception as e:
+        print(prefixError + "Error decoding the log entry `{0:s}': {1:s}".format(entryStr, str(e)))
+        return None
+    return seq, fmtId, uptimeUs, args
+
+
+
+# Expand a format string with the arguments of a log entry like UARTprintf.
+def expand(fmt, args):
+    args = list(args)
+    def conv(match):
+        width, spec = match.groups()
+        if spec == "%":
+            return "%"
+        arg = args.pop(0) if args else 0
+        if spec in "di" and arg & 0x80000000:
+            arg -= 1 << 32
+        if spec == "s":
+            return "<str@0x{0:08x}>".format(arg)
+        if spec == "c":
+            return chr(arg & 0xff)
+        width = width or ""
+        return ("%" + width + {"i": "d", "u": "d"}.get(spec, spec)) % arg
+    return fmtConvRegex.sub(conv, fmt)
+
+
+
+# Format a log entry as text line.
+def format_entry(entry, formats):
+    seq, fmtId, uptimeUs, args = entry
+    if fmtId in formats:
+        message = expand(formats[fmtId], args)
+    else:
+        message = "Unknown format ID 0x{0:04x}, arguments: {1:s}".format(fmtId, " ".join(["0x{0:08x}".format(arg) for arg in args]))
+    return "{0:8d} {1:12.6f} s: {2:s}".format(seq, uptimeUs / 1e6, message)
+
+
+
+# Read and expand all pending log entries.
+def log_dump(mcuSer, formats, verbosity):
+    ret, dataStr = mcu_cmd(mcuSer, "dlog dump", verbosity)
+    if ret:
+        return -1
+    lines = dataStr.splitlines()
+    try:
+        formatVersion = int(lines[0], 16)
+    except Exception as e:
+        print(prefixError + "Error decoding the log format version: " + str(e))
+        return -1
+    if formatVersion != dlogFormatVersion:
+        print(prefixError + "Unsupported log format version {0:d}!".format(formatVersion))
+        return -1
+    for line in lines[1:]:
+        line = line.strip()
+        if line.startswith(mcuSer.mcuResponseWarning):
+            print(line)
+            continue
+        entry = decode_entry(line)
+        if entry:
+            print(format_entry(entry, formats))
+    return 0
+
+
+
+# Decode a record of the persistent log into a text line.
+def plog_format_record(data):
+    seq, boot, recType, length, timestampUs, recData, crc = struct.unpack(plogRecordFormat, data)
+    if crc != zlib.crc32(data[:-4]):
+        return "{0:8d} {1:5d}: CRC error!".format(seq, boot)
+    timeStr = "{0:.6f}".format(timestampUs / 1e6)
+    if not recType & plogFlagSynced:
+        timeStr = "up " + timeStr
+    recType &= plogTypeMask
+    recData = recData[:length]
+    if recType == 1:
+        message = "Boot, reset cause 0x{0:08x}.".format(*struct.unpack_from("<I", recData))
+    elif recType == 2:
+        message = "Power {0:s} requested by the SM.".format("up" if recData[0] else "down")
+    elif recType == 3:
+        fpga, state, failReason, reserved, configUs = struct.unpack_from("<BBBBI", recData)
+        if state == 3:
+            message = "FPGA {0:s} configured in {1:d} us.".format(fpgaNames[fpga], configUs)
+        else:
+            message = "FPGA {0:s} configuration failed with reason {1:d}.".format(fpgaNames[fpga], failReason)
+    elif recType == 4:
+        message = "Telemetry max. [degC]: " + " ".join(["-" if value == -128 else str(value) for value in struct.unpack("<{0:d}b".format(length), recData)])
+    else:
+        message = "Type {0:s}, data: {1:s}".format(plogTypes.get(recType, str(recType)), recData.hex())
+    return "{0:8d} {1:5d} {2:s}: {3:s}".format(seq, boot, timeStr, message)
+
+
+
+# Export the records of the persistent log from the oldest to the newest one.
+def plog_read(mcuSer, count, verbosity):
+    ret, dataStr = mcu_cmd(mcuSer, "log dump" + (" {0:d}".format(count) if count else ""), verbosity)
+    if ret:
+        return -1
+    lines = dataStr.splitlines()
+    try:
+        formatVersion = int(lines[0], 16)
+    except Exception as e:
+        print(prefixError + "Error decoding the log format version: " + str(e))
+        return -1
+    if formatVersion != plogFormatVersion:
+        print(prefixError + "Unsupported persistent log format version {0:d}!".format(formatVersion))
+        return -1
+    for line in lines[1:]:
+        try:
+            print(plog_format_record(bytes.fromhex(line.strip())))
+        except Exception as e:
+            print(prefixError + "Error decoding the record `{0:s}': {1:s}".format(line.strip(), str(e)))
+            ret = -1
+    return ret
+
+
+
+# Show the new log entries sent by the MCU in the automatic mode until the
+# script is interrupted.
+def log_monitor(mcuSer, formats, verbosity):
+    def callback(frame):
+        entry = decode_entry(frame)
+        if entry:
+            print(format_entry(entry, formats), flush=True)
+    mcuSer.start_reader(logCallback=callback)
+    ret, response = mcu_cmd(mcuSer, "dlog auto on", verbosity)
+    if ret:
+        mcuSer.stop_reader()
+        return -1
+    try:
+        while True:
+            time.sleep(0.1)
+    except KeyboardInterrupt:
+        pass
+    ret, response = mcu_cmd(mcuSer, "dlog auto off", verbosity)
+    mcuSer.stop_reader()
+    return ret
+
+
+
+# Access the deferred log.
+if __name__ == "__main__":
+    # Command line arguments.
+    import argparse
+    parser = argparse.ArgumentParser(description='Read and expand the deferred binary log of the MCU.')
+    parser.add_argument('-c', '--command', action='store', type=str,
+                        choices=['dump', 'monitor', 'status', 'clear', 'log_read', 'log_status', 'log_clear'],
+                        dest='command', default='dump',
+                        help='Log command. `monitor\' shows new entries until interrupted by Ctrl-C. '
+                             'The `log_*\' commands access the persistent log in the flash.')
+    parser.add_argument('-n', '--number', action='store', type=int,
+                        dest='number', default=0,
+                        help='Number of the newest records to read with `log_read\'. The default 0 reads all.')
+    parser.add_argument('-d', '--device', action='store', type=str,
+                        dest='serialDevice', default='/dev/ttyUL1', metavar='SERIAL_DEVICE',
+                        help='Serial device to access the MCU.')
+    parser.add_argument('-f', '--formats', action='store', type=str,
+                        dest='fmtFileName', default=fmtFileDefault, metavar='FORMAT_FILE',
+                        help='Format string table written by the firmware build.')
+    parser.add_argument('-e', '--elf', action='store', type=str,
+                        dest='elfFileName', default=elfFileDefault, metavar='ELF_FILE',
+                        help='ELF file of the firmware, used if the format string table does not exist.')
+    parser.add_argument('-o', '--objcopy', action='store', type=str,
+                        dest='objcopyTool', default=objcopyToolDefault, metavar='OBJCOPY',
+                        help='Tool to extract the format string table from the ELF file.')
+    parser.add_argument('-v', '--verbosity', action='store', type=int,
+                        dest='verbosity', default="1", choices=range(0, 5),
+                        help='Set the verbosity level. The default is 1.')
+    args = parser.parse_args()
+
+    # Open the MCU serial interface.
+    mcuSer = McuSerial.McuSerial(args.serialDevice)
+    mcuSer.debugLevel = args.verbosity
+    mcuSer.clear()
+    # The log entries and records are sent one per line.
+    mcuSer.mcuReadLineMax = 2000
+    mcuSer.ser.timeout = 0.05
+
+    ret = 0
+    if args.command in ("dump", "monitor"):
+        formats = read_formats(args.fmtFileName, args.elfFileName, args.objcopyTool)
+        if args.verbosity >= 2:
+            print(prefixDebug + "{0:d} format strings read.".format(len(formats)))
+        if args.command == "dump":
+            ret = log_dump(mcuSer, formats, args.verbosity)
+        else:
+            ret = log_monitor(mcuSer, formats, args.verbosity)
+    elif args.command == "log_read":
+        ret = plog_read(mcuSer, args.number, args.verbosity)
+    elif args.command.startswith("log_"):
+        ret, response = mcu_cmd(mcuSer, "log " + args.command[4:], args.verbosity)
+        if not ret and args.verbosity >= 1:
+            print(response)
+    else:
+        ret, response = mcu_cmd(mcuSer, "dlog " + args.command, args.verbosity)
+        if not ret and args.verbosity >= 1:
+            print(response)
+    sys.exit(-1 if ret else 0)
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# File: pyMcuProf.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 18 Oct 2026
+# Rev.: 18 Oct 2026
+#
+# Python script to control the PC-sampling profiler of the hardware test
+# firmware on the TI Tiva TM4C1290 MCU on the ATLAS MDT Trigger Processor (TP)
+# Command Module (CM) and to symbolize the histogram against the ELF file of the
+# firmware into a flat profile.
+#
+
+
+
+# Append hardware classes folder to Python path.
+import os
+import sys
+sys.path.append(os.path.relpath(os.path.join(os.path.dirname(__file__), 'hw')))
+
+
+
+# System modules.
+import bisect
+import struct
+import subprocess
+import time
+
+
+
+# Hardware classes.
+import McuSerial
+
+
+
+# Message prefixes and separators.
+prefixError             = "ERROR: {0:s}: ".format(__file__)
+prefixDebug             = "DEBUG: {0:s}: ".format(__file__)
+
+# Profiler parameters.
+profFormatVersion       = 1
+profHeaderFormat        = "<BBHIIIII"
+profBucketFormat        = "<HH"
+
+# Default ELF file of the firmware and tool to read its symbols.
+elfFileDefault          = os.path.join(os.path.dirname(__file__), "../../../Firmware/Projects/cm_mcu_hwtest/gcc/cm_mcu_hwtest.axf")
+nmToolDefault           = "arm-none-eabi-nm"
+
+
+
+# Send an MCU command and return the response without the status.
+def mcu_cmd(mcuSer, cmd, verbosity):
+    if verbosity >= 2:
+        print(prefixDebug + "Sending MCU command: " + cmd)
+    ret = mcuSer.send(cmd)
+    if ret or mcuSer.eval():
+        print(prefixError + "Error executing MCU command `{0:s}'!".format(cmd))
+        if verbosity >= 1:
+            print(prefixError + "Response from MCU: " + mcuSer.get_full())
+        return -1, ""
+    return 0, mcuSer.get()
+
+
+
+# Read and decode the histogram of the profiler.
+# Returns the error code, a dictionary with the header values and a list of
+# (address, samples) tuples of the non-empty buckets.
+def prof_dump(mcuSer, verbosity):
+    ret, dataStr = mcu_cmd(mcuSer, "prof dump", verbosity)
+    if ret:
+        return -1, {}, []
+    try:
+        data = bytes.fromhex(dataStr)
+        formatVersion, shift, bucketNum, base, rate, samples, samplesRom, samplesOther = \
+            struct.unpack_from(profHeaderFormat, data, 0)
+    except Exception as e:
+        print(prefixError + "Error decoding the profiler histogram: " + str(e))
+        return -1, {}, []
+    if formatVersion != profFormatVersion:
+        print(prefixError + "Unsupported profiler format version {0:d}!".format(formatVersion))
+        return -1, {}, []
+    header = {"shift": shift, "base": base, "rate": rate, "samples": samples,
+              "samplesRom": samplesRom, "samplesOther": samplesOther}
+    buckets = []
+    pos = struct.calcsize(profHeaderFormat)
+    for i in range(0, bucketNum):
+        index, count = struct.unpack_from(profBucketFormat, data, pos)
+        pos += struct.calcsize(profBucketFormat)
+        buckets.append((base + (index << shift), count))
+    return 0, header, buckets
+
+
+
+# Read the function symbols of the ELF file, sorted by address.
+# Returns a list of (address, size, name) tuples.
+def read_symbols(elfFileName, nmTool):
+    try:
+        output = subprocess.run([nmTool, "-n", "-S", "-C", "--defined-only", elfFileName],
+                                stdout=subprocess.PIPE, check=True, universal_newlines=True).stdout
+    except Exception as e:
+        print(prefixError + "Error reading the symbols of `{0:s}': {1:s}".format(elfFileName, str(e)))
+        return []
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split(maxsplit=3)
+        # Only functions with a size: ADDRESS SIZE TYPE NAME
+        if len(fields) == 4 and fields[2] in "Tt":
+            # Clear the Thumb bit.
+            symbols.append((int(fields[0], 16) & ~1, int(fields[1], 16), fields[3]))
+    return symbols
+
+
+
+# Symbolize the buckets into a flat profile: list of (samples, name) tuples
+# sorted by the number of samples. A bucket is assigned to the function
+# containing its start address.
+def symbolize(header, buckets, symbols):
+    addresses = [symbol[0] for symbol in symbols]
+    profile = {}
+    for address, count in buckets:
+        i = bisect.bisect_right(addresses, address) - 1
+        if i >= 0 and address < symbols[i][0] + max(symbols[i][1], 1 << header["shift"]):
+            name = symbols[i][2]
+        else:
+            name = "0x{0:08x}".format(address)
+        profile[name] = profile.get(name, 0) + count
+    if header["samplesRom"]:
+        profile["[ROM driver library]"] = header["samplesRom"]
+    if header["samplesOther"]:
+        profile["[other]"] = header["samplesOther"]
+    return sorted([(count, name) for name, count in profile.items()], reverse=True)
+
+
+
+# Print the flat profile.
+def print_profile(header, profile, lines):
+    samples = header["samples"]
+    print("Samples: {0:d} at {1:d} Hz ({2:.1f} s), bucket size: {3:d} bytes.".format(
+          samples, header["rate"], samples / header["rate"] if header["rate"] else 0, 1 << header["shift"]))
+    print("  Samples       %  Function")
+    for count, name in profile[:lines]:
+        print("{0:9d}  {1:6.2f}  {2:s}".format(count, 100 * count / samples if samples else 0, name))
+
+
+
+# Control the profiler.
+if __name__ == "__main__":
+    # Command line arguments.
+    import argparse
+    parser = argparse.ArgumentParser(description='Control the MCU profiler and show a flat profile.')
+    parser.add_argument('-c', '--command', action='store', type=str,
+                        choices=['start', 'stop', 'dump', 'run'],
+                        dest='command', default='run',
+                        help='Profiler command. `run\' starts the profiler, waits and dumps the profile.')
+    parser.add_argument('-d', '--device', action='store', type=str,
+                        dest='serialDevice', default='/dev/ttyUL1', metavar='SERIAL_DEVICE',
+                        help='Serial device to access the MCU.')
+    parser.add_argument('-e', '--elf', action='store', type=str,
+                        dest='elfFileName', default=elfFileDefault, metavar='ELF_FILE',
+                        help='ELF file of the firmware running on the MCU.')
+    parser.add_argument('-n', '--nm', action='store', type=str,
+                        dest='nmTool', default=nmToolDefault, metavar='NM',
+                        help='Tool to read the symbols of the ELF file.')
+    parser.add_argument('-r', '--rate', action='store', type=int,
+                        dest='rate', default=10000,
+                        help='Sampling rate in Hz. The default is 10000.')
+    parser.add_argument('-t', '--time', action='store', type=float,
+                        dest='time', default=10,
+                        help='Profiling time in seconds for the `run\' command. The default is 10.')
+    parser.add_argument('-l', '--lines', action='store', type=int,
+                        dest='lines', default=30,
+                        help='Number of functions to show. The default is 30.')
+    parser.add_argument('-v', '--verbosity', action='store', type=int,
+                        dest='verbosity', default="1", choices=range(0, 5),
+                        help='Set the verbosity level. The default is 1.')
+    args = parser.parse_args()
+
+    # Open the MCU serial interface.
+    mcuSer = McuSerial.McuSerial(args.serialDevice)
+    mcuSer.debugLevel = args.verbosity
+    mcuSer.clear()
+    # The histogram is sent in one long line.
+    mcuSer.mcuReadLineMax = 1000
+    mcuSer.ser.timeout = 0.05
+
+    ret = 0
+    if args.command in ("start", "run"):
+        ret, response = mcu_cmd(mcuSer, "prof start {0:d}".format(args.rate), args.verbosity)
+        if not ret and args.verbosity >= 1:
+            print(response)
+    if not ret and args.command == "run":
+        time.sleep(args.time)
+    if not ret and args.command in ("stop", "run"):
+        ret, response = mcu_cmd(mcuSer, "prof stop", args.verbosity)
+        if not ret and args.verbosity >= 1:
+            print(response)
+    if not ret and args.command in ("dump", "run"):
+        ret, header, buckets = prof_dump(mcuSer, args.verbosity)
+        if not ret:
+            symbols = read_symbols(args.elfFileName, args.nmTool)
+            print_profile(header, symbolize(header, buckets, symbols), args.lines)
+    sys.exit(-1 if ret else 0)
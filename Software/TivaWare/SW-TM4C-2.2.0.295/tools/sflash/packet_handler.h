@@ -30,12 +30,19 @@
 #define COMMAND_GET_STATUS          0x23
 #define COMMAND_SEND_DATA           0x24
 #define COMMAND_RESET               0x25
+#define COMMAND_SET_BAUD            0x26
+#define COMMAND_SEND_DATA_WIN       0x27
+#define COMMAND_DOWNLOAD_COMP       0x28
+#define COMMAND_GET_PAGE_CRC        0x29
+#define COMMAND_DOWNLOAD_PAGES      0x2a
+#define COMMAND_SKIP_DATA           0x2b
 
 #define COMMAND_RET_SUCCESS         0x40
 #define COMMAND_RET_UNKNOWN_CMD     0x41
 #define COMMAND_RET_INVALID_CMD     0x42
 #define COMMAND_RET_INVALID_ADDR    0x43
 #define COMMAND_RET_FLASH_FAIL      0x44
+#define COMMAND_RET_CRC_FAIL        0x45
 #define COMMAND_ACK                 0xcc
 #define COMMAND_NAK                 0x33
 
@@ -23,6 +23,14 @@
 //
 //*****************************************************************************
 
+//*****************************************************************************
+// Changes by M. Fras on 18 Oct 2026 to negotiate a high baud rate with the
+// boot loader, to send the largest data packets by default, to send the
+// data with several packets in flight (windowed transfer), to send the
+// image compressed, to update only the flash pages that changed and to skip
+// blank regions of the image.
+//*****************************************************************************
+
 //*****************************************************************************
 //
 // Serial Boot Loader Download Utility
@@ -308,18 +316,152 @@
 //! @{
 //
 //*****************************************************************************
+#ifndef __WIN32
+#define _GNU_SOURCE
+#endif
 #include <stdbool.h>
 #include <stdint.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <memory.h>
+#include <time.h>
+#ifdef __WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 #include "uart_handler.h"
 #include "packet_handler.h"
 
+//*****************************************************************************
+//
+// The receive timeout in milliseconds.  Erasing the flash after the download
+// command takes a while, so this must not be too short.
+//
+//*****************************************************************************
+#define RECEIVE_TIMEOUT         10000
+
+//*****************************************************************************
+//
+// The time in milliseconds to wait for the acknowledge of the ping packet
+// that confirms a new baud rate.
+//
+//*****************************************************************************
+#define BAUD_CONFIRM_TIMEOUT    200
+
+//*****************************************************************************
+//
+// The time in milliseconds to wait after a failed baud rate switch.  This must
+// be longer than the time the boot loader waits for the confirmation with the
+// new baud rate (BL_BAUD_CONFIRM_TIMEOUT).
+//
+//*****************************************************************************
+#define BAUD_RESYNC_DELAY       600
+
+//*****************************************************************************
+//
+// The windowed transfer.  The window size is limited by the receive buffer of
+// the boot loader (4096 bytes).  The sequence number takes one more byte of the
+// packet, so the data size is limited to the next lower multiple of 4.  If no
+// acknowledge arrives within the timeout, all packets in flight are sent again.
+//
+//*****************************************************************************
+#define WINDOW_SIZE_MAX         16
+#define WINDOW_DATA_SIZE_MAX    248
+#define WINDOW_ACK_TIMEOUT      500
+#define WINDOW_RETRIES          5
+
+//*****************************************************************************
+//
+// The return values of GetWindowAck() besides a negative value on timeout.
+//
+//*****************************************************************************
+#define WINDOW_ACK              0
+#define WINDOW_ACK_INVALID      1
+#define WINDOW_ACK_PLAIN        2
+
+//*****************************************************************************
+//
+// The compression of the image.  The format is described in bl_lz.h of the
+// boot loader.  A match must be at least LZ_MATCH_MIN bytes long and may start
+// up to LZ_OFFSET_MAX bytes back.  The match finder follows a hash chain of
+// previous positions up to LZ_CHAIN_DEPTH deep.
+//
+//*****************************************************************************
+#define LZ_TYPE                 1
+#define LZ_MATCH_MIN            4
+#define LZ_OFFSET_MAX           65535
+#define LZ_HASH_BITS            16
+#define LZ_CHAIN_DEPTH          128
+
+//*****************************************************************************
+//
+// The delta update.  The boot loader returns the CRC32 of up to DELTA_PAGES_MAX
+// flash pages at once, which takes some time for the boot loader to calculate.
+// Changed pages separated by up to DELTA_MERGE_GAP unchanged pages are sent in
+// one download, as each download has some overhead in the boot loader.
+//
+//*****************************************************************************
+#define DELTA_PAGES_MAX         60
+#define DELTA_CRC_TIMEOUT       2000
+#define DELTA_MERGE_GAP         1
+
+//*****************************************************************************
+//
+// Runs of at least BLANK_SIZE_MIN bytes with the erased value 0xff are not
+// sent, but skipped in the flash, which is erased already.
+//
+//*****************************************************************************
+#define BLANK_SIZE_MIN          512
+
+//*****************************************************************************
+//
+// Flashing several boards in parallel.  Each board is flashed by a child
+// process, whose output is read through a pipe.  The child reports the
+// progress of the data transfer with lines starting with PROGRESS_PREFIX,
+// followed by the percentage.  All other lines are status messages.
+//
+//*****************************************************************************
+#define PORTS_MAX               64
+#define PORT_NAME_SIZE          32
+#define BOARD_LINE_SIZE         128
+#define PROGRESS_PREFIX         '%'
+
+//*****************************************************************************
+//
+// Loopback benchmark of the UART handler on a pseudo terminal.  The latency is
+// measured with BENCH_LATENCY_COUNT single bytes, the throughput with
+// BENCH_BLOCK_COUNT blocks of BENCH_BLOCK_SIZE bytes, of which up to
+// BENCH_WINDOW are in flight.
+//
+//*****************************************************************************
+#define BENCH_LATENCY_COUNT     1000
+#define BENCH_BLOCK_SIZE        255
+#define BENCH_BLOCK_COUNT       4096
+#define BENCH_WINDOW            8
+
 int32_t SendCommand(uint8_t *pui8Command, uint8_t ui8Size);
+int32_t NegotiateBaudRate(void);
+int32_t SendDataWindowed(uint8_t *pui8Data, uint32_t ui32Length);
+int32_t SendCompressed(uint8_t *pui8Data, uint32_t ui32Length);
+int32_t UpdateDelta(uint8_t *pui8Data, uint32_t ui32Start,
+                    uint32_t ui32Length);
+int32_t VerifyImage(uint8_t *pui8Data, uint32_t ui32Start,
+                    uint32_t ui32Length);
+int32_t SendDataPackets(uint8_t *pui8Data, uint32_t ui32Length);
+uint32_t FindBlank(uint8_t *pui8Data, uint32_t ui32Offset, uint32_t ui32Length,
+                   uint32_t *pui32Blank);
 int32_t UpdateFlash(FILE *hBootFile, FILE *hFile, uint32_t ui32Address);
 int32_t CheckArgs(void);
+int32_t FlashBoard(void);
+#ifndef __WIN32
+int32_t FlashBoards(void);
+int32_t Benchmark(void);
+#endif
 
 //*****************************************************************************
 //
@@ -330,8 +472,17 @@ int32_t CheckArgs(void);
 uint8_t g_pui8Buffer[256];
 
 uint32_t g_pui32BaudRate;
+uint32_t g_ui32MaxBaudRate;
 uint32_t g_ui32DataSize;
+uint32_t g_ui32WindowSize;
+int32_t g_i32Compress;
+int32_t g_i32Delta;
+int32_t g_i32SkipBlank;
+uint32_t g_ui32BlankSkipped;
+uint8_t g_ui8WindowSeq;
 int32_t g_i32DisableAutoBaud;
+int32_t g_i32BoardMode;
+int32_t g_i32Benchmark;
 
 //*****************************************************************************
 //
@@ -348,7 +499,8 @@ static char const pcUsageString[] =
 #else
 "    -c [tty] -d -l [Boot Loader filename] -b [baud rate]\n"
 #endif
-"    -s [data size]\n\n"
+"    -B [max baud rate] -s [data size] -w [window size] -z --delta\n"
+"    --no-skip -C [port file] --bench\n\n"
 "-p [program address]:\n"
 "    if address is not specified it is assumed to be 0x00000000\n"
 "    if there is no 0x prefix is added then the address is assumed to be \n"
@@ -360,17 +512,42 @@ static char const pcUsageString[] =
 "    This is the number of the COM port to use.\n"
 #else
 "-c [tty]:\n"
-"    This is the name of the TTY device to use.\n"
+"    This is the name of the TTY device to use.  Several devices can be\n"
+"    given as a comma separated list or with several -c options.  The\n"
+"    boards are then flashed in parallel.\n"
+"-C [port file]:\n"
+"    Read the TTY devices of the boards to flash in parallel from a file,\n"
+"    one per line.  Lines starting with # are ignored.\n"
 #endif
 "-l [Boot Loader filename]:\n"
 "    This specifies a boot loader binary that will be loaded to the device\n"
 "    before downloading the application specified by the filename parameter.\n"
 "-b [baud rate]:\n"
 "    Specifies the baud rate in decimal.\n"
+"-B [max baud rate]:\n"
+"    Specifies the highest baud rate in decimal to negotiate with the boot\n"
+"    loader after the connection has been established.  The default is\n"
+"    3000000.  Use 0 to stay at the baud rate given by -b.\n"
 "-d  Disable Auto-Baud support\n"
 "-s [data size]:\n"
 "    Specifies the number of data bytes to be sent in each data packet.  Must\n"
-"    be a multiple of 4 between 4 and 252 (inclusive).\n\n"
+"    be a multiple of 4 between 4 and 252 (inclusive).  The default is 252.\n"
+"-w [window size]:\n"
+"    Specifies the number of data packets that are sent without waiting for\n"
+"    an acknowledge, between 1 and 16.  The default is 8.  1 sends one packet\n"
+"    at a time.  The data size is limited to 248 bytes in the windowed mode.\n"
+"-z  Compress the image, the boot loader decompresses it on the fly\n"
+"--delta\n"
+"    Update only the flash pages whose CRC32 differs from the image and\n"
+"    verify the whole image afterwards.\n"
+"--no-skip\n"
+"    Send blank regions of the image (0xff) instead of skipping them.\n"
+#ifndef __WIN32
+"--bench\n"
+"    Measure the latency and throughput of the serial port handling with a\n"
+"    loopback on a pseudo terminal.  No board is needed.\n"
+#endif
+"\n"
 "    Example: Download test.bin using COM 1 to address 0x800 and run at 0x820\n"
 "        sflash test.bin -p 0x800 -r 0x820 -c 1\n"
 };
@@ -413,7 +590,7 @@ static uint32_t g_ui32StartAddress;
 //! port that has been requested.
 //
 //*****************************************************************************
-static char g_pcCOMName[32] =
+static char g_pcCOMName[PORT_NAME_SIZE] =
 {
 #ifdef __WIN32
     "\\\\.\\COM1"
@@ -422,6 +599,123 @@ static char g_pcCOMName[32] =
 #endif
 };
 
+//*****************************************************************************
+//
+//! The ports of the boards to flash.  With more than one port, the boards are
+//! flashed in parallel.
+//
+//*****************************************************************************
+static char g_ppcPorts[PORTS_MAX][PORT_NAME_SIZE];
+static uint32_t g_ui32Ports;
+
+//*****************************************************************************
+//
+// The length and the last reported percentage of the current data transfer.
+//
+//*****************************************************************************
+static uint32_t g_ui32ProgressLength;
+static int32_t g_i32ProgressPercent;
+
+//*****************************************************************************
+//
+// The baud rates that are tried by NegotiateBaudRate(), highest first.  Not all
+// of them are exact on the device.  With the 120 MHz system clock of the MCU,
+// the fractional divisor of its UART yields:
+//
+//     3000000, 2000000, 1500000, 1000000:  exact
+//     921600:  921305 (-0.032%)
+//     460800:  460653 (-0.032%)
+//     230400:  230437 (+0.016%)
+//
+// The UART of the host adds an error of its own, which depends on the device
+// and its driver.  Therefore a baud rate is only used after the ping packets
+// that confirm it were exchanged successfully in both directions.
+//
+//*****************************************************************************
+static uint32_t const g_pui32BaudRates[] =
+{
+    3000000, 2000000, 1500000, 1000000, 921600, 460800, 230400
+};
+
+//*****************************************************************************
+//
+//! DelayMs() waits for the given number of milliseconds.
+//
+//*****************************************************************************
+static void
+DelayMs(uint32_t ui32Delay)
+{
+#ifdef __WIN32
+    Sleep(ui32Delay);
+#else
+    usleep(ui32Delay * 1000);
+#endif
+}
+
+//*****************************************************************************
+//
+//! ProgressStart() starts showing the progress of a data transfer.
+//!
+//! \param ui32Length is the number of bytes to transfer.
+//!
+//! A single board shows the remaining bytes.  When several boards are flashed
+//! in parallel, the percentage is reported to the parent process instead.
+//
+//*****************************************************************************
+static void
+ProgressStart(uint32_t ui32Length)
+{
+    g_ui32ProgressLength = ui32Length;
+    g_i32ProgressPercent = -1;
+    if(!g_i32BoardMode)
+    {
+        printf("Remaining Bytes: ");
+    }
+}
+
+//*****************************************************************************
+//
+//! ProgressUpdate() shows the progress of a data transfer.
+//!
+//! \param ui32Remaining is the number of bytes still to transfer.
+//
+//*****************************************************************************
+static void
+ProgressUpdate(uint32_t ui32Remaining)
+{
+    int32_t i32Percent;
+
+    if(!g_i32BoardMode)
+    {
+        printf("%08d\b\b\b\b\b\b\b\b", ui32Remaining);
+        return;
+    }
+    i32Percent = g_ui32ProgressLength ?
+                 (int32_t)(100 - ((uint64_t)ui32Remaining * 100) /
+                           g_ui32ProgressLength) : 100;
+    if(i32Percent != g_i32ProgressPercent)
+    {
+        g_i32ProgressPercent = i32Percent;
+        printf("%c%d\n", PROGRESS_PREFIX, i32Percent);
+    }
+}
+
+//*****************************************************************************
+//
+//! ProgressEnd() finishes showing the progress of a data transfer.
+//
+//*****************************************************************************
+static void
+ProgressEnd(void)
+{
+    if(!g_i32BoardMode)
+    {
+        printf("00000000\n");
+        return;
+    }
+    ProgressUpdate(0);
+}
+
 //****************************************************************************
 //
 //! AutoBaud() performs Automatic baud rate detection.
@@ -455,7 +749,10 @@ AutoBaud(void)
     //
     do
     {
-        UARTReceiveData(&ui8Ack, 1);
+        if(UARTReceiveData(&ui8Ack, 1))
+        {
+            return(-1);
+        }
     } while(ui8Ack == 0);
 
     if (ui8Ack != COMMAND_ACK)
@@ -533,285 +830,1999 @@ SendCommand(uint8_t *pui8Command, uint8_t ui8Size)
 
 //*****************************************************************************
 //
-//! parseArgs() handles command line processing.
+//! ResyncDevice() brings the device back in sync after a failed baud rate
+//! switch.
 //!
-//! \param argc is the argc parameter passed into main().
-//! \param argv is the argv parameter passed into main().
+//! \param pui8Status returns the status of the device.
 //!
-//! This function parses the known arguments and generates an error if any
-//! parameter was specified incorrectly.
+//! The device may have interpreted bytes sent with the wrong baud rate as the
+//! start of a packet.  Zero bytes complete any such packet and are ignored by
+//! the device afterwards.  Then the status of the device is read back with the
+//! old baud rate.
 //!
-//! \return A return value of zero indicates success while any other value
-//!     indicates a problem with the parameters that were passed in.
+//! \return This function returns zero if the device answered or a negative
+//!     value if the device is not in sync with the host.
 //
 //*****************************************************************************
 int32_t
-parseArgs(int32_t argc, char **argv)
+ResyncDevice(uint8_t *pui8Status)
 {
-    int32_t i;
-    char cArg;
+    uint8_t ui8Size;
 
-    cArg = 0;
+    DelayMs(BAUD_RESYNC_DELAY);
+    memset(g_pui8Buffer, 0, sizeof(g_pui8Buffer));
+    if(UARTSendData(g_pui8Buffer, 255))
+    {
+        return(-1);
+    }
+    DelayMs(BAUD_CONFIRM_TIMEOUT);
+    UARTFlushReceive();
 
-    for(i = 1; i < argc; i++)
+    g_pui8Buffer[0] = COMMAND_GET_STATUS;
+    if(SendPacket(g_pui8Buffer, 1, 1) < 0)
     {
-        if(argv[i][0] != '-')
-        {
-            if(cArg)
-            {
-                switch(cArg)
-                {
-                    case 'p':
-                    {
-                        g_ui32DownloadAddress = strtoul(argv[i], 0, 0);
-                        break;
-                    }
-                    case 'r':
-                    {
-                        g_ui32StartAddress = strtoul(argv[i], 0, 0);
-                        break;
-                    }
-                    case 'c':
-                    {
-#ifdef __WIN32
-                        sprintf(g_pcCOMName, "\\\\.\\COM%s", argv[i]);
-#else
-                        strncpy(g_pcCOMName, argv[i], sizeof(g_pcCOMName));
-#endif
-                        break;
-                    }
-                    case 'l':
-                    {
-                        g_pcBootLoadName = argv[i];
-                        break;
-                    }
-                    case 'b':
-                    {
-                        g_pui32BaudRate = strtoul(argv[i], 0, 0);
-                        break;
-                    }
-                    case 's':
-                    {
-                        g_ui32DataSize = strtoul(argv[i], 0, 0);
-                        if((g_ui32DataSize < 4) || (g_ui32DataSize > 252))
-                        {
-                            g_ui32DataSize = 8;
-                        }
-                        g_ui32DataSize &= ~3;
-                        break;
-                    }
-                    default:
-                    {
-                        printf("ERROR: Invalid argument\n");
-                        return(-1);
-                    }
-                }
-                cArg = 0;
-            }
-            else
-            {
-                //
-                // If we already have a filename then error out as everything
-                // else should have an option before it.
-                //
-                if(g_pcFilename)
-                {
-                    return(-1);
-                }
-                g_pcFilename = argv[i];
-            }
-        }
-        else
-        {
-            //
-            // Single flag parameters go here.
-            //
-            switch(argv[i][1])
-            {
-                case '-':
-                case '?':
-                case 'h':
-                {
-                    return(-2);
-                    break;
-                }
-                case 'd':
-                {
-                    g_i32DisableAutoBaud = 1;
-                    break;
-                }
-                default:
-                {
-                    cArg = argv[i][1];
-                    break;
-                }
-            }
-        }
+        return(-1);
+    }
+    ui8Size = sizeof(*pui8Status);
+    if(GetPacket(pui8Status, &ui8Size) < 0)
+    {
+        return(-1);
     }
     return(0);
 }
 
 //*****************************************************************************
 //
-//! main() is the programs main routine.
-//!
-//! \param argc is the number of parameters that were passed in via the command
-//!     line.
-//! \param argv is the list of strings that holds each parameter that was were
-//!     passed in via the command line.
+//! NegotiateBaudRate() switches the host and the device to a higher baud rate.
 //!
-//! This is the main routine for downloading an image to the device via the
-//! UART.
+//! This routine tries the baud rates from g_pui32BaudRates that are above the
+//! current baud rate and not above g_ui32MaxBaudRate, starting with the highest
+//! one.  The device acknowledges COMMAND_SET_BAUD with the old baud rate and
+//! then waits for a ping packet with the new one.  After the acknowledge of
+//! the ping, the host sends a second ping, which tells the device that the
+//! acknowledge was received correctly.  If a ping is not acknowledged, both
+//! sides return to the old baud rate and the next lower baud rate is tried.  A NAK means that the device does not support the baud
+//! rate.  Boot loaders which do not know COMMAND_SET_BAUD just stay at the old
+//! baud rate.
 //!
-//! \return This function either returns a negative value indicating a failure
-//!     or zero if the download was successful.
+//! \return This function returns zero if the device is in sync with the host,
+//!     either with a new or with the old baud rate, or a negative value if the
+//!     communication with the device was lost.
 //
 //*****************************************************************************
 int32_t
-main(int32_t argc, char **argv)
+NegotiateBaudRate(void)
 {
-    FILE *hFile;
-    FILE *hFileBoot;
-
-    g_ui32DownloadAddress = 0;
-    g_ui32StartAddress = 0xffffffff;
-    g_pcFilename = 0;
-    g_pcBootLoadName = 0;
-    g_pui32BaudRate = 115200;
-    g_ui32DataSize = 8;
-    g_i32DisableAutoBaud = 0;
+    uint32_t ui32Idx;
+    uint32_t ui32BaudRate;
+    int32_t i32HostSupport;
+    uint8_t ui8Command;
+    uint8_t ui8Status;
 
-    setbuf(stdout, 0);
+    for(ui32Idx = 0;
+        ui32Idx < (sizeof(g_pui32BaudRates) / sizeof(g_pui32BaudRates[0]));
+        ui32Idx++)
+    {
+        ui32BaudRate = g_pui32BaudRates[ui32Idx];
+        if((ui32BaudRate > g_ui32MaxBaudRate) ||
+           (ui32BaudRate <= g_pui32BaudRate))
+        {
+            continue;
+        }
+
+        //
+        // Skip baud rates that the host UART does not support.
+        //
+        i32HostSupport = UARTSetBaudRate(ui32BaudRate);
+        if(UARTSetBaudRate(g_pui32BaudRate))
+        {
+            return(-1);
+        }
+        if(i32HostSupport)
+        {
+            continue;
+        }
+
+        //
+        // Ask the device to switch to the new baud rate.
+        //
+        g_pui8Buffer[0] = COMMAND_SET_BAUD;
+        g_pui8Buffer[1] = (uint8_t)(ui32BaudRate >> 24);
+        g_pui8Buffer[2] = (uint8_t)(ui32BaudRate >> 16);
+        g_pui8Buffer[3] = (uint8_t)(ui32BaudRate >> 8);
+        g_pui8Buffer[4] = (uint8_t)ui32BaudRate;
+        if(SendPacket(g_pui8Buffer, 5, 1) < 0)
+        {
+            continue;
+        }
+
+        //
+        // Confirm the new baud rate with two ping packets.  The second one
+        // tells the device that the acknowledge of the first one was received
+        // correctly.
+        //
+        UARTSetBaudRate(ui32BaudRate);
+        UARTSetTimeout(BAUD_CONFIRM_TIMEOUT);
+        ui8Command = COMMAND_PING;
+        if((SendPacket(&ui8Command, 1, 1) == 0) &&
+           (SendPacket(&ui8Command, 1, 1) == 0))
+        {
+            UARTSetTimeout(RECEIVE_TIMEOUT);
+            g_pui32BaudRate = ui32BaudRate;
+            return(SendCommand(&ui8Command, 1));
+        }
+
+        //
+        // Go back to the old baud rate.  Stop if the device does not know the
+        // baud rate command at all.
+        //
+        UARTSetTimeout(RECEIVE_TIMEOUT);
+        if(UARTSetBaudRate(g_pui32BaudRate) || ResyncDevice(&ui8Status))
+        {
+            return(-1);
+        }
+        if(ui8Status == COMMAND_RET_UNKNOWN_CMD)
+        {
+            break;
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! GetWindowAck() receives an acknowledge of the windowed transfer.
+//!
+//! \param pui8Status returns the status of the device.
+//! \param pui8Seq returns the next sequence number that the device expects.
+//!
+//! The device answers the data packets of the windowed transfer with short
+//! packets holding the status and the next expected sequence number.  These
+//! packets are not acknowledged by the host.
+//!
+//! \return This function returns WINDOW_ACK if an acknowledge packet was
+//!     received, WINDOW_ACK_INVALID for a NAK or invalid data, WINDOW_ACK_PLAIN
+//!     for a plain ACK of a device that does not support the windowed transfer,
+//!     or a negative value on timeout.
+//
+//*****************************************************************************
+int32_t
+GetWindowAck(uint8_t *pui8Status, uint8_t *pui8Seq)
+{
+    uint8_t pui8Ack[3];
+
+    do
+    {
+        if(UARTReceiveData(pui8Ack, 1))
+        {
+            return(-1);
+        }
+    }
+    while(pui8Ack[0] == 0);
+
+    if(pui8Ack[0] == COMMAND_ACK)
+    {
+        return(WINDOW_ACK_PLAIN);
+    }
+    if(pui8Ack[0] != 4)
+    {
+        return(WINDOW_ACK_INVALID);
+    }
+
+    if(UARTReceiveData(pui8Ack, 3))
+    {
+        return(-1);
+    }
+    if((uint8_t)(pui8Ack[1] + pui8Ack[2]) != pui8Ack[0])
+    {
+        return(WINDOW_ACK_INVALID);
+    }
+    *pui8Status = pui8Ack[1];
+    *pui8Seq = pui8Ack[2];
+    return(WINDOW_ACK);
+}
+
+//*****************************************************************************
+//
+//! SendDataWindowed() sends the image data with several packets in flight.
+//!
+//! \param pui8Data is the image data.
+//! \param ui32Length is the length of the image data in bytes.
+//!
+//! This routine keeps up to g_ui32WindowSize sequence numbered data packets in
+//! flight.  The device programs the packets in sequence and acknowledges them
+//! cumulatively with the next sequence number it expects.  If the device
+//! reports a gap in the sequence or no acknowledge arrives in time, all
+//! packets after the last acknowledged one are sent again (go-back-N).
+//!
+//! \return This function returns zero if all data was programmed, a negative
+//!     value on failure, or a positive value if the device does not support
+//!     the windowed transfer.  In the latter case no data was programmed.
+//
+//*****************************************************************************
+int32_t
+SendDataWindowed(uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint32_t ui32PacketSize;
+    uint32_t ui32Packets;
+    uint32_t ui32Acked;
+    uint32_t ui32Sent;
+    uint32_t ui32High;
+    uint32_t ui32Retries;
+    uint32_t ui32Offset;
+    uint32_t ui32Size;
+    uint8_t ui8Status;
+    uint8_t ui8Seq;
+    uint8_t ui8Count;
+    uint32_t ui32Window;
+    int32_t i32Ret;
+
+    ui32Window = g_ui32WindowSize ? g_ui32WindowSize : 1;
+    ui32PacketSize = g_ui32DataSize;
+    if(ui32PacketSize > WINDOW_DATA_SIZE_MAX)
+    {
+        ui32PacketSize = WINDOW_DATA_SIZE_MAX;
+    }
+    ui32Packets = (ui32Length + ui32PacketSize - 1) / ui32PacketSize;
+
+    //
+    // The packets are counted from the start of this call.  The sequence
+    // number continues from the previous call of the same download.
+    //
+    ui32Acked = 0;
+    ui32Sent = 0;
+    ui32High = 0;
+    ui32Retries = 0;
+
+    UARTSetTimeout(WINDOW_ACK_TIMEOUT);
+    ProgressStart(ui32Length);
+    while(ui32Acked < ui32Packets)
+    {
+        //
+        // Fill the window.
+        //
+        while(((ui32Sent - ui32Acked) < ui32Window) &&
+              (ui32Sent < ui32Packets))
+        {
+            ui32Offset = ui32Sent * ui32PacketSize;
+            ui32Size = ui32Length - ui32Offset;
+            if(ui32Size > ui32PacketSize)
+            {
+                ui32Size = ui32PacketSize;
+            }
+            g_pui8Buffer[0] = COMMAND_SEND_DATA_WIN;
+            g_pui8Buffer[1] = (uint8_t)(g_ui8WindowSeq + ui32Sent);
+            memcpy(&g_pui8Buffer[2], &pui8Data[ui32Offset], ui32Size);
+            if(SendPacket(g_pui8Buffer, ui32Size + 2, 0) < 0)
+            {
+                printf("\nFailed to Send Packet data\n");
+                UARTSetTimeout(RECEIVE_TIMEOUT);
+                return(-1);
+            }
+            ui32Sent++;
+            if(ui32Sent > ui32High)
+            {
+                ui32High = ui32Sent;
+            }
+        }
+
+        i32Ret = GetWindowAck(&ui8Status, &ui8Seq);
+
+        //
+        // A plain ACK of the first packet means that the device does not know
+        // the windowed transfer.  Wait for the remaining ACKs and discard them.
+        //
+        if((i32Ret == WINDOW_ACK_PLAIN) && (ui32Acked == 0))
+        {
+            DelayMs(BAUD_CONFIRM_TIMEOUT);
+            UARTFlushReceive();
+            UARTSetTimeout(RECEIVE_TIMEOUT);
+            printf("\n");
+            return(1);
+        }
+        if((i32Ret == WINDOW_ACK_INVALID) || (i32Ret == WINDOW_ACK_PLAIN))
+        {
+            continue;
+        }
+
+        //
+        // No acknowledge in time, send all packets in flight again.
+        //
+        if(i32Ret < 0)
+        {
+            if(++ui32Retries > WINDOW_RETRIES)
+            {
+                printf("\nNo acknowledge from the device\n");
+                UARTSetTimeout(RECEIVE_TIMEOUT);
+                return(-1);
+            }
+            ui32Sent = ui32Acked;
+            continue;
+        }
+
+        if(ui8Status != COMMAND_RET_SUCCESS)
+        {
+            printf("\nFailed to program data Return Code: %04x\n", ui8Status);
+            UARTSetTimeout(RECEIVE_TIMEOUT);
+            return(-1);
+        }
+
+        //
+        // Ignore acknowledges for packets that were never sent.  An unchanged
+        // sequence number reports a gap, so go back and send again from there.
+        //
+        ui8Count = (uint8_t)(ui8Seq - (uint8_t)(g_ui8WindowSeq + ui32Acked));
+        if(ui8Count > (ui32High - ui32Acked))
+        {
+            continue;
+        }
+        if(ui8Count == 0)
+        {
+            ui32Sent = ui32Acked;
+            continue;
+        }
+        ui32Acked += ui8Count;
+        if(ui32Sent < ui32Acked)
+        {
+            ui32Sent = ui32Acked;
+        }
+        ui32Retries = 0;
+
+        ui32Offset = ui32Acked * ui32PacketSize;
+        ProgressUpdate((ui32Offset < ui32Length) ? (ui32Length - ui32Offset) : 0);
+    }
+    ProgressEnd();
+    g_ui8WindowSeq += ui32Packets;
+
+    UARTSetTimeout(RECEIVE_TIMEOUT);
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Crc32() calculates the CRC32 of a block of data.
+//!
+//! \param pui8Data is the data.
+//! \param ui32Length is the length of the data in bytes.
+//!
+//! This is the common CRC32 (polynomial 0x04c11db7, reflected) which the boot
+//! loader uses to check images.
+//!
+//! \return This function returns the CRC32 of the data.
+//
+//*****************************************************************************
+uint32_t
+Crc32(uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint32_t ui32Crc;
+    int32_t i32Bit;
+
+    ui32Crc = 0xffffffff;
+    while(ui32Length--)
+    {
+        ui32Crc ^= *pui8Data++;
+        for(i32Bit = 0; i32Bit < 8; i32Bit++)
+        {
+            ui32Crc = (ui32Crc >> 1) ^ ((ui32Crc & 1) ? 0xedb88320 : 0);
+        }
+    }
+    return(ui32Crc ^ 0xffffffff);
+}
+
+//*****************************************************************************
+//
+//! LzPutLength() appends the extension bytes of a literal or match length.
+//
+//*****************************************************************************
+static uint8_t *
+LzPutLength(uint8_t *pui8Out, uint32_t ui32Length)
+{
+    while(ui32Length >= 255)
+    {
+        *pui8Out++ = 255;
+        ui32Length -= 255;
+    }
+    *pui8Out++ = (uint8_t)ui32Length;
+    return(pui8Out);
+}
+
+//*****************************************************************************
+//
+//! LzCompress() compresses an image for the boot loader.
+//!
+//! \param pui8In is the uncompressed image.
+//! \param ui32Length is the length of the image in bytes.
+//! \param pui8Out is the buffer for the compressed image.  It must hold at
+//!     least ui32Length + ui32Length / 255 + 16 bytes.
+//!
+//! The image is compressed greedily with the longest match found on a hash
+//! chain of the previous positions with the same four leading bytes.
+//!
+//! \return This function returns the length of the compressed image or zero
+//!     if out of memory.
+//
+//*****************************************************************************
+uint32_t
+LzCompress(uint8_t *pui8In, uint32_t ui32Length, uint8_t *pui8Out)
+{
+    int32_t *pi32Head;
+    int32_t *pi32Prev;
+    uint8_t *pui8Start;
+    uint32_t ui32Pos;
+    uint32_t ui32Anchor;
+    uint32_t ui32Hash;
+    uint32_t ui32Literals;
+    uint32_t ui32BestLen;
+    uint32_t ui32BestOffset;
+    uint32_t ui32Len;
+    uint32_t ui32Depth;
+    int32_t i32Cand;
+
+    pi32Head = malloc((1 << LZ_HASH_BITS) * sizeof(int32_t));
+    pi32Prev = malloc((ui32Length + 1) * sizeof(int32_t));
+    if((pi32Head == 0) || (pi32Prev == 0))
+    {
+        free(pi32Head);
+        free(pi32Prev);
+        return(0);
+    }
+    memset(pi32Head, 0xff, (1 << LZ_HASH_BITS) * sizeof(int32_t));
+
+    pui8Start = pui8Out;
+    ui32Anchor = 0;
+    ui32Pos = 0;
+    while(ui32Pos < ui32Length)
+    {
+        //
+        // Find the longest match for the current position.
+        //
+        ui32BestLen = 0;
+        ui32BestOffset = 0;
+        if(ui32Pos + LZ_MATCH_MIN <= ui32Length)
+        {
+            ui32Hash = ((pui8In[ui32Pos] | (pui8In[ui32Pos + 1] << 8) |
+                         (pui8In[ui32Pos + 2] << 16) |
+                         ((uint32_t)pui8In[ui32Pos + 3] << 24)) *
+                        2654435761U) >> (32 - LZ_HASH_BITS);
+            i32Cand = pi32Head[ui32Hash];
+            ui32Depth = LZ_CHAIN_DEPTH;
+            while((i32Cand >= 0) && (ui32Pos - i32Cand <= LZ_OFFSET_MAX) &&
+                  ui32Depth--)
+            {
+                ui32Len = 0;
+                while((ui32Pos + ui32Len < ui32Length) &&
+                      (pui8In[i32Cand + ui32Len] == pui8In[ui32Pos + ui32Len]))
+                {
+                    ui32Len++;
+                }
+                if(ui32Len > ui32BestLen)
+                {
+                    ui32BestLen = ui32Len;
+                    ui32BestOffset = ui32Pos - i32Cand;
+                }
+                i32Cand = pi32Prev[i32Cand];
+            }
+            pi32Prev[ui32Pos] = pi32Head[ui32Hash];
+            pi32Head[ui32Hash] = ui32Pos;
+        }
+
+        if(ui32BestLen < LZ_MATCH_MIN)
+        {
+            ui32Pos++;
+            continue;
+        }
+
+        //
+        // Emit the sequence of the pending literals and the match.
+        //
+        ui32Literals = ui32Pos - ui32Anchor;
+        *pui8Out++ = ((ui32Literals < 15 ? ui32Literals : 15) << 4) |
+                     ((ui32BestLen - LZ_MATCH_MIN) < 15 ?
+                      (ui32BestLen - LZ_MATCH_MIN) : 15);
+        if(ui32Literals >= 15)
+        {
+            pui8Out = LzPutLength(pui8Out, ui32Literals - 15);
+        }
+        memcpy(pui8Out, &pui8In[ui32Anchor], ui32Literals);
+        pui8Out += ui32Literals;
+        *pui8Out++ = (uint8_t)ui32BestOffset;
+        *pui8Out++ = (uint8_t)(ui32BestOffset >> 8);
+        if((ui32BestLen - LZ_MATCH_MIN) >= 15)
+        {
+            pui8Out = LzPutLength(pui8Out, ui32BestLen - LZ_MATCH_MIN - 15);
+        }
+
+        //
+        // Enter the positions covered by the match into the hash chains.
+        //
+        for(ui32Len = 1; ui32Len < ui32BestLen; ui32Len++)
+        {
+            if(ui32Pos + ui32Len + LZ_MATCH_MIN <= ui32Length)
+            {
+                ui32Hash = ((pui8In[ui32Pos + ui32Len] |
+                             (pui8In[ui32Pos + ui32Len + 1] << 8) |
+                             (pui8In[ui32Pos + ui32Len + 2] << 16) |
+                             ((uint32_t)pui8In[ui32Pos + ui32Len + 3] << 24)) *
+                            2654435761U) >> (32 - LZ_HASH_BITS);
+                pi32Prev[ui32Pos + ui32Len] = pi32Head[ui32Hash];
+                pi32Head[ui32Hash] = ui32Pos + ui32Len;
+            }
+        }
+        ui32Pos += ui32BestLen;
+        ui32Anchor = ui32Pos;
+    }
+
+    //
+    // The last literals end the stream.
+    //
+    ui32Literals = ui32Length - ui32Anchor;
+    if(ui32Literals)
+    {
+        *pui8Out++ = (ui32Literals < 15 ? ui32Literals : 15) << 4;
+        if(ui32Literals >= 15)
+        {
+            pui8Out = LzPutLength(pui8Out, ui32Literals - 15);
+        }
+        memcpy(pui8Out, &pui8In[ui32Anchor], ui32Literals);
+        pui8Out += ui32Literals;
+    }
+
+    free(pi32Head);
+    free(pi32Prev);
+    return(pui8Out - pui8Start);
+}
+
+//*****************************************************************************
+//
+//! SendCompressed() sends the image data compressed.
+//!
+//! \param pui8Data is the image data.
+//! \param ui32Length is the length of the image data in bytes.
+//!
+//! This routine compresses the image and declares the data of the download as
+//! compressed with the compression type and the CRC32 of the uncompressed
+//! image.  The boot loader decompresses the data on the fly and checks the
+//! CRC32 at the end.  The compressed data is sent with the windowed transfer.
+//!
+//! \return This function returns zero if all data was programmed, a negative
+//!     value on failure, or a positive value if the image is not compressible
+//!     or the device does not support compressed images.  In the latter case
+//!     no data was programmed.
+//
+//*****************************************************************************
+int32_t
+SendCompressed(uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint8_t *pui8Comp;
+    uint32_t ui32CompLength;
+    uint32_t ui32Crc;
+    int32_t i32Ret;
+
+    pui8Comp = malloc(ui32Length + ui32Length / 255 + 16);
+    if(pui8Comp == 0)
+    {
+        return(-1);
+    }
+    ui32CompLength = LzCompress(pui8Data, ui32Length, pui8Comp);
+    if((ui32CompLength == 0) || (ui32CompLength >= ui32Length))
+    {
+        printf("Image not compressible.\n");
+        free(pui8Comp);
+        return(1);
+    }
+    printf("Compressed %d to %d bytes (%d%%).\n", ui32Length, ui32CompLength,
+           (int32_t)((100ULL * ui32CompLength) / ui32Length));
+
+    ui32Crc = Crc32(pui8Data, ui32Length);
+    g_pui8Buffer[0] = COMMAND_DOWNLOAD_COMP;
+    g_pui8Buffer[1] = LZ_TYPE;
+    g_pui8Buffer[2] = (uint8_t)(ui32Crc >> 24);
+    g_pui8Buffer[3] = (uint8_t)(ui32Crc >> 16);
+    g_pui8Buffer[4] = (uint8_t)(ui32Crc >> 8);
+    g_pui8Buffer[5] = (uint8_t)ui32Crc;
+    if(SendCommand(g_pui8Buffer, 6) < 0)
+    {
+        free(pui8Comp);
+        return(1);
+    }
+
+    //
+    // The device supports the windowed transfer, as it knows compressed data.
+    //
+    i32Ret = SendDataWindowed(pui8Comp, ui32CompLength);
+    free(pui8Comp);
+    return((i32Ret == 0) ? 0 : -1);
+}
+
+//*****************************************************************************
+//
+//! AddPorts() adds ports to the list of boards to flash.
+//!
+//! \param pcNames is a comma separated list of port names.
+//!
+//! \return A return value of zero indicates success while any other value
+//!     indicates too many ports.
+//
+//*****************************************************************************
+static int32_t
+AddPorts(char *pcNames)
+{
+    char *pcName;
+
+    for(pcName = strtok(pcNames, ","); pcName; pcName = strtok(0, ","))
+    {
+        if(g_ui32Ports >= PORTS_MAX)
+        {
+            printf("ERROR: More than %d ports specified.\n", PORTS_MAX);
+            return(-1);
+        }
+#ifdef __WIN32
+        snprintf(g_ppcPorts[g_ui32Ports], PORT_NAME_SIZE, "\\\\.\\COM%s",
+                 pcName);
+#else
+        snprintf(g_ppcPorts[g_ui32Ports], PORT_NAME_SIZE, "%s", pcName);
+#endif
+        g_ui32Ports++;
+    }
+
+    //
+    // A single board uses the first port.
+    //
+    if(g_ui32Ports)
+    {
+        strcpy(g_pcCOMName, g_ppcPorts[0]);
+    }
+
+    return(0);
+}
+
+#ifndef __WIN32
+//*****************************************************************************
+//
+//! ReadPortFile() adds the ports listed in a file to the boards to flash.
+//!
+//! \param pcFilename is the name of the file.  It holds one port name per
+//!     line.  Empty lines and lines starting with # are ignored.
+//!
+//! \return A return value of zero indicates success while any other value
+//!     indicates a problem with the file.
+//
+//*****************************************************************************
+static int32_t
+ReadPortFile(char *pcFilename)
+{
+    FILE *hFile;
+    char pcLine[BOARD_LINE_SIZE];
+    char *pcName;
+    int32_t i32Ret;
+
+    hFile = fopen(pcFilename, "r");
+    if(hFile == 0)
+    {
+        printf("Failed to open file: %s\n", pcFilename);
+        return(-1);
+    }
+    i32Ret = 0;
+    while(!i32Ret && fgets(pcLine, sizeof(pcLine), hFile))
+    {
+        pcName = strtok(pcLine, " \t\r\n");
+        if(pcName && (pcName[0] != '#'))
+        {
+            i32Ret = AddPorts(pcName);
+        }
+    }
+    fclose(hFile);
+
+    return(i32Ret);
+}
+#endif
+
+//*****************************************************************************
+//
+//! parseArgs() handles command line processing.
+//!
+//! \param argc is the argc parameter passed into main().
+//! \param argv is the argv parameter passed into main().
+//!
+//! This function parses the known arguments and generates an error if any
+//! parameter was specified incorrectly.
+//!
+//! \return A return value of zero indicates success while any other value
+//!     indicates a problem with the parameters that were passed in.
+//
+//*****************************************************************************
+int32_t
+parseArgs(int32_t argc, char **argv)
+{
+    int32_t i;
+    char cArg;
+
+    cArg = 0;
+
+    for(i = 1; i < argc; i++)
+    {
+        if(argv[i][0] != '-')
+        {
+            if(cArg)
+            {
+                switch(cArg)
+                {
+                    case 'p':
+                    {
+                        g_ui32DownloadAddress = strtoul(argv[i], 0, 0);
+                        break;
+                    }
+                    case 'r':
+                    {
+                        g_ui32StartAddress = strtoul(argv[i], 0, 0);
+                        break;
+                    }
+                    case 'c':
+                    {
+                        if(AddPorts(argv[i]))
+                        {
+                            return(-1);
+                        }
+                        break;
+                    }
+#ifndef __WIN32
+                    case 'C':
+                    {
+                        if(ReadPortFile(argv[i]))
+                        {
+                            return(-1);
+                        }
+                        break;
+                    }
+#endif
+                    case 'l':
+                    {
+                        g_pcBootLoadName = argv[i];
+                        break;
+                    }
+                    case 'b':
+                    {
+                        g_pui32BaudRate = strtoul(argv[i], 0, 0);
+                        break;
+                    }
+                    case 'B':
+                    {
+                        g_ui32MaxBaudRate = strtoul(argv[i], 0, 0);
+                        break;
+                    }
+                    case 's':
+                    {
+                        g_ui32DataSize = strtoul(argv[i], 0, 0);
+                        if((g_ui32DataSize < 4) || (g_ui32DataSize > 252))
+                        {
+                            g_ui32DataSize = 252;
+                        }
+                        g_ui32DataSize &= ~3;
+                        break;
+                    }
+                    case 'w':
+                    {
+                        g_ui32WindowSize = strtoul(argv[i], 0, 0);
+                        if(g_ui32WindowSize > WINDOW_SIZE_MAX)
+                        {
+                            g_ui32WindowSize = WINDOW_SIZE_MAX;
+                        }
+                        break;
+                    }
+                    default:
+                    {
+                        printf("ERROR: Invalid argument\n");
+                        return(-1);
+                    }
+                }
+                cArg = 0;
+            }
+            else
+            {
+                //
+                // If we already have a filename then error out as everything
+                // else should have an option before it.
+                //
+                if(g_pcFilename)
+                {
+                    return(-1);
+                }
+                g_pcFilename = argv[i];
+            }
+        }
+        else
+        {
+            //
+            // Single flag parameters go here.
+            //
+            switch(argv[i][1])
+            {
+                case '-':
+                {
+                    if(strcmp(argv[i], "--delta") == 0)
+                    {
+                        g_i32Delta = 1;
+                        break;
+                    }
+                    if(strcmp(argv[i], "--no-skip") == 0)
+                    {
+                        g_i32SkipBlank = 0;
+                        break;
+                    }
+#ifndef __WIN32
+                    if(strcmp(argv[i], "--bench") == 0)
+                    {
+                        g_i32Benchmark = 1;
+                        break;
+                    }
+#endif
+                    return(-2);
+                    break;
+                }
+                case '?':
+                case 'h':
+                {
+                    return(-2);
+                    break;
+                }
+                case 'd':
+                {
+                    g_i32DisableAutoBaud = 1;
+                    break;
+                }
+                case 'z':
+                {
+                    g_i32Compress = 1;
+                    break;
+                }
+                default:
+                {
+                    cArg = argv[i][1];
+                    break;
+                }
+            }
+        }
+    }
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! main() is the programs main routine.
+//!
+//! \param argc is the number of parameters that were passed in via the command
+//!     line.
+//! \param argv is the list of strings that holds each parameter that was were
+//!     passed in via the command line.
+//!
+//! This is the main routine for downloading an image to the device via the
+//! UART.
+//!
+//! \return This function either returns a negative value indicating a failure
+//!     or zero if the download was successful.
+//
+//*****************************************************************************
+int32_t
+main(int32_t argc, char **argv)
+{
+    g_ui32DownloadAddress = 0;
+    g_ui32StartAddress = 0xffffffff;
+    g_pcFilename = 0;
+    g_pcBootLoadName = 0;
+    g_pui32BaudRate = 115200;
+    g_ui32MaxBaudRate = 3000000;
+    g_ui32DataSize = 252;
+    g_ui32WindowSize = 8;
+    g_i32Compress = 0;
+    g_i32Delta = 0;
+    g_i32SkipBlank = 1;
+    g_i32DisableAutoBaud = 0;
+    g_i32BoardMode = 0;
+    g_i32Benchmark = 0;
+    g_ui32Ports = 0;
+
+    setbuf(stdout, 0);
+
+    //
+    // Get any arguments that were passed in.
+    //
+    if(parseArgs(argc, argv))
+    {
+        printf("%s", pcUsageString);
+        return(-1);
+    }
+
+#ifndef __WIN32
+    if(g_i32Benchmark)
+    {
+        return(Benchmark());
+    }
+#endif
+
+    if(CheckArgs())
+    {
+        return(-1);
+    }
+
+    //
+    // Flash several boards in parallel.
+    //
+    if(g_ui32Ports > 1)
+    {
+#ifdef __WIN32
+        printf("ERROR: Flashing several boards is not supported.\n");
+        return(-1);
+#else
+        return(FlashBoards());
+#endif
+    }
+
+    return(FlashBoard());
+}
+
+//*****************************************************************************
+//
+//! FlashBoard() downloads the image to one board.
+//!
+//! This opens the files and the UART given on the command line, synchronizes
+//! with the boot loader and downloads the image.
+//!
+//! \return This function either returns a negative value indicating a failure
+//!     or zero if the download was successful.
+//
+//*****************************************************************************
+int32_t
+FlashBoard(void)
+{
+    FILE *hFile;
+    FILE *hFileBoot;
+
+    hFileBoot = 0;
+
+    //
+    // If a boot loader was specified then open it.
+    //
+    if(g_pcBootLoadName)
+    {
+        //
+        // Open the boot loader file to download.
+        //
+        hFileBoot = fopen(g_pcBootLoadName, "rb");
+        if(hFileBoot == 0)
+        {
+            printf("Failed to open file: %s\n", g_pcBootLoadName);
+            return(-1);
+        }
+    }
+
+    //
+    // Open the file to download.
+    //
+    hFile = fopen(g_pcFilename, "rb");
+    if(hFile == 0)
+    {
+        printf("Failed to open file: %s\n", g_pcFilename);
+        return(-1);
+    }
+
+    if(OpenUART(g_pcCOMName, g_pui32BaudRate) ||
+       UARTSetTimeout(RECEIVE_TIMEOUT))
+    {
+        printf("Failed to configure Host UART\n");
+        return(-1);
+    }
+
+    //
+    // Now try to auto baud with the board by sending the Sync and waiting
+    // for an ack from the board.
+    //
+    if(g_i32DisableAutoBaud == 0)
+    {
+        if(AutoBaud())
+        {
+            printf("Failed to synchronize with board.\n");
+            return(-1);
+        }
+    }
+
+    //
+    // Switch to the highest baud rate that both the host and the board
+    // support.
+    //
+    if(g_ui32MaxBaudRate > g_pui32BaudRate)
+    {
+        if(NegotiateBaudRate())
+        {
+            printf("Failed to synchronize with board.\n");
+            return(-1);
+        }
+    }
+
+    printf("\n");
+    if(g_pcBootLoadName)
+    {
+        printf("Boot Loader    : %s\n", g_pcBootLoadName);
+    }
+    printf("Application    : %s\n", g_pcFilename);
+    printf("Program Address: 0x%x\n", g_ui32DownloadAddress);
+    printf("       COM Port: %s\n", g_pcCOMName);
+    printf("      Baud Rate: %d\n", g_pui32BaudRate);
+
+    printf("Erasing Flash:\n");
+
+    //
+    // If both a boot loader and an application were specified then update both
+    // the boot loader and the application.
+    //
+    if(g_pcBootLoadName != 0)
+    {
+        if(UpdateFlash(hFile, hFileBoot, g_ui32DownloadAddress) < 0)
+        {
+            return(-1);
+        }
+    }
+    //
+    // Otherwise just update the application.
+    //
+    else if(UpdateFlash(hFile, 0, g_ui32DownloadAddress) < 0)
+    {
+        return(-1);
+    }
+
+    //
+    // If a start address was specified then send the run command to the
+    // boot loader.
+    //
+    if(g_ui32StartAddress != 0xffffffff)
+    {
+        //
+        // Send the run command but just send the packet, there will likely
+        // be no boot loader to answer after this command completes.
+        //
+        g_pui8Buffer[0] = COMMAND_RUN;
+        g_pui8Buffer[1] = (uint8_t)(g_ui32StartAddress>>24);
+        g_pui8Buffer[2] = (uint8_t)(g_ui32StartAddress>>16);
+        g_pui8Buffer[3] = (uint8_t)(g_ui32StartAddress>>8);
+        g_pui8Buffer[4] = (uint8_t)g_ui32StartAddress;
+        if(SendPacket(g_pui8Buffer, 5, 0) < 0)
+        {
+            printf("Failed to Send Run command\n");
+        }
+        else
+        {
+            printf("Running from address %08x\n",g_ui32StartAddress);
+        }
+    }
+    else
+    {
+        //
+        // Send the reset command but just send the packet, there will likely
+        // be no boot loader to answer after this command completes.
+        //
+        g_pui8Buffer[0] = COMMAND_RESET;
+        SendPacket(g_pui8Buffer, 1, 0);
+    }
+    if(hFile != 0)
+    {
+        fclose(hFile);
+    }
+    printf("Successfully downloaded to device.\n");
+    return(0);
+}
+
+#ifndef __WIN32
+//*****************************************************************************
+//
+//! FlashBoards() downloads the image to several boards in parallel.
+//!
+//! The download state of sflash is global, so each board is flashed by a
+//! child process running FlashBoard() on its own port.  The output of the
+//! children is collected through pipes.  Progress lines are combined into one
+//! progress line of all boards, all other lines are shown with the port name.
+//!
+//! \return This function returns zero if all boards were flashed successfully
+//!     and a negative value otherwise.
+//
+//*****************************************************************************
+int32_t
+FlashBoards(void)
+{
+    struct
+    {
+        pid_t iPid;
+        int iFd;
+        int32_t i32Percent;
+        int32_t i32Status;
+        uint32_t ui32Fill;
+        char pcLine[BOARD_LINE_SIZE];
+        char pcLast[BOARD_LINE_SIZE];
+    } psBoards[PORTS_MAX];
+    struct pollfd psPoll[PORTS_MAX];
+    int piPipe[2];
+    char pcData[256];
+    uint32_t ui32Board;
+    uint32_t ui32Open;
+    uint32_t ui32Failed;
+    int32_t i32Count;
+    int32_t i;
+    int32_t bChanged;
+    time_t tLast;
+
+    printf("Flashing %d boards in parallel.\n", g_ui32Ports);
+
+    //
+    // Start one child process per board.
+    //
+    memset(psBoards, 0, sizeof(psBoards));
+    for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+    {
+        psBoards[ui32Board].iPid = -1;
+        psBoards[ui32Board].iFd = -1;
+        psBoards[ui32Board].i32Status = -1;
+        strcpy(psBoards[ui32Board].pcLast, "Not started.");
+        if(pipe(piPipe))
+        {
+            printf("[%s] Failed to create pipe.\n", g_ppcPorts[ui32Board]);
+            continue;
+        }
+        psBoards[ui32Board].iPid = fork();
+        if(psBoards[ui32Board].iPid == 0)
+        {
+            close(piPipe[0]);
+            dup2(piPipe[1], STDOUT_FILENO);
+            dup2(piPipe[1], STDERR_FILENO);
+            close(piPipe[1]);
+            g_i32BoardMode = 1;
+            strcpy(g_pcCOMName, g_ppcPorts[ui32Board]);
+            exit(FlashBoard() ? 1 : 0);
+        }
+        close(piPipe[1]);
+        if(psBoards[ui32Board].iPid < 0)
+        {
+            printf("[%s] Failed to start process.\n", g_ppcPorts[ui32Board]);
+            close(piPipe[0]);
+            continue;
+        }
+        psBoards[ui32Board].iFd = piPipe[0];
+    }
+
+    //
+    // Collect the output of the children until all pipes are closed.
+    //
+    tLast = time(0);
+    bChanged = 0;
+    for(;;)
+    {
+        ui32Open = 0;
+        for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+        {
+            psPoll[ui32Board].fd = psBoards[ui32Board].iFd;
+            psPoll[ui32Board].events = POLLIN;
+            psPoll[ui32Board].revents = 0;
+            if(psBoards[ui32Board].iFd >= 0)
+            {
+                ui32Open++;
+            }
+        }
+        if(ui32Open == 0)
+        {
+            break;
+        }
+        if(poll(psPoll, g_ui32Ports, 1000) < 0)
+        {
+            break;
+        }
+
+        for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+        {
+            if(!(psPoll[ui32Board].revents & (POLLIN | POLLHUP | POLLERR)))
+            {
+                continue;
+            }
+            i32Count = read(psBoards[ui32Board].iFd, pcData, sizeof(pcData));
+            if(i32Count <= 0)
+            {
+                close(psBoards[ui32Board].iFd);
+                psBoards[ui32Board].iFd = -1;
+                continue;
+            }
+
+            //
+            // Split the output into lines.
+            //
+            for(i = 0; i < i32Count; i++)
+            {
+                if((pcData[i] != '\n') && (pcData[i] != '\r'))
+                {
+                    if(psBoards[ui32Board].ui32Fill < BOARD_LINE_SIZE - 1)
+                    {
+                        psBoards[ui32Board].pcLine[
+                            psBoards[ui32Board].ui32Fill++] = pcData[i];
+                    }
+                    continue;
+                }
+                if(psBoards[ui32Board].ui32Fill == 0)
+                {
+                    continue;
+                }
+                psBoards[ui32Board].pcLine[psBoards[ui32Board].ui32Fill] = 0;
+                psBoards[ui32Board].ui32Fill = 0;
+                if(psBoards[ui32Board].pcLine[0] == PROGRESS_PREFIX)
+                {
+                    psBoards[ui32Board].i32Percent =
+                        atoi(&psBoards[ui32Board].pcLine[1]);
+                    bChanged = 1;
+                }
+                else
+                {
+                    printf("[%s] %s\n", g_ppcPorts[ui32Board],
+                           psBoards[ui32Board].pcLine);
+                    strcpy(psBoards[ui32Board].pcLast,
+                           psBoards[ui32Board].pcLine);
+                }
+            }
+        }
+
+        //
+        // Show the progress of all boards at most once per second.
+        //
+        if(bChanged && (time(0) != tLast))
+        {
+            printf("Progress:");
+            for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+            {
+                printf(" %s %3d%%", g_ppcPorts[ui32Board],
+                       psBoards[ui32Board].i32Percent);
+            }
+            printf("\n");
+            tLast = time(0);
+            bChanged = 0;
+        }
+    }
+
+    //
+    // Collect the results of the children.
+    //
+    for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+    {
+        if(psBoards[ui32Board].iPid > 0)
+        {
+            if((waitpid(psBoards[ui32Board].iPid, &i, 0) > 0) &&
+               WIFEXITED(i) && (WEXITSTATUS(i) == 0))
+            {
+                psBoards[ui32Board].i32Status = 0;
+            }
+        }
+    }
+
+    //
+    // Show the summary.
+    //
+    ui32Failed = 0;
+    for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+    {
+        if(psBoards[ui32Board].i32Status)
+        {
+            ui32Failed++;
+        }
+    }
+    printf("\n%d of %d boards flashed successfully.\n",
+           g_ui32Ports - ui32Failed, g_ui32Ports);
+    for(ui32Board = 0; ui32Board < g_ui32Ports; ui32Board++)
+    {
+        if(psBoards[ui32Board].i32Status)
+        {
+            printf("FAILED: %s: %s\n", g_ppcPorts[ui32Board],
+                   psBoards[ui32Board].pcLast);
+        }
+    }
+
+    return(ui32Failed ? -1 : 0);
+}
+#endif
+
+#ifndef __WIN32
+//*****************************************************************************
+//
+//! BenchTimeUs() returns the time of the monotonic clock in microseconds.
+//
+//*****************************************************************************
+static uint64_t
+BenchTimeUs(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+    return((uint64_t)sTime.tv_sec * 1000000 + sTime.tv_nsec / 1000);
+}
+
+//*****************************************************************************
+//
+//! Benchmark() measures the latency and throughput of the UART handler.
+//!
+//! The UART handler is opened on the slave side of a pseudo terminal, whose
+//! master side is served by a child process that echoes all data.  The
+//! latency is measured as the round trip time of single bytes, the throughput
+//! by sending blocks with up to BENCH_WINDOW blocks in flight.  A pseudo
+//! terminal has no baud rate, so this measures the overhead of the host side
+//! only.
+//!
+//! \return This function returns zero on success and a negative value if the
+//!     pseudo terminal could not be set up or the echoed data was wrong.
+//
+//*****************************************************************************
+int32_t
+Benchmark(void)
+{
+    uint8_t pui8Tx[BENCH_BLOCK_SIZE];
+    uint8_t pui8Rx[BENCH_BLOCK_SIZE];
+    uint8_t pui8Echo[4096];
+    uint64_t ui64Start;
+    uint64_t ui64Time;
+    uint64_t ui64Sum;
+    uint64_t ui64Max;
+    uint32_t ui32Sent;
+    uint32_t ui32Received;
+    uint32_t ui32Idx;
+    ssize_t iCount;
+    pid_t iPid;
+    int iMaster;
+
+    //
+    // Open the pseudo terminal.
+    //
+    iMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if((iMaster < 0) || grantpt(iMaster) || unlockpt(iMaster) ||
+       OpenUART(ptsname(iMaster), g_pui32BaudRate) ||
+       UARTSetTimeout(RECEIVE_TIMEOUT))
+    {
+        printf("Failed to open pseudo terminal.\n");
+        return(-1);
+    }
+    printf("Loopback benchmark on %s.\n", ptsname(iMaster));
+
+    //
+    // Echo all data in a child process until the slave side is closed.
+    //
+    iPid = fork();
+    if(iPid == 0)
+    {
+        CloseUART();
+        while((iCount = read(iMaster, pui8Echo, sizeof(pui8Echo))) > 0)
+        {
+            if(write(iMaster, pui8Echo, iCount) != iCount)
+            {
+                break;
+            }
+        }
+        exit(0);
+    }
+    close(iMaster);
+    if(iPid < 0)
+    {
+        printf("Failed to start echo process.\n");
+        CloseUART();
+        return(-1);
+    }
+
+    //
+    // Measure the round trip time of single bytes.
+    //
+    ui64Sum = 0;
+    ui64Max = 0;
+    for(ui32Idx = 0; ui32Idx < BENCH_LATENCY_COUNT; ui32Idx++)
+    {
+        pui8Tx[0] = (uint8_t)ui32Idx;
+        ui64Start = BenchTimeUs();
+        if(UARTSendData(pui8Tx, 1) || UARTReceiveData(pui8Rx, 1) ||
+           (pui8Rx[0] != pui8Tx[0]))
+        {
+            printf("Echo failed.\n");
+            break;
+        }
+        ui64Time = BenchTimeUs() - ui64Start;
+        ui64Sum += ui64Time;
+        if(ui64Time > ui64Max)
+        {
+            ui64Max = ui64Time;
+        }
+    }
+    if(ui32Idx == BENCH_LATENCY_COUNT)
+    {
+        printf("Round trip time: %d us average, %d us maximum\n",
+               (int32_t)(ui64Sum / BENCH_LATENCY_COUNT), (int32_t)ui64Max);
+    }
+
+    //
+    // Measure the throughput with several blocks in flight.
+    //
+    ui32Sent = 0;
+    ui32Received = 0;
+    ui64Start = BenchTimeUs();
+    while((ui32Idx == BENCH_LATENCY_COUNT) &&
+          (ui32Received < BENCH_BLOCK_COUNT))
+    {
+        if((ui32Sent < BENCH_BLOCK_COUNT) &&
+           (ui32Sent - ui32Received < BENCH_WINDOW))
+        {
+            memset(pui8Tx, (uint8_t)ui32Sent, BENCH_BLOCK_SIZE);
+            if(UARTSendData(pui8Tx, BENCH_BLOCK_SIZE))
+            {
+                printf("Send failed.\n");
+                break;
+            }
+            ui32Sent++;
+            continue;
+        }
+        if(UARTReceiveData(pui8Rx, BENCH_BLOCK_SIZE) ||
+           (pui8Rx[0] != (uint8_t)ui32Received) ||
+           (pui8Rx[BENCH_BLOCK_SIZE - 1] != (uint8_t)ui32Received))
+        {
+            printf("Echo failed.\n");
+            break;
+        }
+        ui32Received++;
+    }
+    ui64Time = BenchTimeUs() - ui64Start;
+    if(ui32Received == BENCH_BLOCK_COUNT)
+    {
+        printf("Throughput: %d kB/s in each direction\n",
+               (int32_t)((uint64_t)BENCH_BLOCK_COUNT * BENCH_BLOCK_SIZE * 1000 /
+                         (ui64Time ? ui64Time : 1)));
+    }
+
+    CloseUART();
+    waitpid(iPid, 0, 0);
+
+    return(((ui32Idx == BENCH_LATENCY_COUNT) &&
+            (ui32Received == BENCH_BLOCK_COUNT)) ? 0 : -1);
+}
+#endif
+
+//*****************************************************************************
+//
+//! DownloadImage() downloads data to the flash.
+//!
+//! \param ui8Command is the command starting the download, COMMAND_DOWNLOAD
+//!     or COMMAND_DOWNLOAD_PAGES.
+//! \param pui8Data is the data.
+//! \param ui32Start is the flash address of the data.
+//! \param ui32Length is the length of the data in bytes.
+//!
+//! This routine starts the download, which erases the flash, and sends the
+//! data compressed, with the windowed transfer or one packet at a time,
+//! depending on the options and on what the boot loader supports.  Blank
+//! regions are skipped unless the data is compressed.
+//!
+//! \return This function either returns a negative value indicating a failure
+//!     or zero if the download was successful.
+//
+//*****************************************************************************
+int32_t
+DownloadImage(uint8_t ui8Command, uint8_t *pui8Data, uint32_t ui32Start,
+              uint32_t ui32Length)
+{
+    uint32_t ui32Offset;
+    uint32_t ui32End;
+    uint32_t ui32Blank;
+    int32_t bWindowed;
+    int32_t bSkip;
+    int32_t i32Ret;
+
+    //
+    // Build up the download command and send it to the board.
+    //
+    g_pui8Buffer[0] = ui8Command;
+    g_pui8Buffer[1] = (uint8_t)(ui32Start >> 24);
+    g_pui8Buffer[2] = (uint8_t)(ui32Start >> 16);
+    g_pui8Buffer[3] = (uint8_t)(ui32Start >> 8);
+    g_pui8Buffer[4] = (uint8_t)ui32Start;
+    g_pui8Buffer[5] = (uint8_t)(ui32Length>>24);
+    g_pui8Buffer[6] = (uint8_t)(ui32Length>>16);
+    g_pui8Buffer[7] = (uint8_t)(ui32Length>>8);
+    g_pui8Buffer[8] = (uint8_t)ui32Length;
+    if(SendCommand(g_pui8Buffer, 9) < 0)
+    {
+        printf("Failed to Send Download Command\n");
+        return(-1);
+    }
+    g_ui8WindowSeq = 0;
+
+    //
+    // Send the image compressed if requested.  Compressed images are not
+    // supported if the boot loader itself is updated.
+    //
+    if(g_i32Compress && (ui32Start != 0))
+    {
+        i32Ret = SendCompressed(pui8Data, ui32Length);
+        if(i32Ret <= 0)
+        {
+            return(i32Ret);
+        }
+        printf("Sending the image uncompressed.\n");
+    }
+
+    //
+    // Send the data in segments between the blank regions, which are skipped,
+    // as the flash is erased already.  Use the windowed transfer unless the
+    // boot loader itself is updated.  If the boot loader does not support the
+    // windowed transfer or skipping, nothing of the segment has been
+    // programmed yet, so fall back to sending one packet at a time or to
+    // sending the blank region.
+    //
+    bWindowed = (g_ui32WindowSize > 1) && (ui32Start != 0);
+    bSkip = g_i32SkipBlank && (ui32Start != 0);
+    ui32Offset = 0;
+    while(ui32Offset < ui32Length)
+    {
+        ui32End = ui32Length;
+        ui32Blank = 0;
+        if(bSkip)
+        {
+            ui32End = FindBlank(pui8Data, ui32Offset, ui32Length, &ui32Blank);
+        }
+
+        if(bWindowed && (ui32End > ui32Offset))
+        {
+            i32Ret = SendDataWindowed(&pui8Data[ui32Offset],
+                                      ui32End - ui32Offset);
+            if(i32Ret < 0)
+            {
+                return(i32Ret);
+            }
+            if(i32Ret > 0)
+            {
+                printf("Windowed transfer not supported, sending one packet "
+                       "at a time.\n");
+                bWindowed = 0;
+            }
+        }
+        if(!bWindowed && (ui32End > ui32Offset))
+        {
+            if(SendDataPackets(&pui8Data[ui32Offset], ui32End - ui32Offset) < 0)
+            {
+                return(-1);
+            }
+        }
+        ui32Offset = ui32End;
+
+        if(ui32Blank)
+        {
+            g_pui8Buffer[0] = COMMAND_SKIP_DATA;
+            g_pui8Buffer[1] = (uint8_t)(ui32Blank >> 24);
+            g_pui8Buffer[2] = (uint8_t)(ui32Blank >> 16);
+            g_pui8Buffer[3] = (uint8_t)(ui32Blank >> 8);
+            g_pui8Buffer[4] = (uint8_t)ui32Blank;
+            if(SendCommand(g_pui8Buffer, 5) < 0)
+            {
+                printf("Skipping blank regions not supported, sending them.\n");
+                bSkip = 0;
+                continue;
+            }
+            ui32Offset += ui32Blank;
+            g_ui32BlankSkipped += ui32Blank;
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! SendDataPackets() sends data one packet at a time.
+//!
+//! \param pui8Data is the data.
+//! \param ui32Length is the length of the data in bytes.
+//!
+//! This routine sends each data packet with COMMAND_SEND_DATA and checks the
+//! status before sending the next one.
+//!
+//! \return This function either returns a negative value indicating a failure
+//!     or zero if the data was programmed.
+//
+//*****************************************************************************
+int32_t
+SendDataPackets(uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint32_t ui32Offset;
 
-    //
-    // Get any arguments that were passed in.
-    //
-    if(parseArgs(argc, argv))
+    ui32Offset = 0;
+
+    ProgressStart(ui32Length);
+    do
     {
-        printf("%s", pcUsageString);
-        return(-1);
-    }
+        uint8_t ui8BytesSent;
 
-    if(CheckArgs())
+        g_pui8Buffer[0] = COMMAND_SEND_DATA;
+
+        ProgressUpdate(ui32Length);
+
+        //
+        // Send out 8 bytes at a time to throttle download rate and avoid
+        // overruning the device since it is programming flash on the fly.
+        //
+        if(ui32Length >= g_ui32DataSize)
+        {
+            memcpy(&g_pui8Buffer[1], &pui8Data[ui32Offset], g_ui32DataSize);
+
+            ui32Offset += g_ui32DataSize;
+            ui32Length -= g_ui32DataSize;
+            ui8BytesSent = g_ui32DataSize + 1;
+        }
+        else
+        {
+            memcpy(&g_pui8Buffer[1], &pui8Data[ui32Offset], ui32Length);
+            ui32Offset += ui32Length;
+            ui8BytesSent = ui32Length + 1;
+            ui32Length = 0;
+        }
+        //
+        // Send the Send Data command to the device.
+        //
+        if(SendCommand(g_pui8Buffer, ui8BytesSent) < 0)
+        {
+            printf("Failed to Send Packet data\n");
+            return(-1);
+        }
+    } while (ui32Length);
+    ProgressEnd();
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! FindBlank() finds the next blank region of an image.
+//!
+//! \param pui8Data is the image data.
+//! \param ui32Offset is the offset to start searching at.
+//! \param ui32Length is the length of the image in bytes.
+//! \param pui32Blank returns the length of the blank region, zero if none.
+//!
+//! A blank region is a run of at least BLANK_SIZE_MIN bytes with the erased
+//! value 0xff.  It starts at a flash word and covers whole flash words, except
+//! at the end of the image.
+//!
+//! \return This function returns the offset of the blank region or the length
+//!     of the image if there is none.
+//
+//*****************************************************************************
+uint32_t
+FindBlank(uint8_t *pui8Data, uint32_t ui32Offset, uint32_t ui32Length,
+          uint32_t *pui32Blank)
+{
+    uint32_t ui32Pos;
+    uint32_t ui32End;
+    uint32_t ui32Blank;
+
+    for(ui32Pos = (ui32Offset + 3) & ~3; ui32Pos < ui32Length; ui32Pos += 4)
     {
-        return(-1);
+        for(ui32End = ui32Pos;
+            (ui32End < ui32Length) && (pui8Data[ui32End] == 0xff); ui32End++)
+        {
+        }
+        ui32Blank = ui32End - ui32Pos;
+        if(ui32End < ui32Length)
+        {
+            ui32Blank &= ~3;
+        }
+        if(ui32Blank >= BLANK_SIZE_MIN)
+        {
+            *pui32Blank = ui32Blank;
+            return(ui32Pos);
+        }
+        ui32Pos = ui32End & ~3;
     }
 
-    //
-    // If a boot loader was specified then open it.
-    //
-    if(g_pcBootLoadName)
+    *pui32Blank = 0;
+    return(ui32Length);
+}
+
+
+//*****************************************************************************
+//
+//! GetPageCrcs() reads the CRC32 of flash pages from the boot loader.
+//!
+//! \param ui32Start is the flash address of the first page.
+//! \param ui32Pages is the number of pages.
+//! \param pui32PageSize returns the page size of the device.
+//! \param pui32Crc returns the CRC32 of each page.
+//!
+//! The pages are requested in chunks of up to DELTA_PAGES_MAX pages.  With
+//! zero pages only the page size is read, which tells whether the boot
+//! loader supports this command at all.
+//!
+//! \return This function returns zero on success, a negative value on failure
+//!     or a positive value if the device does not support the command.
+//
+//*****************************************************************************
+int32_t
+GetPageCrcs(uint32_t ui32Start, uint32_t ui32Pages, uint32_t *pui32PageSize,
+            uint32_t *pui32Crc)
+{
+    uint32_t ui32Count;
+    uint32_t ui32Page;
+    uint8_t *pui8Crc;
+    uint8_t ui8Size;
+    int32_t i32Ret;
+
+    UARTSetTimeout(DELTA_CRC_TIMEOUT);
+    i32Ret = 0;
+    ui32Page = 0;
+    do
     {
+        ui32Count = ui32Pages - ui32Page;
+        if(ui32Count > DELTA_PAGES_MAX)
+        {
+            ui32Count = DELTA_PAGES_MAX;
+        }
+        g_pui8Buffer[0] = COMMAND_GET_PAGE_CRC;
+        g_pui8Buffer[1] = (uint8_t)(ui32Start >> 24);
+        g_pui8Buffer[2] = (uint8_t)(ui32Start >> 16);
+        g_pui8Buffer[3] = (uint8_t)(ui32Start >> 8);
+        g_pui8Buffer[4] = (uint8_t)ui32Start;
+        g_pui8Buffer[5] = (uint8_t)ui32Count;
+        if(SendPacket(g_pui8Buffer, 6, 1) < 0)
+        {
+            i32Ret = -1;
+            break;
+        }
+
         //
-        // Open the boot loader file to download.
+        // A device that does not know the command does not answer.
         //
-        hFileBoot = fopen(g_pcBootLoadName, "rb");
-        if(hFileBoot == 0)
+        if(GetPacket(g_pui8Buffer, &ui8Size) < 0)
         {
-            printf("Failed to open file: %s\n", g_pcBootLoadName);
-            return(-1);
+            i32Ret = 1;
+            break;
+        }
+        if((ui8Size != 5 + 4 * ui32Count) ||
+           (g_pui8Buffer[0] != COMMAND_RET_SUCCESS))
+        {
+            printf("Failed to get the page CRCs Return Code: %04x\n",
+                   g_pui8Buffer[0]);
+            i32Ret = -1;
+            break;
         }
+        *pui32PageSize = (g_pui8Buffer[1] << 24) | (g_pui8Buffer[2] << 16) |
+                         (g_pui8Buffer[3] << 8) | g_pui8Buffer[4];
+        if((*pui32PageSize == 0) || (*pui32PageSize & 3))
+        {
+            i32Ret = -1;
+            break;
+        }
+        for(pui8Crc = &g_pui8Buffer[5]; ui32Count; ui32Count--, pui8Crc += 4)
+        {
+            pui32Crc[ui32Page++] = (pui8Crc[0] << 24) | (pui8Crc[1] << 16) |
+                                   (pui8Crc[2] << 8) | pui8Crc[3];
+        }
+        ui32Start += DELTA_PAGES_MAX * *pui32PageSize;
     }
+    while(ui32Page < ui32Pages);
+    UARTSetTimeout(RECEIVE_TIMEOUT);
 
-    //
-    // Open the file to download.
-    //
-    hFile = fopen(g_pcFilename, "rb");
-    if(hFile == 0)
+    return(i32Ret);
+}
+
+//*****************************************************************************
+//
+//! GetChangedPages() compares the flash pages of the device with an image.
+//!
+//! \param pui8Data is the image data.
+//! \param ui32Start is the flash address of the image.
+//! \param ui32Length is the length of the image in bytes.
+//! \param pui32PageSize returns the page size of the device.
+//! \param pui32Pages returns the number of pages of the image.
+//! \param ppui8Changed returns an allocated array with a non-zero entry for
+//!     each page that differs.  It must be freed by the caller.
+//!
+//! This routine compares the CRC32 of the flash pages on the device with the
+//! CRC32 of the pages of the image, padded with the erased value 0xff at the
+//! end.
+//!
+//! \return This function returns zero on success, a negative value on failure
+//!     or a positive value if the device does not support it.
+//
+//*****************************************************************************
+int32_t
+GetChangedPages(uint8_t *pui8Data, uint32_t ui32Start, uint32_t ui32Length,
+                uint32_t *pui32PageSize, uint32_t *pui32Pages,
+                uint8_t **ppui8Changed)
+{
+    uint32_t ui32PageSize;
+    uint32_t ui32Pages;
+    uint32_t *pui32DevCrc;
+    uint8_t *pui8Changed;
+    uint8_t *pui8Page;
+    uint32_t i;
+    int32_t i32Ret;
+
+    if(GetPageCrcs(ui32Start, 0, &ui32PageSize, 0) != 0)
     {
-        printf("Failed to open file: %s\n", g_pcFilename);
+        return(1);
+    }
+    if(ui32Start % ui32PageSize)
+    {
+        printf("The program address is not aligned to the flash pages.\n");
+        return(1);
+    }
+    ui32Pages = (ui32Length + ui32PageSize - 1) / ui32PageSize;
+
+    pui32DevCrc = malloc(ui32Pages * sizeof(uint32_t));
+    pui8Changed = malloc(ui32Pages);
+    pui8Page = malloc(ui32PageSize);
+    if((pui32DevCrc == 0) || (pui8Changed == 0) || (pui8Page == 0))
+    {
+        free(pui32DevCrc);
+        free(pui8Changed);
+        free(pui8Page);
         return(-1);
     }
 
-    if(OpenUART(g_pcCOMName, g_pui32BaudRate))
+    i32Ret = GetPageCrcs(ui32Start, ui32Pages, &ui32PageSize, pui32DevCrc);
+    for(i = 0; (i32Ret == 0) && (i < ui32Pages); i++)
     {
-        printf("Failed to configure Host UART\n");
+        memset(pui8Page, 0xff, ui32PageSize);
+        memcpy(pui8Page, &pui8Data[i * ui32PageSize],
+               (ui32Length - i * ui32PageSize < ui32PageSize) ?
+               (ui32Length - i * ui32PageSize) : ui32PageSize);
+        pui8Changed[i] = (Crc32(pui8Page, ui32PageSize) != pui32DevCrc[i]);
+    }
+    free(pui32DevCrc);
+    free(pui8Page);
+    if(i32Ret != 0)
+    {
+        free(pui8Changed);
         return(-1);
     }
 
-    //
-    // Now try to auto baud with the board by sending the Sync and waiting
-    // for an ack from the board.
-    //
-    if(g_i32DisableAutoBaud == 0)
+    *pui32PageSize = ui32PageSize;
+    *pui32Pages = ui32Pages;
+    *ppui8Changed = pui8Changed;
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! VerifyImage() verifies the image in the flash of the device.
+//!
+//! \param pui8Data is the image data.
+//! \param ui32Start is the flash address of the image.
+//! \param ui32Length is the length of the image in bytes.
+//!
+//! This routine compares the CRC32 of all flash pages of the image.
+//!
+//! \return This function returns zero if the flash holds the image or a
+//!     negative value otherwise.
+//
+//*****************************************************************************
+int32_t
+VerifyImage(uint8_t *pui8Data, uint32_t ui32Start, uint32_t ui32Length)
+{
+    uint32_t ui32PageSize;
+    uint32_t ui32Pages;
+    uint8_t *pui8Changed;
+    uint32_t i;
+    int32_t i32Ret;
+
+    if(GetChangedPages(pui8Data, ui32Start, ui32Length, &ui32PageSize,
+                       &ui32Pages, &pui8Changed) != 0)
     {
-        if(AutoBaud())
+        printf("Failed to verify the image.\n");
+        return(-1);
+    }
+    i32Ret = 0;
+    for(i = 0; i < ui32Pages; i++)
+    {
+        if(pui8Changed[i])
         {
-            printf("Failed to synchronize with board.\n");
-            return(-1);
+            printf("Verify failed at flash page %d.\n", i);
+            i32Ret = -1;
         }
     }
-
-    printf("\n");
-    if(g_pcBootLoadName)
+    if(i32Ret == 0)
     {
-        printf("Boot Loader    : %s\n", g_pcBootLoadName);
+        printf("Verified %d flash pages.\n", ui32Pages);
     }
-    printf("Application    : %s\n", g_pcFilename);
-    printf("Program Address: 0x%x\n", g_ui32DownloadAddress);
-    printf("       COM Port: %s\n", g_pcCOMName);
-    printf("      Baud Rate: %d\n", g_pui32BaudRate);
 
-    printf("Erasing Flash:\n");
+    free(pui8Changed);
+    return(i32Ret);
+}
 
-    //
-    // If both a boot loader and an application were specified then update both
-    // the boot loader and the application.
-    //
-    if(g_pcBootLoadName != 0)
+//*****************************************************************************
+//
+//! UpdateDelta() updates only the flash pages that changed.
+//!
+//! \param pui8Data is the image data.
+//! \param ui32Start is the flash address of the image.
+//! \param ui32Length is the length of the image in bytes.
+//!
+//! This routine finds the flash pages which differ from the image.  Each run
+//! of changed pages is erased and programmed separately.  Finally the whole
+//! image is verified.
+//!
+//! \return This function returns zero if the flash holds the image, a
+//!     negative value on failure, or a positive value if the device does not
+//!     support the delta update.  In the latter case no data was programmed.
+//
+//*****************************************************************************
+int32_t
+UpdateDelta(uint8_t *pui8Data, uint32_t ui32Start, uint32_t ui32Length)
+{
+    uint32_t ui32PageSize;
+    uint32_t ui32Pages;
+    uint32_t ui32Changed;
+    uint32_t ui32First;
+    uint32_t ui32Last;
+    uint32_t ui32End;
+    uint8_t *pui8Changed;
+    uint32_t i;
+    int32_t i32Ret;
+
+    i32Ret = GetChangedPages(pui8Data, ui32Start, ui32Length, &ui32PageSize,
+                             &ui32Pages, &pui8Changed);
+    if(i32Ret != 0)
     {
-        if(UpdateFlash(hFile, hFileBoot, g_ui32DownloadAddress) < 0)
-        {
-            return(-1);
-        }
+        return(i32Ret);
     }
-    //
-    // Otherwise just update the application.
-    //
-    else if(UpdateFlash(hFile, 0, g_ui32DownloadAddress) < 0)
+    ui32Changed = 0;
+    for(i = 0; i < ui32Pages; i++)
     {
-        return(-1);
+        if(pui8Changed[i])
+        {
+            ui32Changed++;
+        }
     }
+    printf("%d of %d flash pages changed.\n", ui32Changed, ui32Pages);
 
     //
-    // If a start address was specified then send the run command to the
-    // boot loader.
+    // Download each run of changed pages.
     //
-    if(g_ui32StartAddress != 0xffffffff)
+    for(i = 0; (i32Ret == 0) && (i < ui32Pages); )
     {
-        //
-        // Send the run command but just send the packet, there will likely
-        // be no boot loader to answer after this command completes.
-        //
-        g_pui8Buffer[0] = COMMAND_RUN;
-        g_pui8Buffer[1] = (uint8_t)(g_ui32StartAddress>>24);
-        g_pui8Buffer[2] = (uint8_t)(g_ui32StartAddress>>16);
-        g_pui8Buffer[3] = (uint8_t)(g_ui32StartAddress>>8);
-        g_pui8Buffer[4] = (uint8_t)g_ui32StartAddress;
-        if(SendPacket(g_pui8Buffer, 5, 0) < 0)
+        if(!pui8Changed[i])
         {
-            printf("Failed to Send Run command\n");
+            i++;
+            continue;
         }
-        else
+        ui32First = i;
+        ui32Last = i;
+        for(i++; (i < ui32Pages) && (i <= ui32Last + DELTA_MERGE_GAP + 1); i++)
         {
-            printf("Running from address %08x\n",g_ui32StartAddress);
+            if(pui8Changed[i])
+            {
+                ui32Last = i;
+            }
         }
+        ui32End = (ui32Last + 1) * ui32PageSize;
+        if(ui32End > ui32Length)
+        {
+            ui32End = ui32Length;
+        }
+        printf("Updating flash pages %d to %d.\n", ui32First, ui32Last);
+        i32Ret = DownloadImage(COMMAND_DOWNLOAD_PAGES,
+                               &pui8Data[ui32First * ui32PageSize],
+                               ui32Start + ui32First * ui32PageSize,
+                               ui32End - ui32First * ui32PageSize);
+        if(i32Ret > 0)
+        {
+            i32Ret = -1;
+        }
+        i = ui32Last + 1;
     }
-    else
-    {
-        //
-        // Send the reset command but just send the packet, there will likely
-        // be no boot loader to answer after this command completes.
-        //
-        g_pui8Buffer[0] = COMMAND_RESET;
-        SendPacket(g_pui8Buffer, 1, 0);
-    }
-    if(hFile != 0)
+    free(pui8Changed);
+
+    //
+    // Verify the whole image.
+    //
+    if(i32Ret == 0)
     {
-        fclose(hFile);
+        i32Ret = VerifyImage(pui8Data, ui32Start, ui32Length);
     }
-    printf("Successfully downloaded to device.\n");
-    return(0);
+
+    return((i32Ret == 0) ? 0 : -1);
 }
 
 //*****************************************************************************
@@ -842,7 +2853,7 @@ UpdateFlash(FILE *hFile, FILE *hBootFile, uint32_t ui32Address)
     uint32_t ui32TransferStart;
     uint32_t ui32TransferLength;
     uint8_t *pui8FileBuffer;
-    uint32_t ui32Offset;
+    int32_t i32Ret;
 
     //
     // At least one file must be specified.
@@ -922,71 +2933,38 @@ UpdateFlash(FILE *hFile, FILE *hBootFile, uint32_t ui32Address)
     }
 
     //
-    // Build up the download command and send it to the board.
+    // Update only the flash pages that changed if requested.  If the boot
+    // loader does not support it, nothing has been programmed yet, so fall
+    // back to updating the whole image.
     //
-    g_pui8Buffer[0] = COMMAND_DOWNLOAD;
-    g_pui8Buffer[1] = (uint8_t)(ui32TransferStart >> 24);
-    g_pui8Buffer[2] = (uint8_t)(ui32TransferStart >> 16);
-    g_pui8Buffer[3] = (uint8_t)(ui32TransferStart >> 8);
-    g_pui8Buffer[4] = (uint8_t)ui32TransferStart;
-    g_pui8Buffer[5] = (uint8_t)(ui32TransferLength>>24);
-    g_pui8Buffer[6] = (uint8_t)(ui32TransferLength>>16);
-    g_pui8Buffer[7] = (uint8_t)(ui32TransferLength>>8);
-    g_pui8Buffer[8] = (uint8_t)ui32TransferLength;
-    if(SendCommand(g_pui8Buffer, 9) < 0)
-    {
-        printf("Failed to Send Download Command\n");
-        return(-1);
-    }
-
-    ui32Offset = 0;
-
-    printf("Remaining Bytes: ");
-    do
+    if(g_i32Delta && (ui32TransferStart != 0))
     {
-        uint8_t ui8BytesSent;
-
-        g_pui8Buffer[0] = COMMAND_SEND_DATA;
-
-        printf("%08ld", ui32TransferLength);
-
-        //
-        // Send out 8 bytes at a time to throttle download rate and avoid
-        // overruning the device since it is programming flash on the fly.
-        //
-        if(ui32TransferLength >= g_ui32DataSize)
-        {
-            memcpy(&g_pui8Buffer[1], &pui8FileBuffer[ui32Offset], g_ui32DataSize);
-
-            ui32Offset += g_ui32DataSize;
-            ui32TransferLength -= g_ui32DataSize;
-            ui8BytesSent = g_ui32DataSize + 1;
-        }
-        else
-        {
-            memcpy(&g_pui8Buffer[1], &pui8FileBuffer[ui32Offset], ui32TransferLength);
-            ui32Offset += ui32TransferLength;
-            ui8BytesSent = ui32TransferLength + 1;
-            ui32TransferLength = 0;
-        }
-        //
-        // Send the Send Data command to the device.
-        //
-        if(SendCommand(g_pui8Buffer, ui8BytesSent) < 0)
+        i32Ret = UpdateDelta(pui8FileBuffer, ui32TransferStart,
+                             ui32TransferLength);
+        if(i32Ret <= 0)
         {
-            printf("Failed to Send Packet data\n");
-            break;
+            free(pui8FileBuffer);
+            return(i32Ret);
         }
+        printf("Delta update not supported, updating the whole image.\n");
+    }
 
-        printf("\b\b\b\b\b\b\b\b");
-    } while (ui32TransferLength);
-    printf("00000000\n");
+    g_ui32BlankSkipped = 0;
+    i32Ret = DownloadImage(COMMAND_DOWNLOAD, pui8FileBuffer,
+                           ui32TransferStart, ui32TransferLength);
 
-    if(pui8FileBuffer)
+    //
+    // Verify the image if blank regions were skipped, as the flash is assumed
+    // to be erased there.
+    //
+    if((i32Ret == 0) && g_ui32BlankSkipped)
     {
-        free(pui8FileBuffer);
+        printf("Skipped %d bytes of blank regions.\n", g_ui32BlankSkipped);
+        i32Ret = VerifyImage(pui8FileBuffer, ui32TransferStart,
+                             ui32TransferLength);
     }
-    return(0);
+    free(pui8FileBuffer);
+    return(i32Ret);
 }
 
 //*****************************************************************************
@@ -22,6 +22,12 @@
 //
 //*****************************************************************************
 
+//*****************************************************************************
+// Changes by M. Fras on 18 Oct 2026 to support high baud rates, to switch the
+// baud rate of an open port and to time out on receive.  The POSIX version
+// uses non-blocking I/O with poll() and buffers the received data.
+//*****************************************************************************
+
 #include <stdint.h>
 #ifdef __WIN32
 #include <stdio.h>
@@ -29,10 +35,19 @@
 #include <fcntl.h>
 #include <windows.h>
 #else
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <string.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#include <sys/ioctl.h>
 #endif
+#endif
+#include "uart_handler.h"
 
 //*****************************************************************************
 //
@@ -56,6 +71,79 @@ static HANDLE g_hComPort;
 static int32_t g_i32ComPort = -1;
 #endif
 
+#ifndef __WIN32
+//*****************************************************************************
+//
+//! The size of the receive buffer.  Each read() fetches as much data as is
+//! available up to this size, so that short reads of single bytes, as done by
+//! the packet handler, do not cost one system call each.
+//
+//*****************************************************************************
+#define UART_RX_BUFFER_SIZE     4096
+
+//*****************************************************************************
+//
+//! The receive buffer and the positions of the first unread and the last
+//! received byte.
+//
+//*****************************************************************************
+static uint8_t g_pui8RxBuffer[UART_RX_BUFFER_SIZE];
+static uint32_t g_ui32RxRead;
+static uint32_t g_ui32RxFill;
+
+//*****************************************************************************
+//
+//! The time in milliseconds a call to UARTReceiveData() or UARTSendData() may
+//! take before it fails.
+//
+//*****************************************************************************
+static uint32_t g_ui32Timeout = 8000;
+#endif
+
+#ifndef __WIN32
+//*****************************************************************************
+//
+//! This table maps the supported baud rates to the termios speed values.  The
+//! high baud rates are not available on all hosts.  The rate the UART of the
+//! host actually runs at depends on its clock and divider, e.g. USB serial
+//! converters with a 3 MHz base clock run 921600 baud at 923077 (+0.16%).  The
+//! device adds the error of its own divider, see g_pui32BaudRates in sflash.c.
+//
+//*****************************************************************************
+static const struct
+{
+    uint32_t ui32BaudRate;
+    speed_t sSpeed;
+}
+g_psBaudRates[] =
+{
+    { 9600, B9600 },
+    { 19200, B19200 },
+    { 38400, B38400 },
+    { 57600, B57600 },
+    { 115200, B115200 },
+    { 230400, B230400 },
+#ifdef B460800
+    { 460800, B460800 },
+#endif
+#ifdef B921600
+    { 921600, B921600 },
+#endif
+#ifdef B1000000
+    { 1000000, B1000000 },
+#endif
+#ifdef B1500000
+    { 1500000, B1500000 },
+#endif
+#ifdef B2000000
+    { 2000000, B2000000 },
+#endif
+#ifdef B3000000
+    { 3000000, B3000000 },
+#endif
+};
+#endif
+
 //*****************************************************************************
 //
 //! OpenUART() opens the UART port.
@@ -124,65 +212,208 @@ OpenUART(char *pcComPort, uint32_t ui32BaudRate)
 #else
     struct termios sOptions;
 
-    g_i32ComPort = open(pcComPort, O_RDWR | O_NOCTTY | O_NDELAY);
+#ifdef __linux__
+    struct serial_struct sSerial;
+#endif
+
+    //
+    // The port stays in the non-blocking mode, UARTReceiveData() and
+    // UARTSendData() wait with poll().
+    //
+    g_i32ComPort = open(pcComPort, O_RDWR | O_NOCTTY | O_NONBLOCK);
     if(g_i32ComPort == -1)
     {
         return(-1);
     }
+    g_ui32RxRead = 0;
+    g_ui32RxFill = 0;
+
+    if(tcgetattr(g_i32ComPort, &sOptions))
+    {
+        return(-1);
+    }
+
+    sOptions.c_cflag |= (CLOCAL | CREAD);
+
+    sOptions.c_cflag &= ~(CSIZE);
+    sOptions.c_cflag |= CS8;
+
+    sOptions.c_cflag &= ~(PARENB);
+    sOptions.c_cflag &= ~(CSTOPB);
+
+    sOptions.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+
+    sOptions.c_oflag &= ~(OPOST);
 
-    fcntl(g_i32ComPort, F_SETFL, 0);
+    sOptions.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL | INLCR | IGNCR |
+                          ISTRIP | INPCK | BRKINT | PARMRK);
 
-    tcgetattr(g_i32ComPort, &sOptions);
+    sOptions.c_cflag &= ~(CRTSCTS);
+
+    //
+    // Return every byte as soon as it arrives.  The timeouts are handled by
+    // poll().
+    //
+    sOptions.c_cc[VMIN] = 0;
+    sOptions.c_cc[VTIME] = 0;
 
-    if(ui32BaudRate == 9600)
+    if(tcsetattr(g_i32ComPort, TCSANOW, &sOptions))
     {
-        cfsetispeed(&sOptions, B9600);
-        cfsetospeed(&sOptions, B9600);
+        return(-1);
     }
-    else if(ui32BaudRate == 19200)
+
+#ifdef __linux__
+    //
+    // Ask the serial driver to pass received data on immediately instead of
+    // collecting it first.  Not all drivers support this, e.g. USB serial
+    // adapters and pseudo terminals, so failures are ignored.
+    //
+    if(ioctl(g_i32ComPort, TIOCGSERIAL, &sSerial) == 0)
     {
-        cfsetispeed(&sOptions, B19200);
-        cfsetospeed(&sOptions, B19200);
+        sSerial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(g_i32ComPort, TIOCSSERIAL, &sSerial);
     }
-    else if(ui32BaudRate == 38400)
+#endif
+
+    tcflush(g_i32ComPort, TCIOFLUSH);
+
+    return(UARTSetBaudRate(ui32BaudRate));
+#endif
+}
+
+//*****************************************************************************
+//
+//! UARTSetBaudRate() changes the baud rate of the open UART port.
+//!
+//! \param ui32BaudRate is the new baud rate.
+//!
+//! This function waits until all pending data has been sent and then switches
+//! the host UART to the new baud rate.  The settings are read back, since some
+//! drivers silently keep a fixed baud rate.
+//!
+//! \return The function returns zero to indicated success while any non-zero
+//!     value indicates that the baud rate is not supported by the host.
+//
+//*****************************************************************************
+int32_t
+UARTSetBaudRate(uint32_t ui32BaudRate)
+{
+#ifdef __WIN32
+    DCB sDCB;
+
+    if(GetCommState(g_hComPort, &sDCB) == 0)
     {
-        cfsetispeed(&sOptions, B38400);
-        cfsetospeed(&sOptions, B38400);
+        return(-1);
     }
-    else if(ui32BaudRate == 57600)
+
+    sDCB.BaudRate = ui32BaudRate;
+    if(SetCommState(g_hComPort, &sDCB) == 0)
     {
-        cfsetispeed(&sOptions, B57600);
-        cfsetospeed(&sOptions, B57600);
+        return(-1);
     }
-    else if(ui32BaudRate == 115200)
+    return(0);
+#else
+    struct termios sOptions;
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0;
+        ui32Idx < (sizeof(g_psBaudRates) / sizeof(g_psBaudRates[0]));
+        ui32Idx++)
     {
-        cfsetispeed(&sOptions, B115200);
-        cfsetospeed(&sOptions, B115200);
+        if(g_psBaudRates[ui32Idx].ui32BaudRate == ui32BaudRate)
+        {
+            break;
+        }
     }
-    else
+    if(ui32Idx == (sizeof(g_psBaudRates) / sizeof(g_psBaudRates[0])))
     {
-        cfsetispeed(&sOptions, B230400);
-        cfsetospeed(&sOptions, B230400);
+        return(-1);
     }
 
-    sOptions.c_cflag |= (CLOCAL | CREAD);
+    tcdrain(g_i32ComPort);
 
-    sOptions.c_cflag &= ~(CSIZE);
-    sOptions.c_cflag |= CS8;
+    if(tcgetattr(g_i32ComPort, &sOptions))
+    {
+        return(-1);
+    }
+    cfsetispeed(&sOptions, g_psBaudRates[ui32Idx].sSpeed);
+    cfsetospeed(&sOptions, g_psBaudRates[ui32Idx].sSpeed);
+    if(tcsetattr(g_i32ComPort, TCSANOW, &sOptions))
+    {
+        return(-1);
+    }
 
-    sOptions.c_cflag &= ~(PARENB);
-    sOptions.c_cflag &= ~(CSTOPB);
+    if(tcgetattr(g_i32ComPort, &sOptions) ||
+       (cfgetospeed(&sOptions) != g_psBaudRates[ui32Idx].sSpeed))
+    {
+        return(-1);
+    }
+    return(0);
+#endif
+}
 
-    sOptions.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+//*****************************************************************************
+//
+//! UARTSetTimeout() sets the receive timeout of the UART port.
+//!
+//! \param ui32Timeout is the timeout in milliseconds.
+//!
+//! This function sets the time UARTReceiveData() waits for data before it
+//! fails.  On POSIX hosts the timeout applies to the whole call of
+//! UARTReceiveData() or UARTSendData(), not to each byte.
+//!
+//! \return The function returns zero to indicated success while any non-zero
+//!     value indicates a failure.
+//
+//*****************************************************************************
+int32_t
+UARTSetTimeout(uint32_t ui32Timeout)
+{
+#ifdef __WIN32
+    COMMTIMEOUTS sCommTimeouts;
 
-    sOptions.c_oflag &= ~(OPOST);
+    if(GetCommTimeouts(g_hComPort, &sCommTimeouts) == 0)
+    {
+        return(-1);
+    }
 
-    tcsetattr(g_i32ComPort, TCSANOW, &sOptions);
+    sCommTimeouts.ReadIntervalTimeout = 0;
+    sCommTimeouts.ReadTotalTimeoutConstant = ui32Timeout;
+    sCommTimeouts.ReadTotalTimeoutMultiplier = 0;
+
+    if(SetCommTimeouts(g_hComPort, &sCommTimeouts) == 0)
+    {
+        return(-1);
+    }
+    return(0);
+#else
+    g_ui32Timeout = ui32Timeout;
 
     return(0);
 #endif
 }
 
+//*****************************************************************************
+//
+//! UARTFlushReceive() discards all received data that has not been read.
+//!
+//! \return The function returns zero to indicated success while any non-zero
+//!     value indicates a failure.
+//
+//*****************************************************************************
+int32_t
+UARTFlushReceive(void)
+{
+#ifdef __WIN32
+    return(PurgeComm(g_hComPort, PURGE_RXCLEAR) ? 0 : -1);
+#else
+    g_ui32RxRead = 0;
+    g_ui32RxFill = 0;
+
+    return(tcflush(g_i32ComPort, TCIFLUSH));
+#endif
+}
+
 //*****************************************************************************
 //
 //! CloseUART() closes the UART port.
@@ -202,12 +433,76 @@ CloseUART(void)
     if(g_i32ComPort != -1)
     {
         close(g_i32ComPort);
+        g_i32ComPort = -1;
     }
 
     return(0);
 #endif
 }
 
+#ifndef __WIN32
+//*****************************************************************************
+//
+//! UARTDeadline() returns the time at which the current operation times out.
+//!
+//! \return The deadline in milliseconds of the monotonic clock.
+//
+//*****************************************************************************
+static uint64_t
+UARTDeadline(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+    return((uint64_t)sTime.tv_sec * 1000 + sTime.tv_nsec / 1000000 +
+           g_ui32Timeout);
+}
+
+//*****************************************************************************
+//
+//! UARTWait() waits until the UART port is ready.
+//!
+//! \param i16Events is the event to wait for, POLLIN or POLLOUT.
+//! \param ui64Deadline is the time returned by UARTDeadline().
+//!
+//! \return This function returns zero if the port is ready and a non-zero
+//!     value on timeout or error.
+//
+//*****************************************************************************
+static int32_t
+UARTWait(int16_t i16Events, uint64_t ui64Deadline)
+{
+    struct pollfd sPoll;
+    struct timespec sTime;
+    uint64_t ui64Now;
+    int32_t i32Ret;
+
+    for(;;)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &sTime);
+        ui64Now = (uint64_t)sTime.tv_sec * 1000 + sTime.tv_nsec / 1000000;
+        if(ui64Now >= ui64Deadline)
+        {
+            return(-1);
+        }
+
+        sPoll.fd = g_i32ComPort;
+        sPoll.events = i16Events;
+        sPoll.revents = 0;
+        i32Ret = poll(&sPoll, 1, (int)(ui64Deadline - ui64Now));
+        if(i32Ret > 0)
+        {
+            return((sPoll.revents & i16Events) ? 0 : -1);
+        }
+        if((i32Ret < 0) && (errno != EINTR))
+        {
+            return(-1);
+        }
+    }
+}
+#endif
+
 //*****************************************************************************
 //
 //! UARTSendData() sends data over a UART port.
@@ -244,9 +539,31 @@ UARTSendData(uint8_t const *pui8Data, uint8_t ui8Size)
     }
     return(0);
 #else
-    if(write(g_i32ComPort, pui8Data, ui8Size) != ui8Size)
+    uint64_t ui64Deadline;
+    ssize_t iCount;
+
+    //
+    // The port may accept less data than given, so keep on writing until all
+    // data has been sent or the timeout expires.
+    //
+    ui64Deadline = UARTDeadline();
+    while(ui8Size)
     {
-        return(-1);
+        iCount = write(g_i32ComPort, pui8Data, ui8Size);
+        if(iCount > 0)
+        {
+            pui8Data += iCount;
+            ui8Size -= iCount;
+            continue;
+        }
+        if((iCount < 0) && (errno != EAGAIN) && (errno != EINTR))
+        {
+            return(-1);
+        }
+        if(UARTWait(POLLOUT, ui64Deadline))
+        {
+            return(-1);
+        }
     }
 
     return(0);
@@ -285,9 +602,46 @@ UARTReceiveData(uint8_t *pui8Data, uint8_t ui8Size)
     }
     return(0);
 #else
-    if(read(g_i32ComPort, pui8Data, ui8Size) != ui8Size)
+    uint64_t ui64Deadline;
+    uint32_t ui32Count;
+    ssize_t iCount;
+
+    //
+    // Take the data from the receive buffer and refill it from the port until
+    // all data has been received or the timeout expires.
+    //
+    ui64Deadline = UARTDeadline();
+    while(ui8Size)
     {
-        return(-1);
+        if(g_ui32RxRead < g_ui32RxFill)
+        {
+            ui32Count = g_ui32RxFill - g_ui32RxRead;
+            if(ui32Count > ui8Size)
+            {
+                ui32Count = ui8Size;
+            }
+            memcpy(pui8Data, &g_pui8RxBuffer[g_ui32RxRead], ui32Count);
+            g_ui32RxRead += ui32Count;
+            pui8Data += ui32Count;
+            ui8Size -= ui32Count;
+            continue;
+        }
+
+        iCount = read(g_i32ComPort, g_pui8RxBuffer, UART_RX_BUFFER_SIZE);
+        if(iCount > 0)
+        {
+            g_ui32RxRead = 0;
+            g_ui32RxFill = iCount;
+            continue;
+        }
+        if((iCount < 0) && (errno != EAGAIN) && (errno != EINTR))
+        {
+            return(-1);
+        }
+        if(UARTWait(POLLIN, ui64Deadline))
+        {
+            return(-1);
+        }
     }
 
     return(0);
@@ -26,6 +26,9 @@
 
 int32_t CloseUART(void);
 int32_t OpenUART(char *pcComPort, uint32_t ui32BaudRate);
+int32_t UARTSetBaudRate(uint32_t ui32BaudRate);
+int32_t UARTSetTimeout(uint32_t ui32Timeout);
+int32_t UARTFlushReceive(void);
 int32_t UARTSendData(uint8_t const *pui8Data, uint8_t ui8Size);
 int32_t UARTReceiveData(uint8_t *pui8Data, uint8_t ui8Size);
 